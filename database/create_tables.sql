@@ -8,82 +8,162 @@ CREATE USER IF NOT EXISTS 'sensor_user'@'localhost' IDENTIFIED BY 'sensor_pass';
 GRANT ALL PRIVILEGES ON sensor_data.* TO 'sensor_user'@'localhost';
 FLUSH PRIVILEGES;
 
+-- 两张数据表按created_at范围分区（TIMESTAMP列只能用UNIX_TIMESTAMP()分区，
+-- 分区列必须包含在主键中）。建表时只有pmax一个分区，程序运行时按天或按周
+-- 预建p<YYYYMMDD>分区，过期数据按整个分区删除（ALTER TABLE ... DROP PARTITION），
+-- 不再逐行DELETE。
+
+-- 表结构v2：学号和传感器名称只在字典表中保存一次，数据行引用SMALLINT字典键；
+-- 温湿度为0.01单位的SMALLINT，状态为TINYINT（0 NORMAL、1 WARNING、2 ERROR、
+-- 3 OFFLINE）。按学号查询最新数据走(student_key, id)索引范围扫描（timestamp是
+-- 设备的节拍计数，每次启动从头开始，最新数据按id排序）。
+-- 从v1升级见migrate_v2.sql。
+
+-- 创建字典表（kind：0学号，1传感器名称）
+CREATE TABLE IF NOT EXISTS sensor_dict (
+    dict_key SMALLINT UNSIGNED AUTO_INCREMENT PRIMARY KEY COMMENT '字典键',
+    kind TINYINT UNSIGNED NOT NULL COMMENT '类别（0学号，1传感器名称）',
+    name VARCHAR(20) NOT NULL COMMENT '名称',
+    UNIQUE KEY uk_kind_name (kind, name)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci COMMENT='学号和传感器名称字典';
+
 -- 创建传感器1数据表（温湿度传感器）
 CREATE TABLE IF NOT EXISTS sensor1_data (
-    id INT AUTO_INCREMENT PRIMARY KEY COMMENT '主键ID',
-    student_id VARCHAR(20) NOT NULL COMMENT '学号姓名缩写',
-    sensor_name VARCHAR(16) NOT NULL COMMENT '传感器名称',
-    temperature DECIMAL(5,2) NOT NULL COMMENT '温度值（摄氏度）',
-    humidity DECIMAL(5,2) NOT NULL COMMENT '湿度值（百分比）',
-    status VARCHAR(10) NOT NULL DEFAULT 'NORMAL' COMMENT '传感器状态',
+    id INT AUTO_INCREMENT COMMENT '主键ID',
+    student_key SMALLINT UNSIGNED NOT NULL COMMENT '学号字典键',
+    sensor_key SMALLINT UNSIGNED NOT NULL COMMENT '传感器名称字典键',
+    temperature SMALLINT NOT NULL COMMENT '温度值（0.01摄氏度）',
+    humidity SMALLINT UNSIGNED NOT NULL COMMENT '湿度值（0.01%）',
+    status TINYINT UNSIGNED NOT NULL DEFAULT 0 COMMENT '传感器状态',
     timestamp INT UNSIGNED NOT NULL COMMENT '时间戳',
-    created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP COMMENT '记录创建时间',
-    updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP COMMENT '记录更新时间',
-    INDEX idx_student_id (student_id),
-    INDEX idx_timestamp (timestamp),
-    INDEX idx_created_at (created_at)
-) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci COMMENT='传感器1数据表（温湿度传感器）';
+    created_at TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP COMMENT '记录创建时间',
+    PRIMARY KEY (id, created_at),
+    INDEX idx_student_row (student_key, id),
+    INDEX idx_timestamp (timestamp)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci COMMENT='传感器1数据表（温湿度传感器）'
+PARTITION BY RANGE (UNIX_TIMESTAMP(created_at)) (
+    PARTITION pmax VALUES LESS THAN MAXVALUE
+);
 
 -- 创建传感器2数据表（中断传感器）
 CREATE TABLE IF NOT EXISTS sensor2_data (
-    id INT AUTO_INCREMENT PRIMARY KEY COMMENT '主键ID',
+    id INT AUTO_INCREMENT COMMENT '主键ID',
+    student_key SMALLINT UNSIGNED NOT NULL COMMENT '学号字典键',
+    sensor_key SMALLINT UNSIGNED NOT NULL COMMENT '传感器名称字典键',
+    interrupt_type TINYINT UNSIGNED NOT NULL COMMENT '中断类型',
+    interrupt_count INT UNSIGNED NOT NULL DEFAULT 1 COMMENT '中断次数（合并窗口内事件数）',
+    status TINYINT UNSIGNED NOT NULL DEFAULT 0 COMMENT '传感器状态',
+    first_timestamp INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '合并窗口内首个事件时间戳',
+    timestamp INT UNSIGNED NOT NULL COMMENT '时间戳（合并窗口内最后一个事件）',
+    created_at TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP COMMENT '记录创建时间',
+    PRIMARY KEY (id, created_at),
+    INDEX idx_student_row (student_key, id),
+    INDEX idx_sensor_timestamp (sensor_key, timestamp),
+    INDEX idx_timestamp (timestamp)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci COMMENT='传感器2数据表（中断传感器）'
+PARTITION BY RANGE (UNIX_TIMESTAMP(created_at)) (
+    PARTITION pmax VALUES LESS THAN MAXVALUE
+);
+
+-- 按v1的列（学号、名称、小数、状态文本）查看数据的视图，供手工查询使用
+CREATE OR REPLACE VIEW sensor1_readings AS
+SELECT d.id, s.name AS student_id, n.name AS sensor_name,
+       d.temperature / 100 AS temperature, d.humidity / 100 AS humidity,
+       ELT(d.status + 1, 'NORMAL', 'WARNING', 'ERROR', 'OFFLINE') AS status,
+       d.timestamp, d.created_at
+FROM sensor1_data d
+JOIN sensor_dict s ON s.dict_key = d.student_key
+JOIN sensor_dict n ON n.dict_key = d.sensor_key;
+
+CREATE OR REPLACE VIEW sensor2_readings AS
+SELECT d.id, s.name AS student_id, n.name AS sensor_name,
+       d.interrupt_type, d.interrupt_count,
+       ELT(d.status + 1, 'NORMAL', 'WARNING', 'ERROR', 'OFFLINE') AS status,
+       d.first_timestamp, d.timestamp, d.created_at
+FROM sensor2_data d
+JOIN sensor_dict s ON s.dict_key = d.student_key
+JOIN sensor_dict n ON n.dict_key = d.sensor_key;
+
+-- 汇总表：按分钟、小时、天三级保存每个(时间桶, 类型, 学号, 传感器, 状态)的
+-- 行数和数值之和，由程序在写入原始数据的同一事务中累加（INSERT ... ON DUPLICATE
+-- KEY UPDATE）。时间桶按写入时服务器的UNIX_TIMESTAMP()划分（与created_at同一
+-- 时钟；数据中的timestamp是设备上电后的计数，不能作为时间桶）；status为0 NORMAL、
+-- 1 WARNING、2 ERROR、3 OFFLINE；sum_a/sum_b在传感器1中为温度、湿度之和，
+-- 在传感器2中为中断次数之和和0。原始数据按分区过期后汇总仍然保留。
+CREATE TABLE IF NOT EXISTS sensor_rollup_minute (
+    bucket INT UNSIGNED NOT NULL COMMENT '时间桶起点（服务器UNIX秒）',
+    sensor_type TINYINT UNSIGNED NOT NULL COMMENT '数据类型（1温湿度，2中断）',
     student_id VARCHAR(20) NOT NULL COMMENT '学号姓名缩写',
     sensor_name VARCHAR(16) NOT NULL COMMENT '传感器名称',
-    interrupt_type TINYINT UNSIGNED NOT NULL COMMENT '中断类型',
-    interrupt_count INT UNSIGNED NOT NULL DEFAULT 1 COMMENT '中断次数',
-    status VARCHAR(10) NOT NULL DEFAULT 'NORMAL' COMMENT '传感器状态',
-    timestamp INT UNSIGNED NOT NULL COMMENT '时间戳',
-    created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP COMMENT '记录创建时间',
-    updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP COMMENT '记录更新时间',
-    INDEX idx_student_id (student_id),
-    INDEX idx_sensor_name (sensor_name),
-    INDEX idx_timestamp (timestamp),
-    INDEX idx_created_at (created_at)
-) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci COMMENT='传感器2数据表（中断传感器）';
-
--- 创建传感器状态统计视图
-CREATE VIEW sensor_status_summary AS
-SELECT 
-    'sensor1' as sensor_type,
-    student_id,
-    sensor_name,
-    status,
-    COUNT(*) as count,
-    MAX(created_at) as last_update
-FROM sensor1_data 
-GROUP BY student_id, sensor_name, status
-UNION ALL
+    status TINYINT UNSIGNED NOT NULL COMMENT '传感器状态',
+    row_count INT UNSIGNED NOT NULL COMMENT '行数',
+    sum_a DOUBLE NOT NULL COMMENT '温度或中断次数之和',
+    sum_b DOUBLE NOT NULL COMMENT '湿度之和',
+    last_timestamp INT UNSIGNED NOT NULL COMMENT '最后一行的timestamp（设备计数）',
+    PRIMARY KEY (bucket, sensor_type, student_id, sensor_name, status)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci COMMENT='传感器数据按分钟汇总';
+
+CREATE TABLE IF NOT EXISTS sensor_rollup_hour LIKE sensor_rollup_minute;
+ALTER TABLE sensor_rollup_hour COMMENT='传感器数据按小时汇总';
+
+CREATE TABLE IF NOT EXISTS sensor_rollup_day LIKE sensor_rollup_minute;
+ALTER TABLE sensor_rollup_day COMMENT='传感器数据按天汇总';
+
+-- 旧版本数据库升级：用已有的原始数据初始化汇总表（只需执行一次，在程序
+-- 停止写入时进行；直接用SQL写入原始表的数据，包括下面的示例数据，也要这样
+-- 补入汇总表。小时表、天表把60换成3600、86400，表名相应替换）：
+-- INSERT INTO sensor_rollup_minute
+-- SELECT UNIX_TIMESTAMP(created_at) - UNIX_TIMESTAMP(created_at) % 60, 1, student_id, sensor_name,
+--        FIELD(status, 'NORMAL', 'WARNING', 'ERROR', 'OFFLINE') - 1,
+--        COUNT(*), SUM(temperature), SUM(humidity), MAX(timestamp)
+-- FROM sensor1_readings GROUP BY 1, 3, 4, 5
+-- UNION ALL
+-- SELECT UNIX_TIMESTAMP(created_at) - UNIX_TIMESTAMP(created_at) % 60, 2, student_id, sensor_name,
+--        FIELD(status, 'NORMAL', 'WARNING', 'ERROR', 'OFFLINE') - 1,
+--        COUNT(*), SUM(interrupt_count), 0, MAX(timestamp)
+-- FROM sensor2_readings GROUP BY 1, 3, 4, 5;
+
+-- 创建传感器状态统计视图（读取按天汇总表，不再扫描原始数据表）
+CREATE OR REPLACE VIEW sensor_status_summary AS
 SELECT 
-    'sensor2' as sensor_type,
+    CONCAT('sensor', sensor_type) as sensor_type,
     student_id,
     sensor_name,
-    status,
-    COUNT(*) as count,
-    MAX(created_at) as last_update
-FROM sensor2_data 
-GROUP BY student_id, sensor_name, status;
-
--- 插入一些示例数据
-INSERT INTO sensor1_data (student_id, sensor_name, temperature, humidity, status, timestamp) VALUES
-('2021001ZS', 'TEMP_HUM', 25.60, 60.20, 'NORMAL', UNIX_TIMESTAMP()),
-('2021001ZS', 'TEMP_HUM', 26.10, 58.50, 'NORMAL', UNIX_TIMESTAMP()),
-('2021002LS', 'TEMP_HUM', 24.80, 62.30, 'NORMAL', UNIX_TIMESTAMP());
-
-INSERT INTO sensor2_data (student_id, sensor_name, interrupt_type, interrupt_count, status, timestamp) VALUES
-('2021001ZS', 'DOOR_SENSOR', 1, 1, 'NORMAL', UNIX_TIMESTAMP()),
-('2021001ZS', 'MOTION_SENSOR', 2, 1, 'NORMAL', UNIX_TIMESTAMP()),
-('2021002LS', 'DOOR_SENSOR', 1, 1, 'NORMAL', UNIX_TIMESTAMP());
+    ELT(status + 1, 'NORMAL', 'WARNING', 'ERROR', 'OFFLINE') as status,
+    SUM(row_count) as count,
+    DATE(FROM_UNIXTIME(MAX(bucket))) as last_update
+FROM sensor_rollup_day 
+GROUP BY sensor_type, student_id, sensor_name, status;
+
+-- 插入一些示例数据（新建的字典表中键从1开始依次分配）
+INSERT INTO sensor_dict (dict_key, kind, name) VALUES
+(1, 0, '2021001ZS'),
+(2, 0, '2021002LS'),
+(3, 1, 'TEMP_HUM'),
+(4, 1, 'DOOR_SENSOR'),
+(5, 1, 'MOTION_SENSOR');
+
+INSERT INTO sensor1_data (student_key, sensor_key, temperature, humidity, status, timestamp) VALUES
+(1, 3, 2560, 6020, 0, UNIX_TIMESTAMP()),
+(1, 3, 2610, 5850, 0, UNIX_TIMESTAMP()),
+(2, 3, 2480, 6230, 0, UNIX_TIMESTAMP());
+
+INSERT INTO sensor2_data (student_key, sensor_key, interrupt_type, interrupt_count, status, first_timestamp, timestamp) VALUES
+(1, 4, 1, 1, 0, UNIX_TIMESTAMP(), UNIX_TIMESTAMP()),
+(1, 5, 2, 1, 0, UNIX_TIMESTAMP(), UNIX_TIMESTAMP()),
+(2, 4, 1, 1, 0, UNIX_TIMESTAMP(), UNIX_TIMESTAMP());
 
 -- 显示表结构
+DESCRIBE sensor_dict;
 DESCRIBE sensor1_data;
 DESCRIBE sensor2_data;
 
 -- 显示示例数据
 SELECT '=== 传感器1数据示例 ===' as info;
-SELECT * FROM sensor1_data ORDER BY created_at DESC LIMIT 5;
+SELECT * FROM sensor1_readings ORDER BY id DESC LIMIT 5;
 
 SELECT '=== 传感器2数据示例 ===' as info;
-SELECT * FROM sensor2_data ORDER BY created_at DESC LIMIT 5;
+SELECT * FROM sensor2_readings ORDER BY id DESC LIMIT 5;
 
 SELECT '=== 传感器状态统计 ===' as info;
 SELECT * FROM sensor_status_summary;
\ No newline at end of file
@@ -0,0 +1,136 @@
+-- 传感器数据采集系统数据库升级脚本：表结构v1 → v2
+--
+-- v1：数据行保存学号和传感器名称字符串、DECIMAL(5,2)温湿度、状态文本。
+-- v2：学号和传感器名称保存在字典表sensor_dict中，数据行引用SMALLINT字典键；
+--     温湿度为0.01单位的SMALLINT，状态为TINYINT；按学号查询最新数据的索引为
+--     (student_key, id)。
+--
+-- 迁移新建v2表、复制数据后互换表名，原表保留为sensor*_data_v1，核对无误后
+-- 再删除。执行期间停止写入程序（程序以DB_SCHEMA_VERSION 2编译后再启动）。
+-- 程序以ENABLE_DB_PARTITION 1编译时（默认），新表转换为只有pmax一个分区的
+-- 分区表，与程序建立的表相同；程序启动后由db_partition从pmax中拆分出按天
+-- 或按周的分区（已有数据落入当前分区）。编译时关闭分区的，把下面的
+-- @enable_db_partition改为0，新表保持不分区。
+--
+-- 更早的v1表若没有sensor2_data.first_timestamp列，先执行：
+-- ALTER TABLE sensor2_data ADD COLUMN first_timestamp INT UNSIGNED NOT NULL DEFAULT 0 AFTER status;
+
+USE sensor_data;
+
+-- 与程序的ENABLE_DB_PARTITION一致
+SET @enable_db_partition = 1;
+
+-- 1. 字典表，填入已有的学号和传感器名称
+CREATE TABLE IF NOT EXISTS sensor_dict (
+    dict_key SMALLINT UNSIGNED AUTO_INCREMENT PRIMARY KEY COMMENT '字典键',
+    kind TINYINT UNSIGNED NOT NULL COMMENT '类别（0学号，1传感器名称）',
+    name VARCHAR(20) NOT NULL COMMENT '名称',
+    UNIQUE KEY uk_kind_name (kind, name)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci COMMENT='学号和传感器名称字典';
+
+INSERT IGNORE INTO sensor_dict (kind, name)
+SELECT 0, student_id FROM sensor1_data
+UNION
+SELECT 0, student_id FROM sensor2_data;
+
+INSERT IGNORE INTO sensor_dict (kind, name)
+SELECT 1, sensor_name FROM sensor1_data
+UNION
+SELECT 1, sensor_name FROM sensor2_data;
+
+-- 2. v2数据表
+CREATE TABLE sensor1_data_v2 (
+    id INT AUTO_INCREMENT COMMENT '主键ID',
+    student_key SMALLINT UNSIGNED NOT NULL COMMENT '学号字典键',
+    sensor_key SMALLINT UNSIGNED NOT NULL COMMENT '传感器名称字典键',
+    temperature SMALLINT NOT NULL COMMENT '温度值（0.01摄氏度）',
+    humidity SMALLINT UNSIGNED NOT NULL COMMENT '湿度值（0.01%）',
+    status TINYINT UNSIGNED NOT NULL DEFAULT 0 COMMENT '传感器状态',
+    timestamp INT UNSIGNED NOT NULL COMMENT '时间戳',
+    created_at TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP COMMENT '记录创建时间',
+    PRIMARY KEY (id),
+    INDEX idx_student_row (student_key, id),
+    INDEX idx_timestamp (timestamp)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci COMMENT='传感器1数据表（温湿度传感器）';
+
+CREATE TABLE sensor2_data_v2 (
+    id INT AUTO_INCREMENT COMMENT '主键ID',
+    student_key SMALLINT UNSIGNED NOT NULL COMMENT '学号字典键',
+    sensor_key SMALLINT UNSIGNED NOT NULL COMMENT '传感器名称字典键',
+    interrupt_type TINYINT UNSIGNED NOT NULL COMMENT '中断类型',
+    interrupt_count INT UNSIGNED NOT NULL DEFAULT 1 COMMENT '中断次数（合并窗口内事件数）',
+    status TINYINT UNSIGNED NOT NULL DEFAULT 0 COMMENT '传感器状态',
+    first_timestamp INT UNSIGNED NOT NULL DEFAULT 0 COMMENT '合并窗口内首个事件时间戳',
+    timestamp INT UNSIGNED NOT NULL COMMENT '时间戳（合并窗口内最后一个事件）',
+    created_at TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP COMMENT '记录创建时间',
+    PRIMARY KEY (id),
+    INDEX idx_student_row (student_key, id),
+    INDEX idx_sensor_timestamp (sensor_key, timestamp),
+    INDEX idx_timestamp (timestamp)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci COMMENT='传感器2数据表（中断传感器）';
+
+-- 启用分区时转换为分区表（分区列必须包含在主键中），在复制数据前进行
+SET @partition_sql = IF(@enable_db_partition = 1,
+    'ALTER TABLE sensor1_data_v2 DROP PRIMARY KEY, ADD PRIMARY KEY (id, created_at)
+     PARTITION BY RANGE (UNIX_TIMESTAMP(created_at)) (PARTITION pmax VALUES LESS THAN MAXVALUE)',
+    'DO 0');
+PREPARE partition_stmt FROM @partition_sql;
+EXECUTE partition_stmt;
+DEALLOCATE PREPARE partition_stmt;
+
+SET @partition_sql = IF(@enable_db_partition = 1,
+    'ALTER TABLE sensor2_data_v2 DROP PRIMARY KEY, ADD PRIMARY KEY (id, created_at)
+     PARTITION BY RANGE (UNIX_TIMESTAMP(created_at)) (PARTITION pmax VALUES LESS THAN MAXVALUE)',
+    'DO 0');
+PREPARE partition_stmt FROM @partition_sql;
+EXECUTE partition_stmt;
+DEALLOCATE PREPARE partition_stmt;
+
+-- 3. 复制数据（保留id和created_at；未知的状态文本按NORMAL处理，与程序一致）
+INSERT INTO sensor1_data_v2 (id, student_key, sensor_key, temperature, humidity, status, timestamp, created_at)
+SELECT d.id, s.dict_key, n.dict_key,
+       ROUND(d.temperature * 100), ROUND(d.humidity * 100),
+       GREATEST(FIELD(d.status, 'NORMAL', 'WARNING', 'ERROR', 'OFFLINE') - 1, 0),
+       d.timestamp, COALESCE(d.created_at, CURRENT_TIMESTAMP)
+FROM sensor1_data d
+JOIN sensor_dict s ON s.kind = 0 AND s.name = d.student_id
+JOIN sensor_dict n ON n.kind = 1 AND n.name = d.sensor_name;
+
+INSERT INTO sensor2_data_v2 (id, student_key, sensor_key, interrupt_type, interrupt_count, status,
+                             first_timestamp, timestamp, created_at)
+SELECT d.id, s.dict_key, n.dict_key, d.interrupt_type, d.interrupt_count,
+       GREATEST(FIELD(d.status, 'NORMAL', 'WARNING', 'ERROR', 'OFFLINE') - 1, 0),
+       d.first_timestamp, d.timestamp, COALESCE(d.created_at, CURRENT_TIMESTAMP)
+FROM sensor2_data d
+JOIN sensor_dict s ON s.kind = 0 AND s.name = d.student_id
+JOIN sensor_dict n ON n.kind = 1 AND n.name = d.sensor_name;
+
+-- 4. 核对行数（两列应相等）
+SELECT (SELECT COUNT(*) FROM sensor1_data) AS v1_rows, (SELECT COUNT(*) FROM sensor1_data_v2) AS v2_rows;
+SELECT (SELECT COUNT(*) FROM sensor2_data) AS v1_rows, (SELECT COUNT(*) FROM sensor2_data_v2) AS v2_rows;
+
+-- 5. 互换表名（原子操作）
+RENAME TABLE sensor1_data TO sensor1_data_v1, sensor1_data_v2 TO sensor1_data,
+             sensor2_data TO sensor2_data_v1, sensor2_data_v2 TO sensor2_data;
+
+-- 6. 按v1的列查看数据的视图（与create_tables.sql相同）
+CREATE OR REPLACE VIEW sensor1_readings AS
+SELECT d.id, s.name AS student_id, n.name AS sensor_name,
+       d.temperature / 100 AS temperature, d.humidity / 100 AS humidity,
+       ELT(d.status + 1, 'NORMAL', 'WARNING', 'ERROR', 'OFFLINE') AS status,
+       d.timestamp, d.created_at
+FROM sensor1_data d
+JOIN sensor_dict s ON s.dict_key = d.student_key
+JOIN sensor_dict n ON n.dict_key = d.sensor_key;
+
+CREATE OR REPLACE VIEW sensor2_readings AS
+SELECT d.id, s.name AS student_id, n.name AS sensor_name,
+       d.interrupt_type, d.interrupt_count,
+       ELT(d.status + 1, 'NORMAL', 'WARNING', 'ERROR', 'OFFLINE') AS status,
+       d.first_timestamp, d.timestamp, d.created_at
+FROM sensor2_data d
+JOIN sensor_dict s ON s.dict_key = d.student_key
+JOIN sensor_dict n ON n.dict_key = d.sensor_key;
+
+-- 7. 核对无误、程序运行正常后删除原表
+-- DROP TABLE sensor1_data_v1, sensor2_data_v1;
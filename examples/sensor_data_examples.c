@@ -138,6 +138,7 @@ void example_database_operations(void)
         sensor2_data.interrupt_count = 1;
         sensor2_data.status = SENSOR_STATUS_NORMAL;
         sensor2_data.timestamp = get_timestamp();
+        sensor2_data.first_timestamp = sensor2_data.timestamp;
         
         // 插入数据
         result = database_insert_sensor1_data(&sensor1_data);
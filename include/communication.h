@@ -27,7 +27,8 @@ typedef enum {
     COMM_ERROR_FRAMING = 3,
     COMM_ERROR_PARITY = 4,
     COMM_ERROR_BUFFER_FULL = 5,
-    COMM_ERROR_INVALID_PARAM = 6
+    COMM_ERROR_INVALID_PARAM = 6,
+    COMM_ERROR_CRC = 7
 } comm_error_t;
 
 /* 通信配置结构 */
@@ -49,6 +50,9 @@ typedef struct {
     uint32_t packets_transmitted;           /* 发送包数 */
     uint32_t error_count;                   /* 错误计数 */
     uint32_t timeout_count;                 /* 超时计数 */
+    uint32_t frame_crc_ok_count;            /* CRC校验通过的帧数 */
+    uint32_t frame_crc_error_count;         /* CRC校验失败的帧数 */
+    uint32_t frame_unchecked_count;         /* 本端口未携带CRC的帧数 */  
 } comm_statistics_t;
 
 /* 数据包结构 */
@@ -109,6 +113,20 @@ system_status_t communication_receive(uint8_t* buffer, uint16_t buffer_size,
  */
 system_status_t communication_receive_line(char* buffer, uint16_t buffer_size, uint32_t timeout_ms);
 
+/**
+ * @brief 校验一帧数据的CRC32C后缀并去除后缀
+ * @param line 以'\0'结尾的帧（格式：负载*XXXXXXXX，XXXXXXXX为负载的CRC32C十六进制）
+ * @return system_status_t 校验通过或未携带CRC（且未强制要求）返回SYSTEM_OK
+ */
+system_status_t communication_verify_frame(char* line);
+
+/**
+ * @brief 附加CRC32C后缀并发送一帧数据
+ * @param payload 帧负载字符串
+ * @return system_status_t 发送状态
+ */
+system_status_t communication_send_frame(const char* payload);
+
 /**
  * @brief 检查是否有数据可读
  * @return bool 是否有数据
@@ -265,6 +283,17 @@ system_status_t communication_stop_dma_tx(void);
 #define COMM_MAX_PACKET_SIZE        256
 #define COMM_LINE_ENDING            "\r\n"
 
+/* 帧CRC定义 */
+#define COMM_FRAME_CRC_DELIMITER    '*'     /* 负载与CRC的分隔符 */
+#define COMM_FRAME_CRC_HEX_LEN      8       /* CRC32C十六进制位数 */
+#ifndef COMM_FRAME_CRC_REQUIRED
+#define COMM_FRAME_CRC_REQUIRED     0       /* 1: 拒绝未携带CRC的帧 */
+#endif
+#ifndef COMM_FRAME_UNCHECKED_LOG_EVERY
+#define COMM_FRAME_UNCHECKED_LOG_EVERY  100 /* 放行未带CRC的帧时，首帧及每N帧记录一次 */
+#endif
+#define COMM_PORT_NAME              "UART1" /* 本模块驱动的端口，用于日志 */
+
 /* 校验位定义 */
 #define COMM_PARITY_NONE            0
 #define COMM_PARITY_ODD             1
@@ -291,6 +320,7 @@ system_status_t communication_stop_dma_tx(void);
 #define COMM_ERROR_MSG_PARITY       "Parity error"
 #define COMM_ERROR_MSG_BUFFER_FULL  "Buffer full"
 #define COMM_ERROR_MSG_INVALID_PARAM "Invalid parameter"
+#define COMM_ERROR_MSG_CRC          "Frame CRC mismatch"
 
 /* 默认配置 */
 extern const comm_config_t DEFAULT_COMM_CONFIG;
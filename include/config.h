@@ -87,6 +87,7 @@
 #define DB_PASSWORD             "sensor_pass"
 #define DB_NAME                 "sensor_data"
 #define DB_TIMEOUT              30
+#define DB_SCHEMA_VERSION       2           /* 数据表结构版本（1为旧表，从1升级见database/migrate_v2.sql） */
 
 /* 系统状态定义 */
 typedef enum {
@@ -136,6 +137,7 @@ typedef enum {
     #define UART1_BASE              0x40013800UL
     #define GPIOA_BASE              0x40010800UL
     #define RCC_BASE                0x40021000UL
+    #define DEVICE_UID_BASE         0x1FFFF7E8UL    /* STM32F1的96位唯一ID（3个字） */
     
     #define REG32(addr)             (*(volatile uint32_t *)(addr))
     #define REG16(addr)             (*(volatile uint16_t *)(addr))
@@ -147,21 +149,32 @@ typedef enum {
     
     #define DISABLE_INTERRUPTS()    __disable_interrupt()
     #define ENABLE_INTERRUPTS()     __enable_interrupt()
+#elif defined(TEST_BUILD)
+    /* 宿主机测试构建（Makefile）：无HAL，中断开关为空操作 */
+    #define DISABLE_INTERRUPTS()    do { } while (0)
+    #define ENABLE_INTERRUPTS()     do { } while (0)
 #else
     /* 现代HAL库支持 */
     #include "stm32f1xx_hal.h"
+    #define DEVICE_UID_BASE         0x1FFFF7E8UL    /* STM32F1的96位唯一ID（3个字） */
     #define DISABLE_INTERRUPTS()    __disable_irq()
     #define ENABLE_INTERRUPTS()     __enable_irq()
 #endif
 
+/* 临界区 - 宿主机多线程构建可预先定义为互斥锁操作 */
+#ifndef ENTER_CRITICAL
+    #define ENTER_CRITICAL()        DISABLE_INTERRUPTS()
+    #define EXIT_CRITICAL()         ENABLE_INTERRUPTS()
+#endif
+
 /* 工具宏 */
 #define ARRAY_SIZE(arr)         (sizeof(arr) / sizeof((arr)[0]))
 #define MIN(a, b)               ((a) < (b) ? (a) : (b))
 #define MAX(a, b)               ((a) > (b) ? (a) : (b))
 #define CLAMP(val, min, max)    (MIN(MAX(val, min), max))
 
-/* 字符串处理宏 */
-#ifdef IAR_LEGACY_SUPPORT
+/* 字符串处理宏（宿主机C库通常没有strcpy_s，测试构建使用截断版本） */
+#if defined(IAR_LEGACY_SUPPORT) || defined(TEST_BUILD)
     #define SAFE_STRCPY(dst, src, size) do { \
         strncpy(dst, src, size - 1); \
         dst[size - 1] = '\0'; \
@@ -195,11 +208,66 @@ typedef enum {
 #define ERROR_MEMORY            0x07
 #define ERROR_HARDWARE          0x08
 
-/* 功能开关 */
+/* 功能开关
+ * 各开关可在编译选项中重定义（-DENABLE_xxx=1）。注释中是32位目标上该模块的
+ * 静态RAM（按各头文件中的默认深度估算）；目标板STM32F103CB共20KB RAM，核心
+ * 部分（database、main、communication等）约9KB，默认配置合计约17KB，其余
+ * 留给栈。默认只启用写入路径必需的模块，其余按需在网关等RAM充足的构建中
+ * 打开。关闭的模块整个文件不参与编译（XLINK总是链接全部目标文件）。 */
+#ifndef ENABLE_WATCHDOG
 #define ENABLE_WATCHDOG         1
+#endif
+#ifndef ENABLE_DEBUG_OUTPUT
 #define ENABLE_DEBUG_OUTPUT     1
+#endif
+#ifndef ENABLE_ERROR_RECOVERY
 #define ENABLE_ERROR_RECOVERY   1
+#endif
+#ifndef ENABLE_DATA_VALIDATION
 #define ENABLE_DATA_VALIDATION  1
+#endif
+#ifndef ENABLE_SENSOR_AGGREGATE
+#define ENABLE_SENSOR_AGGREGATE 0       /* 滑动窗口统计，约7.2KB */
+#endif
+#ifndef ENABLE_SENSOR_FILTER
+#define ENABLE_SENSOR_FILTER    1       /* 死区过滤，约1.3KB */
+#endif
+#ifndef ENABLE_SENSOR_COALESCE
+#define ENABLE_SENSOR_COALESCE  0       /* 中断事件合并，约1.7KB */
+#endif
+#ifndef ENABLE_SENSOR_ANOMALY
+#define ENABLE_SENSOR_ANOMALY   0       /* 异常检测，约5.6KB */
+#endif
+#ifndef ENABLE_SENSOR_DISPATCH
+#define ENABLE_SENSOR_DISPATCH  0       /* 异步回调分发，约2.2KB */
+#endif
+#ifndef ENABLE_DB_BATCH
+#define ENABLE_DB_BATCH         1       /* 多行INSERT，约3.3KB（DB_BATCH_MAX_ROWS=8） */
+#endif
+#ifndef ENABLE_DB_WRITER
+#define ENABLE_DB_WRITER        1       /* 写入队列，约1.1KB（DB_WRITER_MAX_DEPTH=16） */
+#endif
+#ifndef ENABLE_DB_WAL
+#define ENABLE_DB_WAL           1       /* 断线日志，约0.3KB */
+#endif
+#ifndef ENABLE_DB_CONN
+#define ENABLE_DB_CONN          1       /* 连接管理，约0.3KB */
+#endif
+#ifndef ENABLE_DB_CACHE
+#define ENABLE_DB_CACHE         0       /* 最新行缓存，约7.8KB */
+#endif
+#ifndef ENABLE_DB_PARTITION
+#define ENABLE_DB_PARTITION     1       /* 分区维护，约1.3KB（同时决定建表语句是否分区） */
+#endif
+#ifndef ENABLE_DB_ROLLUP
+#define ENABLE_DB_ROLLUP        0       /* 汇总表，约3.1KB */
+#endif
+#ifndef ENABLE_DB_BACKUP
+#define ENABLE_DB_BACKUP        0       /* 在线备份，约4.2KB */
+#endif
+#ifndef ENABLE_DB_BULK
+#define ENABLE_DB_BULK          0       /* 批量装载，约0.3KB（需要文件系统） */
+#endif
 
 /* 性能配置 */
 #define MAX_PROCESSING_TIME_MS  100
@@ -0,0 +1,91 @@
+/**
+ * @file crc.h
+ * @brief CRC校验模块头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * CRC32C（Castagnoli，多项式0x1EDC6F41）与CRC16-CCITT（多项式0x1021，
+ * 初值0xFFFF）。CRC32C按平台选择实现：
+ * - x86宿主机：运行时检测SSE4.2，使用crc32指令
+ * - 其他宿主机：查表slice-by-8（表在crc_init()中生成）
+ * - Cortex-M3等嵌入式目标：单表按字（32位）处理，表位于Flash
+ */
+
+#ifndef CRC_H
+#define CRC_H
+
+#include "config.h"
+
+/* 函数声明 */
+
+/**
+ * @brief 初始化CRC模块（生成slice-by-8表并检测硬件指令）
+ * @return system_status_t 初始化状态
+ */
+system_status_t crc_init(void);
+
+/**
+ * @brief 计算CRC32C
+ * @param data 数据指针
+ * @param length 数据长度
+ * @return uint32_t CRC值
+ */
+uint32_t crc32c(const uint8_t* data, size_t length);
+
+/**
+ * @brief 增量计算CRC32C
+ * @param crc 之前数据的CRC值（首段传0）
+ * @param data 数据指针
+ * @param length 数据长度
+ * @return uint32_t 包含本段数据的CRC值
+ */
+uint32_t crc32c_update(uint32_t crc, const uint8_t* data, size_t length);
+
+/**
+ * @brief 计算CRC16-CCITT
+ * @param data 数据指针
+ * @param length 数据长度
+ * @return uint16_t CRC值
+ */
+uint16_t crc16_ccitt(const uint8_t* data, size_t length);
+
+/**
+ * @brief 增量计算CRC16-CCITT
+ * @param crc 之前数据的CRC值（首段传CRC16_CCITT_INIT）
+ * @param data 数据指针
+ * @param length 数据长度
+ * @return uint16_t 包含本段数据的CRC值
+ */
+uint16_t crc16_ccitt_update(uint16_t crc, const uint8_t* data, size_t length);
+
+/**
+ * @brief 自检：核对两种CRC的校验值，并用逐字节查表核对已编译的每条CRC32C路径
+ * @return system_status_t 全部一致返回SYSTEM_OK
+ */
+system_status_t crc_self_test(void);
+
+/**
+ * @brief 获取当前使用的CRC32C实现名称
+ * @return const char* 实现名称
+ */
+const char* crc32c_get_implementation(void);
+
+/* 常量定义 */
+#define CRC16_CCITT_INIT        0xFFFF
+#define CRC32C_CHECK_VALUE      0xE3069283UL    /* "123456789"的CRC32C */
+#define CRC16_CCITT_CHECK_VALUE 0x29B1          /* "123456789"的CRC16-CCITT */
+
+/* 实现选择（可在编译时定义CRC32C_WORD_AT_A_TIME指定按字实现，用于宿主机测试） */
+#if defined(CRC32C_WORD_AT_A_TIME)
+    /* 已指定 */
+#elif defined(__ICCARM__) || defined(__arm__) || defined(__thumb__)
+    #define CRC32C_WORD_AT_A_TIME   1
+#else
+    #define CRC32C_SLICE_BY_8       1
+    #if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+        #define CRC32C_HW_SSE42     1
+    #endif
+#endif
+
+#endif /* CRC_H */
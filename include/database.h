@@ -11,6 +11,7 @@
 
 #include "config.h"
 #include "sensor_data.h"
+#include "strbuf.h"
 
 /* 数据库连接状态 */
 typedef enum {
@@ -43,10 +44,90 @@ typedef struct {
 typedef struct {
     uint32_t row_count;                 /* 行数 */
     uint32_t column_count;              /* 列数 */
-    char** data;                        /* 数据指针 */
-    char** column_names;                /* 列名 */
+    char** data;                        /* 保留，始终为NULL（列值通过游标或db_rowset读取） */
+    char** column_names;                /* 保留，始终为NULL */
 } db_query_result_t;
 
+/* 预编译语句参数个数上限（不超过16，见bound_mask） */
+#ifndef DB_STMT_MAX_PARAMS
+#define DB_STMT_MAX_PARAMS      10
+#endif
+
+/* 语句参数类型（按二进制协议传输，不经过文本转义） */
+typedef enum {
+    DB_PARAM_NULL = 0,
+    DB_PARAM_INT = 1,                   /* 有符号32位整数 */
+    DB_PARAM_UINT = 2,                  /* 无符号32位整数 */
+    DB_PARAM_REAL = 3,                  /* 双精度浮点数（汇总表的累计值需要双精度） */
+    DB_PARAM_TEXT = 4                   /* 字符串（指针+长度，不复制） */
+} db_param_type_t;
+
+/* 绑定的参数值 */
+typedef struct {
+    db_param_type_t type;               /* 参数类型 */
+    union {
+        int32_t i;
+        uint32_t u;
+        double f;
+        struct {
+            const char* ptr;            /* 执行前必须保持有效 */
+            uint16_t length;
+        } text;
+    } value;
+} db_param_t;
+
+/* 预编译语句编号 */
+typedef enum {
+    DB_STMT_INSERT_SENSOR1 = 0,
+    DB_STMT_INSERT_SENSOR2,
+    DB_STMT_SELECT_SENSOR1_ALL,
+    DB_STMT_SELECT_SENSOR1_BY_ID,
+    DB_STMT_SELECT_SENSOR2_ALL,
+    DB_STMT_SELECT_SENSOR2_BY_ID,
+    DB_STMT_COUNT_SENSOR1,
+    DB_STMT_COUNT_SENSOR2,
+    DB_STMT_TABLE_EXISTS,
+    DB_STMT_CLEANUP_SENSOR1,
+    DB_STMT_CLEANUP_SENSOR2,
+    DB_STMT_SCAN_SENSOR1,
+    DB_STMT_SCAN_SENSOR1_BY_ID,
+    DB_STMT_SCAN_SENSOR2,
+    DB_STMT_SCAN_SENSOR2_BY_ID,
+    DB_STMT_LIST_PARTITIONS,
+    DB_STMT_CURRENT_DAY,
+    DB_STMT_CURRENT_TIME,
+    DB_STMT_ROLLUP_UPSERT_MINUTE,       /* 汇总语句按分钟、小时、天排列 */
+    DB_STMT_ROLLUP_UPSERT_HOUR,
+    DB_STMT_ROLLUP_UPSERT_DAY,
+    DB_STMT_ROLLUP_QUERY_MINUTE,
+    DB_STMT_ROLLUP_QUERY_HOUR,
+    DB_STMT_ROLLUP_QUERY_DAY,
+    DB_STMT_DICT_LOOKUP,
+    DB_STMT_DICT_INSERT,
+    DB_STMT_BACKUP_SENSOR1,
+    DB_STMT_BACKUP_SENSOR2,
+    DB_STMT_WARNING_COUNT,
+    DB_STMT_COUNT                       /* 语句数量（也用作临时语句编号） */
+} db_stmt_id_t;
+
+/* 预编译语句（每个连接准备一次，之后只绑定参数并执行） */
+typedef struct {
+    db_stmt_id_t id;                    /* 语句编号 */
+    const char* sql;                    /* 带?占位符的语句模板 */
+    uint8_t param_count;                /* 占位符个数 */
+    uint16_t bound_mask;                /* 已绑定参数位图 */
+    bool prepared;                      /* 是否已在当前连接上准备 */
+    db_param_t params[DB_STMT_MAX_PARAMS];  /* 参数值 */
+    void* handle;                       /* 驱动私有语句句柄 */
+} db_stmt_t;
+
+/* 查询游标（逐行读取，不复制结果集） */
+typedef struct {
+    db_stmt_t* stmt;                    /* 所属语句 */
+    uint32_t row_index;                 /* 已取出的行数 */
+    bool open;                          /* 是否处于打开状态 */
+} db_cursor_t;
+
 /* 函数声明 */
 
 /**
@@ -74,6 +155,12 @@ db_result_t database_disconnect(void);
  */
 db_status_t database_get_status(void);
 
+/**
+ * @brief 检查连接是否可用（执行一条最简查询，不经过语句缓存）
+ * @return db_result_t 检查结果
+ */
+db_result_t database_ping(void);
+
 /**
  * @brief 插入传感器1数据到数据库
  * @param data 传感器1数据
@@ -96,7 +183,58 @@ db_result_t database_insert_sensor2_data(const sensor2_data_t* data);
 db_result_t database_insert_sensor_data(const sensor_data_t* data);
 
 /**
- * @brief 查询传感器1数据
+ * @brief 检查一行传感器数据能否写入（数据范围和字符检查）
+ * @param data 传感器数据
+ * @return db_result_t 检查结果
+ */
+db_result_t database_check_sensor_row(const sensor_data_t* data);
+
+/**
+ * @brief 解析一行数据引用的字典键（v2表结构，新名称写入字典表；v1直接返回成功）
+ * @param data 传感器数据（需已通过database_check_sensor_row）
+ * @return db_result_t 操作结果
+ */
+db_result_t database_resolve_sensor_row(const sensor_data_t* data);
+
+/**
+ * @brief 追加一行传感器数据的VALUES元组"(...)"
+ * @param sb SQL构建器
+ * @param data 传感器数据（需已通过database_check_sensor_row和database_resolve_sensor_row）
+ * @return bool 是否完整追加（空间不足返回false，调用方负责回退）
+ */
+bool database_append_sensor_values(strbuf_t* sb, const sensor_data_t* data);
+
+/**
+ * @brief 执行多行INSERT语句
+ * @param sql 以SQL_INSERT_SENSOR1/2开头、含row_count个元组的语句
+ * @param row_count 语句中的行数
+ * @return db_result_t 执行结果，成功时affected_rows为插入行数
+ */
+db_result_t database_execute_insert(const char* sql, uint32_t row_count);
+
+/**
+ * @brief 追加一行传感器数据的批量装载行（SQL_BULK_*文本格式，以换行结束）
+ * @param sb 行缓冲区
+ * @param data 传感器数据（需已通过database_check_sensor_row和database_resolve_sensor_row）
+ * @return bool 是否完整追加（空间不足返回false，调用方负责回退）
+ */
+bool database_append_sensor_line(strbuf_t* sb, const sensor_data_t* data);
+
+/**
+ * @brief 用一条批量装载语句把暂存文件装入数据表（全部装入或全部失败）
+ * @param table 表序号（DB_TABLE_*）
+ * @param path 暂存文件路径，每行由database_append_sensor_line生成
+ * @param row_count 文件中的行数
+ * @param defer_indexes 装载期间推迟二级索引维护（装入的行相对表中已有的行较多时更快）；
+ *        只有能在事务中删除并重建索引的驱动（SQLite）使用，LOAD DATA忽略
+ * @return db_result_t 执行结果，成功时affected_rows为装入的行数；装入的行数与row_count
+ *         不同或产生警告（被跳过或转换的行）时失败，调用方应回滚
+ */
+db_result_t database_bulk_load(uint8_t table, const char* path, uint32_t row_count, bool defer_indexes);
+
+/**
+ * @brief 查询传感器1数据（ENABLE_DB_CACHE时按学号查询最新不超过DB_CACHE_DEPTH
+ *        条的请求经过最新数据缓存）
  * @param student_id 学号（可为NULL查询所有）
  * @param limit 限制返回行数（0表示无限制）
  * @return db_query_result_t 查询结果
@@ -104,13 +242,140 @@ db_result_t database_insert_sensor_data(const sensor_data_t* data);
 db_query_result_t database_query_sensor1_data(const char* student_id, uint32_t limit);
 
 /**
- * @brief 查询传感器2数据
+ * @brief 查询传感器2数据（ENABLE_DB_CACHE时按学号查询最新不超过DB_CACHE_DEPTH
+ *        条的请求经过最新数据缓存）
  * @param student_id 学号（可为NULL查询所有）
  * @param limit 限制返回行数（0表示无限制）
  * @return db_query_result_t 查询结果
  */
 db_query_result_t database_query_sensor2_data(const char* student_id, uint32_t limit);
 
+/**
+ * @brief 获取在当前连接上已准备好的语句（首次使用时准备），并清除上次的绑定
+ * @param id 语句编号
+ * @return db_stmt_t* 语句指针，未连接或准备失败返回NULL
+ */
+db_stmt_t* database_prepare(db_stmt_id_t id);
+
+/**
+ * @brief 绑定有符号整数参数
+ * @param stmt 语句
+ * @param index 参数序号（从0开始，对应第index+1个?）
+ * @param value 参数值
+ * @return system_status_t 绑定状态
+ */
+system_status_t db_stmt_bind_int(db_stmt_t* stmt, uint8_t index, int32_t value);
+
+/**
+ * @brief 绑定无符号整数参数
+ * @param stmt 语句
+ * @param index 参数序号（从0开始）
+ * @param value 参数值
+ * @return system_status_t 绑定状态
+ */
+system_status_t db_stmt_bind_uint(db_stmt_t* stmt, uint8_t index, uint32_t value);
+
+/**
+ * @brief 绑定浮点数参数
+ * @param stmt 语句
+ * @param index 参数序号（从0开始）
+ * @param value 参数值
+ * @return system_status_t 绑定状态
+ */
+system_status_t db_stmt_bind_real(db_stmt_t* stmt, uint8_t index, double value);
+
+/**
+ * @brief 绑定字符串参数（只保存指针，执行前字符串必须保持有效）
+ * @param stmt 语句
+ * @param index 参数序号（从0开始）
+ * @param value 字符串（NULL绑定为SQL NULL）
+ * @return system_status_t 绑定状态
+ */
+system_status_t db_stmt_bind_text(db_stmt_t* stmt, uint8_t index, const char* value);
+
+/**
+ * @brief 执行已绑定全部参数的写语句
+ * @param stmt 语句
+ * @return db_result_t 执行结果
+ */
+db_result_t db_stmt_execute(db_stmt_t* stmt);
+
+/**
+ * @brief 执行已绑定全部参数的查询语句并统计结果行数
+ * @param stmt 语句
+ * @return db_query_result_t 查询结果（只填写行数和列数）
+ */
+db_query_result_t db_stmt_query(db_stmt_t* stmt);
+
+/**
+ * @brief 在已绑定全部参数的查询语句上打开游标
+ * @param stmt 语句
+ * @param cursor 游标输出
+ * @return db_result_t 操作结果
+ */
+db_result_t db_stmt_open_cursor(db_stmt_t* stmt, db_cursor_t* cursor);
+
+/**
+ * @brief 移动到下一行
+ * @param cursor 游标
+ * @return bool 是否取到一行（结束或出错返回false，出错时设置最后错误信息）
+ */
+bool db_cursor_next(db_cursor_t* cursor);
+
+/**
+ * @brief 读取当前行的整数列
+ * @param cursor 游标
+ * @param column 列序号（从0开始）
+ * @return int32_t 列值
+ */
+int32_t db_cursor_get_int(const db_cursor_t* cursor, uint8_t column);
+
+/**
+ * @brief 读取当前行的无符号整数列
+ * @param cursor 游标
+ * @param column 列序号（从0开始）
+ * @return uint32_t 列值
+ */
+uint32_t db_cursor_get_uint(const db_cursor_t* cursor, uint8_t column);
+
+/**
+ * @brief 读取当前行的浮点数列
+ * @param cursor 游标
+ * @param column 列序号（从0开始）
+ * @return double 列值
+ */
+double db_cursor_get_real(const db_cursor_t* cursor, uint8_t column);
+
+/**
+ * @brief 读取当前行的文本列（下一次db_cursor_next前有效）
+ * @param cursor 游标
+ * @param column 列序号（从0开始）
+ * @return const char* 列值（NULL值返回空字符串）
+ */
+const char* db_cursor_get_text(const db_cursor_t* cursor, uint8_t column);
+
+/**
+ * @brief 把游标当前行（SELECT *的列顺序）转换为传感器数据
+ * @param cursor 游标
+ * @param type 数据类型（游标所查询的表）
+ * @param data 输出的传感器数据
+ * @return uint32_t 该行的自增主键
+ */
+uint32_t db_cursor_get_sensor_data(const db_cursor_t* cursor, sensor_type_t type, sensor_data_t* data);
+
+/**
+ * @brief 关闭游标（语句可再次绑定使用）
+ * @param cursor 游标
+ */
+void db_cursor_close(db_cursor_t* cursor);
+
+/**
+ * @brief 获取预编译语句统计信息
+ * @param prepare_count 准备次数（每个连接每条语句一次）
+ * @param execute_count 执行次数
+ */
+void database_get_stmt_statistics(uint32_t* prepare_count, uint32_t* execute_count);
+
 /**
  * @brief 执行自定义SQL查询
  * @param sql SQL语句
@@ -125,6 +390,14 @@ db_query_result_t database_execute_query(const char* sql);
  */
 db_result_t database_execute_update(const char* sql);
 
+/**
+ * @brief 执行自定义SQL查询并读取第一行第一列的整数值
+ * @param sql SQL语句（不带参数）
+ * @param value 输出值（没有结果行时为0）
+ * @return db_result_t 执行结果，affected_rows为结果行数是否大于0
+ */
+db_result_t database_query_uint(const char* sql, uint32_t* value);
+
 /**
  * @brief 释放查询结果内存
  * @param result 查询结果指针
@@ -163,13 +436,19 @@ bool database_table_exists(const char* table_name);
 db_result_t database_create_tables(void);
 
 /**
- * @brief 获取数据库统计信息
+ * @brief 获取数据库统计信息（连接后首次调用时全表计数，之后返回随写入和清理维护的行数）
  * @param sensor1_count 传感器1数据条数
  * @param sensor2_count 传感器2数据条数
  * @return db_result_t 操作结果
  */
 db_result_t database_get_statistics(uint32_t* sensor1_count, uint32_t* sensor2_count);
 
+/**
+ * @brief 重新全表计数，校正维护的行数（外部写入或删除会使计数偏离，低频调用）
+ * @return db_result_t 操作结果，affected_rows为校正的偏差行数；事务进行中返回失败
+ */
+db_result_t database_reconcile_statistics(void);
+
 /**
  * @brief 清理过期数据
  * @param days_old 保留天数
@@ -178,16 +457,31 @@ db_result_t database_get_statistics(uint32_t* sensor1_count, uint32_t* sensor2_c
 db_result_t database_cleanup_old_data(uint32_t days_old);
 
 /**
- * @brief 备份数据库
+ * @brief 清理一张表的过期数据（逐行删除）
+ * @param table 表序号（DB_TABLE_*）
+ * @param days_old 保留天数
+ * @return db_result_t 清理结果，affected_rows为删除的行数
+ */
+db_result_t database_cleanup_table(uint8_t table, uint32_t days_old);
+
+/**
+ * @brief 记录通过其他途径（如删除分区）增减的表行数
+ * @param table 表序号（DB_TABLE_*）
+ * @param delta 增减的行数
+ */
+void database_adjust_row_count(uint8_t table, int32_t delta);
+
+/**
+ * @brief 全量备份数据库（同步完成，见db_backup.h）
  * @param backup_path 备份文件路径
- * @return db_result_t 备份结果
+ * @return db_result_t 备份结果，affected_rows为导出的行数
  */
 db_result_t database_backup(const char* backup_path);
 
 /**
- * @brief 恢复数据库
+ * @brief 从备份文件恢复数据库（见db_backup.h）
  * @param backup_path 备份文件路径
- * @return db_result_t 恢复结果
+ * @return db_result_t 恢复结果，affected_rows为写入的行数
  */
 db_result_t database_restore(const char* backup_path);
 
@@ -203,6 +497,12 @@ void database_set_error_callback(void (*callback)(const char* error_msg));
  */
 const char* database_get_last_error(void);
 
+/**
+ * @brief 获取最后一次错误码（错误回调中可用来区分连接错误和数据错误）
+ * @return int 错误码（DB_ERROR_*）
+ */
+int database_get_last_error_code(void);
+
 /* 内联函数 - IAR 5.3兼容 */
 #ifdef IAR_LEGACY_SUPPORT
     #pragma inline
@@ -233,26 +533,241 @@ const char* database_get_last_error(void);
 #define DB_RETRY_COUNT          3           /* 数据库重试次数 */
 #define DB_RETRY_DELAY_MS       1000        /* 重试延迟时间 */
 
-/* SQL语句模板 */
+/* SQL语句片段（由strbuf顺序拼接，值部分见database.c） */
+#if DB_SCHEMA_VERSION >= 2
+/* v2表结构：学号和传感器名称保存在字典表sensor_dict中，数据行只保存字典键；
+ * 温湿度为0.01单位的SMALLINT，状态为sensor_status_t。查询通过JOIN还原出与v1
+ * SELECT *相同的列顺序（见DB_SENSOR*_COL_*），温湿度换算回小数 */
+#define SQL_SENSOR1_COLUMNS \
+    "(student_key, sensor_key, temperature, humidity, status, timestamp)"
+
+#define SQL_SENSOR2_COLUMNS \
+    "(student_key, sensor_key, interrupt_type, interrupt_count, status, first_timestamp, timestamp)"
+
 #define SQL_INSERT_SENSOR1 \
-    "INSERT INTO sensor1_data (student_id, sensor_name, temperature, humidity, status, timestamp) " \
-    "VALUES ('%s', '%s', %.2f, %.2f, '%s', %lu)"
+    "INSERT INTO sensor1_data " SQL_SENSOR1_COLUMNS " VALUES "
 
 #define SQL_INSERT_SENSOR2 \
-    "INSERT INTO sensor2_data (student_id, sensor_name, interrupt_type, interrupt_count, status, timestamp) " \
-    "VALUES ('%s', '%s', %d, %lu, '%s', %lu)"
+    "INSERT INTO sensor2_data " SQL_SENSOR2_COLUMNS " VALUES "
+
+#define SQL_FROM_SENSOR1 \
+    "SELECT d.id, s.name, n.name, d.temperature * 0.01, d.humidity * 0.01, d.status, d.timestamp " \
+    "FROM sensor1_data d JOIN sensor_dict s ON s.dict_key = d.student_key " \
+    "JOIN sensor_dict n ON n.dict_key = d.sensor_key"
+
+#define SQL_FROM_SENSOR2 \
+    "SELECT d.id, s.name, n.name, d.interrupt_type, d.interrupt_count, d.status, " \
+    "d.first_timestamp, d.timestamp " \
+    "FROM sensor2_data d JOIN sensor_dict s ON s.dict_key = d.student_key " \
+    "JOIN sensor_dict n ON n.dict_key = d.sensor_key"
+
+/* 按唯一键(kind, name)定位学号，数据表按(student_key, id)索引范围扫描。
+ * 最新数据按id排序：timestamp是设备的节拍计数，每次启动从头开始，不能比较先后 */
+#define SQL_WHERE_STUDENT \
+    " WHERE s.kind = 0 AND s.name = "
+
+#define SQL_ORDER_BY_LATEST \
+    " ORDER BY id DESC"
+#else
+#define SQL_SENSOR1_COLUMNS \
+    "(student_id, sensor_name, temperature, humidity, status, timestamp)"
+
+#define SQL_SENSOR2_COLUMNS \
+    "(student_id, sensor_name, interrupt_type, interrupt_count, status, first_timestamp, timestamp)"
+
+#define SQL_INSERT_SENSOR1 \
+    "INSERT INTO sensor1_data " SQL_SENSOR1_COLUMNS " VALUES "
+
+#define SQL_INSERT_SENSOR2 \
+    "INSERT INTO sensor2_data " SQL_SENSOR2_COLUMNS " VALUES "
+
+#define SQL_FROM_SENSOR1 \
+    "SELECT * FROM sensor1_data"
+
+#define SQL_FROM_SENSOR2 \
+    "SELECT * FROM sensor2_data"
+
+#define SQL_WHERE_STUDENT \
+    " WHERE student_id = "
+
+#define SQL_ORDER_BY_LATEST \
+    " ORDER BY created_at DESC, id DESC"
+#endif
 
 #define SQL_SELECT_SENSOR1_ALL \
-    "SELECT * FROM sensor1_data ORDER BY created_at DESC"
+    SQL_FROM_SENSOR1 SQL_ORDER_BY_LATEST
 
 #define SQL_SELECT_SENSOR1_BY_ID \
-    "SELECT * FROM sensor1_data WHERE student_id = '%s' ORDER BY created_at DESC"
+    SQL_FROM_SENSOR1 SQL_WHERE_STUDENT
 
 #define SQL_SELECT_SENSOR2_ALL \
-    "SELECT * FROM sensor2_data ORDER BY created_at DESC"
+    SQL_FROM_SENSOR2 SQL_ORDER_BY_LATEST
 
 #define SQL_SELECT_SENSOR2_BY_ID \
-    "SELECT * FROM sensor2_data WHERE student_id = '%s' ORDER BY created_at DESC"
+    SQL_FROM_SENSOR2 SQL_WHERE_STUDENT
+
+/* 预编译语句模板（?为参数占位符，LIMIT总是绑定，0表示无限制时绑定最大值） */
+#define SQL_STMT_INSERT_SENSOR1 \
+    SQL_INSERT_SENSOR1 "(?, ?, ?, ?, ?, ?)"
+
+#define SQL_STMT_INSERT_SENSOR2 \
+    SQL_INSERT_SENSOR2 "(?, ?, ?, ?, ?, ?, ?)"
+
+#define SQL_STMT_SELECT_SENSOR1_ALL \
+    SQL_SELECT_SENSOR1_ALL " LIMIT ?"
+
+#define SQL_STMT_SELECT_SENSOR1_BY_ID \
+    SQL_SELECT_SENSOR1_BY_ID "?" SQL_ORDER_BY_LATEST " LIMIT ?"
+
+#define SQL_STMT_SELECT_SENSOR2_ALL \
+    SQL_SELECT_SENSOR2_ALL " LIMIT ?"
+
+#define SQL_STMT_SELECT_SENSOR2_BY_ID \
+    SQL_SELECT_SENSOR2_BY_ID "?" SQL_ORDER_BY_LATEST " LIMIT ?"
+
+#define SQL_STMT_TABLE_EXISTS \
+    "SHOW TABLES LIKE ?"
+
+#define SQL_STMT_CLEANUP_SENSOR1 \
+    "DELETE FROM sensor1_data WHERE created_at < DATE_SUB(NOW(), INTERVAL ? DAY)"
+
+#define SQL_STMT_CLEANUP_SENSOR2 \
+    "DELETE FROM sensor2_data WHERE created_at < DATE_SUB(NOW(), INTERVAL ? DAY)"
+
+/* 键集续读：从上一批最后一行的id之后按主键顺序取下一批，不使用OFFSET。
+ * 全部读取走主键范围扫描，按学号读取走idx_student_row (student_key, id)；
+ * timestamp是每次启动从头计数的解析序号，不能作为续读位置 */
+#define SQL_SCAN_AFTER_KEY \
+    "id > ? ORDER BY id LIMIT ?"
+
+#define SQL_STMT_SCAN_SENSOR1 \
+    SQL_FROM_SENSOR1 " WHERE " SQL_SCAN_AFTER_KEY
+
+#define SQL_STMT_SCAN_SENSOR1_BY_ID \
+    SQL_SELECT_SENSOR1_BY_ID "? AND " SQL_SCAN_AFTER_KEY
+
+#define SQL_STMT_SCAN_SENSOR2 \
+    SQL_FROM_SENSOR2 " WHERE " SQL_SCAN_AFTER_KEY
+
+#define SQL_STMT_SCAN_SENSOR2_BY_ID \
+    SQL_SELECT_SENSOR2_BY_ID "? AND " SQL_SCAN_AFTER_KEY
+
+/* 表的分区名（未分区的表没有行），按分区顺序 */
+#define SQL_STMT_LIST_PARTITIONS \
+    "SELECT PARTITION_NAME FROM information_schema.PARTITIONS " \
+    "WHERE TABLE_SCHEMA = DATABASE() AND TABLE_NAME = ? AND PARTITION_NAME IS NOT NULL " \
+    "ORDER BY PARTITION_ORDINAL_POSITION"
+
+/* 数据库服务器的当前日期（从0000-01-01起的天数） */
+#define SQL_STMT_CURRENT_DAY \
+    "SELECT TO_DAYS(CURDATE())"
+
+/* 数据库服务器的当前时间（UNIX秒，汇总表的时间桶） */
+#define SQL_STMT_CURRENT_TIME \
+    "SELECT UNIX_TIMESTAMP()"
+
+/* 汇总表：每个(时间桶, 数据类型, 学号, 传感器, 状态)一行，status为sensor_status_t。
+ * sum_a/sum_b在传感器1表中为温度、湿度之和，在传感器2表中为中断次数之和和0 */
+#define SQL_ROLLUP_MINUTE           "sensor_rollup_minute"
+#define SQL_ROLLUP_HOUR             "sensor_rollup_hour"
+#define SQL_ROLLUP_DAY              "sensor_rollup_day"
+
+#define SQL_CREATE_ROLLUP_TABLE(table) \
+    "CREATE TABLE IF NOT EXISTS " table " (" \
+    "bucket INT UNSIGNED NOT NULL, " \
+    "sensor_type TINYINT UNSIGNED NOT NULL, " \
+    "student_id VARCHAR(20) NOT NULL, " \
+    "sensor_name VARCHAR(16) NOT NULL, " \
+    "status TINYINT UNSIGNED NOT NULL, " \
+    "row_count INT UNSIGNED NOT NULL, " \
+    "sum_a DOUBLE NOT NULL, " \
+    "sum_b DOUBLE NOT NULL, " \
+    "last_timestamp INT UNSIGNED NOT NULL, " \
+    "PRIMARY KEY (bucket, sensor_type, student_id, sensor_name, status)" \
+    ")"
+
+/* 把一个键在一批中的合计累加到汇总表 */
+#define SQL_ROLLUP_INSERT(table) \
+    "INSERT INTO " table " (bucket, sensor_type, student_id, sensor_name, status, " \
+    "row_count, sum_a, sum_b, last_timestamp) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)"
+
+#define SQL_STMT_ROLLUP_UPSERT(table) \
+    SQL_ROLLUP_INSERT(table) " ON DUPLICATE KEY UPDATE " \
+    "row_count = row_count + VALUES(row_count), " \
+    "sum_a = sum_a + VALUES(sum_a), " \
+    "sum_b = sum_b + VALUES(sum_b), " \
+    "last_timestamp = GREATEST(last_timestamp, VALUES(last_timestamp))"
+
+/* 时间桶范围内按状态合计（学号参数为空串时不按学号过滤） */
+#define SQL_STMT_ROLLUP_QUERY(table) \
+    "SELECT status, SUM(row_count), SUM(sum_a), SUM(sum_b), MAX(last_timestamp) FROM " table \
+    " WHERE bucket >= ? AND bucket < ? AND sensor_type = ? AND (? = '' OR student_id = ?)" \
+    " GROUP BY status"
+
+/* 字典：按(kind, name)查找或新增字典键（并发新增同一名称时忽略重复） */
+#define SQL_STMT_DICT_LOOKUP \
+    "SELECT dict_key FROM sensor_dict WHERE kind = ? AND name = ?"
+
+#define SQL_STMT_DICT_INSERT \
+    "INSERT IGNORE INTO sensor_dict (kind, name) VALUES (?, ?)"
+
+/* 备份：按主键顺序读取(上次位置, 快照上界]内的行，只做主键范围扫描，不加锁 */
+#define SQL_BACKUP_ID_RANGE \
+    " WHERE id > ? AND id <= ? ORDER BY id LIMIT ?"
+
+#define SQL_STMT_BACKUP_SENSOR1 \
+    SQL_FROM_SENSOR1 SQL_BACKUP_ID_RANGE
+
+#define SQL_STMT_BACKUP_SENSOR2 \
+    SQL_FROM_SENSOR2 SQL_BACKUP_ID_RANGE
+
+/* 上一条语句产生的警告数（LOAD DATA LOCAL把无法转换的值和重复键降级为警告） */
+#define SQL_STMT_WARNING_COUNT \
+    "SELECT @@warning_count"
+
+#define SQL_STMT_NO_LIMIT           0xFFFFFFFFUL    /* limit为0时绑定的值 */
+
+/* 批量装载：LOAD DATA默认的文本格式（制表符分隔字段、反斜杠转义、换行结束一行），
+ * 列顺序与SQL_INSERT_SENSOR*相同；路径拼接在前缀之后，不能含单引号 */
+#define SQL_BULK_FIELD_SEPARATOR    '\t'
+#define SQL_BULK_LINE_END           '\n'
+#define SQL_BULK_LOAD_PREFIX        "LOAD DATA LOCAL INFILE '"
+#define SQL_BULK_LOAD_SIZE          384     /* LOAD DATA语句缓冲区大小（含路径） */
+#define SQL_BULK_LOAD_OPTIONS \
+    " FIELDS TERMINATED BY '\\t' ESCAPED BY '\\\\' LINES TERMINATED BY '\\n' "
+
+#define SQL_BULK_LOAD_SENSOR1 \
+    "' INTO TABLE sensor1_data" SQL_BULK_LOAD_OPTIONS SQL_SENSOR1_COLUMNS
+
+#define SQL_BULK_LOAD_SENSOR2 \
+    "' INTO TABLE sensor2_data" SQL_BULK_LOAD_OPTIONS SQL_SENSOR2_COLUMNS
+
+#define SQL_TEMPERATURE_DECIMALS    2       /* 温度小数位数 */
+#define SQL_HUMIDITY_DECIMALS       2       /* 湿度小数位数 */
+#define SQL_FIXED_SCALE             100.0f  /* v2表中温湿度的定点比例（0.01单位） */
+#ifndef DB_DICT_CACHE_SIZE
+#define DB_DICT_CACHE_SIZE          32      /* 缓存的字典键数（v2表结构） */
+#endif
+
+/* 查询结果的列序号（v1与建表语句的列顺序一致，v2与SQL_FROM_SENSOR*的选择列一致） */
+#define DB_SENSOR1_COL_ID               0
+#define DB_SENSOR1_COL_STUDENT_ID       1
+#define DB_SENSOR1_COL_SENSOR_NAME      2
+#define DB_SENSOR1_COL_TEMPERATURE      3
+#define DB_SENSOR1_COL_HUMIDITY         4
+#define DB_SENSOR1_COL_STATUS           5
+#define DB_SENSOR1_COL_TIMESTAMP        6
+
+#define DB_SENSOR2_COL_ID               0
+#define DB_SENSOR2_COL_STUDENT_ID       1
+#define DB_SENSOR2_COL_SENSOR_NAME      2
+#define DB_SENSOR2_COL_INTERRUPT_TYPE   3
+#define DB_SENSOR2_COL_INTERRUPT_COUNT  4
+#define DB_SENSOR2_COL_STATUS           5
+#define DB_SENSOR2_COL_FIRST_TIMESTAMP  6
+#define DB_SENSOR2_COL_TIMESTAMP        7
+
+#define SQL_PING                    "SELECT 1"
 
 #define SQL_COUNT_SENSOR1 \
     "SELECT COUNT(*) FROM sensor1_data"
@@ -260,34 +775,116 @@ const char* database_get_last_error(void);
 #define SQL_COUNT_SENSOR2 \
     "SELECT COUNT(*) FROM sensor2_data"
 
+#define SQL_MAX_ID_SENSOR1 \
+    "SELECT COALESCE(MAX(id), 0) FROM sensor1_data"
+
+#define SQL_MAX_ID_SENSOR2 \
+    "SELECT COALESCE(MAX(id), 0) FROM sensor2_data"
+
+/* 按created_at范围分区：TIMESTAMP列只能用UNIX_TIMESTAMP()分区，分区列必须
+ * 包含在主键中。新建的表只有pmax一个分区，按天或按周的分区由db_partition
+ * 从pmax中拆分预建，过期数据按整个分区删除 */
+#define SQL_PARTITION_MAX           "PARTITION pmax VALUES LESS THAN MAXVALUE"
+#if ENABLE_DB_PARTITION
+#define SQL_COLUMN_ID               "id INT AUTO_INCREMENT, "
+#define SQL_PRIMARY_KEY             "PRIMARY KEY (id, created_at), "
+#define SQL_PARTITION_CLAUSE \
+    " PARTITION BY RANGE (UNIX_TIMESTAMP(created_at)) (" SQL_PARTITION_MAX ")"
+#else
+#define SQL_COLUMN_ID               "id INT AUTO_INCREMENT PRIMARY KEY, "
+#define SQL_PRIMARY_KEY             ""
+#define SQL_PARTITION_CLAUSE        ""
+#endif
+
+#if DB_SCHEMA_VERSION >= 2
+#define SQL_CREATE_DICT_TABLE \
+    "CREATE TABLE IF NOT EXISTS sensor_dict (" \
+    "dict_key SMALLINT UNSIGNED AUTO_INCREMENT PRIMARY KEY, " \
+    "kind TINYINT UNSIGNED NOT NULL, " \
+    "name VARCHAR(20) NOT NULL, " \
+    "UNIQUE KEY uk_kind_name (kind, name)" \
+    ")"
+
 #define SQL_CREATE_SENSOR1_TABLE \
     "CREATE TABLE IF NOT EXISTS sensor1_data (" \
-    "id INT AUTO_INCREMENT PRIMARY KEY, " \
+    SQL_COLUMN_ID \
+    "student_key SMALLINT UNSIGNED NOT NULL, " \
+    "sensor_key SMALLINT UNSIGNED NOT NULL, " \
+    "temperature SMALLINT NOT NULL, " \
+    "humidity SMALLINT UNSIGNED NOT NULL, " \
+    "status TINYINT UNSIGNED NOT NULL, " \
+    "timestamp INT UNSIGNED NOT NULL, " \
+    "created_at TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP, " \
+    SQL_PRIMARY_KEY \
+    "INDEX idx_student_row (student_key, id), " \
+    "INDEX idx_timestamp (timestamp)" \
+    ")" SQL_PARTITION_CLAUSE
+
+#define SQL_CREATE_SENSOR2_TABLE \
+    "CREATE TABLE IF NOT EXISTS sensor2_data (" \
+    SQL_COLUMN_ID \
+    "student_key SMALLINT UNSIGNED NOT NULL, " \
+    "sensor_key SMALLINT UNSIGNED NOT NULL, " \
+    "interrupt_type TINYINT UNSIGNED NOT NULL, " \
+    "interrupt_count INT UNSIGNED NOT NULL, " \
+    "status TINYINT UNSIGNED NOT NULL, " \
+    "first_timestamp INT UNSIGNED NOT NULL DEFAULT 0, " \
+    "timestamp INT UNSIGNED NOT NULL, " \
+    "created_at TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP, " \
+    SQL_PRIMARY_KEY \
+    "INDEX idx_student_row (student_key, id), " \
+    "INDEX idx_sensor_timestamp (sensor_key, timestamp), " \
+    "INDEX idx_timestamp (timestamp)" \
+    ")" SQL_PARTITION_CLAUSE
+
+/* 以v2列名查询，v1的表上会失败（字典键0从不分配，只检查列是否存在） */
+#define SQL_SCHEMA_CHECK_SENSOR1 \
+    "SELECT COUNT(*) FROM sensor1_data WHERE student_key = 0"
+
+#define SQL_SCHEMA_CHECK_SENSOR2 \
+    "SELECT COUNT(*) FROM sensor2_data WHERE student_key = 0"
+#else
+#define SQL_CREATE_SENSOR1_TABLE \
+    "CREATE TABLE IF NOT EXISTS sensor1_data (" \
+    SQL_COLUMN_ID \
     "student_id VARCHAR(20) NOT NULL, " \
     "sensor_name VARCHAR(16) NOT NULL, " \
     "temperature DECIMAL(5,2) NOT NULL, " \
     "humidity DECIMAL(5,2) NOT NULL, " \
     "status VARCHAR(10) NOT NULL, " \
     "timestamp INT UNSIGNED NOT NULL, " \
-    "created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP, " \
-    "INDEX idx_student_id (student_id), " \
+    "created_at TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP, " \
+    SQL_PRIMARY_KEY \
+    "INDEX idx_student_timestamp (student_id, timestamp), " \
     "INDEX idx_timestamp (timestamp)" \
-    ")"
+    ")" SQL_PARTITION_CLAUSE
 
 #define SQL_CREATE_SENSOR2_TABLE \
     "CREATE TABLE IF NOT EXISTS sensor2_data (" \
-    "id INT AUTO_INCREMENT PRIMARY KEY, " \
+    SQL_COLUMN_ID \
     "student_id VARCHAR(20) NOT NULL, " \
     "sensor_name VARCHAR(16) NOT NULL, " \
     "interrupt_type TINYINT NOT NULL, " \
     "interrupt_count INT UNSIGNED NOT NULL, " \
     "status VARCHAR(10) NOT NULL, " \
+    "first_timestamp INT UNSIGNED NOT NULL DEFAULT 0, " \
     "timestamp INT UNSIGNED NOT NULL, " \
-    "created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP, " \
-    "INDEX idx_student_id (student_id), " \
+    "created_at TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP, " \
+    SQL_PRIMARY_KEY \
+    "INDEX idx_student_timestamp (student_id, timestamp), " \
     "INDEX idx_sensor_name (sensor_name), " \
     "INDEX idx_timestamp (timestamp)" \
-    ")"
+    ")" SQL_PARTITION_CLAUSE
+#endif
+
+/* 字典类别（sensor_dict.kind） */
+#define DB_DICT_STUDENT         0
+#define DB_DICT_SENSOR          1
+
+/* 数据表序号 */
+#define DB_TABLE_SENSOR1        0
+#define DB_TABLE_SENSOR2        1
+#define DB_TABLE_COUNT          2
 
 /* 错误代码定义 */
 #define DB_ERROR_NONE           0
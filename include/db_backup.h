@@ -0,0 +1,149 @@
+/**
+ * @file db_backup.h
+ * @brief 传感器数据备份与恢复模块头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 把两张数据表按主键顺序导出为带校验的压缩二进制块文件，恢复时经批量
+ * 写入路径写回。
+ *
+ * - 一致性：开始时记下每张表的最大id作为快照上界，之后只读取
+ *   (起点, 上界]内的行。数据表只追加不修改，这个id前缀就是开始时刻的
+ *   一致副本，读取只做主键范围扫描，不加锁也不开长事务
+ * - 不阻塞写入：备份在主循环中由db_backup_poll()推进，每次每张表读取
+ *   一批并写出一个块，两张表交替进行，写入路径在两次调用之间照常运行
+ * - 增量：起点为上次备份的终点（db_backup_get_point()或
+ *   db_backup_read_point()），只导出之后新增的行；全量备份起点为0
+ * - 状态文件：备份序号和最近一次完成的终点保存在
+ *   DB_BACKUP_DIRECTORY/DB_BACKUP_PREFIX DB_BACKUP_STATE_SUFFIX中，
+ *   重启后继续增量并按序号生成不重复的文件名；已存在的文件不会被覆盖
+ * - 压缩：块内的行按前一行做差分编码（id、时间戳、0.01单位的温湿度用
+ *   变长整数，学号和传感器名称与前一行相同时省略），每块从零开始，
+ *   可以单独解码
+ *
+ * 文件格式（小端）：24字节文件头（标识、版本、增量标记、起点id、备份
+ * 序号、CRC32C），之后是若干数据块，每块16字节块头（标识、表序号、
+ * 行数、负载长度、首行id、CRC32C）加编码后的行，最后是记录终点id和
+ * 各表行数的结束块。恢复先校验整个文件，全部通过后才写入数据库；
+ * 恢复的行由数据库重新分配id。文件内容与表结构版本无关。
+ */
+
+#ifndef DB_BACKUP_H
+#define DB_BACKUP_H
+
+#include "config.h"
+#include "database.h"
+
+/* 常量定义 */
+#ifndef DB_BACKUP_BATCH_ROWS
+#define DB_BACKUP_BATCH_ROWS        32      /* 每块（每次读取）的行数 */
+#endif
+#ifndef DB_BACKUP_DIRECTORY
+#define DB_BACKUP_DIRECTORY         "."
+#endif
+#ifndef DB_BACKUP_PREFIX
+#define DB_BACKUP_PREFIX            "sensor_backup"
+#endif
+#define DB_BACKUP_SUFFIX            ".bak"
+#define DB_BACKUP_STATE_SUFFIX      ".state"
+#define DB_BACKUP_PATH_SIZE         96
+#define DB_BACKUP_FILE_HEADER_SIZE  24
+#define DB_BACKUP_CHUNK_HEADER_SIZE 16
+#define DB_BACKUP_TRAILER_SIZE      (DB_BACKUP_CHUNK_HEADER_SIZE + 4 * DB_TABLE_COUNT * 2)
+/* 一行编码后的最大字节数：标记1 + id 5 + 时间戳5 + 学号和名称（含长度） + 数值字段15 */
+#define DB_BACKUP_MAX_ROW_BYTES     (1 + 5 + 5 + (1 + MAX_STUDENT_ID_LEN) + (1 + MAX_SENSOR_NAME_LEN) + 15)
+#define DB_BACKUP_CHUNK_PAYLOAD_SIZE (DB_BACKUP_BATCH_ROWS * DB_BACKUP_MAX_ROW_BYTES)
+
+/* 备份位置：每张表已备份的最大id（按DB_TABLE_*排列） */
+typedef struct {
+    uint32_t last_id[DB_TABLE_COUNT];
+} db_backup_point_t;
+
+/* 备份状态 */
+typedef enum {
+    DB_BACKUP_IDLE = 0,                     /* 没有进行中的备份 */
+    DB_BACKUP_RUNNING = 1                   /* 备份进行中，等待db_backup_poll()推进 */
+} db_backup_state_t;
+
+/* 备份统计 */
+typedef struct {
+    db_backup_state_t state;                /* 当前状态 */
+    uint32_t backups_completed;             /* 完成的备份数 */
+    uint32_t backups_failed;                /* 失败或中止的备份数 */
+    uint32_t rows_written;                  /* 最近一次备份导出的行数 */
+    uint32_t chunks_written;                /* 最近一次备份写出的块数 */
+    uint32_t bytes_written;                 /* 最近一次备份的文件字节数 */
+    uint32_t rows_restored;                 /* 恢复写入数据库的行数 */
+    uint32_t restore_failures;              /* 校验或写入失败的恢复次数 */
+} db_backup_statistics_t;
+
+/* 函数声明 */
+
+/**
+ * @brief 初始化备份模块
+ * @return system_status_t 初始化状态
+ */
+system_status_t db_backup_init(void);
+
+/**
+ * @brief 开始一次备份：创建文件并记下快照上界，备份序号加一并保存
+ * @param path 备份文件路径（文件已存在时失败并跳过这个序号，不覆盖）
+ * @param since 增量备份的起点（NULL表示全量备份）
+ * @return db_result_t 操作结果；起点超过表中最大id（表被重建过）时失败，
+ *         error_code为DB_ERROR_INVALID_PARAM，应改为全量备份
+ */
+db_result_t db_backup_start(const char* path, const db_backup_point_t* since);
+
+/**
+ * @brief 推进进行中的备份：每张表写出至多一个块，全部导出后写结束块并关闭文件
+ * @return db_result_t 操作结果，affected_rows为本次导出的行数；失败时备份中止
+ */
+db_result_t db_backup_poll(void);
+
+/**
+ * @brief 是否有进行中的备份
+ * @return bool 进行中返回true
+ */
+bool db_backup_running(void);
+
+/**
+ * @brief 中止进行中的备份并删除未完成的文件
+ */
+void db_backup_abort(void);
+
+/**
+ * @brief 下一次db_backup_start()使用的备份序号（用于生成文件名，跨重启递增）
+ * @return uint32_t 备份序号
+ */
+uint32_t db_backup_next_sequence(void);
+
+/**
+ * @brief 获取最近一次完成的备份的终点（下一次增量备份的起点）
+ * @param point 输出位置
+ * @return bool 有完成的备份时返回true（含重启前完成、保存在状态文件中的备份）
+ */
+bool db_backup_get_point(db_backup_point_t* point);
+
+/**
+ * @brief 读取已有备份文件的终点（重启后继续增量备份）
+ * @param path 备份文件路径
+ * @param point 输出位置
+ * @return db_result_t 操作结果
+ */
+db_result_t db_backup_read_point(const char* path, db_backup_point_t* point);
+
+/**
+ * @brief 从备份文件恢复：校验全部块后经批量写入路径写回数据库
+ * @param path 备份文件路径
+ * @return db_result_t 操作结果，affected_rows为写入的行数
+ */
+db_result_t db_backup_restore(const char* path);
+
+/**
+ * @brief 获取备份统计信息
+ * @param stats 统计信息结构指针
+ */
+void db_backup_get_statistics(db_backup_statistics_t* stats);
+
+#endif /* DB_BACKUP_H */
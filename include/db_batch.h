@@ -0,0 +1,137 @@
+/**
+ * @file db_batch.h
+ * @brief 数据库批量写入模块头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 按表收集待写入的行，在行数、语句字节数或最长等待时间任一达到
+ * 上限时，以一条多行INSERT ... VALUES (...),(...)语句写入。每行的
+ * 写入结果（成功/被拒绝/语句失败）通过回调逐行报告。启用汇总表时，
+ * 批次与汇总表的累加在同一个事务中提交。
+ */
+
+#ifndef DB_BATCH_H
+#define DB_BATCH_H
+
+#include "config.h"
+#include "database.h"
+
+/* 单行写入结果 */
+typedef enum {
+    DB_ROW_INSERTED = 0,                    /* 已写入 */
+    DB_ROW_REJECTED = 1,                    /* 数据检查未通过，未进入批次 */
+    DB_ROW_FAILED = 2                       /* 所在批次语句执行失败（或入批前访问数据库失败） */
+} db_row_status_t;
+
+/* 批量刷新原因 */
+typedef enum {
+    DB_FLUSH_ROWS = 0,                      /* 行数达到上限 */
+    DB_FLUSH_BYTES = 1,                     /* 语句长度达到上限 */
+    DB_FLUSH_TIME = 2,                      /* 等待时间达到上限 */
+    DB_FLUSH_FORCED = 3                     /* 主动刷新 */
+} db_flush_reason_t;
+
+/* 单行结果 */
+typedef struct {
+    uint32_t row_id;                        /* db_batch_add()返回的行号 */
+    sensor_type_t type;                     /* 数据类型（对应的表） */
+    db_row_status_t status;                 /* 写入结果 */
+    int error_code;                         /* 错误代码（DB_ERROR_*） */
+    const sensor_data_t* data;              /* 该行数据（仅在回调期间有效，可用于失败重试） */
+} db_row_outcome_t;
+
+/* 结果回调：一次报告一个批次的所有行，回调中不能调用db_batch_add() */
+typedef void (*db_batch_outcome_callback_t)(const db_row_outcome_t* outcomes, uint16_t count,
+                                            void* context);
+
+/* 批量配置 */
+typedef struct {
+    uint16_t max_rows;                      /* 单条语句最大行数（1~DB_BATCH_MAX_ROWS） */
+    uint16_t max_bytes;                     /* 单条语句最大字节数（不超过DB_BATCH_SQL_SIZE-1） */
+    uint32_t max_delay;                     /* 首行入批后最长等待时间（毫秒），0表示不限 */
+} db_batch_config_t;
+
+/* 批量统计 */
+typedef struct {
+    uint32_t rows_added;                    /* 进入批次的行数 */
+    uint32_t rows_inserted;                 /* 写入成功的行数 */
+    uint32_t rows_rejected;                 /* 被拒绝的行数 */
+    uint32_t rows_failed;                   /* 语句失败的行数 */
+    uint32_t statements;                    /* 执行的INSERT语句数 */
+    uint32_t flush_count[4];                /* 按刷新原因统计（db_flush_reason_t） */
+    uint16_t pending_rows;                  /* 当前待写入行数 */
+} db_batch_statistics_t;
+
+/* 函数声明 */
+
+/**
+ * @brief 初始化批量写入模块
+ * @param config 批量配置（NULL使用默认配置）
+ * @return system_status_t 初始化状态
+ */
+system_status_t db_batch_init(const db_batch_config_t* config);
+
+/**
+ * @brief 运行时调整批量配置（已积累的行超过新上限时立即刷新）
+ * @param config 批量配置
+ * @return system_status_t 操作状态
+ */
+system_status_t db_batch_set_config(const db_batch_config_t* config);
+
+/**
+ * @brief 获取当前批量配置
+ * @param config 配置输出
+ */
+void db_batch_get_config(db_batch_config_t* config);
+
+/**
+ * @brief 设置逐行结果回调
+ * @param callback 回调函数（NULL取消）
+ * @param context 回调上下文
+ */
+void db_batch_set_outcome_callback(db_batch_outcome_callback_t callback, void* context);
+
+/**
+ * @brief 添加一行待写入数据
+ * @param data 传感器数据
+ * @param row_id 输出行号（可为NULL），与结果回调中的row_id对应
+ * @return db_result_t 入批结果；被拒绝的行同时通过回调报告
+ */
+db_result_t db_batch_add(const sensor_data_t* data, uint32_t* row_id);
+
+/**
+ * @brief 刷新等待时间已到的批次（在主循环中周期调用）
+ * @param now 当前毫秒计时（get_tick_ms()）
+ * @return uint16_t 本次写入（含失败）的行数
+ */
+uint16_t db_batch_poll(uint32_t now);
+
+/**
+ * @brief 立即刷新所有批次（关闭或断开连接前调用）
+ * @return uint16_t 本次写入（含失败）的行数
+ */
+uint16_t db_batch_flush_all(void);
+
+/**
+ * @brief 获取批量统计信息
+ * @param stats 统计信息结构指针
+ */
+void db_batch_get_statistics(db_batch_statistics_t* stats);
+
+/* 常量定义 */
+#ifndef DB_BATCH_MAX_ROWS
+#define DB_BATCH_MAX_ROWS           8       /* 单批最大行数（静态分配，每行约70字节） */
+#endif
+#ifndef DB_BATCH_SQL_SIZE
+#define DB_BATCH_SQL_SIZE           MAX_SQL_LENGTH  /* 每张表的语句缓冲区大小 */
+#endif
+#define DB_BATCH_TABLE_COUNT        2       /* sensor1_data, sensor2_data */
+#define DB_BATCH_DEFAULT_ROWS       8
+#define DB_BATCH_DEFAULT_BYTES      (DB_BATCH_SQL_SIZE - 1)
+#define DB_BATCH_DEFAULT_DELAY      500     /* 毫秒 */
+
+/* 默认配置 */
+extern const db_batch_config_t DEFAULT_DB_BATCH_CONFIG;
+
+#endif /* DB_BATCH_H */
@@ -0,0 +1,116 @@
+/**
+ * @file db_bulk.h
+ * @brief 数据库批量装载模块头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 大量积压数据（断线后的日志回放、备份恢复）不逐行INSERT，而是先按
+ * 数据库的批量装载格式写入每张表一个暂存文件，再用一条批量装载语句
+ * （MySQL为LOAD DATA，SQLite和时序存储由驱动读取暂存文件）装入。
+ *
+ * - db_bulk_begin()开始事务并创建暂存文件；db_bulk_add()检查数据、
+ *   解析字典键、追加一行并计入汇总表；db_bulk_commit()装载各表、
+ *   写出汇总表后提交，失败时回滚，暂存文件总是被删除
+ * - 装入的行相对表中已有的行较多时（见DB_BULK_DEFER_INDEX_RATIO），
+ *   SQLite驱动装载前删除该表的二级索引，装载后一次重建；MySQL的
+ *   LOAD DATA不推迟（删除和重建索引的DDL会隐式提交事务）
+ * - LOAD DATA LOCAL把跳过和转换的行降级为警告：装入行数与暂存行数
+ *   不同或有警告时装载失败并回滚
+ * - 暂存文件只在一次装载期间存在，不需要fsync：装载提交前掉电时，
+ *   数据仍在原来的来源（日志或备份文件）中
+ * - 统计中记录最近一次装载的耗时和行/秒
+ */
+
+#ifndef DB_BULK_H
+#define DB_BULK_H
+
+#include "config.h"
+#include "database.h"
+
+/* 批量装载统计 */
+typedef struct {
+    uint32_t loads_completed;               /* 提交成功的装载次数 */
+    uint32_t loads_failed;                  /* 失败或放弃的装载次数 */
+    uint32_t rows_loaded;                   /* 累计装入的行数 */
+    uint32_t rows_rejected;                 /* 数据检查未通过、未进入暂存文件的行数 */
+    uint32_t last_rows;                     /* 最近一次装载的行数 */
+    uint32_t last_elapsed_ms;               /* 最近一次装载从开始到提交的毫秒数 */
+    uint32_t last_rows_per_second;          /* 最近一次装载的速度（耗时不足1毫秒时按1毫秒计） */
+} db_bulk_statistics_t;
+
+/* 函数声明 */
+
+/**
+ * @brief 初始化批量装载模块
+ * @return system_status_t 初始化状态
+ */
+system_status_t db_bulk_init(void);
+
+/**
+ * @brief 开始一次装载：开始事务并创建暂存文件
+ * @return db_result_t 操作结果
+ */
+db_result_t db_bulk_begin(void);
+
+/**
+ * @brief 追加一行到暂存文件
+ * @param data 传感器数据
+ * @return db_result_t 操作结果；数据无效时error_code为DB_ERROR_INVALID_PARAM，
+ *         该行被跳过，装载可以继续；其他错误应调用db_bulk_abort()
+ */
+db_result_t db_bulk_add(const sensor_data_t* data);
+
+/**
+ * @brief 装载暂存的行并提交事务（失败时回滚）
+ * @return db_result_t 操作结果，affected_rows为装入的行数
+ */
+db_result_t db_bulk_commit(void);
+
+/**
+ * @brief 放弃进行中的装载：回滚事务并删除暂存文件
+ */
+void db_bulk_abort(void);
+
+/**
+ * @brief 是否有进行中的装载
+ * @return bool 进行中返回true
+ */
+bool db_bulk_active(void);
+
+/**
+ * @brief 当前装载已暂存的行数
+ * @return uint32_t 行数
+ */
+uint32_t db_bulk_staged_rows(void);
+
+/**
+ * @brief 获取批量装载统计信息
+ * @param stats 统计信息结构指针
+ */
+void db_bulk_get_statistics(db_bulk_statistics_t* stats);
+
+/* 常量定义 */
+#ifndef DB_BULK_DIRECTORY
+#define DB_BULK_DIRECTORY           "."
+#endif
+#ifndef DB_BULK_PREFIX
+#define DB_BULK_PREFIX              "sensor_bulk"
+#endif
+#define DB_BULK_SUFFIX              ".tsv"
+#define DB_BULK_PATH_SIZE           96
+#define DB_BULK_LINE_SIZE           128     /* 一行的最大长度（v1文本字段转义后） */
+#ifndef DB_BULK_MIN_ROWS
+#define DB_BULK_MIN_ROWS            256     /* 积压达到此行数时走批量装载（更少时逐批INSERT） */
+#endif
+#ifndef DB_BULK_MAX_ROWS
+#define DB_BULK_MAX_ROWS            100000UL    /* 一次装载（一个事务）的最大行数 */
+#endif
+#ifndef DB_BULK_RETRY_SECONDS
+#define DB_BULK_RETRY_SECONDS       30      /* 装载失败后至少间隔此秒数再开始下一次装载 */
+#endif
+#ifndef DB_BULK_DEFER_INDEX_RATIO
+#define DB_BULK_DEFER_INDEX_RATIO   8       /* 装入行数 x 比例 >= 表中行数时推迟索引维护 */
+#endif
+
+#endif /* DB_BULK_H */
@@ -0,0 +1,81 @@
+/**
+ * @file db_cache.h
+ * @brief 最新数据缓存模块头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 按(学号, 数据类型)在内存中保存最近写入的DB_CACHE_DEPTH条记录
+ * （每个键一个固定大小的环形缓冲区），用于"某学号最新N条"查询。
+ * 缓存中的行数足够时直接从内存返回，不足时查询数据库，并用查询
+ * 结果重新填充该键的缓冲区。database_query_sensor1_data()/
+ * database_query_sensor2_data()按学号查询最新N条时经过这里。
+ *
+ * 写入路径在行确实写入数据库（批次或事务提交成功）后调用
+ * db_cache_put()，缓存内容始终是数据库中对应键最新行的副本。
+ * 绕过写入路径修改数据表（清理、外部写入、重连到另一个库文件）
+ * 之后必须调用db_cache_invalidate()。
+ */
+
+#ifndef DB_CACHE_H
+#define DB_CACHE_H
+
+#include "config.h"
+#include "database.h"
+
+/* 缓存统计 */
+typedef struct {
+    uint32_t hits;                          /* 从缓存返回的查询数 */
+    uint32_t misses;                        /* 查询数据库的次数 */
+    uint32_t fills;                         /* 用数据库查询结果填充的次数 */
+    uint32_t puts;                          /* 写入的行数 */
+    uint32_t evictions;                     /* 淘汰的键数 */
+    uint32_t invalidations;                 /* 整体失效次数 */
+    uint8_t keys_used;                      /* 当前使用的键数 */
+} db_cache_statistics_t;
+
+/* 函数声明 */
+
+/**
+ * @brief 初始化缓存（清空所有键）
+ * @return system_status_t 初始化状态
+ */
+system_status_t db_cache_init(void);
+
+/**
+ * @brief 记录一条已写入数据库的数据
+ * @param data 传感器数据
+ */
+void db_cache_put(const sensor_data_t* data);
+
+/**
+ * @brief 查询某学号最新的limit条数据（顺序同SQL_ORDER_BY_LATEST）
+ * @param type 数据类型（决定查询的表）
+ * @param student_id 学号（NULL或空串表示全部学号，不经过缓存）
+ * @param rows 输出缓冲区（至少limit条）
+ * @param limit 最大条数
+ * @return db_result_t 查询结果，affected_rows为返回的条数
+ */
+db_result_t db_cache_query_latest(sensor_type_t type, const char* student_id,
+                                  sensor_data_t* rows, uint16_t limit);
+
+/**
+ * @brief 使全部缓存失效
+ */
+void db_cache_invalidate(void);
+
+/**
+ * @brief 获取缓存统计信息
+ * @param stats 统计信息结构指针
+ */
+void db_cache_get_statistics(db_cache_statistics_t* stats);
+
+/* 常量定义 */
+#ifndef DB_CACHE_MAX_KEYS
+#define DB_CACHE_MAX_KEYS           8       /* 最多缓存的(学号, 类型)数，超出时淘汰最久未用的键 */
+#endif
+#ifndef DB_CACHE_DEPTH
+#define DB_CACHE_DEPTH              16      /* 每个键保存的最新行数（不超过255） */
+#endif
+
+#endif /* DB_CACHE_H */
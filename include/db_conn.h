@@ -0,0 +1,111 @@
+/**
+ * @file db_conn.h
+ * @brief 数据库连接管理模块头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 接管数据库连接的建立、健康检查和重连，替代在错误回调中同步
+ * 断开再连接的做法。所有连接操作都在db_conn_poll()中按计时进行，
+ * 错误回调只调用db_conn_report_error()做标记，不访问数据库。
+ *
+ * - 连接正常：空闲超过keepalive_interval时发一次心跳；收到连接类
+ *   错误（DB_ERROR_CONNECTION/DB_ERROR_TIMEOUT）报告后（两次检查至少
+ *   间隔probe_interval）立即心跳确认，数据被拒绝等语句错误只计数
+ * - 重连抖动的种子取芯片唯一ID，同时上电的多台设备掉线后不会同步重连
+ * - 心跳或连接失败：断开，按指数退避加随机抖动重连
+ *   （等待时间在[d/2, d]内随机，d从backoff_min起每次翻倍至backoff_max）
+ * - 连续失败breaker_threshold次：熔断breaker_cooldown，期间不做
+ *   任何尝试，db_conn_available()返回false，调用方不再访问数据库
+ *   （数据进入断线日志）；冷却后只放一次探测连接，成功即恢复
+ */
+
+#ifndef DB_CONN_H
+#define DB_CONN_H
+
+#include "config.h"
+#include "database.h"
+
+/* 连接状态 */
+typedef enum {
+    DB_CONN_UP = 0,                         /* 已连接，可以访问 */
+    DB_CONN_BACKOFF = 1,                    /* 等待重连 */
+    DB_CONN_OPEN = 2,                       /* 熔断中 */
+    DB_CONN_HALF_OPEN = 3                   /* 熔断冷却结束，正在探测 */
+} db_conn_state_t;
+
+/* 连接管理配置（时间均为毫秒，按get_tick_ms()计时） */
+typedef struct {
+    uint32_t backoff_min;                   /* 首次重连等待时间 */
+    uint32_t backoff_max;                   /* 重连等待时间上限 */
+    uint32_t keepalive_interval;            /* 空闲心跳间隔，0表示不发心跳 */
+    uint32_t probe_interval;                /* 错误报告触发检查的最小间隔 */
+    uint8_t breaker_threshold;              /* 连续失败多少次后熔断（0表示不熔断） */
+    uint32_t breaker_cooldown;              /* 熔断持续时间 */
+} db_conn_config_t;
+
+/* 连接管理统计 */
+typedef struct {
+    db_conn_state_t state;                  /* 当前状态 */
+    uint32_t connect_count;                 /* 连接成功次数 */
+    uint32_t connect_failures;              /* 连接失败次数 */
+    uint32_t ping_count;                    /* 心跳次数 */
+    uint32_t ping_failures;                 /* 心跳失败次数 */
+    uint32_t errors_reported;               /* 收到的错误报告数 */
+    uint32_t breaker_trips;                 /* 熔断次数 */
+    uint8_t consecutive_failures;           /* 当前连续失败次数 */
+    uint32_t next_attempt;                  /* 下次重连时间（get_tick_ms()毫秒计时） */
+} db_conn_statistics_t;
+
+/* 函数声明 */
+
+/**
+ * @brief 初始化连接管理并立即尝试第一次连接（连接成功后建表）
+ * @param config 连接管理配置（NULL使用默认配置）
+ * @param db_config 数据库配置（复制保存，用于之后的重连）
+ * @return system_status_t 参数错误返回SYSTEM_ERROR；连接失败不视为错误，进入重连等待
+ */
+system_status_t db_conn_init(const db_conn_config_t* config, const db_config_t* db_config);
+
+/**
+ * @brief 按计时执行心跳、重连和熔断探测（在主循环中周期调用）
+ * @param now 当前毫秒计时（get_tick_ms()）
+ */
+void db_conn_poll(uint32_t now);
+
+/**
+ * @brief 数据库当前是否可以访问（未熔断且已连接）
+ * @return bool 是否可以访问
+ */
+bool db_conn_available(void);
+
+/**
+ * @brief 报告一次数据库错误（可在数据库错误回调中调用，不访问数据库）
+ * @param error_code 错误码，只有连接类错误会触发心跳确认
+ */
+void db_conn_report_error(int error_code);
+
+/**
+ * @brief 获取当前连接状态
+ * @return db_conn_state_t 连接状态
+ */
+db_conn_state_t db_conn_get_state(void);
+
+/**
+ * @brief 获取连接管理统计信息
+ * @param stats 统计信息结构指针
+ */
+void db_conn_get_statistics(db_conn_statistics_t* stats);
+
+/* 常量定义 */
+#define DB_CONN_DEFAULT_BACKOFF_MIN 500     /* 毫秒 */
+#define DB_CONN_DEFAULT_BACKOFF_MAX 30000   /* 毫秒 */
+#define DB_CONN_DEFAULT_KEEPALIVE   10000   /* 毫秒 */
+#define DB_CONN_DEFAULT_PROBE       200     /* 毫秒 */
+#define DB_CONN_DEFAULT_THRESHOLD   5
+#define DB_CONN_DEFAULT_COOLDOWN    60000   /* 毫秒 */
+
+/* 默认配置 */
+extern const db_conn_config_t DEFAULT_DB_CONN_CONFIG;
+
+#endif /* DB_CONN_H */
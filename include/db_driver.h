@@ -0,0 +1,138 @@
+/**
+ * @file db_driver.h
+ * @brief 数据库存储驱动接口头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * database_*接口只负责参数检查、语句缓存和结果封装，实际的连接、
+ * 语句准备、执行、游标取行和事务由驱动函数表完成。内置三个驱动：
+ * 模拟驱动（目标板默认，不访问任何存储）、嵌入式SQLite驱动
+ * （定义DB_WITH_SQLITE并链接libsqlite3时可用，离线运行）和列式
+ * 时序存储驱动（定义DB_WITH_TSDB时可用，不需要任何数据库软件）。
+ * 新增后端（如MySQL客户端）只需提供一张db_driver_t函数表。
+ *
+ * 驱动函数返回DB_ERROR_*错误代码（DB_ERROR_NONE表示成功），
+ * 详细信息通过last_error()获取。
+ */
+
+#ifndef DB_DRIVER_H
+#define DB_DRIVER_H
+
+#include "config.h"
+#include "database.h"
+
+/* 驱动函数表 */
+typedef struct {
+    const char* name;                                   /* 驱动名称 */
+
+    /* 方言：NULL结尾的建表语句；按db_stmt_id_t覆盖的语句模板（NULL或元素为NULL时使用默认模板） */
+    const char* const* create_tables;
+    const char* const* statement_sql;
+
+    /* 连接 */
+    int (*connect)(const db_config_t* config);
+    void (*disconnect)(void);
+
+    /* 执行无参数语句（建表、清理、多行INSERT批量写入），affected_rows可为NULL */
+    int (*exec)(const char* sql, uint32_t* affected_rows);
+
+    /* 预编译语句：prepare设置stmt->handle，finalize释放 */
+    int (*prepare)(db_stmt_t* stmt);
+    void (*finalize)(db_stmt_t* stmt);
+
+    /* 绑定stmt->params并执行写语句 */
+    int (*execute)(db_stmt_t* stmt, uint32_t* affected_rows);
+
+    /* 查询游标：query绑定参数并开始查询，step取下一行，reset结束查询 */
+    int (*query)(db_stmt_t* stmt);
+    int (*step)(db_stmt_t* stmt, bool* has_row);
+    void (*reset)(db_stmt_t* stmt);
+
+    /* 当前行的列值（列序号从0开始，文本在下一次step前有效） */
+    uint8_t (*column_count)(db_stmt_t* stmt);
+    int32_t (*column_int)(db_stmt_t* stmt, uint8_t column);
+    uint32_t (*column_uint)(db_stmt_t* stmt, uint8_t column);
+    double (*column_real)(db_stmt_t* stmt, uint8_t column);
+    const char* (*column_text)(db_stmt_t* stmt, uint8_t column);
+
+    /* 事务 */
+    int (*begin)(void);
+    int (*commit)(void);
+    int (*rollback)(void);
+
+    /* 批量装载暂存文件（SQL_BULK_*文本格式）到表中，全部装入或全部失败；
+     * NULL表示按默认方言执行LOAD DATA语句 */
+    int (*bulk_load)(uint8_t table, const char* path, bool defer_indexes);
+
+    /* 最近一次驱动错误信息 */
+    const char* (*last_error)(void);
+} db_driver_t;
+
+/* 内置驱动 */
+extern const db_driver_t DB_DRIVER_SIM;
+#ifdef DB_WITH_SQLITE
+extern const db_driver_t DB_DRIVER_SQLITE;
+#endif
+#ifdef DB_WITH_TSDB
+extern const db_driver_t DB_DRIVER_TSDB;
+#endif
+
+/* 函数声明 */
+
+/**
+ * @brief 选择数据库驱动（只能在未连接时切换）
+ * @param driver 驱动函数表（NULL恢复默认驱动）
+ * @return system_status_t 操作状态
+ */
+system_status_t database_set_driver(const db_driver_t* driver);
+
+/**
+ * @brief 获取当前数据库驱动
+ * @return const db_driver_t* 驱动函数表
+ */
+const db_driver_t* database_get_driver(void);
+
+/* 常量定义 */
+#ifndef DB_DEFAULT_DRIVER
+#if defined(DB_WITH_TSDB)
+#define DB_DEFAULT_DRIVER           (&DB_DRIVER_TSDB)
+#elif defined(DB_WITH_SQLITE)
+#define DB_DEFAULT_DRIVER           (&DB_DRIVER_SQLITE)
+#else
+#define DB_DEFAULT_DRIVER           (&DB_DRIVER_SIM)
+#endif
+#endif
+
+#ifndef DB_SQLITE_FILE_SUFFIX
+#define DB_SQLITE_FILE_SUFFIX       ".db"   /* 数据库文件名 = db_config_t.database + 后缀 */
+#endif
+#define DB_SQLITE_MEMORY            ":memory:"  /* database为此值时使用内存数据库 */
+#define DB_SQLITE_PATH_SIZE         64
+
+#ifndef DB_SQLITE_PRAGMAS
+#define DB_SQLITE_PRAGMAS           "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL"
+#endif
+
+/* 列式时序存储：文件名 = db_config_t.database + "_" + 文件名，见db_driver_tsdb.c */
+#ifndef DB_TSDB_HEAD_ROWS
+#define DB_TSDB_HEAD_ROWS           256     /* 头部日志的行数，达到后封存为列式块 */
+#endif
+#ifndef DB_TSDB_CHUNK_ROWS
+#define DB_TSDB_CHUNK_ROWS          128     /* 每个列式块的最大行数 */
+#endif
+#ifndef DB_TSDB_RESULT_ROWS
+#define DB_TSDB_RESULT_ROWS         32      /* 查询每次归并取出的行数 */
+#endif
+#ifndef DB_TSDB_MAX_DAYS
+#define DB_TSDB_MAX_DAYS            64      /* 每张表的天段文件数上限 */
+#endif
+#ifndef DB_TSDB_DICT_SIZE
+#define DB_TSDB_DICT_SIZE           128     /* 学号和传感器名称的字典容量 */
+#endif
+#ifndef DB_TSDB_CURSORS
+#define DB_TSDB_CURSORS             4       /* 同时打开的查询数 */
+#endif
+#define DB_TSDB_PATH_SIZE           96
+
+#endif /* DB_DRIVER_H */
@@ -0,0 +1,79 @@
+/**
+ * @file db_partition.h
+ * @brief 数据表分区管理模块头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 传感器数据表按created_at范围分区（见SQL_CREATE_SENSOR*_TABLE），
+ * 每个分区覆盖period_days天，命名为p<起始日期>（如p20261018），
+ * 最后是接收其余数据的pmax。db_partition_maintain()：
+ *
+ * - 预建分区：保证当前分区和之后precreate个分区已经存在
+ *   （从空的pmax中拆分，不移动数据）
+ * - 过期清理：结束日期早于retention_days天前的分区整个删除，
+ *   代价与分区中的行数无关，不逐行删除、不长时间锁表
+ *
+ * 日期取数据库服务器的当前日期。未分区的表（升级前建立的表、
+ * SQLite）仍按created_at逐行删除过期数据。
+ */
+
+#ifndef DB_PARTITION_H
+#define DB_PARTITION_H
+
+#include "config.h"
+#include "database.h"
+
+/* 分区配置 */
+typedef struct {
+    uint8_t period_days;                    /* 分区跨度天数（1按天，7按周，周分区从周一开始） */
+    uint8_t precreate;                      /* 当前分区之后预建的分区数 */
+    uint16_t retention_days;                /* 数据保留天数，0表示不清理 */
+} db_partition_config_t;
+
+/* 分区统计 */
+typedef struct {
+    uint32_t maintain_count;                /* 维护次数 */
+    uint32_t partitions_created;            /* 预建的分区数 */
+    uint32_t partitions_dropped;            /* 删除的分区数 */
+    uint32_t rows_dropped;                  /* 随分区删除的行数 */
+    uint32_t rows_deleted;                  /* 未分区表逐行删除的行数 */
+    uint8_t partitioned_tables;             /* 最近一次维护时已分区的表数 */
+} db_partition_statistics_t;
+
+/* 函数声明 */
+
+/**
+ * @brief 初始化分区管理
+ * @param config 分区配置（NULL使用默认配置）
+ * @return system_status_t 初始化状态
+ */
+system_status_t db_partition_init(const db_partition_config_t* config);
+
+/**
+ * @brief 预建分区并删除过期分区（启动后及此后每天至少调用一次）
+ * @return db_result_t 操作结果，affected_rows为删除的行数
+ */
+db_result_t db_partition_maintain(void);
+
+/**
+ * @brief 获取分区统计信息
+ * @param stats 统计信息结构指针
+ */
+void db_partition_get_statistics(db_partition_statistics_t* stats);
+
+/* 常量定义 */
+#ifndef DB_PARTITION_MAX
+#define DB_PARTITION_MAX            64      /* 每张表最多识别的日期分区数 */
+#endif
+#define DB_PARTITION_MAX_NAME       "pmax"  /* 接收其余数据的分区（与SQL_PARTITION_MAX一致） */
+#define DB_PARTITION_TO_DAYS_EPOCH  719528  /* TO_DAYS('1970-01-01') */
+#define DB_PARTITION_MONDAY         4       /* 1970-01-05（周一）起的天数，周分区对齐用 */
+#define DB_PARTITION_DEFAULT_PERIOD 1       /* 按天分区 */
+#define DB_PARTITION_DEFAULT_PRECREATE 3
+#define DB_PARTITION_DEFAULT_RETENTION 30   /* 天 */
+
+/* 默认配置 */
+extern const db_partition_config_t DEFAULT_DB_PARTITION_CONFIG;
+
+#endif /* DB_PARTITION_H */
@@ -0,0 +1,122 @@
+/**
+ * @file db_rollup.h
+ * @brief 传感器数据汇总表模块头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 按分钟、小时、天三级汇总表（sensor_rollup_minute/hour/day）保存每个
+ * (时间桶, 数据类型, 学号, 传感器, 状态)的行数、数值之和和最后时间戳，
+ * 代替每次对两张原始表做GROUP BY的统计视图。
+ *
+ * 汇总表与原始数据在同一事务中更新：database_insert_sensor_data()
+ * 自己计入汇总（调用方没有开始事务时为这一行开始一个），不经过它写入
+ * 的路径（多行INSERT、批量装载）把写入的行交给db_rollup_add()。
+ * database_commit_transaction()在提交前调用db_rollup_flush()：同一
+ * 事务中相同键的行先在内存中合并，每个键对每级汇总表执行一条累加的
+ * upsert；database_rollback_transaction()调用db_rollup_discard()。
+ *
+ * 时间桶按写出时数据库服务器的时间（UNIX秒，与原始表created_at的默认
+ * 值同一时钟）划分。数据自身的timestamp是get_timestamp()的计数，每次
+ * 启动从头开始，不能作为时间桶。回放的数据与其created_at一样计入回放
+ * 时的时间桶。汇总表不随原始数据的过期清理而删除。
+ *
+ * 时序存储驱动不写汇总表，范围汇总直接从数据块计算；其行中没有写入
+ * 时间，仍按行的timestamp筛选。
+ */
+
+#ifndef DB_ROLLUP_H
+#define DB_ROLLUP_H
+
+#include "config.h"
+#include "database.h"
+
+/* 常量定义 */
+#ifndef DB_ROLLUP_MAX_KEYS
+#define DB_ROLLUP_MAX_KEYS          48      /* 待写入的(级别, 键)数，满时提前写出 */
+#endif
+#define DB_ROLLUP_STATUS_COUNT      4       /* sensor_status_t取值个数 */
+#define DB_ROLLUP_MINUTE_SECONDS    60UL
+#define DB_ROLLUP_HOUR_SECONDS      3600UL
+#define DB_ROLLUP_DAY_SECONDS       86400UL
+
+/* 汇总级别（与DB_STMT_ROLLUP_*的顺序一致） */
+typedef enum {
+    DB_ROLLUP_MINUTE = 0,
+    DB_ROLLUP_HOUR = 1,
+    DB_ROLLUP_DAY = 2,
+    DB_ROLLUP_LEVEL_COUNT = 3
+} db_rollup_level_t;
+
+/* 时间范围汇总结果 */
+typedef struct {
+    uint32_t row_count;                     /* 行数 */
+    uint32_t status_counts[DB_ROLLUP_STATUS_COUNT];  /* 按sensor_status_t统计的行数 */
+    float temperature_avg;                  /* 平均温度（传感器1） */
+    float humidity_avg;                     /* 平均湿度（传感器1） */
+    uint32_t interrupt_total;               /* 中断次数之和（传感器2） */
+    uint32_t last_timestamp;                /* 最后一行的timestamp（设备计数），没有数据时为0 */
+} db_rollup_summary_t;
+
+/* 汇总统计 */
+typedef struct {
+    uint32_t rows_added;                    /* 计入汇总的行数 */
+    uint32_t upserts;                       /* 执行的upsert语句数 */
+    uint32_t flush_failures;                /* 写入汇总表失败的次数 */
+    uint32_t discarded;                     /* 随事务回滚丢弃的键数 */
+    uint32_t queries;                       /* 范围查询次数 */
+    uint32_t segments[DB_ROLLUP_LEVEL_COUNT];  /* 范围查询读取的各级汇总段数 */
+    uint8_t pending_keys;                   /* 当前待写入的键数 */
+} db_rollup_statistics_t;
+
+/* 函数声明 */
+
+/**
+ * @brief 初始化汇总模块（清空待写入的键）
+ * @return system_status_t 初始化状态
+ */
+system_status_t db_rollup_init(void);
+
+/**
+ * @brief 计入一条与原始数据同一事务写入的行（待写入键已满时先写出）；
+ *        database_insert_sensor_data()写入的行已自动计入，不要重复调用
+ * @param data 传感器数据
+ * @return db_result_t 操作结果
+ */
+db_result_t db_rollup_add(const sensor_data_t* data);
+
+/**
+ * @brief 把待写入的键累加到各级汇总表中当前服务器时间所在的时间桶
+ *        （database_commit_transaction()在提交前调用）
+ * @return db_result_t 操作结果，affected_rows为执行的upsert数
+ */
+db_result_t db_rollup_flush(void);
+
+/**
+ * @brief 丢弃待写入的键（database_rollback_transaction()调用）
+ */
+void db_rollup_discard(void);
+
+/**
+ * @brief 汇总一个时间范围内的数据
+ *
+ * 范围按整分钟向外对齐，拆成"整天 + 两端的整小时 + 两端的整分钟"，
+ * 每段读取能覆盖它的最粗一级汇总表。
+ *
+ * @param type 数据类型
+ * @param student_id 学号（NULL或空串表示全部学号）
+ * @param from 起始时间（UNIX秒，含）
+ * @param to 结束时间（UNIX秒，不含）
+ * @param summary 输出汇总结果
+ * @return db_result_t 查询结果，affected_rows为读取的汇总行数
+ */
+db_result_t db_rollup_query(sensor_type_t type, const char* student_id,
+                            uint32_t from, uint32_t to, db_rollup_summary_t* summary);
+
+/**
+ * @brief 获取汇总统计信息
+ * @param stats 统计信息结构指针
+ */
+void db_rollup_get_statistics(db_rollup_statistics_t* stats);
+
+#endif /* DB_ROLLUP_H */
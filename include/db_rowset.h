@@ -0,0 +1,124 @@
+/**
+ * @file db_rowset.h
+ * @brief 列式查询结果模块头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 查询结果按列连续存放在调用方提供的内存区（arena）中：
+ * id和时间戳为32位整数，温度、湿度为0.01单位的定点数，学号和
+ * 传感器名称在结果集内去重后以序号引用。所有列数组和字符串
+ * 都从同一块arena顺序分配，db_rowset_free()一次回退即全部释放，
+ * 不逐格分配、不产生堆碎片。
+ *
+ * 读取列值使用DB_ROWSET_*宏，行号从0开始，不做越界检查。
+ */
+
+#ifndef DB_ROWSET_H
+#define DB_ROWSET_H
+
+#include "config.h"
+#include "database.h"
+
+/* 顺序分配内存区 */
+typedef struct {
+    uint8_t* base;                          /* 缓冲区起始地址 */
+    uint32_t capacity;                      /* 缓冲区大小 */
+    uint32_t used;                          /* 已分配字节数 */
+} db_arena_t;
+
+/* 列式结果集 */
+typedef struct {
+    sensor_type_t type;                     /* 数据类型（决定哪些列有效） */
+    uint32_t row_count;                     /* 行数 */
+    uint32_t row_capacity;                  /* 列数组容量 */
+    bool truncated;                         /* 因行数上限或arena空间不足未读完 */
+
+    /* 公共列 */
+    int32_t* id;                            /* 自增主键 */
+    uint16_t* student_id;                   /* 学号（字符串序号） */
+    uint16_t* sensor_name;                  /* 传感器名称（字符串序号） */
+    uint32_t* timestamp;                    /* 时间戳 */
+
+    /* 传感器1列（传感器2结果集为NULL） */
+    int16_t* temperature;                   /* 温度，0.01℃ */
+    uint16_t* humidity;                     /* 湿度，0.01% */
+
+    /* 传感器2列（传感器1结果集为NULL） */
+    uint8_t* interrupt_type;                /* 中断类型 */
+    uint32_t* interrupt_count;              /* 中断次数 */
+    uint32_t* first_timestamp;              /* 首个事件时间戳 */
+
+    /* 去重字符串表 */
+    const char** strings;                   /* 序号 -> 字符串 */
+    uint16_t string_count;                  /* 字符串个数 */
+    uint16_t* string_slots;                 /* 开放寻址散列表（序号+1，0为空） */
+
+    db_arena_t* arena;                      /* 所属arena */
+    uint32_t arena_mark;                    /* 查询前arena位置，释放时回退到此 */
+} db_rowset_t;
+
+/* 列访问宏 */
+#define DB_ROWSET_ID(rs, row)               ((rs)->id[row])
+#define DB_ROWSET_STUDENT_ID(rs, row)       ((rs)->strings[(rs)->student_id[row]])
+#define DB_ROWSET_SENSOR_NAME(rs, row)      ((rs)->strings[(rs)->sensor_name[row]])
+#define DB_ROWSET_TIMESTAMP(rs, row)        ((rs)->timestamp[row])
+#define DB_ROWSET_TEMPERATURE_FIXED(rs, row) ((rs)->temperature[row])
+#define DB_ROWSET_TEMPERATURE(rs, row)      ((float)(rs)->temperature[row] / DB_ROWSET_FIXED_SCALE)
+#define DB_ROWSET_HUMIDITY_FIXED(rs, row)   ((rs)->humidity[row])
+#define DB_ROWSET_HUMIDITY(rs, row)         ((float)(rs)->humidity[row] / DB_ROWSET_FIXED_SCALE)
+#define DB_ROWSET_INTERRUPT_TYPE(rs, row)   ((interrupt_type_t)(rs)->interrupt_type[row])
+#define DB_ROWSET_INTERRUPT_COUNT(rs, row)  ((rs)->interrupt_count[row])
+#define DB_ROWSET_FIRST_TIMESTAMP(rs, row)  ((rs)->first_timestamp[row])
+
+/* 函数声明 */
+
+/**
+ * @brief 初始化内存区
+ * @param arena 内存区
+ * @param buffer 缓冲区（由调用方提供，通常为静态数组）
+ * @param size 缓冲区大小
+ */
+void db_arena_init(db_arena_t* arena, void* buffer, uint32_t size);
+
+/**
+ * @brief 从内存区分配（4字节对齐）
+ * @param arena 内存区
+ * @param size 字节数
+ * @return void* 分配到的地址，空间不足返回NULL
+ */
+void* db_arena_alloc(db_arena_t* arena, uint32_t size);
+
+/**
+ * @brief 释放内存区中的全部分配
+ * @param arena 内存区
+ */
+void db_arena_reset(db_arena_t* arena);
+
+/**
+ * @brief 查询传感器数据到列式结果集（按created_at倒序）
+ * @param rowset 结果集
+ * @param arena 结果集使用的内存区
+ * @param type 数据类型（决定查询的表）
+ * @param student_id 学号（NULL或空串查询全部）
+ * @param max_rows 最大行数（0表示按arena剩余空间尽量多读）
+ * @return db_result_t 查询结果，affected_rows为读出的行数
+ */
+db_result_t db_rowset_query(db_rowset_t* rowset, db_arena_t* arena, sensor_type_t type,
+                            const char* student_id, uint32_t max_rows);
+
+/**
+ * @brief 释放结果集（arena回退到查询前的位置）
+ * @param rowset 结果集
+ */
+void db_rowset_free(db_rowset_t* rowset);
+
+/* 常量定义 */
+#define DB_ROWSET_FIXED_SCALE       100.0f  /* 定点数比例（0.01单位） */
+#ifndef DB_ROWSET_MAX_STRINGS
+#define DB_ROWSET_MAX_STRINGS       128     /* 结果集内不同字符串的最大个数 */
+#endif
+#define DB_ROWSET_HASH_SLOTS        (DB_ROWSET_MAX_STRINGS * 2)
+#define DB_ROWSET_STRING_RESERVE_SHIFT 3    /* max_rows为0时留给字符串的arena比例（1/8） */
+
+#endif /* DB_ROWSET_H */
@@ -0,0 +1,72 @@
+/**
+ * @file db_stream.h
+ * @brief 传感器数据流式读取模块头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 按自增主键id升序只进读取一张表，每次读出固定条数到调用方
+ * 提供的缓冲区。每批是一条独立的键集查询（从上一批最后一行的
+ * id之后继续，不使用OFFSET，按学号读取时走(student_key, id)索引），
+ * 批与批之间不持有数据库游标，内存占用与总行数无关，第一批立即返回。
+ *
+ * 读到末尾之前新写入的行id大于当前位置，仍会被读到。
+ */
+
+#ifndef DB_STREAM_H
+#define DB_STREAM_H
+
+#include "config.h"
+#include "database.h"
+
+/* 读出的一行 */
+typedef struct {
+    uint32_t id;                            /* 自增主键 */
+    sensor_data_t data;                     /* 传感器数据 */
+} db_stream_row_t;
+
+/* 流式读取状态 */
+typedef struct {
+    sensor_type_t type;                     /* 读取的表 */
+    char student_id[MAX_STUDENT_ID_LEN];    /* 学号过滤（空串表示全部） */
+    uint32_t last_id;                       /* 已读出的最后一行的id */
+    uint16_t batch_size;                    /* 每批条数 */
+    uint32_t rows_read;                     /* 已读出的总行数 */
+    bool open;                              /* 是否已打开 */
+    bool done;                              /* 已读完 */
+} db_stream_t;
+
+/* 函数声明 */
+
+/**
+ * @brief 打开流式读取
+ * @param stream 读取状态
+ * @param type 数据类型（决定读取的表）
+ * @param student_id 学号（NULL或空串读取全部）
+ * @param after_id 从id大于该值的行开始（0表示从头读取）
+ * @param batch_size 每批条数（1~DB_STREAM_MAX_BATCH）
+ * @return db_result_t 操作结果
+ */
+db_result_t db_stream_open(db_stream_t* stream, sensor_type_t type, const char* student_id,
+                           uint32_t after_id, uint16_t batch_size);
+
+/**
+ * @brief 读取下一批
+ * @param stream 读取状态
+ * @param rows 输出缓冲区（至少batch_size条）
+ * @param count 输出本批条数，0表示已读完
+ * @return db_result_t 操作结果（失败时位置不变，可重试）
+ */
+db_result_t db_stream_next_batch(db_stream_t* stream, db_stream_row_t* rows, uint16_t* count);
+
+/**
+ * @brief 关闭流式读取
+ * @param stream 读取状态
+ */
+void db_stream_close(db_stream_t* stream);
+
+/* 常量定义 */
+#define DB_STREAM_MAX_BATCH         1000    /* 每批最大条数 */
+#define DB_STREAM_DEFAULT_BATCH     64
+
+#endif /* DB_STREAM_H */
@@ -0,0 +1,146 @@
+/**
+ * @file db_wal.h
+ * @brief 数据库断线预写日志模块头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 数据库不可用时，待写入的行追加到磁盘上的分段日志，恢复连接后按
+ * 顺序回放并确认，确认过的整段日志文件被删除。
+ *
+ * 日志由若干段文件<dir>/<prefix>_NNNNNNNN.log组成，每条记录为
+ * 12字节记录头（序号、长度、标记、CRC32C，小端）加一条sensor_data_t。
+ * 追加只写当前段，写满后换到下一段；每次初始化都从新段开始追加，
+ * 因此掉电造成的半条记录只会出现在旧段末尾，扫描时遇到CRC错误即
+ * 跳到下一段。已确认的序号和首段号保存在检查点文件<prefix>.ckpt中
+ * （先写临时文件再改名，改名前掉电时从临时文件恢复）。两者都无效时从
+ * 最小的已有段开始按未确认回放（可能重复写入少量已落库的行）；日志
+ * 排空后段号从1重新开始，所以只需从段1向上探测。追加时不会截断已存在
+ * 的段文件。
+ *
+ * 追加的记录按组同步：累计sync_rows条或距第一条未同步记录超过
+ * sync_interval毫秒时才fflush并fsync一次。记录内容是本机sensor_data_t的原始字节，
+ * 日志只能由同一固件版本回放（长度不符的记录视为损坏）。
+ */
+
+#ifndef DB_WAL_H
+#define DB_WAL_H
+
+#include "config.h"
+#include "database.h"
+
+/* 日志配置 */
+typedef struct {
+    const char* directory;                  /* 日志目录（必须已存在） */
+    const char* prefix;                     /* 文件名前缀 */
+    uint32_t segment_size;                  /* 单段最大字节数 */
+    uint16_t sync_rows;                     /* 累计多少条同步一次（1表示每条同步） */
+    uint32_t sync_interval;                 /* 有未同步记录时的最长同步间隔（毫秒），0表示不限 */
+} db_wal_config_t;
+
+/* 日志统计 */
+typedef struct {
+    uint32_t appended_count;                /* 追加的记录数 */
+    uint32_t sync_count;                    /* fsync次数 */
+    uint32_t replayed_count;                /* 读出待回放的记录数（含重读） */
+    uint32_t acked_count;                   /* 确认的记录数 */
+    uint32_t corrupt_count;                 /* 扫描时遇到的损坏记录数 */
+    uint32_t pending_count;                 /* 未确认的记录数 */
+    uint32_t first_segment;                 /* 最旧的段号 */
+    uint32_t active_segment;                /* 正在追加的段号 */
+    uint32_t acked_lsn;                     /* 已确认的最大序号 */
+} db_wal_statistics_t;
+
+/* 函数声明 */
+
+/**
+ * @brief 打开日志：读取检查点，扫描已有的段并定位回放位置
+ * @param config 日志配置（NULL使用默认配置）
+ * @return system_status_t 初始化状态
+ */
+system_status_t db_wal_init(const db_wal_config_t* config);
+
+/**
+ * @brief 追加一条记录（达到sync_rows时同步）
+ * @param data 传感器数据
+ * @param lsn 输出记录序号（可为NULL）
+ * @return db_result_t 追加结果
+ */
+db_result_t db_wal_append(const sensor_data_t* data, uint32_t* lsn);
+
+/**
+ * @brief 从最早未确认的记录开始读出至多max_rows条，不改变确认位置
+ * @param rows 输出数据缓冲区
+ * @param max_rows 缓冲区条数
+ * @param last_lsn 输出读出的最后一条记录序号（可为NULL）
+ * @return uint16_t 读出的条数
+ */
+uint16_t db_wal_peek(sensor_data_t* rows, uint16_t max_rows, uint32_t* last_lsn);
+
+/**
+ * @brief 从上一次peek读出的最后一条之后继续读出至多max_rows条，不改变确认位置
+ *        （批量回放：连续读出积压的记录，全部落库后一次确认；之前没有peek时同db_wal_peek）
+ * @param rows 输出数据缓冲区
+ * @param max_rows 缓冲区条数
+ * @param last_lsn 输出读出的最后一条记录序号（可为NULL）
+ * @return uint16_t 读出的条数，0表示已读到末尾
+ */
+uint16_t db_wal_peek_next(sensor_data_t* rows, uint16_t max_rows, uint32_t* last_lsn);
+
+/**
+ * @brief 确认序号不大于lsn的记录已落库，删除完全确认的段并写检查点
+ * @param lsn 已落库的最大记录序号
+ * @return system_status_t 操作状态
+ */
+system_status_t db_wal_ack(uint32_t lsn);
+
+/**
+ * @brief 获取未确认的记录数
+ * @return uint32_t 未确认的记录数
+ */
+uint32_t db_wal_pending(void);
+
+/**
+ * @brief 有未同步记录且距第一条未同步记录超过sync_interval时同步（在主循环中周期调用）
+ * @param now 当前毫秒计时（get_tick_ms()）
+ */
+void db_wal_poll(uint32_t now);
+
+/**
+ * @brief 立即同步已追加的记录
+ * @return system_status_t 操作状态
+ */
+system_status_t db_wal_sync(void);
+
+/**
+ * @brief 同步并关闭日志
+ */
+void db_wal_close(void);
+
+/**
+ * @brief 获取日志统计信息
+ * @param stats 统计信息结构指针
+ */
+void db_wal_get_statistics(db_wal_statistics_t* stats);
+
+/* 常量定义 */
+#ifndef DB_WAL_DIRECTORY
+#define DB_WAL_DIRECTORY            "."
+#endif
+#ifndef DB_WAL_PREFIX
+#define DB_WAL_PREFIX               "sensor_wal"
+#endif
+#define DB_WAL_DEFAULT_SEGMENT_SIZE 262144UL /* 256KB，约3000条 */
+#define DB_WAL_DEFAULT_SYNC_ROWS    16
+#define DB_WAL_DEFAULT_SYNC_INTERVAL 100    /* 毫秒 */
+#define DB_WAL_PATH_SIZE            96
+#define DB_WAL_RECORD_HEADER_SIZE   12
+#define DB_WAL_REPLAY_BATCH         32      /* 每次回放（一个事务）的最大条数 */
+#ifndef DB_WAL_RECOVERY_PROBE
+#define DB_WAL_RECOVERY_PROBE       1024    /* 没有检查点时最多探测的段号 */
+#endif
+
+/* 默认配置 */
+extern const db_wal_config_t DEFAULT_DB_WAL_CONFIG;
+
+#endif /* DB_WAL_H */
@@ -0,0 +1,127 @@
+/**
+ * @file db_writer.h
+ * @brief 数据库异步写入队列模块头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 解析路径只把数据放入有界队列（多生产者：主循环、合并窗口回调、
+ * 工作线程均可入队），由唯一的写入者（主循环或写入线程）取出后
+ * 交给写入函数落库。数据库阻塞或重连时只是队列变长，不会阻塞
+ * UART接收。队列满时按配置丢弃新数据、丢弃最旧数据或等待。
+ *
+ * 入队和出队在ENTER_CRITICAL/EXIT_CRITICAL内完成，写入函数在临界区
+ * 外调用；宿主机多线程构建需把临界区宏定义为互斥锁操作。
+ *
+ * 等待超时和延迟统计以get_tick_ms()的毫秒计（旧版IAR构建没有时钟时
+ * 延迟为0，等待只在腾出空间后结束）。
+ */
+
+#ifndef DB_WRITER_H
+#define DB_WRITER_H
+
+#include "config.h"
+#include "database.h"
+
+/* 队列满时的处理方式 */
+typedef enum {
+    DB_WRITER_DROP_NEWEST = 0,              /* 丢弃新数据 */
+    DB_WRITER_DROP_OLDEST = 1,              /* 丢弃最旧的未写入数据 */
+    DB_WRITER_BLOCK = 2                     /* 等待写入线程腾出空间，超时后丢弃新数据 */
+} db_writer_full_policy_t;
+
+/* 写入方式 */
+typedef enum {
+    DB_WRITER_MAIN_LOOP = 0,                /* 由db_writer_poll()在主循环写入 */
+    DB_WRITER_WORKER = 1                    /* 由写入线程循环调用db_writer_drain() */
+} db_writer_delivery_t;
+
+/* 写入函数：把一条数据落库（如db_batch_add或database_insert_sensor_data） */
+typedef db_result_t (*db_writer_sink_t)(const sensor_data_t* data);
+
+/* 写入队列配置 */
+typedef struct {
+    uint16_t queue_depth;                   /* 队列深度（1~DB_WRITER_MAX_DEPTH） */
+    uint16_t batch_size;                    /* 主循环每次最多写入条数 */
+    db_writer_full_policy_t full_policy;    /* 队列满时的处理方式 */
+    uint32_t block_timeout;                 /* DB_WRITER_BLOCK的最长等待时间（毫秒） */
+    db_writer_delivery_t delivery;          /* 写入方式 */
+} db_writer_config_t;
+
+/* 写入队列统计 */
+typedef struct {
+    uint32_t enqueued_count;                /* 入队条数 */
+    uint32_t written_count;                 /* 写入成功条数 */
+    uint32_t failed_count;                  /* 写入失败条数 */
+    uint32_t dropped_count;                 /* 因队列满丢弃的条数 */
+    uint32_t blocked_count;                 /* 入队时等待过的次数 */
+    uint16_t queue_length;                  /* 当前队列长度 */
+    uint16_t max_queue_length;              /* 队列长度峰值 */
+    uint32_t latency_last;                  /* 最近一条的入队到写完延迟（毫秒） */
+    uint32_t latency_max;                   /* 最大延迟 */
+    uint32_t latency_avg;                   /* 平滑平均延迟（1/8指数平均） */
+} db_writer_statistics_t;
+
+/* 函数声明 */
+
+/**
+ * @brief 初始化写入队列
+ * @param config 队列配置（NULL使用默认配置）
+ * @return system_status_t 初始化状态
+ */
+system_status_t db_writer_init(const db_writer_config_t* config);
+
+/**
+ * @brief 设置写入函数
+ * @param sink 写入函数（NULL恢复为database_insert_sensor_data）
+ */
+void db_writer_set_sink(db_writer_sink_t sink);
+
+/**
+ * @brief 数据入队（复制数据，不访问数据库）
+ * @param data 传感器数据
+ * @return system_status_t SYSTEM_OK已入队；SYSTEM_BUSY队列满被丢弃；SYSTEM_TIMEOUT等待超时被丢弃
+ */
+system_status_t db_writer_enqueue(const sensor_data_t* data);
+
+/**
+ * @brief 主循环写入：最多写入batch_size条（DB_WRITER_WORKER方式下不做任何事）
+ * @return uint16_t 本次写入（含失败）的条数
+ */
+uint16_t db_writer_poll(void);
+
+/**
+ * @brief 写入线程调用：最多写入max_rows条
+ * @param max_rows 最多写入条数
+ * @return uint16_t 本次写入（含失败）的条数
+ */
+uint16_t db_writer_drain(uint16_t max_rows);
+
+/**
+ * @brief 写完队列中所有数据（关闭前调用）
+ * @return uint16_t 本次写入（含失败）的条数
+ */
+uint16_t db_writer_flush(void);
+
+/**
+ * @brief 获取写入队列统计信息
+ * @param stats 统计信息结构指针
+ */
+void db_writer_get_statistics(db_writer_statistics_t* stats);
+
+/* 常量定义 */
+#ifndef DB_WRITER_MAX_DEPTH
+#define DB_WRITER_MAX_DEPTH         16      /* 队列最大深度（静态分配，每项约64字节） */
+#endif
+#define DB_WRITER_DEFAULT_BATCH     4       /* 主循环每次写入条数 */
+#define DB_WRITER_DEFAULT_TIMEOUT   10      /* 默认等待时间（毫秒） */
+
+/* 等待队列空间时的让出操作，宿主机多线程构建可定义为sched_yield() */
+#ifndef DB_WRITER_YIELD
+#define DB_WRITER_YIELD()           do { } while (0)
+#endif
+
+/* 默认配置 */
+extern const db_writer_config_t DEFAULT_DB_WRITER_CONFIG;
+
+#endif /* DB_WRITER_H */
@@ -0,0 +1,87 @@
+/**
+ * @file sensor_aggregate.h
+ * @brief 传感器滚动统计模块头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 按(学号, 传感器名)维护滑动窗口内的计数、最小值、最大值、
+ * 均值和方差（Welford算法）。每个窗口划分为固定数量的子桶，
+ * 单条数据更新为O(1)，查询时合并窗口覆盖的子桶。
+ *
+ * 窗口以秒计，样本按到达时间归桶（由get_tick_ms()累加的秒数），不使用
+ * 数据中的timestamp（get_timestamp()的调用计数）。查询以当前时间为基准；
+ * 时钟回退时落入已轮转子桶的迟到样本被丢弃，不覆盖更新的统计。
+ */
+
+#ifndef SENSOR_AGGREGATE_H
+#define SENSOR_AGGREGATE_H
+
+#include "config.h"
+#include "sensor_data.h"
+
+/* 窗口统计结果 */
+typedef struct {
+    uint32_t window_length;                 /* 窗口长度（秒） */
+    uint32_t count;                         /* 样本数 */
+    float min;                              /* 最小值 */
+    float max;                              /* 最大值 */
+    float mean;                             /* 均值 */
+    float variance;                         /* 总体方差 */
+} sensor_aggregate_t;
+
+/* 函数声明 */
+
+/**
+ * @brief 初始化滚动统计模块
+ * @return system_status_t 初始化状态
+ */
+system_status_t sensor_aggregate_init(void);
+
+/**
+ * @brief 配置滑动窗口长度（会清空已有统计）
+ * @param lengths 窗口长度数组（秒）
+ * @param count 窗口数量（不超过SENSOR_AGG_WINDOW_COUNT）
+ * @return system_status_t 操作状态
+ */
+system_status_t sensor_aggregate_set_windows(const uint32_t* lengths, uint8_t count);
+
+/**
+ * @brief 用一条有效传感器数据更新滚动统计
+ * @param data 传感器数据
+ */
+void sensor_aggregate_update(const sensor_data_t* data);
+
+/**
+ * @brief 获取传感器滚动统计
+ * @param student_id 学号
+ * @param sensor_name 传感器名称
+ * @param metric 统计指标
+ * @param window_index 窗口序号（0起）
+ * @param aggregate 输出统计结果
+ * @return system_status_t 操作状态，无该传感器数据时返回SYSTEM_ERROR
+ */
+system_status_t get_sensor_aggregate(const char* student_id, const char* sensor_name,
+                                     sensor_metric_t metric, uint8_t window_index,
+                                     sensor_aggregate_t* aggregate);
+
+/**
+ * @brief 获取已跟踪的传感器数量
+ * @return uint32_t 传感器数量
+ */
+uint32_t sensor_aggregate_get_sensor_count(void);
+
+/* 常量定义 */
+#ifndef SENSOR_AGG_MAX_SENSORS
+#define SENSOR_AGG_MAX_SENSORS      8           /* 最大跟踪传感器数（2的幂），网关可重定义 */
+#endif
+#define SENSOR_AGG_WINDOW_COUNT     3           /* 窗口数量 */
+#define SENSOR_AGG_BUCKETS          6           /* 每个窗口的子桶数量 */
+#define SENSOR_AGG_METRIC_SLOTS     2           /* 每个传感器的指标槽数 */
+
+/* 默认窗口长度（秒） */
+#define SENSOR_AGG_WINDOW_1MIN      60
+#define SENSOR_AGG_WINDOW_5MIN      300
+#define SENSOR_AGG_WINDOW_1HOUR     3600
+
+#endif /* SENSOR_AGGREGATE_H */
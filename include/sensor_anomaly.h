@@ -0,0 +1,117 @@
+/**
+ * @file sensor_anomaly.h
+ * @brief 传感器流式异常检测模块头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 每个传感器维护EWMA均值和方差，按z分数和变化率判定状态，
+ * 单条数据O(1)更新，每传感器内存固定。预热阶段（样本不足）
+ * 和索引表已满无法跟踪的传感器回退到固定阈值判定。
+ * 变化率和中断事件间隔按get_tick_ms()到达时间计算。
+ */
+
+#ifndef SENSOR_ANOMALY_H
+#define SENSOR_ANOMALY_H
+
+#include "config.h"
+#include "sensor_data.h"
+
+/* 异常原因 */
+typedef enum {
+    ANOMALY_REASON_NONE = 0,
+    ANOMALY_REASON_ZSCORE = 1,              /* 偏离EWMA均值过大 */
+    ANOMALY_REASON_RATE = 2,                /* 变化率过大 */
+    ANOMALY_REASON_RANGE = 3                /* 预热阶段或未跟踪时超出固定阈值 */
+} anomaly_reason_t;
+
+/* 检测配置 */
+typedef struct {
+    float alpha;                            /* EWMA平滑系数（0~1） */
+    float z_threshold;                      /* z分数告警阈值 */
+    float max_temperature_rate;             /* 温度最大变化率（每秒） */
+    float max_humidity_rate;                /* 湿度最大变化率（每秒） */
+    uint16_t warmup_samples;                /* 预热样本数 */
+} sensor_anomaly_config_t;
+
+/* 异常告警信息 */
+typedef struct {
+    const char* student_id;                 /* 学号 */
+    const char* sensor_name;                /* 传感器名称 */
+    sensor_metric_t metric;                 /* 异常指标 */
+    anomaly_reason_t reason;                /* 异常原因 */
+    float value;                            /* 当前值（中断为事件间隔，毫秒） */
+    float mean;                             /* EWMA均值（未跟踪的传感器为0） */
+    uint32_t timestamp;                     /* 时间戳 */
+} sensor_anomaly_alert_t;
+
+/* 检测统计 */
+typedef struct {
+    uint32_t evaluated_count;               /* 评估样本数 */
+    uint32_t anomaly_count;                 /* 异常样本数 */
+    uint32_t untracked_count;               /* 索引表满未跟踪（只做固定阈值检查）的样本数 */
+    uint32_t tracked_sensors;               /* 跟踪中的传感器数 */
+} sensor_anomaly_statistics_t;
+
+/* 函数声明 */
+
+/**
+ * @brief 初始化异常检测模块
+ * @return system_status_t 初始化状态
+ */
+system_status_t sensor_anomaly_init(void);
+
+/**
+ * @brief 设置检测配置
+ * @param config 检测配置
+ * @return system_status_t 操作状态
+ */
+system_status_t sensor_anomaly_set_config(const sensor_anomaly_config_t* config);
+
+/**
+ * @brief 评估传感器1数据并更新检测器
+ * @param data 传感器1数据（时间戳需已设置）
+ * @return sensor_status_t 判定状态
+ */
+sensor_status_t sensor_anomaly_evaluate_sensor1(const sensor1_data_t* data);
+
+/**
+ * @brief 评估传感器2数据并更新检测器
+ * @param data 传感器2数据（时间戳需已设置）
+ * @return sensor_status_t 判定状态
+ */
+sensor_status_t sensor_anomaly_evaluate_sensor2(const sensor2_data_t* data);
+
+/**
+ * @brief 设置异常告警回调函数
+ * @param callback 回调函数指针
+ */
+void sensor_anomaly_set_alert_callback(void (*callback)(const sensor_anomaly_alert_t* alert));
+
+/**
+ * @brief 获取检测统计信息
+ * @param stats 统计信息结构指针
+ */
+void sensor_anomaly_get_statistics(sensor_anomaly_statistics_t* stats);
+
+/* 常量定义 */
+#ifndef SENSOR_ANOMALY_MAX_SENSORS
+#define SENSOR_ANOMALY_MAX_SENSORS      64      /* 最大跟踪传感器数（2的幂），网关可重定义 */
+#endif
+#define SENSOR_ANOMALY_DEFAULT_ALPHA    0.05f   /* 默认EWMA平滑系数 */
+#define SENSOR_ANOMALY_DEFAULT_Z        4.0f    /* 默认z分数阈值 */
+#define SENSOR_ANOMALY_DEFAULT_T_RATE   5.0f    /* 默认温度变化率上限 */
+#define SENSOR_ANOMALY_DEFAULT_H_RATE   20.0f   /* 默认湿度变化率上限 */
+#define SENSOR_ANOMALY_DEFAULT_WARMUP   20      /* 默认预热样本数 */
+#define SENSOR_ANOMALY_MIN_RATE_INTERVAL 1000   /* 计算变化率的最短间隔（毫秒） */
+
+/* 预热阶段（及未跟踪传感器）固定阈值 */
+#define ANOMALY_WARMUP_TEMP_LOW         -20.0f
+#define ANOMALY_WARMUP_TEMP_HIGH        60.0f
+#define ANOMALY_WARMUP_HUMID_LOW        10.0f
+#define ANOMALY_WARMUP_HUMID_HIGH       90.0f
+
+/* 默认配置 */
+extern const sensor_anomaly_config_t DEFAULT_SENSOR_ANOMALY_CONFIG;
+
+#endif /* SENSOR_ANOMALY_H */
@@ -0,0 +1,75 @@
+/**
+ * @file sensor_coalesce.h
+ * @brief 中断事件合并模块头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 按(学号, 传感器名, 中断类型)在时间窗口内累计中断事件，窗口长度按
+ * get_tick_ms()到达时间计算（与解析速率无关）。
+ * 每个窗口只输出一条记录：interrupt_count为窗口内真实事件数，
+ * first_timestamp/timestamp为窗口内首个和最后一个事件的时间。
+ */
+
+#ifndef SENSOR_COALESCE_H
+#define SENSOR_COALESCE_H
+
+#include "config.h"
+#include "sensor_data.h"
+
+/* 合并统计 */
+typedef struct {
+    uint32_t events_in;                     /* 输入事件数 */
+    uint32_t rows_out;                      /* 输出记录数 */
+    uint32_t bypass_count;                  /* 索引表满未合并的事件数 */
+    uint32_t pending_windows;               /* 当前未关闭的窗口数 */
+} sensor_coalesce_statistics_t;
+
+/* 函数声明 */
+
+/**
+ * @brief 初始化中断事件合并模块
+ * @param window_length 合并窗口长度（毫秒）
+ * @return system_status_t 初始化状态
+ */
+system_status_t sensor_coalesce_init(uint32_t window_length);
+
+/**
+ * @brief 设置合并窗口输出回调函数
+ * @param callback 回调函数指针，每个关闭的窗口调用一次
+ */
+void sensor_coalesce_set_output_callback(void (*callback)(const sensor2_data_t* data));
+
+/**
+ * @brief 将一个中断事件加入合并窗口
+ * @param data 传感器2数据
+ * @return bool 已被合并返回true；无法跟踪时返回false，调用方应直接存储
+ */
+bool sensor_coalesce_add(const sensor2_data_t* data);
+
+/**
+ * @brief 输出所有已到期的窗口
+ * @param now 当前毫秒计时（get_tick_ms()）
+ * @return uint32_t 输出的记录数
+ */
+uint32_t sensor_coalesce_flush(uint32_t now);
+
+/**
+ * @brief 输出所有未关闭的窗口（关机前调用）
+ * @return uint32_t 输出的记录数
+ */
+uint32_t sensor_coalesce_flush_all(void);
+
+/**
+ * @brief 获取合并统计信息
+ * @param stats 统计信息结构指针
+ */
+void sensor_coalesce_get_statistics(sensor_coalesce_statistics_t* stats);
+
+/* 常量定义 */
+#ifndef SENSOR_COALESCE_MAX_KEYS
+#define SENSOR_COALESCE_MAX_KEYS        16      /* 最大合并键数（2的幂） */
+#endif
+#define SENSOR_COALESCE_DEFAULT_WINDOW  1000    /* 默认合并窗口长度（毫秒） */
+
+#endif /* SENSOR_COALESCE_H */
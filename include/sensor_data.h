@@ -28,7 +28,8 @@ typedef struct {
     interrupt_type_t interrupt_type;        /* 中断类型 */
     uint32_t interrupt_count;               /* 中断次数 */
     sensor_status_t status;                 /* 传感器状态 */
-    uint32_t timestamp;                     /* 时间戳 */
+    uint32_t first_timestamp;               /* 首个事件时间戳（合并窗口起点） */
+    uint32_t timestamp;                     /* 时间戳（最后一个事件） */
 } sensor2_data_t;
 
 /* 通用传感器数据结构 */
@@ -40,6 +41,13 @@ typedef struct {
     } data;
 } sensor_data_t;
 
+/* 传感器指标 */
+typedef enum {
+    SENSOR_METRIC_TEMPERATURE = 0,          /* 温度（传感器1） */
+    SENSOR_METRIC_HUMIDITY = 1,             /* 湿度（传感器1） */
+    SENSOR_METRIC_INTERRUPT = 2             /* 中断（传感器2） */
+} sensor_metric_t;
+
 /* 数据解析结果结构 */
 typedef struct {
     bool is_valid;                          /* 数据是否有效 */
@@ -79,6 +87,20 @@ parse_result_t parse_sensor2_data(const char* data_str, sensor2_data_t* sensor_d
  */
 parse_result_t parse_sensor_data(const char* data_str, sensor_data_t* sensor_data);
 
+/**
+ * @brief 自动识别并解析传感器数据，统计计入指定分片
+ * @param data_str 输入数据字符串
+ * @param sensor_data 输出传感器数据结构
+ * @param stats_shard 统计分片号（每个串口独占一个）
+ * @return parse_result_t 解析结果
+ * @note 只在单线程中调用（主循环）：只有解析计数按分片累加，解析成功后的
+ *       聚合、异常检测、分发队列和数据回调都使用共享状态且不加锁，多个串口
+ *       的数据须在同一线程中依次解析，分片只用于分别统计各串口。
+ *       parse_sensor_data()等价于使用分片0
+ */
+parse_result_t parse_sensor_data_on_shard(const char* data_str, sensor_data_t* sensor_data,
+                                          uint8_t stats_shard);
+
 /**
  * @brief 验证传感器1数据有效性
  * @param sensor_data 传感器数据结构
@@ -128,7 +150,7 @@ system_status_t format_sensor2_data(const sensor2_data_t* sensor_data,
                                    char* buffer, size_t buffer_size);
 
 /**
- * @brief 计算数据校验和
+ * @brief 计算数据校验和（CRC16-CCITT）
  * @param data 数据指针
  * @param length 数据长度
  * @return uint16_t 校验和
@@ -137,10 +159,18 @@ uint16_t calculate_checksum(const uint8_t* data, size_t length);
 
 /**
  * @brief 获取当前时间戳
- * @return uint32_t 时间戳
+ * @return uint32_t 时间戳（每次调用加1的计数，不是时间）
  */
 uint32_t get_timestamp(void);
 
+/**
+ * @brief 获取毫秒计时（模块中的超时、间隔和耗时统一使用）
+ * @return uint32_t 毫秒数，约49.7天回绕一次，比较时用无符号差值
+ * @note 宿主机为CLOCK_MONOTONIC，目标板为HAL_GetTick()（SysTick），旧版IAR
+ *       构建为clock()（需要目标工程提供时钟，不支持时恒为0）
+ */
+uint32_t get_tick_ms(void);
+
 /**
  * @brief 重置传感器数据统计
  */
@@ -157,6 +187,9 @@ void get_sensor_statistics(uint32_t* total_count, uint32_t* valid_count, uint32_
 /**
  * @brief 设置传感器数据回调函数
  * @param callback 回调函数指针
+ * @note 启用ENABLE_SENSOR_DISPATCH时回调不再在解析路径上同步调用，
+ *       而是作为订阅者由sensor_dispatch_poll()批量投递；多个消费者请使用
+ *       sensor_dispatch_subscribe()
  */
 void set_sensor_data_callback(void (*callback)(const sensor_data_t* data));
 
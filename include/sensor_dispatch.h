@@ -0,0 +1,127 @@
+/**
+ * @file sensor_dispatch.h
+ * @brief 传感器数据多订阅者分发模块头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 解析成功的数据只入队，不在解析路径上调用订阅者。每个订阅者
+ * 拥有独立的有界队列、丢弃策略和过滤条件，由主循环或工作线程
+ * 批量投递，慢订阅者不会阻塞UART接收或其他订阅者。
+ */
+
+#ifndef SENSOR_DISPATCH_H
+#define SENSOR_DISPATCH_H
+
+#include "config.h"
+#include "sensor_data.h"
+
+/* 队列满时的丢弃策略 */
+typedef enum {
+    DISPATCH_DROP_NEWEST = 0,               /* 丢弃新数据 */
+    DISPATCH_DROP_OLDEST = 1                /* 丢弃最旧的未投递数据 */
+} dispatch_drop_policy_t;
+
+/* 投递方式 */
+typedef enum {
+    DISPATCH_DELIVER_MAIN_LOOP = 0,         /* 由sensor_dispatch_poll()在主循环投递 */
+    DISPATCH_DELIVER_WORKER = 1             /* 由工作线程调用sensor_dispatch_drain()投递 */
+} dispatch_delivery_t;
+
+/* 订阅过滤条件 */
+typedef struct {
+    uint8_t type_mask;                      /* 类型掩码 DISPATCH_TYPE_BIT(type)，0表示全部 */
+    uint8_t status_mask;                    /* 状态掩码 DISPATCH_STATUS_BIT(status)，0表示全部 */
+    char student_id[MAX_STUDENT_ID_LEN];    /* 学号，空串表示全部 */
+} dispatch_filter_t;
+
+/* 批量投递处理函数 */
+typedef void (*dispatch_handler_t)(const sensor_data_t* items, uint16_t count, void* context);
+
+/* 订阅者配置 */
+typedef struct {
+    const char* name;                       /* 订阅者名称（用于日志） */
+    dispatch_handler_t handler;             /* 批量处理函数 */
+    void* context;                          /* 处理函数上下文 */
+    dispatch_filter_t filter;               /* 过滤条件 */
+    uint16_t queue_depth;                   /* 队列深度 */
+    uint16_t batch_size;                    /* 单批最大条数 */
+    dispatch_drop_policy_t drop_policy;     /* 丢弃策略 */
+    dispatch_delivery_t delivery;           /* 投递方式 */
+} dispatch_subscriber_config_t;
+
+/* 订阅者统计 */
+typedef struct {
+    uint32_t enqueued_count;                /* 入队条数 */
+    uint32_t delivered_count;               /* 已投递条数 */
+    uint32_t dropped_count;                 /* 丢弃条数 */
+    uint32_t batch_count;                   /* 投递批次数 */
+    uint16_t queue_length;                  /* 当前队列长度 */
+    uint16_t max_queue_length;              /* 队列长度峰值 */
+} dispatch_statistics_t;
+
+/* 函数声明 */
+
+/**
+ * @brief 初始化分发模块（清空所有订阅者）
+ * @return system_status_t 初始化状态
+ */
+system_status_t sensor_dispatch_init(void);
+
+/**
+ * @brief 添加订阅者
+ * @param config 订阅者配置
+ * @return int8_t 订阅者ID，失败返回-1
+ */
+int8_t sensor_dispatch_subscribe(const dispatch_subscriber_config_t* config);
+
+/**
+ * @brief 移除订阅者（未投递的数据被丢弃；可在处理函数中调用，正在投递的批次照常结束）
+ * @param subscriber_id 订阅者ID
+ * @return system_status_t 操作状态
+ */
+system_status_t sensor_dispatch_unsubscribe(int8_t subscriber_id);
+
+/**
+ * @brief 发布一条数据到所有匹配的订阅者队列
+ * @param data 传感器数据
+ * @return uint8_t 入队的订阅者数量
+ */
+uint8_t sensor_dispatch_publish(const sensor_data_t* data);
+
+/**
+ * @brief 主循环投递：为每个主循环订阅者投递至多一批数据
+ * @return uint32_t 本次投递的数据条数
+ */
+uint32_t sensor_dispatch_poll(void);
+
+/**
+ * @brief 工作线程投递：为指定订阅者投递数据
+ * @param subscriber_id 订阅者ID
+ * @param max_batches 最多投递批次数
+ * @return uint32_t 本次投递的数据条数
+ */
+uint32_t sensor_dispatch_drain(int8_t subscriber_id, uint16_t max_batches);
+
+/**
+ * @brief 获取订阅者统计信息
+ * @param subscriber_id 订阅者ID
+ * @param stats 统计信息结构指针
+ * @return system_status_t 操作状态
+ */
+system_status_t sensor_dispatch_get_statistics(int8_t subscriber_id, dispatch_statistics_t* stats);
+
+/* 过滤掩码宏 */
+#define DISPATCH_TYPE_BIT(type)         ((uint8_t)(1u << (type)))
+#define DISPATCH_STATUS_BIT(status)     ((uint8_t)(1u << (status)))
+
+/* 常量定义 */
+#ifndef SENSOR_DISPATCH_MAX_SUBSCRIBERS
+#define SENSOR_DISPATCH_MAX_SUBSCRIBERS     4       /* 最大订阅者数 */
+#endif
+#ifndef SENSOR_DISPATCH_MAX_QUEUE_DEPTH
+#define SENSOR_DISPATCH_MAX_QUEUE_DEPTH     8       /* 单个订阅者最大队列深度 */
+#endif
+#define SENSOR_DISPATCH_DEFAULT_BATCH       4       /* 默认单批条数 */
+
+#endif /* SENSOR_DISPATCH_H */
@@ -0,0 +1,88 @@
+/**
+ * @file sensor_filter.h
+ * @brief 传感器死区过滤模块头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 位于数据解析和数据库存储之间：只有当数值相对上次存储值的变化
+ * 超过死区阈值、状态发生变化或超过最大静默间隔时才存储，
+ * 其余样本被抑制并计数。
+ */
+
+#ifndef SENSOR_FILTER_H
+#define SENSOR_FILTER_H
+
+#include "config.h"
+#include "sensor_data.h"
+
+/* 过滤配置 */
+typedef struct {
+    float temperature_deadband;             /* 温度死区（摄氏度） */
+    float humidity_deadband;                /* 湿度死区（百分比） */
+    uint32_t max_silence;                   /* 最大静默间隔（毫秒，按到达时间），0表示不限制 */
+} sensor_filter_config_t;
+
+/* 过滤统计 */
+typedef struct {
+    uint32_t passed_count;                  /* 放行样本数 */
+    uint32_t suppressed_count;              /* 抑制样本数 */
+    uint32_t heartbeat_count;               /* 因静默超时放行的样本数 */
+    uint32_t untracked_count;               /* 索引表满而直接放行的样本数 */
+} sensor_filter_statistics_t;
+
+/* 函数声明 */
+
+/**
+ * @brief 初始化死区过滤模块
+ * @return system_status_t 初始化状态
+ */
+system_status_t sensor_filter_init(void);
+
+/**
+ * @brief 设置默认过滤配置
+ * @param config 过滤配置
+ * @return system_status_t 操作状态
+ */
+system_status_t sensor_filter_set_default_config(const sensor_filter_config_t* config);
+
+/**
+ * @brief 为单个传感器设置过滤配置
+ * @param student_id 学号
+ * @param sensor_name 传感器名称
+ * @param config 过滤配置
+ * @return system_status_t 操作状态
+ */
+system_status_t sensor_filter_set_sensor_config(const char* student_id, const char* sensor_name,
+                                                const sensor_filter_config_t* config);
+
+/**
+ * @brief 判断样本是否需要存储
+ * @param data 传感器数据
+ * @return bool 需要存储返回true，被抑制返回false
+ */
+bool sensor_filter_should_store(const sensor_data_t* data);
+
+/**
+ * @brief 获取过滤统计信息
+ * @param stats 统计信息结构指针
+ */
+void sensor_filter_get_statistics(sensor_filter_statistics_t* stats);
+
+/**
+ * @brief 重置过滤统计信息
+ */
+void sensor_filter_reset_statistics(void);
+
+/* 常量定义 */
+#ifndef SENSOR_FILTER_MAX_SENSORS
+#define SENSOR_FILTER_MAX_SENSORS               16      /* 最大跟踪传感器数（2的幂） */
+#endif
+#define SENSOR_FILTER_DEFAULT_TEMP_DEADBAND     0.2f    /* 默认温度死区 */
+#define SENSOR_FILTER_DEFAULT_HUMID_DEADBAND    1.0f    /* 默认湿度死区 */
+#define SENSOR_FILTER_DEFAULT_MAX_SILENCE       300000  /* 默认最大静默间隔（毫秒） */
+
+/* 默认配置 */
+extern const sensor_filter_config_t DEFAULT_SENSOR_FILTER_CONFIG;
+
+#endif /* SENSOR_FILTER_H */
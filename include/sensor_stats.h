@@ -0,0 +1,82 @@
+/**
+ * @file sensor_stats.h
+ * @brief 传感器解析统计分片计数模块头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 每个解析线程（或串口）独占一个按缓存行填充的计数分片，写入时
+ * 不需要原子操作，也不会与其他分片争用缓存行。分片内用序号锁
+ * （seqlock）保证读取到的total/valid/error三者一致，读取时汇总
+ * 所有分片。
+ *
+ * 约定：同一分片只能有一个写入者；读取和重置应由同一个上下文
+ * （如统计打印任务）执行，且不能在会打断写入者的中断中调用。
+ */
+
+#ifndef SENSOR_STATS_H
+#define SENSOR_STATS_H
+
+#include "config.h"
+
+/* 统计快照 */
+typedef struct {
+    uint32_t total_count;                   /* 总数据包数 */
+    uint32_t valid_count;                   /* 有效数据包数 */
+    uint32_t error_count;                   /* 错误数据包数 */
+} sensor_stats_snapshot_t;
+
+/* 函数声明 */
+
+/**
+ * @brief 初始化统计模块（清零所有分片）
+ * @return system_status_t 初始化状态
+ */
+system_status_t sensor_stats_init(void);
+
+/**
+ * @brief 记录一次解析结果
+ * @param shard 分片号（调用线程/串口独占，超出范围时取模）
+ * @param valid 解析是否成功
+ */
+void sensor_stats_record(uint8_t shard, bool valid);
+
+/**
+ * @brief 获取所有分片汇总后的一致快照
+ * @param snapshot 快照输出
+ */
+void sensor_stats_snapshot(sensor_stats_snapshot_t* snapshot);
+
+/**
+ * @brief 获取单个分片的一致快照
+ * @param shard 分片号
+ * @param snapshot 快照输出
+ * @return system_status_t 操作状态
+ */
+system_status_t sensor_stats_shard_snapshot(uint8_t shard, sensor_stats_snapshot_t* snapshot);
+
+/**
+ * @brief 重置统计（记录当前值为基线，不修改写入者的计数）
+ */
+void sensor_stats_reset(void);
+
+/* 常量定义 */
+#ifndef SENSOR_STATS_SHARD_COUNT
+    #if defined(__ICCARM__)
+        #define SENSOR_STATS_SHARD_COUNT    1       /* 单核MCU只需一个分片 */
+    #else
+        #define SENSOR_STATS_SHARD_COUNT    8       /* 汇聚主机：每个解析线程一个分片 */
+    #endif
+#endif
+
+#ifndef SENSOR_STATS_CACHE_LINE
+    #if defined(__ICCARM__)
+        #define SENSOR_STATS_CACHE_LINE     16      /* Cortex-M3无数据缓存，不需要填充 */
+    #else
+        #define SENSOR_STATS_CACHE_LINE     64      /* 主机缓存行大小 */
+    #endif
+#endif
+
+#define SENSOR_STATS_DEFAULT_SHARD  0           /* 单线程调用者使用的分片 */
+
+#endif /* SENSOR_STATS_H */
@@ -0,0 +1,88 @@
+/**
+ * @file sensor_table.h
+ * @brief 传感器键值索引表头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 以(学号, 传感器名, 附加标签)为键的开放寻址哈希索引，
+ * 各模块用返回的槽位下标访问自己的每传感器状态数组。
+ * 条目数组由调用方静态分配，模块内部不做动态内存分配。
+ */
+
+#ifndef SENSOR_TABLE_H
+#define SENSOR_TABLE_H
+
+#include "config.h"
+
+/* 索引表条目 */
+typedef struct {
+    char student_id[MAX_STUDENT_ID_LEN];    /* 学号姓名缩写 */
+    char sensor_name[MAX_SENSOR_NAME_LEN];  /* 传感器名称 */
+    uint8_t tag;                            /* 附加键（传感器类型等） */
+    bool in_use;                            /* 槽位是否占用 */
+    uint32_t hash;                          /* 键哈希值 */
+    uint32_t last_seen;                     /* 最近一次访问时间戳 */
+} sensor_table_entry_t;
+
+/* 索引表 */
+typedef struct {
+    sensor_table_entry_t* entries;          /* 条目数组（调用方提供） */
+    uint32_t capacity;                      /* 容量，必须为2的幂 */
+    uint32_t count;                         /* 已占用槽位数 */
+} sensor_table_t;
+
+/* 函数声明 */
+
+/**
+ * @brief 初始化索引表
+ * @param table 索引表
+ * @param entries 条目数组
+ * @param capacity 条目数组长度（2的幂）
+ * @return system_status_t 初始化状态
+ */
+system_status_t sensor_table_init(sensor_table_t* table, sensor_table_entry_t* entries,
+                                  uint32_t capacity);
+
+/**
+ * @brief 清空索引表
+ * @param table 索引表
+ */
+void sensor_table_clear(sensor_table_t* table);
+
+/**
+ * @brief 查找键对应的槽位
+ * @param table 索引表
+ * @param student_id 学号
+ * @param sensor_name 传感器名称
+ * @param tag 附加标签
+ * @return int32_t 槽位下标，未找到返回-1
+ */
+int32_t sensor_table_find(const sensor_table_t* table, const char* student_id,
+                          const char* sensor_name, uint8_t tag);
+
+/**
+ * @brief 查找或新建键对应的槽位
+ * @param table 索引表
+ * @param student_id 学号
+ * @param sensor_name 传感器名称
+ * @param tag 附加标签
+ * @param now 当前时间戳（记录为最近访问时间）
+ * @return int32_t 槽位下标，表满返回-1
+ */
+int32_t sensor_table_acquire(sensor_table_t* table, const char* student_id,
+                             const char* sensor_name, uint8_t tag, uint32_t now);
+
+/**
+ * @brief 计算传感器键哈希（FNV-1a）
+ * @param student_id 学号
+ * @param sensor_name 传感器名称
+ * @param tag 附加标签
+ * @return uint32_t 哈希值
+ */
+uint32_t sensor_key_hash(const char* student_id, const char* sensor_name, uint8_t tag);
+
+/* 装载上限：占用超过容量的7/8时拒绝新键，保证探测长度有界 */
+#define SENSOR_TABLE_LOAD_LIMIT(capacity)   ((capacity) - ((capacity) >> 3))
+
+#endif /* SENSOR_TABLE_H */
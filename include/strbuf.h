@@ -0,0 +1,116 @@
+/**
+ * @file strbuf.h
+ * @brief 定长缓冲区字符串构建模块头文件 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 在调用方提供的定长缓冲区上顺序追加整数、定点小数和字符串，
+ * 记录当前长度，不解析格式串，不依赖printf。空间不足时置溢出
+ * 标志并停止追加，缓冲区始终以'\0'结尾。
+ */
+
+#ifndef STRBUF_H
+#define STRBUF_H
+
+#include "config.h"
+
+/* 字符串构建器 */
+typedef struct {
+    char* data;                             /* 缓冲区（调用方提供） */
+    size_t capacity;                        /* 缓冲区大小（含结尾'\0'） */
+    size_t length;                          /* 当前长度 */
+    bool overflow;                          /* 是否发生过截断 */
+} strbuf_t;
+
+/* 函数声明 */
+
+/**
+ * @brief 初始化构建器
+ * @param sb 构建器
+ * @param buffer 缓冲区
+ * @param capacity 缓冲区大小
+ */
+void strbuf_init(strbuf_t* sb, char* buffer, size_t capacity);
+
+/**
+ * @brief 清空构建器内容（保留缓冲区）
+ * @param sb 构建器
+ */
+void strbuf_reset(strbuf_t* sb);
+
+/**
+ * @brief 回退到指定长度并清除溢出标志（用于撤销部分追加）
+ * @param sb 构建器
+ * @param length 目标长度（不大于当前长度，内容在此之前均完整）
+ */
+void strbuf_truncate(strbuf_t* sb, size_t length);
+
+/**
+ * @brief 追加字符串
+ * @param sb 构建器
+ * @param str 字符串（NULL按空串处理）
+ * @return bool 是否完整追加
+ */
+bool strbuf_append_str(strbuf_t* sb, const char* str);
+
+/**
+ * @brief 追加指定长度的字节
+ * @param sb 构建器
+ * @param data 数据
+ * @param length 长度
+ * @return bool 是否完整追加
+ */
+bool strbuf_append_mem(strbuf_t* sb, const char* data, size_t length);
+
+/**
+ * @brief 追加单个字符
+ * @param sb 构建器
+ * @param c 字符
+ * @return bool 是否追加成功
+ */
+bool strbuf_append_char(strbuf_t* sb, char c);
+
+/**
+ * @brief 追加无符号十进制整数
+ * @param sb 构建器
+ * @param value 数值
+ * @return bool 是否完整追加
+ */
+bool strbuf_append_uint(strbuf_t* sb, uint32_t value);
+
+/**
+ * @brief 追加有符号十进制整数
+ * @param sb 构建器
+ * @param value 数值
+ * @return bool 是否完整追加
+ */
+bool strbuf_append_int(strbuf_t* sb, int32_t value);
+
+/**
+ * @brief 追加定点小数（四舍五入，.5远离0取整，与"%.Nf"仅在恰好.5处可能不同）
+ * @param sb 构建器
+ * @param value 数值
+ * @param decimals 小数位数（0~STRBUF_MAX_DECIMALS）
+ * @return bool 是否完整追加，数值超出范围或非有限值时返回false
+ */
+bool strbuf_append_fixed(strbuf_t* sb, float value, uint8_t decimals);
+
+/**
+ * @brief 追加8位大写十六进制数
+ * @param sb 构建器
+ * @param value 数值
+ * @return bool 是否完整追加
+ */
+bool strbuf_append_hex32(strbuf_t* sb, uint32_t value);
+
+/* 内联访问宏 */
+#define strbuf_length(sb)       ((sb)->length)
+#define strbuf_cstr(sb)         ((const char*)(sb)->data)
+#define strbuf_ok(sb)           (!(sb)->overflow)
+
+/* 常量定义 */
+#define STRBUF_MAX_DECIMALS     6           /* 定点小数最大位数 */
+#define STRBUF_UINT_DIGITS      10          /* uint32_t最大十进制位数 */
+
+#endif /* STRBUF_H */
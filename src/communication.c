@@ -7,6 +7,8 @@
  */
 
 #include "communication.h"
+#include "crc.h"
+#include "strbuf.h"
 #include <stdarg.h>
 
 /* 静态变量 */
@@ -50,6 +52,7 @@ static void uart_hardware_init(const comm_config_t* config);
 static void uart_enable_interrupts(void);
 static void uart_disable_interrupts(void);
 static uint32_t get_system_tick(void);
+static bool parse_hex32(const char* str, uint32_t* value);
 
 /**
  * @brief 初始化通信模块
@@ -273,6 +276,85 @@ system_status_t communication_receive_line(char* buffer, uint16_t buffer_size, u
     return SYSTEM_OK;
 }
 
+/**
+ * @brief 校验一帧数据的CRC32C后缀并去除后缀
+ */
+system_status_t communication_verify_frame(char* line)
+{
+    char* delimiter;
+    uint32_t expected;
+    size_t payload_length;
+    
+    if (line == NULL) {
+        set_last_error(COMM_ERROR_INVALID_PARAM);
+        return SYSTEM_ERROR;
+    }
+    
+    delimiter = strrchr(line, COMM_FRAME_CRC_DELIMITER);
+    if (delimiter == NULL) {
+        /* 旧设备不带CRC；分隔符本身损坏的帧也会走到这里 */
+        statistics.frame_unchecked_count++;
+        if (COMM_FRAME_CRC_REQUIRED) {
+            set_last_error(COMM_ERROR_CRC);
+            return SYSTEM_ERROR;
+        }
+        
+        /* 放行时限频记录，便于发现本端口上的旧设备或损坏的帧 */
+        if ((statistics.frame_unchecked_count - 1) % COMM_FRAME_UNCHECKED_LOG_EVERY == 0) {
+            INFO_PRINT("%s: frame without CRC accepted unchecked (%lu so far): %s",
+                       COMM_PORT_NAME, (unsigned long)statistics.frame_unchecked_count, line);
+        }
+        return SYSTEM_OK;
+    }
+    
+    payload_length = (size_t)(delimiter - line);
+    if (!parse_hex32(delimiter + 1, &expected) ||
+        crc32c((const uint8_t*)line, payload_length) != expected) {
+        statistics.frame_crc_error_count++;
+        set_last_error(COMM_ERROR_CRC);
+        return SYSTEM_ERROR;
+    }
+    
+    /* 去掉CRC后缀，只把负载交给解析 */
+    *delimiter = '\0';
+    statistics.frame_crc_ok_count++;
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 附加CRC32C后缀并发送一帧数据
+ */
+system_status_t communication_send_frame(const char* payload)
+{
+    char suffix[1 + COMM_FRAME_CRC_HEX_LEN + sizeof(COMM_LINE_ENDING)];
+    strbuf_t sb;
+    uint32_t crc;
+    size_t length;
+    
+    if (payload == NULL) {
+        set_last_error(COMM_ERROR_INVALID_PARAM);
+        return SYSTEM_ERROR;
+    }
+    
+    length = strlen(payload);
+    crc = crc32c((const uint8_t*)payload, length);
+    
+    strbuf_init(&sb, suffix, sizeof(suffix));
+    strbuf_append_char(&sb, COMM_FRAME_CRC_DELIMITER);
+    strbuf_append_hex32(&sb, crc);
+    strbuf_append_str(&sb, COMM_LINE_ENDING);
+    
+    if (get_tx_buffer_space() < length + strlen(suffix)) {
+        set_last_error(COMM_ERROR_BUFFER_FULL);
+        return SYSTEM_ERROR;
+    }
+    
+    if (communication_send((const uint8_t*)payload, (uint16_t)length) != SYSTEM_OK) {
+        return SYSTEM_ERROR;
+    }
+    return communication_send_string(suffix);
+}
+
 /**
  * @brief 检查是否有数据可读
  */
@@ -555,6 +637,9 @@ static void set_last_error(comm_error_t error)
         case COMM_ERROR_INVALID_PARAM:
             ERROR_PRINT("Communication invalid parameter");
             break;
+        case COMM_ERROR_CRC:
+            ERROR_PRINT("Communication frame CRC mismatch");
+            break;
         default:
             break;
     }
@@ -745,4 +830,36 @@ static uint32_t get_system_tick(void)
     /* 简化的时间实现 */
     static uint32_t tick_count = 0;
     return ++tick_count;
+}
+
+/**
+ * @brief 解析8位十六进制数
+ */
+static bool parse_hex32(const char* str, uint32_t* value)
+{
+    uint32_t result = 0;
+    int i;
+    
+    for (i = 0; i < COMM_FRAME_CRC_HEX_LEN; i++) {
+        char c = str[i];
+        
+        result <<= 4;
+        if (c >= '0' && c <= '9') {
+            result |= (uint32_t)(c - '0');
+        } else if (c >= 'A' && c <= 'F') {
+            result |= (uint32_t)(c - 'A' + 10);
+        } else if (c >= 'a' && c <= 'f') {
+            result |= (uint32_t)(c - 'a' + 10);
+        } else {
+            return false;
+        }
+    }
+    
+    /* 后缀之后不允许有其他字符 */
+    if (str[COMM_FRAME_CRC_HEX_LEN] != '\0') {
+        return false;
+    }
+    
+    *value = result;
+    return true;
 }
\ No newline at end of file
@@ -0,0 +1,450 @@
+/**
+ * @file crc.c
+ * @brief CRC校验模块实现 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ */
+
+#include "crc.h"
+
+#ifdef CRC32C_HW_SSE42
+#include <nmmintrin.h>
+#endif
+
+/* CRC32C查表（反射多项式0x82F63B78），同时作为slice-by-8的第0张表 */
+static const uint32_t CRC32C_TABLE[256] = {
+    0x00000000UL, 0xF26B8303UL, 0xE13B70F7UL, 0x1350F3F4UL,
+    0xC79A971FUL, 0x35F1141CUL, 0x26A1E7E8UL, 0xD4CA64EBUL,
+    0x8AD958CFUL, 0x78B2DBCCUL, 0x6BE22838UL, 0x9989AB3BUL,
+    0x4D43CFD0UL, 0xBF284CD3UL, 0xAC78BF27UL, 0x5E133C24UL,
+    0x105EC76FUL, 0xE235446CUL, 0xF165B798UL, 0x030E349BUL,
+    0xD7C45070UL, 0x25AFD373UL, 0x36FF2087UL, 0xC494A384UL,
+    0x9A879FA0UL, 0x68EC1CA3UL, 0x7BBCEF57UL, 0x89D76C54UL,
+    0x5D1D08BFUL, 0xAF768BBCUL, 0xBC267848UL, 0x4E4DFB4BUL,
+    0x20BD8EDEUL, 0xD2D60DDDUL, 0xC186FE29UL, 0x33ED7D2AUL,
+    0xE72719C1UL, 0x154C9AC2UL, 0x061C6936UL, 0xF477EA35UL,
+    0xAA64D611UL, 0x580F5512UL, 0x4B5FA6E6UL, 0xB93425E5UL,
+    0x6DFE410EUL, 0x9F95C20DUL, 0x8CC531F9UL, 0x7EAEB2FAUL,
+    0x30E349B1UL, 0xC288CAB2UL, 0xD1D83946UL, 0x23B3BA45UL,
+    0xF779DEAEUL, 0x05125DADUL, 0x1642AE59UL, 0xE4292D5AUL,
+    0xBA3A117EUL, 0x4851927DUL, 0x5B016189UL, 0xA96AE28AUL,
+    0x7DA08661UL, 0x8FCB0562UL, 0x9C9BF696UL, 0x6EF07595UL,
+    0x417B1DBCUL, 0xB3109EBFUL, 0xA0406D4BUL, 0x522BEE48UL,
+    0x86E18AA3UL, 0x748A09A0UL, 0x67DAFA54UL, 0x95B17957UL,
+    0xCBA24573UL, 0x39C9C670UL, 0x2A993584UL, 0xD8F2B687UL,
+    0x0C38D26CUL, 0xFE53516FUL, 0xED03A29BUL, 0x1F682198UL,
+    0x5125DAD3UL, 0xA34E59D0UL, 0xB01EAA24UL, 0x42752927UL,
+    0x96BF4DCCUL, 0x64D4CECFUL, 0x77843D3BUL, 0x85EFBE38UL,
+    0xDBFC821CUL, 0x2997011FUL, 0x3AC7F2EBUL, 0xC8AC71E8UL,
+    0x1C661503UL, 0xEE0D9600UL, 0xFD5D65F4UL, 0x0F36E6F7UL,
+    0x61C69362UL, 0x93AD1061UL, 0x80FDE395UL, 0x72966096UL,
+    0xA65C047DUL, 0x5437877EUL, 0x4767748AUL, 0xB50CF789UL,
+    0xEB1FCBADUL, 0x197448AEUL, 0x0A24BB5AUL, 0xF84F3859UL,
+    0x2C855CB2UL, 0xDEEEDFB1UL, 0xCDBE2C45UL, 0x3FD5AF46UL,
+    0x7198540DUL, 0x83F3D70EUL, 0x90A324FAUL, 0x62C8A7F9UL,
+    0xB602C312UL, 0x44694011UL, 0x5739B3E5UL, 0xA55230E6UL,
+    0xFB410CC2UL, 0x092A8FC1UL, 0x1A7A7C35UL, 0xE811FF36UL,
+    0x3CDB9BDDUL, 0xCEB018DEUL, 0xDDE0EB2AUL, 0x2F8B6829UL,
+    0x82F63B78UL, 0x709DB87BUL, 0x63CD4B8FUL, 0x91A6C88CUL,
+    0x456CAC67UL, 0xB7072F64UL, 0xA457DC90UL, 0x563C5F93UL,
+    0x082F63B7UL, 0xFA44E0B4UL, 0xE9141340UL, 0x1B7F9043UL,
+    0xCFB5F4A8UL, 0x3DDE77ABUL, 0x2E8E845FUL, 0xDCE5075CUL,
+    0x92A8FC17UL, 0x60C37F14UL, 0x73938CE0UL, 0x81F80FE3UL,
+    0x55326B08UL, 0xA759E80BUL, 0xB4091BFFUL, 0x466298FCUL,
+    0x1871A4D8UL, 0xEA1A27DBUL, 0xF94AD42FUL, 0x0B21572CUL,
+    0xDFEB33C7UL, 0x2D80B0C4UL, 0x3ED04330UL, 0xCCBBC033UL,
+    0xA24BB5A6UL, 0x502036A5UL, 0x4370C551UL, 0xB11B4652UL,
+    0x65D122B9UL, 0x97BAA1BAUL, 0x84EA524EUL, 0x7681D14DUL,
+    0x2892ED69UL, 0xDAF96E6AUL, 0xC9A99D9EUL, 0x3BC21E9DUL,
+    0xEF087A76UL, 0x1D63F975UL, 0x0E330A81UL, 0xFC588982UL,
+    0xB21572C9UL, 0x407EF1CAUL, 0x532E023EUL, 0xA145813DUL,
+    0x758FE5D6UL, 0x87E466D5UL, 0x94B49521UL, 0x66DF1622UL,
+    0x38CC2A06UL, 0xCAA7A905UL, 0xD9F75AF1UL, 0x2B9CD9F2UL,
+    0xFF56BD19UL, 0x0D3D3E1AUL, 0x1E6DCDEEUL, 0xEC064EEDUL,
+    0xC38D26C4UL, 0x31E6A5C7UL, 0x22B65633UL, 0xD0DDD530UL,
+    0x0417B1DBUL, 0xF67C32D8UL, 0xE52CC12CUL, 0x1747422FUL,
+    0x49547E0BUL, 0xBB3FFD08UL, 0xA86F0EFCUL, 0x5A048DFFUL,
+    0x8ECEE914UL, 0x7CA56A17UL, 0x6FF599E3UL, 0x9D9E1AE0UL,
+    0xD3D3E1ABUL, 0x21B862A8UL, 0x32E8915CUL, 0xC083125FUL,
+    0x144976B4UL, 0xE622F5B7UL, 0xF5720643UL, 0x07198540UL,
+    0x590AB964UL, 0xAB613A67UL, 0xB831C993UL, 0x4A5A4A90UL,
+    0x9E902E7BUL, 0x6CFBAD78UL, 0x7FAB5E8CUL, 0x8DC0DD8FUL,
+    0xE330A81AUL, 0x115B2B19UL, 0x020BD8EDUL, 0xF0605BEEUL,
+    0x24AA3F05UL, 0xD6C1BC06UL, 0xC5914FF2UL, 0x37FACCF1UL,
+    0x69E9F0D5UL, 0x9B8273D6UL, 0x88D28022UL, 0x7AB90321UL,
+    0xAE7367CAUL, 0x5C18E4C9UL, 0x4F48173DUL, 0xBD23943EUL,
+    0xF36E6F75UL, 0x0105EC76UL, 0x12551F82UL, 0xE03E9C81UL,
+    0x34F4F86AUL, 0xC69F7B69UL, 0xD5CF889DUL, 0x27A40B9EUL,
+    0x79B737BAUL, 0x8BDCB4B9UL, 0x988C474DUL, 0x6AE7C44EUL,
+    0xBE2DA0A5UL, 0x4C4623A6UL, 0x5F16D052UL, 0xAD7D5351UL
+};
+
+/* CRC16-CCITT查表（多项式0x1021） */
+static const uint16_t CRC16_CCITT_TABLE[256] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+    0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+    0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+    0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+    0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+    0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+    0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+    0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+    0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+    0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+    0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+    0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+    0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+    0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+    0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+    0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+    0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+    0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+    0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+    0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+    0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+    0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+    0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+    0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+    0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+    0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+    0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+    0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+    0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+    0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+    0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+/* 自检数据长度：覆盖8字节对齐前后的头尾和多个整块 */
+#define CRC_SELF_TEST_LENGTH    64
+#define CRC_SELF_TEST_OFFSETS   8
+
+/* 静态变量 */
+#ifdef CRC32C_SLICE_BY_8
+static uint32_t slice_tables[8][256];
+static bool slice_tables_ready = false;
+#endif
+#ifdef CRC32C_HW_SSE42
+static bool use_sse42 = false;
+#endif
+
+/* 内部函数声明 */
+static uint32_t crc32c_bytes(uint32_t crc, const uint8_t* data, size_t length);
+static bool check_paths(const uint8_t* data, size_t length);
+#ifdef CRC32C_WORD_AT_A_TIME
+static uint32_t crc32c_words(uint32_t crc, const uint8_t* data, size_t length);
+#endif
+#ifdef CRC32C_SLICE_BY_8
+static void build_slice_tables(void);
+static uint32_t crc32c_slice8(uint32_t crc, const uint8_t* data, size_t length);
+#endif
+#ifdef CRC32C_HW_SSE42
+static uint32_t crc32c_sse42(uint32_t crc, const uint8_t* data, size_t length);
+#endif
+
+/**
+ * @brief 初始化CRC模块
+ */
+system_status_t crc_init(void)
+{
+#ifdef CRC32C_SLICE_BY_8
+    build_slice_tables();
+#endif
+
+#ifdef CRC32C_HW_SSE42
+    __builtin_cpu_init();
+    use_sse42 = __builtin_cpu_supports("sse4.2") ? true : false;
+#endif
+
+    if (crc_self_test() != SYSTEM_OK) {
+        ERROR_PRINT("CRC self test failed: CRC32C=%s", crc32c_get_implementation());
+        return SYSTEM_ERROR;
+    }
+
+    DEBUG_PRINT("CRC module initialized: CRC32C=%s", crc32c_get_implementation());
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 计算CRC32C
+ */
+uint32_t crc32c(const uint8_t* data, size_t length)
+{
+    return crc32c_update(0, data, length);
+}
+
+/**
+ * @brief 增量计算CRC32C
+ */
+uint32_t crc32c_update(uint32_t crc, const uint8_t* data, size_t length)
+{
+    if (data == NULL || length == 0) {
+        return crc;
+    }
+
+    crc = ~crc;
+
+#if defined(CRC32C_HW_SSE42)
+    if (use_sse42) {
+        return ~crc32c_sse42(crc, data, length);
+    }
+#endif
+
+#if defined(CRC32C_SLICE_BY_8)
+    if (slice_tables_ready) {
+        return ~crc32c_slice8(crc, data, length);
+    }
+    return ~crc32c_bytes(crc, data, length);
+#elif defined(CRC32C_WORD_AT_A_TIME)
+    return ~crc32c_words(crc, data, length);
+#else
+    return ~crc32c_bytes(crc, data, length);
+#endif
+}
+
+/**
+ * @brief 计算CRC16-CCITT
+ */
+uint16_t crc16_ccitt(const uint8_t* data, size_t length)
+{
+    return crc16_ccitt_update(CRC16_CCITT_INIT, data, length);
+}
+
+/**
+ * @brief 增量计算CRC16-CCITT
+ */
+uint16_t crc16_ccitt_update(uint16_t crc, const uint8_t* data, size_t length)
+{
+    size_t i;
+
+    if (data == NULL) {
+        return crc;
+    }
+
+    for (i = 0; i < length; i++) {
+        crc = (uint16_t)((crc << 8) ^ CRC16_CCITT_TABLE[((crc >> 8) ^ data[i]) & 0xFF]);
+    }
+
+    return crc;
+}
+
+/**
+ * @brief 自检
+ */
+system_status_t crc_self_test(void)
+{
+    static const uint8_t check_input[9] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    uint8_t buffer[CRC_SELF_TEST_LENGTH + CRC_SELF_TEST_OFFSETS];
+    uint32_t seed = 0x12345678UL;
+    size_t offset;
+    size_t length;
+    size_t i;
+
+    if (crc16_ccitt(check_input, sizeof(check_input)) != CRC16_CCITT_CHECK_VALUE ||
+        crc32c(check_input, sizeof(check_input)) != CRC32C_CHECK_VALUE ||
+        !check_paths(check_input, sizeof(check_input))) {
+        return SYSTEM_ERROR;
+    }
+
+    for (i = 0; i < sizeof(buffer); i++) {
+        seed = seed * 1103515245UL + 12345UL;
+        buffer[i] = (uint8_t)(seed >> 16);
+    }
+
+    /* 各种起始对齐和长度，覆盖快速路径的头、整块和尾 */
+    for (offset = 0; offset < CRC_SELF_TEST_OFFSETS; offset++) {
+        for (length = 1; length <= CRC_SELF_TEST_LENGTH; length++) {
+            if (!check_paths(buffer + offset, length)) {
+                return SYSTEM_ERROR;
+            }
+        }
+    }
+
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 获取当前使用的CRC32C实现名称
+ */
+const char* crc32c_get_implementation(void)
+{
+#if defined(CRC32C_HW_SSE42)
+    if (use_sse42) {
+        return "sse4.2";
+    }
+#endif
+#if defined(CRC32C_SLICE_BY_8)
+    return slice_tables_ready ? "slice-by-8" : "bytewise";
+#elif defined(CRC32C_WORD_AT_A_TIME)
+    return "word-at-a-time";
+#else
+    return "bytewise";
+#endif
+}
+
+/* 内部函数实现 */
+
+/**
+ * @brief 已编译的各条CRC32C路径与逐字节查表结果一致
+ */
+static bool check_paths(const uint8_t* data, size_t length)
+{
+    uint32_t expected = ~crc32c_bytes(0xFFFFFFFFUL, data, length);
+
+#ifdef CRC32C_WORD_AT_A_TIME
+    if (~crc32c_words(0xFFFFFFFFUL, data, length) != expected) {
+        return false;
+    }
+#endif
+#ifdef CRC32C_SLICE_BY_8
+    if (slice_tables_ready && ~crc32c_slice8(0xFFFFFFFFUL, data, length) != expected) {
+        return false;
+    }
+#endif
+#ifdef CRC32C_HW_SSE42
+    if (use_sse42 && ~crc32c_sse42(0xFFFFFFFFUL, data, length) != expected) {
+        return false;
+    }
+#endif
+
+    /* 对外接口走当前选中的路径，分两段增量计算也应一致 */
+    return crc32c(data, length) == expected &&
+           crc32c_update(crc32c(data, length / 2), data + length / 2, length - length / 2) == expected;
+}
+
+/**
+ * @brief 逐字节查表
+ */
+static uint32_t crc32c_bytes(uint32_t crc, const uint8_t* data, size_t length)
+{
+    while (length--) {
+        crc = CRC32C_TABLE[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#ifdef CRC32C_WORD_AT_A_TIME
+/**
+ * @brief 按32位字处理（小端目标），每字一次对齐读取加四次查表
+ */
+static uint32_t crc32c_words(uint32_t crc, const uint8_t* data, size_t length)
+{
+    /* 先处理到4字节对齐 */
+    while (length > 0 && ((size_t)data & 3u) != 0) {
+        crc = CRC32C_TABLE[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+        length--;
+    }
+
+    while (length >= 4) {
+        crc ^= *(const uint32_t*)data;
+        crc = CRC32C_TABLE[crc & 0xFF] ^ (crc >> 8);
+        crc = CRC32C_TABLE[crc & 0xFF] ^ (crc >> 8);
+        crc = CRC32C_TABLE[crc & 0xFF] ^ (crc >> 8);
+        crc = CRC32C_TABLE[crc & 0xFF] ^ (crc >> 8);
+        data += 4;
+        length -= 4;
+    }
+
+    return crc32c_bytes(crc, data, length);
+}
+#endif
+
+#ifdef CRC32C_SLICE_BY_8
+/**
+ * @brief 生成slice-by-8查表
+ */
+static void build_slice_tables(void)
+{
+    uint32_t i;
+    uint8_t k;
+
+    for (i = 0; i < 256; i++) {
+        slice_tables[0][i] = CRC32C_TABLE[i];
+    }
+
+    for (i = 0; i < 256; i++) {
+        for (k = 1; k < 8; k++) {
+            uint32_t prev = slice_tables[k - 1][i];
+            slice_tables[k][i] = CRC32C_TABLE[prev & 0xFF] ^ (prev >> 8);
+        }
+    }
+
+    slice_tables_ready = true;
+}
+
+/**
+ * @brief slice-by-8：每次处理8字节
+ */
+static uint32_t crc32c_slice8(uint32_t crc, const uint8_t* data, size_t length)
+{
+    while (length > 0 && ((size_t)data & 7u) != 0) {
+        crc = CRC32C_TABLE[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+        length--;
+    }
+
+    while (length >= 8) {
+        uint32_t lo = crc ^ ((uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+                             ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24));
+        uint32_t hi = (uint32_t)data[4] | ((uint32_t)data[5] << 8) |
+                      ((uint32_t)data[6] << 16) | ((uint32_t)data[7] << 24);
+
+        crc = slice_tables[7][lo & 0xFF] ^
+              slice_tables[6][(lo >> 8) & 0xFF] ^
+              slice_tables[5][(lo >> 16) & 0xFF] ^
+              slice_tables[4][lo >> 24] ^
+              slice_tables[3][hi & 0xFF] ^
+              slice_tables[2][(hi >> 8) & 0xFF] ^
+              slice_tables[1][(hi >> 16) & 0xFF] ^
+              slice_tables[0][hi >> 24];
+
+        data += 8;
+        length -= 8;
+    }
+
+    return crc32c_bytes(crc, data, length);
+}
+#endif
+
+#ifdef CRC32C_HW_SSE42
+/**
+ * @brief SSE4.2 crc32指令实现
+ */
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_sse42(uint32_t crc, const uint8_t* data, size_t length)
+{
+#if defined(__x86_64__)
+    uint64_t crc64;
+
+    while (length > 0 && ((size_t)data & 7u) != 0) {
+        crc = _mm_crc32_u8(crc, *data++);
+        length--;
+    }
+
+    crc64 = crc;
+    while (length >= 8) {
+        uint64_t word;
+        memcpy(&word, data, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+        data += 8;
+        length -= 8;
+    }
+    crc = (uint32_t)crc64;
+#endif
+
+    while (length >= 4) {
+        uint32_t word;
+        memcpy(&word, data, sizeof(word));
+        crc = _mm_crc32_u32(crc, word);
+        data += 4;
+        length -= 4;
+    }
+
+    while (length > 0) {
+        crc = _mm_crc32_u8(crc, *data++);
+        length--;
+    }
+
+    return crc;
+}
+#endif
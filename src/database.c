@@ -7,12 +7,99 @@
  */
 
 #include "database.h"
+#include "db_driver.h"
+#include "strbuf.h"
+#if ENABLE_DB_BACKUP
+#include "db_backup.h"
+#endif
+#if ENABLE_DB_ROLLUP
+#include "db_rollup.h"
+#endif
+#if ENABLE_DB_CACHE
+#include "db_cache.h"
+#endif
 
 /* 静态变量 */
 static db_status_t current_status = DB_STATUS_DISCONNECTED;
 static char last_error_message[256] = "";
+static int last_error_code = DB_ERROR_NONE;
 static void (*error_callback)(const char* error_msg) = NULL;
 static db_config_t current_config;
+static db_stmt_t statements[DB_STMT_COUNT];
+static uint32_t stmt_prepare_count = 0;
+static uint32_t stmt_execute_count = 0;
+static const db_driver_t* driver = DB_DEFAULT_DRIVER;
+
+/* 表行数（首次查询时COUNT一次，之后随写入和清理增减） */
+static uint32_t row_counts[DB_TABLE_COUNT];
+static int32_t pending_counts[DB_TABLE_COUNT];  /* 当前事务中未提交的增减 */
+static bool row_counts_valid = false;
+static bool in_transaction = false;
+
+#if DB_SCHEMA_VERSION >= 2
+/* 字典键缓存（学号、传感器名称→sensor_dict.dict_key），满时轮转替换 */
+typedef struct {
+    uint16_t key;                       /* 字典键，0表示空位 */
+    uint8_t kind;                       /* DB_DICT_STUDENT / DB_DICT_SENSOR */
+    char name[MAX_STUDENT_ID_LEN];      /* 名称 */
+} dict_entry_t;
+
+static dict_entry_t dict_cache[DB_DICT_CACHE_SIZE];
+static uint8_t dict_next = 0;
+#endif
+
+#if ENABLE_DB_CACHE
+/* 经过最新数据缓存查询时的行缓冲区 */
+static sensor_data_t latest_rows[DB_CACHE_DEPTH];
+#endif
+
+/* 语句模板，与db_stmt_id_t对应 */
+static const char* const STMT_SQL[DB_STMT_COUNT] = {
+    SQL_STMT_INSERT_SENSOR1,
+    SQL_STMT_INSERT_SENSOR2,
+    SQL_STMT_SELECT_SENSOR1_ALL,
+    SQL_STMT_SELECT_SENSOR1_BY_ID,
+    SQL_STMT_SELECT_SENSOR2_ALL,
+    SQL_STMT_SELECT_SENSOR2_BY_ID,
+    SQL_COUNT_SENSOR1,
+    SQL_COUNT_SENSOR2,
+    SQL_STMT_TABLE_EXISTS,
+    SQL_STMT_CLEANUP_SENSOR1,
+    SQL_STMT_CLEANUP_SENSOR2,
+    SQL_STMT_SCAN_SENSOR1,
+    SQL_STMT_SCAN_SENSOR1_BY_ID,
+    SQL_STMT_SCAN_SENSOR2,
+    SQL_STMT_SCAN_SENSOR2_BY_ID,
+    SQL_STMT_LIST_PARTITIONS,
+    SQL_STMT_CURRENT_DAY,
+    SQL_STMT_CURRENT_TIME,
+    SQL_STMT_ROLLUP_UPSERT(SQL_ROLLUP_MINUTE),
+    SQL_STMT_ROLLUP_UPSERT(SQL_ROLLUP_HOUR),
+    SQL_STMT_ROLLUP_UPSERT(SQL_ROLLUP_DAY),
+    SQL_STMT_ROLLUP_QUERY(SQL_ROLLUP_MINUTE),
+    SQL_STMT_ROLLUP_QUERY(SQL_ROLLUP_HOUR),
+    SQL_STMT_ROLLUP_QUERY(SQL_ROLLUP_DAY),
+    SQL_STMT_DICT_LOOKUP,
+    SQL_STMT_DICT_INSERT,
+    SQL_STMT_BACKUP_SENSOR1,
+    SQL_STMT_BACKUP_SENSOR2,
+    SQL_STMT_WARNING_COUNT
+};
+
+/* 驱动未提供建表语句时使用的默认（MySQL）建表语句 */
+static const char* const DEFAULT_CREATE_TABLES[] = {
+#if DB_SCHEMA_VERSION >= 2
+    SQL_CREATE_DICT_TABLE,
+#endif
+    SQL_CREATE_SENSOR1_TABLE,
+    SQL_CREATE_SENSOR2_TABLE,
+#if ENABLE_DB_ROLLUP
+    SQL_CREATE_ROLLUP_TABLE(SQL_ROLLUP_MINUTE),
+    SQL_CREATE_ROLLUP_TABLE(SQL_ROLLUP_HOUR),
+    SQL_CREATE_ROLLUP_TABLE(SQL_ROLLUP_DAY),
+#endif
+    NULL
+};
 
 /* 默认数据库配置 */
 const db_config_t DEFAULT_DB_CONFIG = {
@@ -26,11 +113,42 @@ const db_config_t DEFAULT_DB_CONFIG = {
 
 /* 内部函数声明 */
 static void set_last_error(int error_code, const char* error_msg);
+static db_result_t insert_row(const sensor_data_t* data);
+static db_result_t insert_sensor1_row(const sensor1_data_t* data);
+static db_result_t insert_sensor2_row(const sensor2_data_t* data);
 static db_result_t create_error_result(int error_code, const char* error_msg);
 static db_result_t create_success_result(uint32_t affected_rows, uint32_t insert_id);
 static bool validate_sql_injection(const char* input);
-static char* escape_string(const char* input, char* output, size_t output_size);
-static void simulate_database_delay(void);
+#if DB_SCHEMA_VERSION < 2
+static bool append_sql_string(strbuf_t* sb, const char* input);
+static bool append_bulk_string(strbuf_t* sb, const char* input);
+#endif
+static bool append_sensor1_values(strbuf_t* sb, const sensor1_data_t* data, bool bulk_line);
+static bool append_sensor2_values(strbuf_t* sb, const sensor2_data_t* data, bool bulk_line);
+static void invalidate_statements(void);
+static void release_statements(void);
+static db_result_t create_driver_error(int error_code);
+static bool prepare_statement(db_stmt_t* stmt);
+static db_param_t* get_bind_slot(db_stmt_t* stmt, uint8_t index);
+static int check_statement_ready(const db_stmt_t* stmt, const char** error_msg);
+static db_stmt_t* prepare_select(db_stmt_id_t all_id, db_stmt_id_t by_id_id,
+                                 const char* student_id, uint32_t limit);
+#if ENABLE_DB_CACHE
+static bool query_latest_cached(sensor_type_t type, const char* student_id, uint32_t limit,
+                                db_query_result_t* result);
+#endif
+static bool get_count(db_stmt_id_t id, uint32_t* count);
+static db_result_t run_transaction_op(int (*op)(void));
+static sensor_status_t read_status(const db_cursor_t* cursor, uint8_t column);
+static void reset_row_counts(void);
+static bool load_row_counts(uint32_t* counts);
+static void reset_dict_cache(void);
+#if DB_SCHEMA_VERSION >= 2
+static db_result_t resolve_dict_key(uint8_t kind, const char* name, uint16_t* key);
+static db_result_t resolve_row_keys(const char* student_id, const char* sensor_name,
+                                    uint16_t* student_key, uint16_t* sensor_key);
+static int32_t to_fixed_point(float value);
+#endif
 
 /**
  * @brief 初始化数据库模块
@@ -40,12 +158,18 @@ system_status_t database_init(void)
     /* 初始化状态 */
     current_status = DB_STATUS_DISCONNECTED;
     memset(last_error_message, 0, sizeof(last_error_message));
+    last_error_code = DB_ERROR_NONE;
     error_callback = NULL;
+    invalidate_statements();
+    stmt_prepare_count = 0;
+    stmt_execute_count = 0;
+    reset_row_counts();
+    reset_dict_cache();
     
     /* 初始化默认配置 */
     memcpy(&current_config, &DEFAULT_DB_CONFIG, sizeof(db_config_t));
     
-    DEBUG_PRINT("Database module initialized");
+    DEBUG_PRINT("Database module initialized (driver: %s)", driver->name);
     return SYSTEM_OK;
 }
 
@@ -55,6 +179,7 @@ system_status_t database_init(void)
 db_result_t database_connect(const db_config_t* config)
 {
     db_result_t result;
+    int error_code;
     
     /* 参数验证 */
     if (!is_valid_db_config(config)) {
@@ -70,17 +195,21 @@ db_result_t database_connect(const db_config_t* config)
     /* 保存配置 */
     memcpy(&current_config, config, sizeof(db_config_t));
     
-    /* 模拟数据库连接过程 */
-    DEBUG_PRINT("Connecting to database %s:%d", config->host, config->port);
-    simulate_database_delay();
-    
-    /* 在实际项目中，这里应该是真实的MySQL连接代码 */
-    /* 由于IAR 5.3环境限制，这里使用模拟实现 */
+    DEBUG_PRINT("Connecting to database %s:%d (driver: %s)", config->host, config->port, driver->name);
+    error_code = driver->connect(config);
+    if (error_code != DB_ERROR_NONE) {
+        current_status = DB_STATUS_ERROR;
+        return create_driver_error(error_code);
+    }
     
+    /* 新连接上的语句需要重新准备，行数和字典键重新读取 */
+    invalidate_statements();
+    reset_row_counts();
+    reset_dict_cache();
     current_status = DB_STATUS_CONNECTED;
     result = create_success_result(0, 0);
     
-    INFO_PRINT("Database connected successfully");
+    INFO_PRINT("Database connected successfully (%s)", driver->name);
     return result;
 }
 
@@ -93,8 +222,9 @@ db_result_t database_disconnect(void)
         return create_success_result(0, 0);
     }
     
-    /* 模拟断开连接 */
-    simulate_database_delay();
+    /* 先释放语句句柄再关闭连接 */
+    release_statements();
+    driver->disconnect();
     current_status = DB_STATUS_DISCONNECTED;
     
     DEBUG_PRINT("Database disconnected");
@@ -110,59 +240,38 @@ db_status_t database_get_status(void)
 }
 
 /**
- * @brief 插入传感器1数据到数据库
+ * @brief 检查连接是否可用
  */
-db_result_t database_insert_sensor1_data(const sensor1_data_t* data)
+db_result_t database_ping(void)
 {
-    char sql[MAX_SQL_LENGTH];
-    char escaped_id[MAX_STUDENT_ID_LEN * 2];
-    char escaped_name[MAX_SENSOR_NAME_LEN * 2];
-    
-    /* 参数检查 */
-    if (data == NULL) {
-        return create_error_result(DB_ERROR_INVALID_PARAM, "Null sensor data");
-    }
+    int error_code;
     
-    /* 连接状态检查 */
     if (current_status != DB_STATUS_CONNECTED) {
         return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
     }
     
-    /* 数据验证 */
-    if (!validate_sensor1_data(data)) {
-        return create_error_result(DB_ERROR_INVALID_PARAM, "Invalid sensor data");
-    }
-    
-    /* SQL注入防护 */
-    if (!validate_sql_injection(data->student_id) || 
-        !validate_sql_injection(data->sensor_name)) {
-        return create_error_result(DB_ERROR_INVALID_PARAM, "Invalid characters in data");
+    error_code = driver->exec(SQL_PING, NULL);
+    if (error_code != DB_ERROR_NONE) {
+        return create_driver_error(error_code);
     }
     
-    /* 转义字符串 */
-    escape_string(data->student_id, escaped_id, sizeof(escaped_id));
-    escape_string(data->sensor_name, escaped_name, sizeof(escaped_name));
-    
-    /* 构建SQL语句 */
-    sprintf(sql, SQL_INSERT_SENSOR1,
-            escaped_id,
-            escaped_name,
-            data->temperature,
-            data->humidity,
-            get_sensor_status_string(data->status),
-            data->timestamp);
-    
-    DEBUG_PRINT("Executing SQL: %s", sql);
-    
-    /* 模拟数据库插入 */
-    simulate_database_delay();
+    return create_success_result(0, 0);
+}
+
+/**
+ * @brief 插入传感器1数据到数据库
+ */
+db_result_t database_insert_sensor1_data(const sensor1_data_t* data)
+{
+    sensor_data_t row;
     
-    /* 在实际项目中，这里应该执行真实的SQL插入操作 */
-    /* 模拟成功插入 */
-    INFO_PRINT("Sensor1 data inserted: ID=%s, Temp=%.2f, Humid=%.2f", 
-               data->student_id, data->temperature, data->humidity);
+    if (data == NULL) {
+        return create_error_result(DB_ERROR_INVALID_PARAM, "Null sensor data");
+    }
     
-    return create_success_result(1, 0); /* 影响1行，插入ID由数据库自动生成 */
+    row.type = SENSOR_TYPE_TEMP_HUMIDITY;
+    row.data.sensor1 = *data;
+    return database_insert_sensor_data(&row);
 }
 
 /**
@@ -170,136 +279,262 @@ db_result_t database_insert_sensor1_data(const sensor1_data_t* data)
  */
 db_result_t database_insert_sensor2_data(const sensor2_data_t* data)
 {
-    char sql[MAX_SQL_LENGTH];
-    char escaped_id[MAX_STUDENT_ID_LEN * 2];
-    char escaped_name[MAX_SENSOR_NAME_LEN * 2];
+    sensor_data_t row;
     
-    /* 参数检查 */
     if (data == NULL) {
         return create_error_result(DB_ERROR_INVALID_PARAM, "Null sensor data");
     }
     
-    /* 连接状态检查 */
-    if (current_status != DB_STATUS_CONNECTED) {
-        return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
-    }
+    row.type = SENSOR_TYPE_INTERRUPT;
+    row.data.sensor2 = *data;
+    return database_insert_sensor_data(&row);
+}
+
+/**
+ * @brief 通用传感器数据插入
+ */
+db_result_t database_insert_sensor_data(const sensor_data_t* data)
+{
+#if ENABLE_DB_ROLLUP
+    db_result_t result;
+    db_result_t step;
+    bool own_transaction;
     
-    /* 数据验证 */
-    if (!validate_sensor2_data(data)) {
-        return create_error_result(DB_ERROR_INVALID_PARAM, "Invalid sensor data");
+    if (data == NULL) {
+        return create_error_result(DB_ERROR_INVALID_PARAM, "Null sensor data");
     }
     
-    /* SQL注入防护 */
-    if (!validate_sql_injection(data->student_id) || 
-        !validate_sql_injection(data->sensor_name)) {
-        return create_error_result(DB_ERROR_INVALID_PARAM, "Invalid characters in data");
+    /* 汇总表与数据行在同一事务中更新：调用方没有开始事务时为这一行开始一个 */
+    own_transaction = !in_transaction;
+    if (own_transaction) {
+        result = database_begin_transaction();
+        if (!result.success) {
+            return result;
+        }
     }
     
-    /* 转义字符串 */
-    escape_string(data->student_id, escaped_id, sizeof(escaped_id));
-    escape_string(data->sensor_name, escaped_name, sizeof(escaped_name));
-    
-    /* 构建SQL语句 */
-    sprintf(sql, SQL_INSERT_SENSOR2,
-            escaped_id,
-            escaped_name,
-            (int)data->interrupt_type,
-            data->interrupt_count,
-            get_sensor_status_string(data->status),
-            data->timestamp);
-    
-    DEBUG_PRINT("Executing SQL: %s", sql);
-    
-    /* 模拟数据库插入 */
-    simulate_database_delay();
-    
-    /* 在实际项目中，这里应该执行真实的SQL插入操作 */
-    /* 模拟成功插入 */
-    INFO_PRINT("Sensor2 data inserted: ID=%s, Sensor=%s, IntType=%d", 
-               data->student_id, data->sensor_name, data->interrupt_type);
+    result = insert_row(data);
+    if (result.success) {
+        step = db_rollup_add(data);
+        if (!step.success) {
+            result = step;
+        }
+    }
     
-    return create_success_result(1, 0); /* 影响1行，插入ID由数据库自动生成 */
+    if (own_transaction) {
+        if (result.success) {
+            step = database_commit_transaction();
+            if (!step.success) {
+                result = step;
+            }
+        }
+        if (!result.success) {
+            database_rollback_transaction();
+        }
+    }
+    return result;
+#else
+    return insert_row(data);
+#endif
 }
 
 /**
- * @brief 通用传感器数据插入
+ * @brief 检查一行传感器数据能否写入
  */
-db_result_t database_insert_sensor_data(const sensor_data_t* data)
+db_result_t database_check_sensor_row(const sensor_data_t* data)
 {
+    const char* student_id;
+    const char* sensor_name;
+    bool valid;
+    
     if (data == NULL) {
         return create_error_result(DB_ERROR_INVALID_PARAM, "Null sensor data");
     }
     
     switch (data->type) {
         case SENSOR_TYPE_TEMP_HUMIDITY:
-            return database_insert_sensor1_data(&data->data.sensor1);
+            valid = validate_sensor1_data(&data->data.sensor1);
+            student_id = data->data.sensor1.student_id;
+            sensor_name = data->data.sensor1.sensor_name;
+            break;
             
         case SENSOR_TYPE_INTERRUPT:
-            return database_insert_sensor2_data(&data->data.sensor2);
+            valid = validate_sensor2_data(&data->data.sensor2);
+            student_id = data->data.sensor2.student_id;
+            sensor_name = data->data.sensor2.sensor_name;
+            break;
             
         default:
             return create_error_result(DB_ERROR_INVALID_PARAM, "Unknown sensor type");
     }
+    
+    if (!valid) {
+        return create_error_result(DB_ERROR_INVALID_PARAM, "Invalid sensor data");
+    }
+    
+    /* SQL注入防护 */
+    if (!validate_sql_injection(student_id) || !validate_sql_injection(sensor_name)) {
+        return create_error_result(DB_ERROR_INVALID_PARAM, "Invalid characters in data");
+    }
+    
+    return create_success_result(0, 0);
 }
 
 /**
- * @brief 查询传感器1数据
+ * @brief 解析一行数据引用的字典键
  */
-db_query_result_t database_query_sensor1_data(const char* student_id, uint32_t limit)
+db_result_t database_resolve_sensor_row(const sensor_data_t* data)
 {
-    db_query_result_t result;
-    char sql[MAX_SQL_LENGTH];
+#if DB_SCHEMA_VERSION >= 2
+    uint16_t student_key;
+    uint16_t sensor_key;
     
-    /* 初始化结果 */
-    memset(&result, 0, sizeof(db_query_result_t));
+    if (data == NULL) {
+        return create_error_result(DB_ERROR_INVALID_PARAM, "Null sensor data");
+    }
+    if (current_status != DB_STATUS_CONNECTED) {
+        return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
+    }
+    
+    if (data->type == SENSOR_TYPE_TEMP_HUMIDITY) {
+        return resolve_row_keys(data->data.sensor1.student_id, data->data.sensor1.sensor_name,
+                                &student_key, &sensor_key);
+    }
+    return resolve_row_keys(data->data.sensor2.student_id, data->data.sensor2.sensor_name,
+                            &student_key, &sensor_key);
+#else
+    (void)data;
+    return create_success_result(0, 0);
+#endif
+}
+
+/**
+ * @brief 追加一行传感器数据的VALUES元组
+ */
+bool database_append_sensor_values(strbuf_t* sb, const sensor_data_t* data)
+{
+    if (sb == NULL || data == NULL) {
+        return false;
+    }
+    
+    if (data->type == SENSOR_TYPE_TEMP_HUMIDITY) {
+        return append_sensor1_values(sb, &data->data.sensor1, false);
+    }
+    return append_sensor2_values(sb, &data->data.sensor2, false);
+}
+
+/**
+ * @brief 追加一行传感器数据的批量装载行
+ */
+bool database_append_sensor_line(strbuf_t* sb, const sensor_data_t* data)
+{
+    if (sb == NULL || data == NULL) {
+        return false;
+    }
+    
+    if (data->type == SENSOR_TYPE_TEMP_HUMIDITY) {
+        return append_sensor1_values(sb, &data->data.sensor1, true);
+    }
+    return append_sensor2_values(sb, &data->data.sensor2, true);
+}
+
+/**
+ * @brief 执行多行INSERT语句
+ */
+db_result_t database_execute_insert(const char* sql, uint32_t row_count)
+{
+    int error_code;
+    
+    /* 参数检查 */
+    if (sql == NULL || row_count == 0) {
+        return create_error_result(DB_ERROR_INVALID_PARAM, "Empty insert statement");
+    }
     
     /* 连接状态检查 */
     if (current_status != DB_STATUS_CONNECTED) {
-        set_last_error(DB_ERROR_CONNECTION, "Database not connected");
-        return result;
+        return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
     }
     
-    /* 构建SQL语句 */
-    if (student_id != NULL && strlen(student_id) > 0) {
-        if (!validate_sql_injection(student_id)) {
-            set_last_error(DB_ERROR_INVALID_PARAM, "Invalid student ID");
-            return result;
-        }
-        sprintf(sql, SQL_SELECT_SENSOR1_BY_ID, student_id);
-    } else {
-        strcpy(sql, SQL_SELECT_SENSOR1_ALL);
+    DEBUG_PRINT("Executing insert (%lu rows): %s", row_count, sql);
+    
+    /* 多行INSERT是单条语句，要么全部写入要么全部失败 */
+    error_code = driver->exec(sql, NULL);
+    if (error_code != DB_ERROR_NONE) {
+        return create_driver_error(error_code);
     }
     
-    /* 添加限制条件 */
-    if (limit > 0) {
-        char limit_clause[32];
-        sprintf(limit_clause, " LIMIT %lu", limit);
-        strcat(sql, limit_clause);
+    database_adjust_row_count((strncmp(sql, SQL_INSERT_SENSOR1, sizeof(SQL_INSERT_SENSOR1) - 1) == 0) ?
+                     DB_TABLE_SENSOR1 : DB_TABLE_SENSOR2, (int32_t)row_count);
+    return create_success_result(row_count, 0);
+}
+
+/**
+ * @brief 从暂存文件批量装载一张表
+ */
+db_result_t database_bulk_load(uint8_t table, const char* path, uint32_t row_count, bool defer_indexes)
+{
+    char sql[SQL_BULK_LOAD_SIZE];
+    strbuf_t sb;
+    uint32_t loaded = 0;
+    uint32_t warnings = 0;
+    int error_code;
+    
+    /* 参数检查 */
+    if (table >= DB_TABLE_COUNT || path == NULL || path[0] == '\0' || row_count == 0) {
+        return create_error_result(DB_ERROR_INVALID_PARAM, "Invalid bulk load parameters");
     }
     
-    DEBUG_PRINT("Executing query: %s", sql);
+    /* 连接状态检查 */
+    if (current_status != DB_STATUS_CONNECTED) {
+        return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
+    }
     
-    /* 模拟数据库查询 */
-    simulate_database_delay();
+    DEBUG_PRINT("Bulk loading %lu rows from %s", row_count, path);
     
-    /* 在实际项目中，这里应该执行真实的SQL查询操作 */
-    /* 模拟查询结果 */
-    result.row_count = 0;
-    result.column_count = 7; /* id, student_id, sensor_name, temperature, humidity, status, timestamp */
-    result.data = NULL;
-    result.column_names = NULL;
+    if (driver->bulk_load != NULL) {
+        error_code = driver->bulk_load(table, path, defer_indexes);
+    } else {
+        /* 默认方言：一条LOAD DATA语句。InnoDB推迟索引需要删除并重建索引，
+         * 其DDL会隐式提交调用方的事务，因此不推迟，忽略defer_indexes */
+        strbuf_init(&sb, sql, sizeof(sql));
+        strbuf_append_str(&sb, SQL_BULK_LOAD_PREFIX);
+        strbuf_append_str(&sb, path);
+        strbuf_append_str(&sb, (table == DB_TABLE_SENSOR1) ? SQL_BULK_LOAD_SENSOR1 : SQL_BULK_LOAD_SENSOR2);
+        if (!strbuf_ok(&sb) || strchr(path, '\'') != NULL) {
+            return create_error_result(DB_ERROR_INVALID_PARAM, "Invalid bulk load path");
+        }
+        
+        error_code = driver->exec(strbuf_cstr(&sb), &loaded);
+        if (error_code != DB_ERROR_NONE) {
+            return create_driver_error(error_code);
+        }
+        
+        /* LOCAL装载按IGNORE处理：重复键的行被跳过、无法转换的值被截断，都只产生
+         * 警告。行数不符或有警告时失败，由调用方回滚，数据仍在原来的来源中 */
+        if (!get_count(DB_STMT_WARNING_COUNT, &warnings)) {
+            return create_error_result(DB_ERROR_QUERY, "Bulk load warning count query failed");
+        }
+        if (loaded != row_count || warnings != 0) {
+            ERROR_PRINT("Bulk load of %s: %lu of %lu rows loaded, %lu warnings", path,
+                        loaded, row_count, warnings);
+            return create_error_result(DB_ERROR_INSERT, "Bulk load skipped or converted rows");
+        }
+    }
+    if (error_code != DB_ERROR_NONE) {
+        return create_driver_error(error_code);
+    }
     
-    INFO_PRINT("Sensor1 data query completed: %lu rows", result.row_count);
-    return result;
+    database_adjust_row_count(table, (int32_t)row_count);
+    return create_success_result(row_count, 0);
 }
 
 /**
- * @brief 查询传感器2数据
+ * @brief 查询传感器1数据
  */
-db_query_result_t database_query_sensor2_data(const char* student_id, uint32_t limit)
+db_query_result_t database_query_sensor1_data(const char* student_id, uint32_t limit)
 {
     db_query_result_t result;
-    char sql[MAX_SQL_LENGTH];
+    db_stmt_t* stmt;
     
     /* 初始化结果 */
     memset(&result, 0, sizeof(db_query_result_t));
@@ -310,318 +545,1055 @@ db_query_result_t database_query_sensor2_data(const char* student_id, uint32_t l
         return result;
     }
     
-    /* 构建SQL语句 */
-    if (student_id != NULL && strlen(student_id) > 0) {
-        if (!validate_sql_injection(student_id)) {
-            set_last_error(DB_ERROR_INVALID_PARAM, "Invalid student ID");
-            return result;
-        }
-        sprintf(sql, SQL_SELECT_SENSOR2_BY_ID, student_id);
-    } else {
-        strcpy(sql, SQL_SELECT_SENSOR2_ALL);
+    stmt = prepare_select(DB_STMT_SELECT_SENSOR1_ALL, DB_STMT_SELECT_SENSOR1_BY_ID, student_id, limit);
+    if (stmt == NULL) {
+        return result;
     }
     
-    /* 添加限制条件 */
-    if (limit > 0) {
-        char limit_clause[32];
-        sprintf(limit_clause, " LIMIT %lu", limit);
-        strcat(sql, limit_clause);
+#if ENABLE_DB_CACHE
+    if (query_latest_cached(SENSOR_TYPE_TEMP_HUMIDITY, student_id, limit, &result)) {
+        result.column_count = driver->column_count(stmt);
+        DEBUG_PRINT("Sensor1 data query served from cache: %lu rows", result.row_count);
+        return result;
     }
+#endif
     
-    DEBUG_PRINT("Executing query: %s", sql);
+    result = db_stmt_query(stmt);
     
-    /* 模拟数据库查询 */
-    simulate_database_delay();
-    
-    /* 在实际项目中，这里应该执行真实的SQL查询操作 */
-    /* 模拟查询结果 */
-    result.row_count = 0;
-    result.column_count = 7; /* id, student_id, sensor_name, interrupt_type, interrupt_count, status, timestamp */
-    result.data = NULL;
-    result.column_names = NULL;
-    
-    INFO_PRINT("Sensor2 data query completed: %lu rows", result.row_count);
+    INFO_PRINT("Sensor1 data query completed: %lu rows", result.row_count);
     return result;
 }
 
 /**
- * @brief 执行自定义SQL查询
+ * @brief 查询传感器2数据
  */
-db_query_result_t database_execute_query(const char* sql)
+db_query_result_t database_query_sensor2_data(const char* student_id, uint32_t limit)
 {
     db_query_result_t result;
+    db_stmt_t* stmt;
     
     /* 初始化结果 */
     memset(&result, 0, sizeof(db_query_result_t));
     
-    /* 参数检查 */
-    if (sql == NULL || strlen(sql) == 0) {
-        set_last_error(DB_ERROR_INVALID_PARAM, "Empty SQL statement");
-        return result;
-    }
-    
     /* 连接状态检查 */
     if (current_status != DB_STATUS_CONNECTED) {
         set_last_error(DB_ERROR_CONNECTION, "Database not connected");
         return result;
     }
     
-    DEBUG_PRINT("Executing custom query: %s", sql);
+    stmt = prepare_select(DB_STMT_SELECT_SENSOR2_ALL, DB_STMT_SELECT_SENSOR2_BY_ID, student_id, limit);
+    if (stmt == NULL) {
+        return result;
+    }
     
-    /* 模拟数据库查询 */
-    simulate_database_delay();
+#if ENABLE_DB_CACHE
+    if (query_latest_cached(SENSOR_TYPE_INTERRUPT, student_id, limit, &result)) {
+        result.column_count = driver->column_count(stmt);
+        DEBUG_PRINT("Sensor2 data query served from cache: %lu rows", result.row_count);
+        return result;
+    }
+#endif
     
-    /* 在实际项目中，这里应该执行真实的SQL查询操作 */
+    result = db_stmt_query(stmt);
     
+    INFO_PRINT("Sensor2 data query completed: %lu rows", result.row_count);
     return result;
 }
 
 /**
- * @brief 执行SQL更新语句
+ * @brief 获取在当前连接上已准备好的语句
  */
-db_result_t database_execute_update(const char* sql)
+db_stmt_t* database_prepare(db_stmt_id_t id)
 {
-    /* 参数检查 */
-    if (sql == NULL || strlen(sql) == 0) {
-        return create_error_result(DB_ERROR_INVALID_PARAM, "Empty SQL statement");
+    db_stmt_t* stmt;
+    
+    if ((uint32_t)id >= DB_STMT_COUNT) {
+        set_last_error(DB_ERROR_INVALID_PARAM, "Invalid statement id");
+        return NULL;
     }
     
-    /* 连接状态检查 */
     if (current_status != DB_STATUS_CONNECTED) {
-        return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
+        set_last_error(DB_ERROR_CONNECTION, "Database not connected");
+        return NULL;
     }
     
-    DEBUG_PRINT("Executing update: %s", sql);
-    
-    /* 模拟数据库更新 */
-    simulate_database_delay();
-    
-    /* 在实际项目中，这里应该执行真实的SQL更新操作 */
+    stmt = &statements[id];
+    if (!stmt->prepared && !prepare_statement(stmt)) {
+        return NULL;
+    }
     
-    return create_success_result(0, 0);
+    stmt->bound_mask = 0;
+    return stmt;
 }
 
 /**
- * @brief 释放查询结果内存
+ * @brief 绑定有符号整数参数
  */
-void database_free_query_result(db_query_result_t* result)
+system_status_t db_stmt_bind_int(db_stmt_t* stmt, uint8_t index, int32_t value)
 {
-    if (result == NULL) {
-        return;
-    }
+    db_param_t* param = get_bind_slot(stmt, index);
     
-    /* 在实际项目中，这里应该释放查询结果分配的内存 */
+    if (param == NULL) {
+        return SYSTEM_ERROR;
+    }
     
-    memset(result, 0, sizeof(db_query_result_t));
+    param->type = DB_PARAM_INT;
+    param->value.i = value;
+    return SYSTEM_OK;
 }
 
 /**
- * @brief 开始事务
+ * @brief 绑定无符号整数参数
  */
-db_result_t database_begin_transaction(void)
+system_status_t db_stmt_bind_uint(db_stmt_t* stmt, uint8_t index, uint32_t value)
 {
-    if (current_status != DB_STATUS_CONNECTED) {
-        return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
+    db_param_t* param = get_bind_slot(stmt, index);
+    
+    if (param == NULL) {
+        return SYSTEM_ERROR;
     }
     
-    DEBUG_PRINT("Beginning transaction");
-    return database_execute_update("BEGIN");
+    param->type = DB_PARAM_UINT;
+    param->value.u = value;
+    return SYSTEM_OK;
 }
 
 /**
- * @brief 提交事务
+ * @brief 绑定浮点数参数
  */
-db_result_t database_commit_transaction(void)
+system_status_t db_stmt_bind_real(db_stmt_t* stmt, uint8_t index, double value)
 {
-    if (current_status != DB_STATUS_CONNECTED) {
-        return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
+    db_param_t* param = get_bind_slot(stmt, index);
+    
+    if (param == NULL) {
+        return SYSTEM_ERROR;
     }
     
-    DEBUG_PRINT("Committing transaction");
-    return database_execute_update("COMMIT");
+    param->type = DB_PARAM_REAL;
+    param->value.f = value;
+    return SYSTEM_OK;
 }
 
 /**
- * @brief 回滚事务
+ * @brief 绑定字符串参数
  */
-db_result_t database_rollback_transaction(void)
+system_status_t db_stmt_bind_text(db_stmt_t* stmt, uint8_t index, const char* value)
 {
-    if (current_status != DB_STATUS_CONNECTED) {
-        return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
+    db_param_t* param = get_bind_slot(stmt, index);
+    size_t length;
+    
+    if (param == NULL) {
+        return SYSTEM_ERROR;
     }
     
-    DEBUG_PRINT("Rolling back transaction");
-    return database_execute_update("ROLLBACK");
+    if (value == NULL) {
+        param->type = DB_PARAM_NULL;
+        return SYSTEM_OK;
+    }
+    
+    length = strlen(value);
+    if (length > 0xFFFFu) {
+        stmt->bound_mask &= (uint16_t)~(1u << index);
+        return SYSTEM_ERROR;
+    }
+    
+    param->type = DB_PARAM_TEXT;
+    param->value.text.ptr = value;
+    param->value.text.length = (uint16_t)length;
+    return SYSTEM_OK;
 }
 
 /**
- * @brief 检查数据库表是否存在
+ * @brief 执行已绑定全部参数的写语句
  */
-bool database_table_exists(const char* table_name)
+db_result_t db_stmt_execute(db_stmt_t* stmt)
 {
-    char sql[MAX_SQL_LENGTH];
-    db_query_result_t result;
+    const char* error_msg;
+    int error_code;
+    uint32_t affected_rows = 0;
     
-    if (table_name == NULL || current_status != DB_STATUS_CONNECTED) {
-        return false;
+    error_code = check_statement_ready(stmt, &error_msg);
+    if (error_code != DB_ERROR_NONE) {
+        return create_error_result(error_code, error_msg);
     }
     
-    sprintf(sql, "SHOW TABLES LIKE '%s'", table_name);
-    result = database_execute_query(sql);
+    DEBUG_PRINT("Executing statement %d (%d params)", stmt->id, stmt->param_count);
     
-    bool exists = (result.row_count > 0);
-    database_free_query_result(&result);
+    /* 只传输语句句柄和参数值，服务器不再解析SQL */
+    error_code = driver->execute(stmt, &affected_rows);
+    stmt_execute_count++;
+    if (error_code != DB_ERROR_NONE) {
+        return create_driver_error(error_code);
+    }
     
-    return exists;
+    return create_success_result(affected_rows, 0);
 }
 
 /**
- * @brief 创建数据库表
+ * @brief 执行已绑定全部参数的查询语句并统计结果行数
  */
-db_result_t database_create_tables(void)
+db_query_result_t db_stmt_query(db_stmt_t* stmt)
 {
-    db_result_t result;
+    db_query_result_t result;
+    db_cursor_t cursor;
     
-    if (current_status != DB_STATUS_CONNECTED) {
-        return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
-    }
+    /* 初始化结果 */
+    memset(&result, 0, sizeof(db_query_result_t));
     
-    /* 创建传感器1数据表 */
-    result = database_execute_update(SQL_CREATE_SENSOR1_TABLE);
-    if (!result.success) {
+    if (!db_stmt_open_cursor(stmt, &cursor).success) {
         return result;
     }
     
-    /* 创建传感器2数据表 */
-    result = database_execute_update(SQL_CREATE_SENSOR2_TABLE);
-    if (!result.success) {
-        return result;
+    while (db_cursor_next(&cursor)) {
+        /* 只统计行数，需要列值的调用方直接使用游标 */
     }
+    result.row_count = cursor.row_index;
+    result.column_count = driver->column_count(stmt);
+    db_cursor_close(&cursor);
     
-    INFO_PRINT("Database tables created successfully");
-    return create_success_result(0, 0);
+    return result;
 }
 
 /**
- * @brief 获取数据库统计信息
+ * @brief 在已绑定全部参数的查询语句上打开游标
  */
-db_result_t database_get_statistics(uint32_t* sensor1_count, uint32_t* sensor2_count)
+db_result_t db_stmt_open_cursor(db_stmt_t* stmt, db_cursor_t* cursor)
 {
-    db_query_result_t result;
+    const char* error_msg;
+    int error_code;
     
+    if (cursor == NULL) {
+        return create_error_result(DB_ERROR_INVALID_PARAM, "Null cursor");
+    }
+    
+    cursor->stmt = stmt;
+    cursor->row_index = 0;
+    cursor->open = false;
+    
+    error_code = check_statement_ready(stmt, &error_msg);
+    if (error_code != DB_ERROR_NONE) {
+        return create_error_result(error_code, error_msg);
+    }
+    
+    DEBUG_PRINT("Executing statement %d (%d params)", stmt->id, stmt->param_count);
+    
+    error_code = driver->query(stmt);
+    stmt_execute_count++;
+    if (error_code != DB_ERROR_NONE) {
+        return create_driver_error(error_code);
+    }
+    
+    cursor->open = true;
+    return create_success_result(0, 0);
+}
+
+/**
+ * @brief 移动到下一行
+ */
+bool db_cursor_next(db_cursor_t* cursor)
+{
+    bool has_row = false;
+    int error_code;
+    
+    if (cursor == NULL || !cursor->open) {
+        return false;
+    }
+    
+    error_code = driver->step(cursor->stmt, &has_row);
+    if (error_code != DB_ERROR_NONE) {
+        set_last_error(error_code, driver->last_error());
+        return false;
+    }
+    
+    if (has_row) {
+        cursor->row_index++;
+    }
+    return has_row;
+}
+
+/**
+ * @brief 读取当前行的整数列
+ */
+int32_t db_cursor_get_int(const db_cursor_t* cursor, uint8_t column)
+{
+    if (cursor == NULL || !cursor->open) {
+        return 0;
+    }
+    return driver->column_int(cursor->stmt, column);
+}
+
+/**
+ * @brief 读取当前行的无符号整数列
+ */
+uint32_t db_cursor_get_uint(const db_cursor_t* cursor, uint8_t column)
+{
+    if (cursor == NULL || !cursor->open) {
+        return 0;
+    }
+    return driver->column_uint(cursor->stmt, column);
+}
+
+/**
+ * @brief 读取当前行的浮点数列
+ */
+double db_cursor_get_real(const db_cursor_t* cursor, uint8_t column)
+{
+    if (cursor == NULL || !cursor->open) {
+        return 0.0;
+    }
+    return driver->column_real(cursor->stmt, column);
+}
+
+/**
+ * @brief 读取当前行的文本列
+ */
+const char* db_cursor_get_text(const db_cursor_t* cursor, uint8_t column)
+{
+    const char* text;
+    
+    if (cursor == NULL || !cursor->open) {
+        return "";
+    }
+    
+    text = driver->column_text(cursor->stmt, column);
+    return (text != NULL) ? text : "";
+}
+
+/**
+ * @brief 把游标当前行转换为传感器数据
+ */
+uint32_t db_cursor_get_sensor_data(const db_cursor_t* cursor, sensor_type_t type, sensor_data_t* data)
+{
+    memset(data, 0, sizeof(sensor_data_t));
+    data->type = type;
+    
+    if (type == SENSOR_TYPE_TEMP_HUMIDITY) {
+        sensor1_data_t* s1 = &data->data.sensor1;
+        
+        SAFE_STRCPY(s1->student_id, db_cursor_get_text(cursor, DB_SENSOR1_COL_STUDENT_ID),
+                    sizeof(s1->student_id));
+        SAFE_STRCPY(s1->sensor_name, db_cursor_get_text(cursor, DB_SENSOR1_COL_SENSOR_NAME),
+                    sizeof(s1->sensor_name));
+        s1->temperature = (float)db_cursor_get_real(cursor, DB_SENSOR1_COL_TEMPERATURE);
+        s1->humidity = (float)db_cursor_get_real(cursor, DB_SENSOR1_COL_HUMIDITY);
+        s1->status = read_status(cursor, DB_SENSOR1_COL_STATUS);
+        s1->timestamp = db_cursor_get_uint(cursor, DB_SENSOR1_COL_TIMESTAMP);
+        return db_cursor_get_uint(cursor, DB_SENSOR1_COL_ID);
+    }
+    
+    {
+        sensor2_data_t* s2 = &data->data.sensor2;
+        
+        SAFE_STRCPY(s2->student_id, db_cursor_get_text(cursor, DB_SENSOR2_COL_STUDENT_ID),
+                    sizeof(s2->student_id));
+        SAFE_STRCPY(s2->sensor_name, db_cursor_get_text(cursor, DB_SENSOR2_COL_SENSOR_NAME),
+                    sizeof(s2->sensor_name));
+        s2->interrupt_type = (interrupt_type_t)db_cursor_get_uint(cursor, DB_SENSOR2_COL_INTERRUPT_TYPE);
+        s2->interrupt_count = db_cursor_get_uint(cursor, DB_SENSOR2_COL_INTERRUPT_COUNT);
+        s2->status = read_status(cursor, DB_SENSOR2_COL_STATUS);
+        s2->first_timestamp = db_cursor_get_uint(cursor, DB_SENSOR2_COL_FIRST_TIMESTAMP);
+        s2->timestamp = db_cursor_get_uint(cursor, DB_SENSOR2_COL_TIMESTAMP);
+        return db_cursor_get_uint(cursor, DB_SENSOR2_COL_ID);
+    }
+}
+
+/**
+ * @brief 关闭游标
+ */
+void db_cursor_close(db_cursor_t* cursor)
+{
+    if (cursor == NULL || !cursor->open) {
+        return;
+    }
+    
+    driver->reset(cursor->stmt);
+    cursor->open = false;
+}
+
+/**
+ * @brief 获取预编译语句统计信息
+ */
+void database_get_stmt_statistics(uint32_t* prepare_count, uint32_t* execute_count)
+{
+    if (prepare_count != NULL) {
+        *prepare_count = stmt_prepare_count;
+    }
+    if (execute_count != NULL) {
+        *execute_count = stmt_execute_count;
+    }
+}
+
+/**
+ * @brief 执行自定义SQL查询
+ */
+db_query_result_t database_execute_query(const char* sql)
+{
+    db_query_result_t result;
+    db_stmt_t stmt;
+    int error_code;
+    
+    /* 初始化结果 */
+    memset(&result, 0, sizeof(db_query_result_t));
+    
+    /* 参数检查 */
+    if (sql == NULL || strlen(sql) == 0) {
+        set_last_error(DB_ERROR_INVALID_PARAM, "Empty SQL statement");
+        return result;
+    }
+    
+    /* 连接状态检查 */
+    if (current_status != DB_STATUS_CONNECTED) {
+        set_last_error(DB_ERROR_CONNECTION, "Database not connected");
+        return result;
+    }
+    
+    DEBUG_PRINT("Executing custom query: %s", sql);
+    
+    /* 临时语句：不带参数，用完即释放 */
+    memset(&stmt, 0, sizeof(stmt));
+    stmt.id = DB_STMT_COUNT;
+    stmt.sql = sql;
+    error_code = driver->prepare(&stmt);
+    if (error_code != DB_ERROR_NONE) {
+        set_last_error(error_code, driver->last_error());
+        return result;
+    }
+    stmt.prepared = true;
+    
+    result = db_stmt_query(&stmt);
+    driver->finalize(&stmt);
+    
+    return result;
+}
+
+/**
+ * @brief 执行SQL更新语句
+ */
+db_result_t database_execute_update(const char* sql)
+{
+    uint32_t affected_rows = 0;
+    int error_code;
+    
+    /* 参数检查 */
+    if (sql == NULL || strlen(sql) == 0) {
+        return create_error_result(DB_ERROR_INVALID_PARAM, "Empty SQL statement");
+    }
+    
+    /* 连接状态检查 */
     if (current_status != DB_STATUS_CONNECTED) {
         return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
     }
     
-    /* 查询传感器1数据数量 */
-    if (sensor1_count != NULL) {
-        result = database_execute_query(SQL_COUNT_SENSOR1);
-        *sensor1_count = 0; /* 在实际项目中从查询结果中获取 */
-        database_free_query_result(&result);
+    DEBUG_PRINT("Executing update: %s", sql);
+    
+    error_code = driver->exec(sql, &affected_rows);
+    if (error_code != DB_ERROR_NONE) {
+        return create_driver_error(error_code);
+    }
+    
+    return create_success_result(affected_rows, 0);
+}
+
+/**
+ * @brief 执行自定义SQL查询并读取第一行第一列的整数值
+ */
+db_result_t database_query_uint(const char* sql, uint32_t* value)
+{
+    db_result_t result;
+    db_stmt_t stmt;
+    db_cursor_t cursor;
+    int error_code;
+    
+    if (sql == NULL || strlen(sql) == 0 || value == NULL) {
+        return create_error_result(DB_ERROR_INVALID_PARAM, "Empty SQL statement");
+    }
+    *value = 0;
+    
+    if (current_status != DB_STATUS_CONNECTED) {
+        return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
+    }
+    
+    DEBUG_PRINT("Executing scalar query: %s", sql);
+    
+    /* 临时语句：不带参数，用完即释放 */
+    memset(&stmt, 0, sizeof(stmt));
+    stmt.id = DB_STMT_COUNT;
+    stmt.sql = sql;
+    error_code = driver->prepare(&stmt);
+    if (error_code != DB_ERROR_NONE) {
+        return create_driver_error(error_code);
+    }
+    stmt.prepared = true;
+    
+    result = db_stmt_open_cursor(&stmt, &cursor);
+    if (result.success) {
+        if (db_cursor_next(&cursor)) {
+            *value = db_cursor_get_uint(&cursor, 0);
+            result.affected_rows = 1;
+        }
+        db_cursor_close(&cursor);
+    }
+    driver->finalize(&stmt);
+    
+    return result;
+}
+
+/**
+ * @brief 释放查询结果内存
+ */
+void database_free_query_result(db_query_result_t* result)
+{
+    if (result == NULL) {
+        return;
     }
     
-    /* 查询传感器2数据数量 */
+    /* 在实际项目中，这里应该释放查询结果分配的内存 */
+    
+    memset(result, 0, sizeof(db_query_result_t));
+}
+
+/**
+ * @brief 开始事务
+ */
+db_result_t database_begin_transaction(void)
+{
+    db_result_t result;
+    
+    if (current_status != DB_STATUS_CONNECTED) {
+        return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
+    }
+    
+    DEBUG_PRINT("Beginning transaction");
+    result = run_transaction_op(driver->begin);
+    if (result.success) {
+        in_transaction = true;
+        memset(pending_counts, 0, sizeof(pending_counts));
+    }
+    return result;
+}
+
+/**
+ * @brief 提交事务
+ */
+db_result_t database_commit_transaction(void)
+{
+    db_result_t result;
+    uint8_t i;
+    
+    if (current_status != DB_STATUS_CONNECTED) {
+        return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
+    }
+    
+#if ENABLE_DB_ROLLUP
+    /* 事务中累计的汇总键在提交前写出；失败时事务保持打开，由调用方回滚 */
+    result = db_rollup_flush();
+    if (!result.success) {
+        return result;
+    }
+#endif
+    
+    DEBUG_PRINT("Committing transaction");
+    result = run_transaction_op(driver->commit);
+    in_transaction = false;
+    if (result.success) {
+        for (i = 0; i < DB_TABLE_COUNT; i++) {
+            database_adjust_row_count(i, pending_counts[i]);
+        }
+    } else {
+        /* 提交失败时事务是否生效不确定，下次查询重新统计 */
+        row_counts_valid = false;
+        reset_dict_cache();
+    }
+    return result;
+}
+
+/**
+ * @brief 回滚事务
+ */
+db_result_t database_rollback_transaction(void)
+{
+    if (current_status != DB_STATUS_CONNECTED) {
+        return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
+    }
+    
+    DEBUG_PRINT("Rolling back transaction");
+    in_transaction = false;
+#if ENABLE_DB_ROLLUP
+    db_rollup_discard();
+#endif
+    /* 事务中新增的字典键随之撤销 */
+    reset_dict_cache();
+    return run_transaction_op(driver->rollback);
+}
+
+/**
+ * @brief 检查数据库表是否存在
+ */
+bool database_table_exists(const char* table_name)
+{
+    db_stmt_t* stmt;
+    db_cursor_t cursor;
+    bool exists = false;
+    
+    if (table_name == NULL || current_status != DB_STATUS_CONNECTED) {
+        return false;
+    }
+    
+    stmt = database_prepare(DB_STMT_TABLE_EXISTS);
+    if (stmt == NULL) {
+        return false;
+    }
+    db_stmt_bind_text(stmt, 0, table_name);
+    
+    if (db_stmt_open_cursor(stmt, &cursor).success) {
+        exists = db_cursor_next(&cursor);
+        db_cursor_close(&cursor);
+    }
+    
+    return exists;
+}
+
+/**
+ * @brief 创建数据库表
+ */
+db_result_t database_create_tables(void)
+{
+    const char* const* ddl;
+    db_result_t result;
+#if DB_SCHEMA_VERSION >= 2
+    uint32_t count;
+#endif
+    
+    if (current_status != DB_STATUS_CONNECTED) {
+        return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
+    }
+    
+    /* 按驱动方言逐条执行建表语句 */
+    ddl = (driver->create_tables != NULL) ? driver->create_tables : DEFAULT_CREATE_TABLES;
+    for (; *ddl != NULL; ddl++) {
+        result = database_execute_update(*ddl);
+        if (!result.success) {
+            return result;
+        }
+    }
+    
+#if DB_SCHEMA_VERSION >= 2
+    /* CREATE TABLE IF NOT EXISTS不会改动已有的v1表，需要先执行迁移脚本 */
+    if (!database_query_uint(SQL_SCHEMA_CHECK_SENSOR1, &count).success ||
+        !database_query_uint(SQL_SCHEMA_CHECK_SENSOR2, &count).success) {
+        return create_error_result(DB_ERROR_TABLE_NOT_EXIST,
+                                   "Tables use schema v1, run database/migrate_v2.sql");
+    }
+#endif
+    
+    INFO_PRINT("Database tables created successfully");
+    return create_success_result(0, 0);
+}
+
+/**
+ * @brief 获取数据库统计信息
+ */
+db_result_t database_get_statistics(uint32_t* sensor1_count, uint32_t* sensor2_count)
+{
+    if (current_status != DB_STATUS_CONNECTED) {
+        return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
+    }
+    
+    /* 只在连接后第一次查询时全表计数，之后返回维护的行数 */
+    if (!row_counts_valid) {
+        if (!load_row_counts(row_counts)) {
+            return create_error_result(DB_ERROR_QUERY, "Count query failed");
+        }
+        row_counts_valid = true;
+    }
+    
+    if (sensor1_count != NULL) {
+        *sensor1_count = row_counts[DB_TABLE_SENSOR1];
+    }
     if (sensor2_count != NULL) {
-        result = database_execute_query(SQL_COUNT_SENSOR2);
-        *sensor2_count = 0; /* 在实际项目中从查询结果中获取 */
-        database_free_query_result(&result);
+        *sensor2_count = row_counts[DB_TABLE_SENSOR2];
     }
     
     return create_success_result(0, 0);
 }
 
+/**
+ * @brief 重新统计表行数并校正维护的计数
+ */
+db_result_t database_reconcile_statistics(void)
+{
+    uint32_t counts[DB_TABLE_COUNT];
+    uint32_t drift = 0;
+    uint8_t i;
+    
+    if (current_status != DB_STATUS_CONNECTED) {
+        return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
+    }
+    
+    /* 事务中的行尚未计入，此时计数与表不可比 */
+    if (in_transaction) {
+        return create_error_result(DB_ERROR_TRANSACTION, "Transaction in progress");
+    }
+    
+    if (!load_row_counts(counts)) {
+        return create_error_result(DB_ERROR_QUERY, "Count query failed");
+    }
+    
+    if (row_counts_valid) {
+        for (i = 0; i < DB_TABLE_COUNT; i++) {
+            drift += (counts[i] > row_counts[i]) ? counts[i] - row_counts[i] : row_counts[i] - counts[i];
+        }
+        if (drift != 0) {
+            INFO_PRINT("Row counters corrected: sensor1 %lu -> %lu, sensor2 %lu -> %lu",
+                       row_counts[DB_TABLE_SENSOR1], counts[DB_TABLE_SENSOR1],
+                       row_counts[DB_TABLE_SENSOR2], counts[DB_TABLE_SENSOR2]);
+        }
+    }
+    
+    memcpy(row_counts, counts, sizeof(row_counts));
+    row_counts_valid = true;
+    return create_success_result(drift, 0);
+}
+
 /**
  * @brief 清理过期数据
  */
 db_result_t database_cleanup_old_data(uint32_t days_old)
 {
-    char sql[MAX_SQL_LENGTH];
     db_result_t result;
+    uint32_t deleted = 0;
+    uint8_t i;
+    
+    if (current_status != DB_STATUS_CONNECTED) {
+        return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
+    }
+    
+    /* 依次删除两张表的过期数据 */
+    for (i = 0; i < DB_TABLE_COUNT; i++) {
+        result = database_cleanup_table(i, days_old);
+        if (!result.success) {
+            return result;
+        }
+        deleted += result.affected_rows;
+    }
+    
+    INFO_PRINT("Old data cleanup completed: %lu days", days_old);
+    return create_success_result(deleted, 0);
+}
+
+/**
+ * @brief 清理一张表的过期数据
+ */
+db_result_t database_cleanup_table(uint8_t table, uint32_t days_old)
+{
+    static const db_stmt_id_t CLEANUP_STMTS[DB_TABLE_COUNT] = {
+        DB_STMT_CLEANUP_SENSOR1,
+        DB_STMT_CLEANUP_SENSOR2
+    };
+    db_stmt_t* stmt;
+    db_result_t result;
+    
+    if (table >= DB_TABLE_COUNT) {
+        return create_error_result(DB_ERROR_INVALID_PARAM, "Invalid table");
+    }
+    
+    stmt = database_prepare(CLEANUP_STMTS[table]);
+    if (stmt == NULL) {
+        return create_error_result(DB_ERROR_DELETE, "Prepare failed");
+    }
+    db_stmt_bind_uint(stmt, 0, days_old);
+    result = db_stmt_execute(stmt);
+    if (result.success) {
+        database_adjust_row_count(table, -(int32_t)result.affected_rows);
+    }
+    return result;
+}
+
+/**
+ * @brief 记录一张表的行数增减（事务中先暂存，提交后生效）
+ */
+void database_adjust_row_count(uint8_t table, int32_t delta)
+{
+    if (table >= DB_TABLE_COUNT) {
+        return;
+    }
+    
+    if (in_transaction) {
+        pending_counts[table] += delta;
+        return;
+    }
+    
+    if (delta < 0 && (uint32_t)(-delta) > row_counts[table]) {
+        row_counts[table] = 0;
+    } else {
+        row_counts[table] = (uint32_t)((int32_t)row_counts[table] + delta);
+    }
+}
+
+/**
+ * @brief 备份数据库
+ */
+db_result_t database_backup(const char* backup_path)
+{
+    if (backup_path == NULL) {
+        return create_error_result(DB_ERROR_INVALID_PARAM, "Invalid backup path");
+    }
+    
+    if (current_status != DB_STATUS_CONNECTED) {
+        return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
+    }
+    
+#if ENABLE_DB_BACKUP
+    /* 全量备份，一次调用内做完（主循环中应使用db_backup_start()/db_backup_poll()） */
+    {
+        db_backup_statistics_t stats;
+        db_result_t result = db_backup_start(backup_path, NULL);
+        while (result.success && db_backup_running()) {
+            result = db_backup_poll();
+        }
+        if (!result.success) {
+            return result;
+        }
+        db_backup_get_statistics(&stats);
+        return create_success_result(stats.rows_written, 0);
+    }
+#else
+    return create_error_result(DB_ERROR_QUERY, "Backup not enabled");
+#endif
+}
+
+/**
+ * @brief 恢复数据库
+ */
+db_result_t database_restore(const char* backup_path)
+{
+    if (backup_path == NULL) {
+        return create_error_result(DB_ERROR_INVALID_PARAM, "Invalid backup path");
+    }
+    
+    if (current_status != DB_STATUS_CONNECTED) {
+        return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
+    }
+    
+#if ENABLE_DB_BACKUP
+    return db_backup_restore(backup_path);
+#else
+    return create_error_result(DB_ERROR_QUERY, "Backup not enabled");
+#endif
+}
+
+/**
+ * @brief 设置数据库错误回调函数
+ */
+void database_set_error_callback(void (*callback)(const char* error_msg))
+{
+    error_callback = callback;
+}
+
+/**
+ * @brief 获取最后一次错误信息
+ */
+const char* database_get_last_error(void)
+{
+    return last_error_message;
+}
+
+/**
+ * @brief 获取最后一次错误码
+ */
+int database_get_last_error_code(void)
+{
+    return last_error_code;
+}
+
+/**
+ * @brief 选择数据库驱动
+ */
+system_status_t database_set_driver(const db_driver_t* new_driver)
+{
+    if (current_status == DB_STATUS_CONNECTED) {
+        return SYSTEM_BUSY;
+    }
+    
+    driver = (new_driver != NULL) ? new_driver : DB_DEFAULT_DRIVER;
+    invalidate_statements();
+    
+    DEBUG_PRINT("Database driver: %s", driver->name);
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 获取当前数据库驱动
+ */
+const db_driver_t* database_get_driver(void)
+{
+    return driver;
+}
+
+/* 内部函数实现 */
+
+/**
+ * @brief 按数据类型插入一行（不更新汇总表）
+ */
+static db_result_t insert_row(const sensor_data_t* data)
+{
+    if (data == NULL) {
+        return create_error_result(DB_ERROR_INVALID_PARAM, "Null sensor data");
+    }
+    
+    switch (data->type) {
+        case SENSOR_TYPE_TEMP_HUMIDITY:
+            return insert_sensor1_row(&data->data.sensor1);
+            
+        case SENSOR_TYPE_INTERRUPT:
+            return insert_sensor2_row(&data->data.sensor2);
+            
+        default:
+            return create_error_result(DB_ERROR_INVALID_PARAM, "Unknown sensor type");
+    }
+}
+
+/**
+ * @brief 插入一行传感器1数据
+ */
+static db_result_t insert_sensor1_row(const sensor1_data_t* data)
+{
+    db_stmt_t* stmt;
+    db_result_t result;
+#if DB_SCHEMA_VERSION >= 2
+    uint16_t student_key;
+    uint16_t sensor_key;
+#endif
     
+    /* 参数检查 */
+    if (data == NULL) {
+        return create_error_result(DB_ERROR_INVALID_PARAM, "Null sensor data");
+    }
+    
+    /* 连接状态检查 */
     if (current_status != DB_STATUS_CONNECTED) {
         return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
     }
     
-    /* 删除过期的传感器1数据 */
-    sprintf(sql, "DELETE FROM sensor1_data WHERE created_at < DATE_SUB(NOW(), INTERVAL %lu DAY)", days_old);
-    result = database_execute_update(sql);
+    /* 数据验证 */
+    if (!validate_sensor1_data(data)) {
+        return create_error_result(DB_ERROR_INVALID_PARAM, "Invalid sensor data");
+    }
+    
+#if DB_SCHEMA_VERSION >= 2
+    result = resolve_row_keys(data->student_id, data->sensor_name, &student_key, &sensor_key);
     if (!result.success) {
         return result;
     }
+#endif
     
-    /* 删除过期的传感器2数据 */
-    sprintf(sql, "DELETE FROM sensor2_data WHERE created_at < DATE_SUB(NOW(), INTERVAL %lu DAY)", days_old);
-    result = database_execute_update(sql);
+    /* 参数按类型绑定，字符串原样传输，不需要注入检查和转义 */
+    stmt = database_prepare(DB_STMT_INSERT_SENSOR1);
+    if (stmt == NULL) {
+        return create_error_result(DB_ERROR_INSERT, "Prepare failed");
+    }
+#if DB_SCHEMA_VERSION >= 2
+    db_stmt_bind_uint(stmt, 0, student_key);
+    db_stmt_bind_uint(stmt, 1, sensor_key);
+    db_stmt_bind_int(stmt, 2, to_fixed_point(data->temperature));
+    db_stmt_bind_int(stmt, 3, to_fixed_point(data->humidity));
+    db_stmt_bind_uint(stmt, 4, (uint32_t)data->status);
+#else
+    db_stmt_bind_text(stmt, 0, data->student_id);
+    db_stmt_bind_text(stmt, 1, data->sensor_name);
+    db_stmt_bind_real(stmt, 2, data->temperature);
+    db_stmt_bind_real(stmt, 3, data->humidity);
+    db_stmt_bind_text(stmt, 4, get_sensor_status_string(data->status));
+#endif
+    db_stmt_bind_uint(stmt, 5, data->timestamp);
+    
+    result = db_stmt_execute(stmt);
+    if (result.success) {
+        database_adjust_row_count(DB_TABLE_SENSOR1, 1);
+        INFO_PRINT("Sensor1 data inserted: ID=%s, Temp=%.2f, Humid=%.2f", 
+                   data->student_id, data->temperature, data->humidity);
+    }
     
-    INFO_PRINT("Old data cleanup completed: %lu days", days_old);
     return result;
 }
 
 /**
- * @brief 备份数据库
+ * @brief 插入一行传感器2数据
  */
-db_result_t database_backup(const char* backup_path)
+static db_result_t insert_sensor2_row(const sensor2_data_t* data)
 {
-    if (backup_path == NULL) {
-        return create_error_result(DB_ERROR_INVALID_PARAM, "Invalid backup path");
+    db_stmt_t* stmt;
+    db_result_t result;
+#if DB_SCHEMA_VERSION >= 2
+    uint16_t student_key;
+    uint16_t sensor_key;
+#endif
+    
+    /* 参数检查 */
+    if (data == NULL) {
+        return create_error_result(DB_ERROR_INVALID_PARAM, "Null sensor data");
     }
     
+    /* 连接状态检查 */
     if (current_status != DB_STATUS_CONNECTED) {
         return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
     }
     
-    /* 在实际项目中，这里应该实现真实的数据库备份功能 */
-    DEBUG_PRINT("Database backup to: %s", backup_path);
-    
-    return create_success_result(0, 0);
-}
-
-/**
- * @brief 恢复数据库
- */
-db_result_t database_restore(const char* backup_path)
-{
-    if (backup_path == NULL) {
-        return create_error_result(DB_ERROR_INVALID_PARAM, "Invalid backup path");
+    /* 数据验证 */
+    if (!validate_sensor2_data(data)) {
+        return create_error_result(DB_ERROR_INVALID_PARAM, "Invalid sensor data");
     }
     
-    if (current_status != DB_STATUS_CONNECTED) {
-        return create_error_result(DB_ERROR_CONNECTION, "Database not connected");
+#if DB_SCHEMA_VERSION >= 2
+    result = resolve_row_keys(data->student_id, data->sensor_name, &student_key, &sensor_key);
+    if (!result.success) {
+        return result;
     }
+#endif
     
-    /* 在实际项目中，这里应该实现真实的数据库恢复功能 */
-    DEBUG_PRINT("Database restore from: %s", backup_path);
+    stmt = database_prepare(DB_STMT_INSERT_SENSOR2);
+    if (stmt == NULL) {
+        return create_error_result(DB_ERROR_INSERT, "Prepare failed");
+    }
+#if DB_SCHEMA_VERSION >= 2
+    db_stmt_bind_uint(stmt, 0, student_key);
+    db_stmt_bind_uint(stmt, 1, sensor_key);
+    db_stmt_bind_int(stmt, 2, (int32_t)data->interrupt_type);
+    db_stmt_bind_uint(stmt, 3, data->interrupt_count);
+    db_stmt_bind_uint(stmt, 4, (uint32_t)data->status);
+#else
+    db_stmt_bind_text(stmt, 0, data->student_id);
+    db_stmt_bind_text(stmt, 1, data->sensor_name);
+    db_stmt_bind_int(stmt, 2, (int32_t)data->interrupt_type);
+    db_stmt_bind_uint(stmt, 3, data->interrupt_count);
+    db_stmt_bind_text(stmt, 4, get_sensor_status_string(data->status));
+#endif
+    db_stmt_bind_uint(stmt, 5, data->first_timestamp);
+    db_stmt_bind_uint(stmt, 6, data->timestamp);
+    
+    result = db_stmt_execute(stmt);
+    if (result.success) {
+        database_adjust_row_count(DB_TABLE_SENSOR2, 1);
+        INFO_PRINT("Sensor2 data inserted: ID=%s, Sensor=%s, IntType=%d", 
+                   data->student_id, data->sensor_name, data->interrupt_type);
+    }
     
-    return create_success_result(0, 0);
-}
-
-/**
- * @brief 设置数据库错误回调函数
- */
-void database_set_error_callback(void (*callback)(const char* error_msg))
-{
-    error_callback = callback;
-}
-
-/**
- * @brief 获取最后一次错误信息
- */
-const char* database_get_last_error(void)
-{
-    return last_error_message;
+    return result;
 }
 
-/* 内部函数实现 */
-
 /**
  * @brief 设置最后一次错误信息
  */
 static void set_last_error(int error_code, const char* error_msg)
 {
+    last_error_code = error_code;
     if (error_msg != NULL) {
         SAFE_STRCPY(last_error_message, error_msg, sizeof(last_error_message));
     } else {
-        sprintf(last_error_message, "Database error %d", error_code);
+        strbuf_t sb;
+        strbuf_init(&sb, last_error_message, sizeof(last_error_message));
+        strbuf_append_str(&sb, "Database error ");
+        strbuf_append_int(&sb, error_code);
     }
     
     /* 调用错误回调 */
@@ -647,13 +1619,26 @@ static db_result_t create_error_result(int error_code, const char* error_msg)
     if (error_msg != NULL) {
         SAFE_STRCPY(result.error_message, error_msg, sizeof(result.error_message));
     } else {
-        sprintf(result.error_message, "Error %d", error_code);
+        strbuf_t sb;
+        strbuf_init(&sb, result.error_message, sizeof(result.error_message));
+        strbuf_append_str(&sb, "Error ");
+        strbuf_append_int(&sb, error_code);
     }
     
     set_last_error(error_code, error_msg);
     return result;
 }
 
+/**
+ * @brief 用驱动错误信息创建错误结果
+ */
+static db_result_t create_driver_error(int error_code)
+{
+    const char* error_msg = driver->last_error();
+    
+    return create_error_result(error_code, (error_msg != NULL && error_msg[0] != '\0') ? error_msg : NULL);
+}
+
 /**
  * @brief 创建成功结果
  */
@@ -694,41 +1679,482 @@ static bool validate_sql_injection(const char* input)
     return true;
 }
 
+#if DB_SCHEMA_VERSION < 2
 /**
- * @brief 转义字符串
+ * @brief 追加转义后加单引号的字符串
  */
-static char* escape_string(const char* input, char* output, size_t output_size)
+static bool append_sql_string(strbuf_t* sb, const char* input)
 {
-    size_t i, j = 0;
+    const char* run = input;
+    size_t i;
     
-    if (input == NULL || output == NULL || output_size == 0) {
-        return NULL;
+    if (input == NULL) {
+        return false;
     }
     
-    for (i = 0; input[i] != '\0' && j < output_size - 1; i++) {
+    strbuf_append_char(sb, '\'');
+    
+    /* 不需要转义的连续字符整段追加 */
+    for (i = 0; input[i] != '\0'; i++) {
         if (input[i] == '\'' || input[i] == '\"' || input[i] == '\\') {
-            if (j < output_size - 2) {
-                output[j++] = '\\';
-                output[j++] = input[i];
+            strbuf_append_mem(sb, run, (size_t)(&input[i] - run));
+            strbuf_append_char(sb, '\\');
+            run = &input[i];
+        }
+    }
+    strbuf_append_mem(sb, run, (size_t)(&input[i] - run));
+    
+    return strbuf_append_char(sb, '\'');
+}
+
+/**
+ * @brief 追加批量装载行中的文本字段（反斜杠转义制表符、换行和反斜杠）
+ */
+static bool append_bulk_string(strbuf_t* sb, const char* input)
+{
+    const char* run = input;
+    size_t i;
+    
+    if (input == NULL) {
+        return false;
+    }
+    
+    for (i = 0; input[i] != '\0'; i++) {
+        if (input[i] == '\t' || input[i] == '\n' || input[i] == '\\') {
+            strbuf_append_mem(sb, run, (size_t)(&input[i] - run));
+            strbuf_append_char(sb, '\\');
+            strbuf_append_char(sb, (input[i] == '\t') ? 't' : (input[i] == '\n') ? 'n' : '\\');
+            run = &input[i + 1];
+        }
+    }
+    return strbuf_append_mem(sb, run, (size_t)(&input[i] - run));
+}
+#endif
+
+/* VALUES元组与批量装载行只有分隔符和文本字段的写法不同 */
+#define APPEND_SEPARATOR(sb, bulk_line) \
+    ((bulk_line) ? strbuf_append_char((sb), SQL_BULK_FIELD_SEPARATOR) : strbuf_append_str((sb), ", "))
+#define APPEND_TEXT(sb, text, bulk_line) \
+    ((bulk_line) ? append_bulk_string((sb), (text)) : append_sql_string((sb), (text)))
+
+/**
+ * @brief 追加传感器1数据的VALUES元组或批量装载行
+ */
+static bool append_sensor1_values(strbuf_t* sb, const sensor1_data_t* data, bool bulk_line)
+{
+#if DB_SCHEMA_VERSION >= 2
+    uint16_t student_key;
+    uint16_t sensor_key;
+    
+    /* 字典键已由database_resolve_sensor_row()解析，这里通常命中缓存 */
+    if (!resolve_row_keys(data->student_id, data->sensor_name, &student_key, &sensor_key).success) {
+        return false;
+    }
+    
+    if (!bulk_line) {
+        strbuf_append_char(sb, '(');
+    }
+    strbuf_append_uint(sb, student_key);
+    APPEND_SEPARATOR(sb, bulk_line);
+    strbuf_append_uint(sb, sensor_key);
+    APPEND_SEPARATOR(sb, bulk_line);
+    strbuf_append_int(sb, to_fixed_point(data->temperature));
+    APPEND_SEPARATOR(sb, bulk_line);
+    strbuf_append_int(sb, to_fixed_point(data->humidity));
+    APPEND_SEPARATOR(sb, bulk_line);
+    strbuf_append_uint(sb, (uint32_t)data->status);
+#else
+    if (!bulk_line) {
+        strbuf_append_char(sb, '(');
+    }
+    APPEND_TEXT(sb, data->student_id, bulk_line);
+    APPEND_SEPARATOR(sb, bulk_line);
+    APPEND_TEXT(sb, data->sensor_name, bulk_line);
+    APPEND_SEPARATOR(sb, bulk_line);
+    strbuf_append_fixed(sb, data->temperature, SQL_TEMPERATURE_DECIMALS);
+    APPEND_SEPARATOR(sb, bulk_line);
+    strbuf_append_fixed(sb, data->humidity, SQL_HUMIDITY_DECIMALS);
+    APPEND_SEPARATOR(sb, bulk_line);
+    APPEND_TEXT(sb, get_sensor_status_string(data->status), bulk_line);
+#endif
+    APPEND_SEPARATOR(sb, bulk_line);
+    strbuf_append_uint(sb, data->timestamp);
+    
+    return strbuf_append_char(sb, bulk_line ? SQL_BULK_LINE_END : ')');
+}
+
+/**
+ * @brief 追加传感器2数据的VALUES元组或批量装载行
+ */
+static bool append_sensor2_values(strbuf_t* sb, const sensor2_data_t* data, bool bulk_line)
+{
+#if DB_SCHEMA_VERSION >= 2
+    uint16_t student_key;
+    uint16_t sensor_key;
+    
+    if (!resolve_row_keys(data->student_id, data->sensor_name, &student_key, &sensor_key).success) {
+        return false;
+    }
+    
+    if (!bulk_line) {
+        strbuf_append_char(sb, '(');
+    }
+    strbuf_append_uint(sb, student_key);
+    APPEND_SEPARATOR(sb, bulk_line);
+    strbuf_append_uint(sb, sensor_key);
+#else
+    if (!bulk_line) {
+        strbuf_append_char(sb, '(');
+    }
+    APPEND_TEXT(sb, data->student_id, bulk_line);
+    APPEND_SEPARATOR(sb, bulk_line);
+    APPEND_TEXT(sb, data->sensor_name, bulk_line);
+#endif
+    APPEND_SEPARATOR(sb, bulk_line);
+    strbuf_append_int(sb, (int32_t)data->interrupt_type);
+    APPEND_SEPARATOR(sb, bulk_line);
+    strbuf_append_uint(sb, data->interrupt_count);
+    APPEND_SEPARATOR(sb, bulk_line);
+#if DB_SCHEMA_VERSION >= 2
+    strbuf_append_uint(sb, (uint32_t)data->status);
+#else
+    APPEND_TEXT(sb, get_sensor_status_string(data->status), bulk_line);
+#endif
+    APPEND_SEPARATOR(sb, bulk_line);
+    strbuf_append_uint(sb, data->first_timestamp);
+    APPEND_SEPARATOR(sb, bulk_line);
+    strbuf_append_uint(sb, data->timestamp);
+    
+    return strbuf_append_char(sb, bulk_line ? SQL_BULK_LINE_END : ')');
+}
+
+/**
+ * @brief 使所有语句失效（连接变化后需要重新准备）
+ */
+static void invalidate_statements(void)
+{
+    uint8_t i;
+    
+    for (i = 0; i < DB_STMT_COUNT; i++) {
+        statements[i].id = (db_stmt_id_t)i;
+        statements[i].sql = STMT_SQL[i];
+        if (driver->statement_sql != NULL && driver->statement_sql[i] != NULL) {
+            statements[i].sql = driver->statement_sql[i];
+        }
+        statements[i].prepared = false;
+        statements[i].bound_mask = 0;
+        statements[i].handle = NULL;
+    }
+}
+
+/**
+ * @brief 释放当前连接上已准备的语句
+ */
+static void release_statements(void)
+{
+    uint8_t i;
+    
+    for (i = 0; i < DB_STMT_COUNT; i++) {
+        if (statements[i].prepared) {
+            driver->finalize(&statements[i]);
+        }
+    }
+    
+    invalidate_statements();
+}
+
+/**
+ * @brief 在当前连接上准备语句：统计占位符并由服务器解析一次
+ */
+static bool prepare_statement(db_stmt_t* stmt)
+{
+    const char* p;
+    uint8_t count = 0;
+    int error_code;
+    
+    for (p = stmt->sql; *p != '\0'; p++) {
+        if (*p == '?') {
+            count++;
+        }
+    }
+    
+    if (count > DB_STMT_MAX_PARAMS) {
+        set_last_error(DB_ERROR_INVALID_PARAM, "Too many statement parameters");
+        return false;
+    }
+    
+    DEBUG_PRINT("Preparing statement %d: %s", stmt->id, stmt->sql);
+    
+    stmt->param_count = count;
+    error_code = driver->prepare(stmt);
+    if (error_code != DB_ERROR_NONE) {
+        set_last_error(error_code, driver->last_error());
+        return false;
+    }
+    
+    stmt->bound_mask = 0;
+    stmt->prepared = true;
+    stmt_prepare_count++;
+    
+    return true;
+}
+
+/**
+ * @brief 取得参数槽并标记为已绑定
+ */
+static db_param_t* get_bind_slot(db_stmt_t* stmt, uint8_t index)
+{
+    if (stmt == NULL || !stmt->prepared || index >= stmt->param_count) {
+        return NULL;
+    }
+    
+    stmt->bound_mask |= (uint16_t)(1u << index);
+    return &stmt->params[index];
+}
+
+/**
+ * @brief 检查语句能否执行（已准备、连接有效、参数全部绑定）
+ */
+static int check_statement_ready(const db_stmt_t* stmt, const char** error_msg)
+{
+    if (stmt == NULL || !stmt->prepared) {
+        *error_msg = "Statement not prepared";
+        return DB_ERROR_INVALID_PARAM;
+    }
+    
+    if (current_status != DB_STATUS_CONNECTED) {
+        *error_msg = "Database not connected";
+        return DB_ERROR_CONNECTION;
+    }
+    
+    if (stmt->bound_mask != (uint16_t)((1u << stmt->param_count) - 1u)) {
+        *error_msg = "Unbound statement parameter";
+        return DB_ERROR_INVALID_PARAM;
+    }
+    
+    return DB_ERROR_NONE;
+}
+
+/**
+ * @brief 准备按学号查询语句并绑定参数（学号为空时查询全部）
+ */
+static db_stmt_t* prepare_select(db_stmt_id_t all_id, db_stmt_id_t by_id_id,
+                                 const char* student_id, uint32_t limit)
+{
+    db_stmt_t* stmt;
+    uint8_t index = 0;
+    
+    if (student_id != NULL && student_id[0] != '\0') {
+        stmt = database_prepare(by_id_id);
+        if (stmt != NULL) {
+            db_stmt_bind_text(stmt, index++, student_id);
+        }
+    } else {
+        stmt = database_prepare(all_id);
+    }
+    
+    if (stmt != NULL) {
+        db_stmt_bind_uint(stmt, index, (limit > 0) ? limit : SQL_STMT_NO_LIMIT);
+    }
+    
+    return stmt;
+}
+
+#if ENABLE_DB_CACHE
+/**
+ * @brief 按学号查询最新limit条时经过最新数据缓存（行数足够时不访问数据库）
+ * @return bool 已由缓存处理返回true；全部学号、不限行数或超过缓存深度时返回false
+ */
+static bool query_latest_cached(sensor_type_t type, const char* student_id, uint32_t limit,
+                                db_query_result_t* result)
+{
+    db_result_t cache_result;
+    
+    if (student_id == NULL || student_id[0] == '\0' || limit == 0 || limit > DB_CACHE_DEPTH) {
+        return false;
+    }
+    
+    cache_result = db_cache_query_latest(type, student_id, latest_rows, (uint16_t)limit);
+    if (!cache_result.success) {
+        return false;
+    }
+    
+    result->row_count = cache_result.affected_rows;
+    return true;
+}
+#endif
+
+/**
+ * @brief 执行计数查询，读取第一行第一列
+ */
+static bool get_count(db_stmt_id_t id, uint32_t* count)
+{
+    db_stmt_t* stmt;
+    db_cursor_t cursor;
+    
+    *count = 0;
+    
+    stmt = database_prepare(id);
+    if (stmt == NULL || !db_stmt_open_cursor(stmt, &cursor).success) {
+        return false;
+    }
+    
+    if (db_cursor_next(&cursor)) {
+        *count = db_cursor_get_uint(&cursor, 0);
+    }
+    db_cursor_close(&cursor);
+    
+    return true;
+}
+
+/**
+ * @brief 执行事务控制操作
+ */
+static db_result_t run_transaction_op(int (*op)(void))
+{
+    int error_code = op();
+    
+    if (error_code != DB_ERROR_NONE) {
+        return create_driver_error(error_code);
+    }
+    return create_success_result(0, 0);
+}
+
+/**
+ * @brief 读取状态列（v2为sensor_status_t数值，v1为状态文本；未知值按正常处理）
+ */
+static sensor_status_t read_status(const db_cursor_t* cursor, uint8_t column)
+{
+#if DB_SCHEMA_VERSION >= 2
+    uint32_t status = db_cursor_get_uint(cursor, column);
+    
+    return (status <= SENSOR_STATUS_OFFLINE) ? (sensor_status_t)status : SENSOR_STATUS_NORMAL;
+#else
+    const char* text = db_cursor_get_text(cursor, column);
+    int status;
+    
+    for (status = SENSOR_STATUS_NORMAL; status <= SENSOR_STATUS_OFFLINE; status++) {
+        if (strcmp(text, get_sensor_status_string((sensor_status_t)status)) == 0) {
+            return (sensor_status_t)status;
+        }
+    }
+    return SENSOR_STATUS_NORMAL;
+#endif
+}
+
+/**
+ * @brief 清除维护的行数，下次查询时重新统计
+ */
+static void reset_row_counts(void)
+{
+    memset(row_counts, 0, sizeof(row_counts));
+    memset(pending_counts, 0, sizeof(pending_counts));
+    row_counts_valid = false;
+    in_transaction = false;
+}
+
+/**
+ * @brief 全表计数
+ */
+static bool load_row_counts(uint32_t* counts)
+{
+    return get_count(DB_STMT_COUNT_SENSOR1, &counts[DB_TABLE_SENSOR1]) &&
+           get_count(DB_STMT_COUNT_SENSOR2, &counts[DB_TABLE_SENSOR2]);
+}
+
+/**
+ * @brief 清空字典键缓存（重连或事务回滚后重新查询）
+ */
+static void reset_dict_cache(void)
+{
+#if DB_SCHEMA_VERSION >= 2
+    memset(dict_cache, 0, sizeof(dict_cache));
+    dict_next = 0;
+#endif
+}
+
+#if DB_SCHEMA_VERSION >= 2
+/**
+ * @brief 取名称的字典键：先查缓存，再查字典表，不存在时新增
+ */
+static db_result_t resolve_dict_key(uint8_t kind, const char* name, uint16_t* key)
+{
+    db_result_t result;
+    db_stmt_t* stmt;
+    db_cursor_t cursor;
+    uint8_t attempt;
+    uint8_t i;
+    
+    for (i = 0; i < DB_DICT_CACHE_SIZE; i++) {
+        if (dict_cache[i].key != 0 && dict_cache[i].kind == kind &&
+            strcmp(dict_cache[i].name, name) == 0) {
+            *key = dict_cache[i].key;
+            return create_success_result(0, 0);
+        }
+    }
+    
+    /* 第一次查不到时新增（与其他写入方同时新增时被忽略），再查一次 */
+    for (attempt = 0; attempt < 2; attempt++) {
+        stmt = database_prepare(DB_STMT_DICT_LOOKUP);
+        if (stmt == NULL) {
+            return create_error_result(DB_ERROR_QUERY, "Prepare failed");
+        }
+        db_stmt_bind_uint(stmt, 0, kind);
+        db_stmt_bind_text(stmt, 1, name);
+        
+        result = db_stmt_open_cursor(stmt, &cursor);
+        if (!result.success) {
+            return result;
+        }
+        *key = db_cursor_next(&cursor) ? (uint16_t)db_cursor_get_uint(&cursor, 0) : 0;
+        db_cursor_close(&cursor);
+        
+        if (*key != 0) {
+            dict_cache[dict_next].key = *key;
+            dict_cache[dict_next].kind = kind;
+            SAFE_STRCPY(dict_cache[dict_next].name, name, sizeof(dict_cache[dict_next].name));
+            dict_next = (uint8_t)((dict_next + 1) % DB_DICT_CACHE_SIZE);
+            return create_success_result(0, 0);
+        }
+        
+        if (attempt == 0) {
+            stmt = database_prepare(DB_STMT_DICT_INSERT);
+            if (stmt == NULL) {
+                return create_error_result(DB_ERROR_INSERT, "Prepare failed");
+            }
+            db_stmt_bind_uint(stmt, 0, kind);
+            db_stmt_bind_text(stmt, 1, name);
+            result = db_stmt_execute(stmt);
+            if (!result.success) {
+                return result;
             }
-        } else {
-            output[j++] = input[i];
         }
     }
     
-    output[j] = '\0';
-    return output;
+    return create_error_result(DB_ERROR_INSERT, "Dictionary key not allocated");
 }
 
 /**
- * @brief 模拟数据库延迟
+ * @brief 取一行数据的学号和传感器名称字典键
  */
-static void simulate_database_delay(void)
+static db_result_t resolve_row_keys(const char* student_id, const char* sensor_name,
+                                    uint16_t* student_key, uint16_t* sensor_key)
 {
-    /* 在实际项目中，这里不需要延迟 */
-    /* 这里只是为了模拟数据库操作的时间消耗 */
-    volatile int i;
-    for (i = 0; i < 1000; i++) {
-        /* 空循环模拟延迟 */
+    db_result_t result = resolve_dict_key(DB_DICT_STUDENT, student_id, student_key);
+    
+    if (result.success) {
+        result = resolve_dict_key(DB_DICT_SENSOR, sensor_name, sensor_key);
     }
-}
\ No newline at end of file
+    return result;
+}
+
+/**
+ * @brief 转换为0.01单位的定点数（四舍五入）
+ */
+static int32_t to_fixed_point(float value)
+{
+    float scaled = value * SQL_FIXED_SCALE;
+    
+    return (int32_t)((scaled >= 0.0f) ? (scaled + 0.5f) : (scaled - 0.5f));
+}
+#endif
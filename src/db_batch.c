@@ -0,0 +1,391 @@
+/**
+ * @file db_batch.c
+ * @brief 数据库批量写入模块实现 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ */
+
+#include "db_batch.h"
+
+#if ENABLE_DB_BATCH
+#if ENABLE_DB_ROLLUP
+#include "db_rollup.h"
+#endif
+
+/* 单表批次 */
+typedef struct {
+    char sql[DB_BATCH_SQL_SIZE];            /* 多行INSERT语句 */
+    strbuf_t sb;                            /* 语句构建器 */
+    size_t prefix_length;                   /* INSERT ... VALUES 前缀长度 */
+    uint32_t row_ids[DB_BATCH_MAX_ROWS];    /* 批内各行行号 */
+    sensor_data_t rows[DB_BATCH_MAX_ROWS];  /* 批内各行数据（失败时随结果报告） */
+    uint16_t count;                         /* 批内行数 */
+    uint32_t first_time;                    /* 首行入批时间（毫秒） */
+} batch_table_t;
+
+/* 静态变量 */
+static batch_table_t tables[DB_BATCH_TABLE_COUNT];
+static db_row_outcome_t outcomes[DB_BATCH_MAX_ROWS];
+static db_batch_config_t current_config;
+static db_batch_statistics_t statistics;
+static uint32_t next_row_id = 1;
+static db_batch_outcome_callback_t outcome_callback = NULL;
+static void* outcome_context = NULL;
+
+/* 表前缀，与sensor_type_t - 1对应 */
+static const char* const TABLE_PREFIXES[DB_BATCH_TABLE_COUNT] = {
+    SQL_INSERT_SENSOR1,
+    SQL_INSERT_SENSOR2
+};
+
+/* 默认批量配置 */
+const db_batch_config_t DEFAULT_DB_BATCH_CONFIG = {
+    DB_BATCH_DEFAULT_ROWS,                  /* max_rows */
+    DB_BATCH_DEFAULT_BYTES,                 /* max_bytes */
+    DB_BATCH_DEFAULT_DELAY                  /* max_delay */
+};
+
+/* 内部函数声明 */
+static bool is_valid_config(const db_batch_config_t* config);
+static uint16_t flush_table(uint8_t index, db_flush_reason_t reason);
+#if ENABLE_DB_ROLLUP
+static db_result_t insert_with_rollup(batch_table_t* table);
+#endif
+static bool append_row(batch_table_t* table, const sensor_data_t* data);
+static void report_row(uint32_t row_id, const sensor_data_t* data, db_row_status_t status, int error_code);
+
+/**
+ * @brief 初始化批量写入模块
+ */
+system_status_t db_batch_init(const db_batch_config_t* config)
+{
+    uint8_t i;
+
+    if (config == NULL) {
+        config = &DEFAULT_DB_BATCH_CONFIG;
+    }
+    if (!is_valid_config(config)) {
+        return SYSTEM_ERROR;
+    }
+
+    memcpy(&current_config, config, sizeof(db_batch_config_t));
+    memset(&statistics, 0, sizeof(statistics));
+    next_row_id = 1;
+
+    for (i = 0; i < DB_BATCH_TABLE_COUNT; i++) {
+        strbuf_init(&tables[i].sb, tables[i].sql, sizeof(tables[i].sql));
+        strbuf_append_str(&tables[i].sb, TABLE_PREFIXES[i]);
+        tables[i].prefix_length = strbuf_length(&tables[i].sb);
+        tables[i].count = 0;
+        tables[i].first_time = 0;
+    }
+
+    DEBUG_PRINT("DB batch initialized: rows=%d, bytes=%d, delay=%lu",
+                current_config.max_rows, current_config.max_bytes, current_config.max_delay);
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 运行时调整批量配置
+ */
+system_status_t db_batch_set_config(const db_batch_config_t* config)
+{
+    uint8_t i;
+
+    if (!is_valid_config(config)) {
+        return SYSTEM_ERROR;
+    }
+
+    memcpy(&current_config, config, sizeof(db_batch_config_t));
+
+    /* 已积累的批次超过新上限时立即写出 */
+    for (i = 0; i < DB_BATCH_TABLE_COUNT; i++) {
+        if (tables[i].count >= current_config.max_rows) {
+            flush_table(i, DB_FLUSH_ROWS);
+        } else if (strbuf_length(&tables[i].sb) > current_config.max_bytes) {
+            flush_table(i, DB_FLUSH_BYTES);
+        }
+    }
+
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 获取当前批量配置
+ */
+void db_batch_get_config(db_batch_config_t* config)
+{
+    if (config != NULL) {
+        memcpy(config, &current_config, sizeof(db_batch_config_t));
+    }
+}
+
+/**
+ * @brief 设置逐行结果回调
+ */
+void db_batch_set_outcome_callback(db_batch_outcome_callback_t callback, void* context)
+{
+    outcome_callback = callback;
+    outcome_context = context;
+}
+
+/**
+ * @brief 添加一行待写入数据
+ */
+db_result_t db_batch_add(const sensor_data_t* data, uint32_t* row_id)
+{
+    db_result_t result;
+    batch_table_t* table;
+    uint8_t index;
+    uint32_t id;
+
+    /* 数据检查（与单行插入相同的规则） */
+    result = database_check_sensor_row(data);
+    if (data == NULL) {
+        return result;
+    }
+
+    id = next_row_id++;
+    if (row_id != NULL) {
+        *row_id = id;
+    }
+
+    if (!result.success) {
+        report_row(id, data, DB_ROW_REJECTED, result.error_code);
+        return result;
+    }
+
+    /* 语句中引用的字典键在入批前取得；需要访问数据库，失败时按语句失败报告 */
+    result = database_resolve_sensor_row(data);
+    if (!result.success) {
+        report_row(id, data, DB_ROW_FAILED, result.error_code);
+        return result;
+    }
+
+    index = (uint8_t)(data->type - SENSOR_TYPE_TEMP_HUMIDITY);
+    table = &tables[index];
+
+    /* 放不下时先写出当前批次，再放入空批次 */
+    if (!append_row(table, data)) {
+        flush_table(index, DB_FLUSH_BYTES);
+        if (!append_row(table, data)) {
+            report_row(id, data, DB_ROW_REJECTED, DB_ERROR_INVALID_PARAM);
+            result.success = false;
+            result.error_code = DB_ERROR_INVALID_PARAM;
+            SAFE_STRCPY(result.error_message, "Row exceeds batch statement size",
+                        sizeof(result.error_message));
+            return result;
+        }
+    }
+
+    if (table->count == 0) {
+        table->first_time = get_tick_ms();
+    }
+    memcpy(&table->rows[table->count], data, sizeof(sensor_data_t));
+    table->row_ids[table->count++] = id;
+    statistics.rows_added++;
+
+    if (table->count >= current_config.max_rows) {
+        flush_table(index, DB_FLUSH_ROWS);
+    }
+
+    result.affected_rows = 0;
+    return result;
+}
+
+/**
+ * @brief 刷新等待时间已到的批次
+ */
+uint16_t db_batch_poll(uint32_t now)
+{
+    uint16_t written = 0;
+    uint8_t i;
+
+    if (current_config.max_delay == 0) {
+        return 0;
+    }
+
+    for (i = 0; i < DB_BATCH_TABLE_COUNT; i++) {
+        /* 无符号差值：计时回绕后仍正确 */
+        if (tables[i].count > 0 &&
+            (uint32_t)(now - tables[i].first_time) >= current_config.max_delay) {
+            written += flush_table(i, DB_FLUSH_TIME);
+        }
+    }
+
+    return written;
+}
+
+/**
+ * @brief 立即刷新所有批次
+ */
+uint16_t db_batch_flush_all(void)
+{
+    uint16_t written = 0;
+    uint8_t i;
+
+    for (i = 0; i < DB_BATCH_TABLE_COUNT; i++) {
+        written += flush_table(i, DB_FLUSH_FORCED);
+    }
+
+    return written;
+}
+
+/**
+ * @brief 获取批量统计信息
+ */
+void db_batch_get_statistics(db_batch_statistics_t* stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+
+    memcpy(stats, &statistics, sizeof(db_batch_statistics_t));
+    stats->pending_rows = (uint16_t)(tables[0].count + tables[1].count);
+}
+
+/* 内部函数实现 */
+
+/**
+ * @brief 检查配置范围
+ */
+static bool is_valid_config(const db_batch_config_t* config)
+{
+    return config != NULL &&
+           config->max_rows >= 1 && config->max_rows <= DB_BATCH_MAX_ROWS &&
+           config->max_bytes > 0 && config->max_bytes < DB_BATCH_SQL_SIZE;
+}
+
+/**
+ * @brief 写出一张表的批次并逐行报告结果
+ */
+static uint16_t flush_table(uint8_t index, db_flush_reason_t reason)
+{
+    batch_table_t* table = &tables[index];
+    db_result_t result;
+    uint16_t count = table->count;
+    uint16_t i;
+
+    if (count == 0) {
+        return 0;
+    }
+
+#if ENABLE_DB_ROLLUP
+    result = insert_with_rollup(table);
+#else
+    result = database_execute_insert(strbuf_cstr(&table->sb), count);
+#endif
+    statistics.statements++;
+    statistics.flush_count[reason]++;
+
+    for (i = 0; i < count; i++) {
+        outcomes[i].row_id = table->row_ids[i];
+        outcomes[i].type = (sensor_type_t)(index + SENSOR_TYPE_TEMP_HUMIDITY);
+        outcomes[i].status = result.success ? DB_ROW_INSERTED : DB_ROW_FAILED;
+        outcomes[i].error_code = result.error_code;
+        outcomes[i].data = &table->rows[i];
+    }
+
+    if (result.success) {
+        statistics.rows_inserted += count;
+    } else {
+        statistics.rows_failed += count;
+    }
+
+    /* 先清空批次再回调（outcomes为共享缓冲区、rows在下次添加前有效，回调中不能再添加数据） */
+    strbuf_truncate(&table->sb, table->prefix_length);
+    table->count = 0;
+
+    if (outcome_callback != NULL) {
+        outcome_callback(outcomes, count, outcome_context);
+    }
+
+    return count;
+}
+
+#if ENABLE_DB_ROLLUP
+/**
+ * @brief 在一个事务中写入批次并累加汇总表，两者一起提交或一起回滚
+ *        （提交前写出汇总表、回滚时丢弃由事务函数完成）
+ */
+static db_result_t insert_with_rollup(batch_table_t* table)
+{
+    db_result_t result;
+    uint16_t i;
+
+    result = database_begin_transaction();
+    if (!result.success) {
+        return result;
+    }
+
+    result = database_execute_insert(strbuf_cstr(&table->sb), table->count);
+    for (i = 0; result.success && i < table->count; i++) {
+        result = db_rollup_add(&table->rows[i]);
+    }
+    if (result.success) {
+        result = database_commit_transaction();
+    }
+
+    if (!result.success) {
+        database_rollback_transaction();
+    }
+    return result;
+}
+#endif
+
+/**
+ * @brief 向批次追加一行，超出行数或字节上限时回退并返回false
+ */
+static bool append_row(batch_table_t* table, const sensor_data_t* data)
+{
+    size_t mark = strbuf_length(&table->sb);
+
+    if (table->count >= current_config.max_rows) {
+        return false;
+    }
+
+    if (table->count > 0) {
+        strbuf_append_str(&table->sb, ", ");
+    }
+
+    if (!database_append_sensor_values(&table->sb, data) ||
+        strbuf_length(&table->sb) > current_config.max_bytes) {
+        strbuf_truncate(&table->sb, mark);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief 报告未进入批次的行
+ */
+static void report_row(uint32_t row_id, const sensor_data_t* data, db_row_status_t status, int error_code)
+{
+    db_row_outcome_t outcome;
+
+    if (status == DB_ROW_FAILED) {
+        statistics.rows_failed++;
+    } else {
+        statistics.rows_rejected++;
+    }
+
+    if (outcome_callback == NULL) {
+        return;
+    }
+
+    outcome.row_id = row_id;
+    outcome.type = data->type;
+    outcome.status = status;
+    outcome.error_code = error_code;
+    outcome.data = data;
+    outcome_callback(&outcome, 1, outcome_context);
+}
+
+#else
+
+/* 未启用时本文件为空，避免空翻译单元告警 */
+typedef int db_batch_unused_t;
+
+#endif /* ENABLE_DB_BATCH */
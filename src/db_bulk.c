@@ -0,0 +1,314 @@
+/**
+ * @file db_bulk.c
+ * @brief 数据库批量装载模块实现 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ */
+
+#include "db_bulk.h"
+
+#if ENABLE_DB_BULK
+#include "strbuf.h"
+#if ENABLE_DB_ROLLUP
+#include "db_rollup.h"
+#endif
+
+/* 静态变量 */
+static db_bulk_statistics_t statistics;
+static bool bulk_active = false;
+static FILE* stage_files[DB_TABLE_COUNT];
+static uint32_t stage_rows[DB_TABLE_COUNT];
+static uint32_t start_ms = 0;
+static char line_buffer[DB_BULK_LINE_SIZE];
+static char path_buffer[DB_BULK_PATH_SIZE];
+
+/* 内部函数声明 */
+static const char* stage_path(uint8_t table);
+static bool close_stage_files(void);
+static void remove_stage_files(void);
+static db_result_t fail_bulk(db_result_t result);
+static db_result_t create_bulk_result(bool success, int error_code, const char* message,
+                                      uint32_t rows);
+
+/**
+ * @brief 初始化批量装载模块
+ */
+system_status_t db_bulk_init(void)
+{
+    if (bulk_active) {
+        db_bulk_abort();
+    }
+
+    memset(&statistics, 0, sizeof(statistics));
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 开始一次装载
+ */
+db_result_t db_bulk_begin(void)
+{
+    db_result_t result;
+    uint8_t t;
+
+    if (bulk_active) {
+        return create_bulk_result(false, DB_ERROR_INVALID_PARAM, "Bulk load already running", 0);
+    }
+
+    result = database_begin_transaction();
+    if (!result.success) {
+        return result;
+    }
+
+    for (t = 0; t < DB_TABLE_COUNT; t++) {
+        /* 二进制方式写入：行尾固定为SQL_BULK_LINE_END，不做换行转换 */
+        stage_files[t] = fopen(stage_path(t), "wb");
+        stage_rows[t] = 0;
+        if (stage_files[t] == NULL) {
+            close_stage_files();
+            remove_stage_files();
+            database_rollback_transaction();
+            return create_bulk_result(false, DB_ERROR_INSERT, "Cannot create staging file", 0);
+        }
+    }
+
+    start_ms = get_tick_ms();
+    bulk_active = true;
+    return create_bulk_result(true, DB_ERROR_NONE, NULL, 0);
+}
+
+/**
+ * @brief 追加一行到暂存文件
+ */
+db_result_t db_bulk_add(const sensor_data_t* data)
+{
+    db_result_t result;
+    strbuf_t sb;
+    uint8_t table;
+
+    if (!bulk_active) {
+        return create_bulk_result(false, DB_ERROR_INVALID_PARAM, "No bulk load running", 0);
+    }
+
+    result = database_check_sensor_row(data);
+    if (!result.success) {
+        statistics.rows_rejected++;
+        return result;
+    }
+
+    /* v2表结构：新名称在同一事务中写入字典表，暂存行只含字典键 */
+    result = database_resolve_sensor_row(data);
+    if (!result.success) {
+        return result;
+    }
+
+    strbuf_init(&sb, line_buffer, sizeof(line_buffer));
+    if (!database_append_sensor_line(&sb, data)) {
+        return create_bulk_result(false, DB_ERROR_INSERT, "Bulk load line too long", 0);
+    }
+
+    table = (data->type == SENSOR_TYPE_TEMP_HUMIDITY) ? DB_TABLE_SENSOR1 : DB_TABLE_SENSOR2;
+    if (fwrite(line_buffer, 1, strbuf_length(&sb), stage_files[table]) != strbuf_length(&sb)) {
+        return create_bulk_result(false, DB_ERROR_INSERT, "Staging file write failed", 0);
+    }
+    stage_rows[table]++;
+
+#if ENABLE_DB_ROLLUP
+    /* 汇总表的累加与装载在同一事务中提交 */
+    result = db_rollup_add(data);
+    if (!result.success) {
+        return result;
+    }
+#endif
+    return create_bulk_result(true, DB_ERROR_NONE, NULL, 1);
+}
+
+/**
+ * @brief 装载暂存的行并提交事务
+ */
+db_result_t db_bulk_commit(void)
+{
+    uint32_t table_rows[DB_TABLE_COUNT];
+    uint32_t total = 0;
+    uint32_t elapsed;
+    db_result_t result;
+    bool defer_indexes;
+    uint8_t t;
+
+    if (!bulk_active) {
+        return create_bulk_result(false, DB_ERROR_INVALID_PARAM, "No bulk load running", 0);
+    }
+
+    if (!close_stage_files()) {
+        return fail_bulk(create_bulk_result(false, DB_ERROR_INSERT, "Staging file write failed", 0));
+    }
+
+    /* 维护的行数不可用时按小批装载处理，不推迟索引维护 */
+    if (!database_get_statistics(&table_rows[DB_TABLE_SENSOR1], &table_rows[DB_TABLE_SENSOR2]).success) {
+        table_rows[DB_TABLE_SENSOR1] = 0xFFFFFFFFUL;
+        table_rows[DB_TABLE_SENSOR2] = 0xFFFFFFFFUL;
+    }
+
+    for (t = 0; t < DB_TABLE_COUNT; t++) {
+        if (stage_rows[t] == 0) {
+            continue;
+        }
+        defer_indexes = (table_rows[t] / DB_BULK_DEFER_INDEX_RATIO) <= stage_rows[t];
+        result = database_bulk_load(t, stage_path(t), stage_rows[t], defer_indexes);
+        if (!result.success) {
+            return fail_bulk(result);
+        }
+        total += stage_rows[t];
+    }
+
+    /* 汇总表由database_commit_transaction()在提交前写出 */
+    result = database_commit_transaction();
+    if (!result.success) {
+        return fail_bulk(result);
+    }
+
+    remove_stage_files();
+    bulk_active = false;
+
+    elapsed = get_tick_ms() - start_ms;
+    if (elapsed == 0) {
+        elapsed = 1;
+    }
+    statistics.loads_completed++;
+    statistics.rows_loaded += total;
+    statistics.last_rows = total;
+    statistics.last_elapsed_ms = elapsed;
+    statistics.last_rows_per_second = (uint32_t)((float)total * 1000.0f / (float)elapsed);
+
+    INFO_PRINT("Bulk load: %lu rows in %lu ms (%lu rows/s)", total, elapsed,
+               statistics.last_rows_per_second);
+    return create_bulk_result(true, DB_ERROR_NONE, NULL, total);
+}
+
+/**
+ * @brief 放弃进行中的装载
+ */
+void db_bulk_abort(void)
+{
+    if (!bulk_active) {
+        return;
+    }
+
+    close_stage_files();
+    remove_stage_files();
+    database_rollback_transaction();
+
+    bulk_active = false;
+    statistics.loads_failed++;
+}
+
+/**
+ * @brief 是否有进行中的装载
+ */
+bool db_bulk_active(void)
+{
+    return bulk_active;
+}
+
+/**
+ * @brief 当前装载已暂存的行数
+ */
+uint32_t db_bulk_staged_rows(void)
+{
+    return bulk_active ? stage_rows[DB_TABLE_SENSOR1] + stage_rows[DB_TABLE_SENSOR2] : 0;
+}
+
+/**
+ * @brief 获取批量装载统计信息
+ */
+void db_bulk_get_statistics(db_bulk_statistics_t* stats)
+{
+    if (stats != NULL) {
+        memcpy(stats, &statistics, sizeof(db_bulk_statistics_t));
+    }
+}
+
+/* 内部函数实现 */
+
+/**
+ * @brief 暂存文件路径：<dir>/<prefix>_s<表>.tsv
+ */
+static const char* stage_path(uint8_t table)
+{
+    strbuf_t sb;
+
+    strbuf_init(&sb, path_buffer, sizeof(path_buffer));
+    strbuf_append_str(&sb, DB_BULK_DIRECTORY "/" DB_BULK_PREFIX "_s");
+    strbuf_append_uint(&sb, (uint32_t)table + 1);
+    strbuf_append_str(&sb, DB_BULK_SUFFIX);
+    return strbuf_cstr(&sb);
+}
+
+/**
+ * @brief 关闭暂存文件
+ * @return bool 所有文件都完整写出时返回true
+ */
+static bool close_stage_files(void)
+{
+    bool ok = true;
+    uint8_t t;
+
+    for (t = 0; t < DB_TABLE_COUNT; t++) {
+        if (stage_files[t] != NULL) {
+            if (fflush(stage_files[t]) != 0 || ferror(stage_files[t])) {
+                ok = false;
+            }
+            fclose(stage_files[t]);
+            stage_files[t] = NULL;
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief 删除暂存文件
+ */
+static void remove_stage_files(void)
+{
+    uint8_t t;
+
+    for (t = 0; t < DB_TABLE_COUNT; t++) {
+        remove(stage_path(t));
+    }
+}
+
+/**
+ * @brief 放弃装载并返回失败结果
+ */
+static db_result_t fail_bulk(db_result_t result)
+{
+    db_bulk_abort();
+    ERROR_PRINT("Bulk load failed: %s", result.error_message);
+    return result;
+}
+
+/**
+ * @brief 创建操作结果
+ */
+static db_result_t create_bulk_result(bool success, int error_code, const char* message,
+                                      uint32_t rows)
+{
+    db_result_t result;
+
+    memset(&result, 0, sizeof(result));
+    result.success = success;
+    result.error_code = error_code;
+    result.affected_rows = rows;
+    if (message != NULL) {
+        SAFE_STRCPY(result.error_message, message, sizeof(result.error_message));
+    }
+    return result;
+}
+
+#else
+
+/* 未启用时本文件为空，避免空翻译单元告警 */
+typedef int db_bulk_unused_t;
+
+#endif /* ENABLE_DB_BULK */
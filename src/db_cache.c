@@ -0,0 +1,293 @@
+/**
+ * @file db_cache.c
+ * @brief 最新数据缓存模块实现 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ */
+
+#include "db_cache.h"
+
+#if ENABLE_DB_CACHE
+
+/* 单个键的缓存 */
+typedef struct {
+    bool used;                              /* 是否在使用 */
+    bool complete;                          /* 缓冲区包含该键在数据库中的全部行 */
+    sensor_type_t type;                     /* 数据类型 */
+    char student_id[MAX_STUDENT_ID_LEN];    /* 学号 */
+    uint8_t head;                           /* 下一次写入位置 */
+    uint8_t count;                          /* 已保存的行数 */
+    uint32_t last_use;                      /* 最近一次写入或查询（淘汰依据） */
+    sensor_data_t rows[DB_CACHE_DEPTH];     /* 环形缓冲区，head之前为最新行 */
+} cache_entry_t;
+
+/* 静态变量 */
+static cache_entry_t entries[DB_CACHE_MAX_KEYS];
+static db_cache_statistics_t statistics;
+static uint32_t use_clock = 0;
+
+/* 内部函数声明 */
+static cache_entry_t* find_entry(sensor_type_t type, const char* student_id);
+static cache_entry_t* allocate_entry(sensor_type_t type, const char* student_id);
+static void fill_entry(cache_entry_t* entry, const sensor_data_t* rows, uint16_t count, bool complete);
+static db_result_t query_database(sensor_type_t type, const char* student_id,
+                                  sensor_data_t* rows, uint16_t limit);
+static const char* get_student_id(const sensor_data_t* data);
+static db_result_t create_cache_result(bool success, int error_code, const char* message,
+                                       uint32_t rows);
+
+/**
+ * @brief 初始化缓存
+ */
+system_status_t db_cache_init(void)
+{
+    memset(entries, 0, sizeof(entries));
+    memset(&statistics, 0, sizeof(statistics));
+    use_clock = 0;
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 记录一条已写入数据库的数据
+ */
+void db_cache_put(const sensor_data_t* data)
+{
+    cache_entry_t* entry;
+    const char* student_id;
+
+    if (data == NULL ||
+        (data->type != SENSOR_TYPE_TEMP_HUMIDITY && data->type != SENSOR_TYPE_INTERRUPT)) {
+        return;
+    }
+
+    student_id = get_student_id(data);
+    entry = find_entry(data->type, student_id);
+    if (entry == NULL) {
+        entry = allocate_entry(data->type, student_id);
+    }
+
+    memcpy(&entry->rows[entry->head], data, sizeof(sensor_data_t));
+    entry->head = (uint8_t)((entry->head + 1) % DB_CACHE_DEPTH);
+    if (entry->count < DB_CACHE_DEPTH) {
+        entry->count++;
+    } else {
+        /* 覆盖了最旧的一行，之后更早的历史只在数据库中 */
+        entry->complete = false;
+    }
+    entry->last_use = ++use_clock;
+    statistics.puts++;
+}
+
+/**
+ * @brief 查询某学号最新的limit条数据
+ */
+db_result_t db_cache_query_latest(sensor_type_t type, const char* student_id,
+                                  sensor_data_t* rows, uint16_t limit)
+{
+    db_result_t result;
+    cache_entry_t* entry = NULL;
+    bool by_id;
+    uint16_t n;
+    uint16_t i;
+    uint8_t pos;
+
+    if (rows == NULL || limit == 0 ||
+        (type != SENSOR_TYPE_TEMP_HUMIDITY && type != SENSOR_TYPE_INTERRUPT) ||
+        (student_id != NULL && strlen(student_id) >= MAX_STUDENT_ID_LEN)) {
+        return create_cache_result(false, DB_ERROR_INVALID_PARAM, "Invalid cache query parameters", 0);
+    }
+
+    by_id = (student_id != NULL && student_id[0] != '\0');
+    if (by_id) {
+        entry = find_entry(type, student_id);
+    }
+
+    if (entry != NULL && (limit <= entry->count || entry->complete)) {
+        n = (limit < entry->count) ? limit : entry->count;
+        pos = entry->head;
+        for (i = 0; i < n; i++) {
+            pos = (uint8_t)((pos + DB_CACHE_DEPTH - 1) % DB_CACHE_DEPTH);
+            memcpy(&rows[i], &entry->rows[pos], sizeof(sensor_data_t));
+        }
+        entry->last_use = ++use_clock;
+        statistics.hits++;
+        return create_cache_result(true, DB_ERROR_NONE, NULL, n);
+    }
+
+    statistics.misses++;
+    result = query_database(type, student_id, rows, limit);
+    if (!result.success || !by_id) {
+        return result;
+    }
+
+    /* 数据库结果就是该键最新的行，用它替换缓冲区内容 */
+    if (entry == NULL) {
+        entry = allocate_entry(type, student_id);
+    }
+    fill_entry(entry, rows, (uint16_t)result.affected_rows, result.affected_rows < limit);
+    entry->last_use = ++use_clock;
+    statistics.fills++;
+
+    return result;
+}
+
+/**
+ * @brief 使全部缓存失效
+ */
+void db_cache_invalidate(void)
+{
+    memset(entries, 0, sizeof(entries));
+    statistics.keys_used = 0;
+    statistics.invalidations++;
+}
+
+/**
+ * @brief 获取缓存统计信息
+ */
+void db_cache_get_statistics(db_cache_statistics_t* stats)
+{
+    if (stats != NULL) {
+        memcpy(stats, &statistics, sizeof(db_cache_statistics_t));
+    }
+}
+
+/* 内部函数实现 */
+
+/**
+ * @brief 查找键
+ */
+static cache_entry_t* find_entry(sensor_type_t type, const char* student_id)
+{
+    uint8_t i;
+
+    for (i = 0; i < DB_CACHE_MAX_KEYS; i++) {
+        if (entries[i].used && entries[i].type == type &&
+            strcmp(entries[i].student_id, student_id) == 0) {
+            return &entries[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 分配一个空键，没有空位时淘汰最久未用的键
+ */
+static cache_entry_t* allocate_entry(sensor_type_t type, const char* student_id)
+{
+    cache_entry_t* entry = NULL;
+    uint8_t i;
+
+    for (i = 0; i < DB_CACHE_MAX_KEYS; i++) {
+        if (!entries[i].used) {
+            entry = &entries[i];
+            statistics.keys_used++;
+            break;
+        }
+        if (entry == NULL || (int32_t)(entries[i].last_use - entry->last_use) < 0) {
+            entry = &entries[i];
+        }
+    }
+    if (entry->used) {
+        statistics.evictions++;
+    }
+
+    entry->used = true;
+    entry->complete = false;
+    entry->type = type;
+    SAFE_STRCPY(entry->student_id, student_id, sizeof(entry->student_id));
+    entry->head = 0;
+    entry->count = 0;
+    return entry;
+}
+
+/**
+ * @brief 用按时间倒序排列的查询结果填充缓冲区
+ */
+static void fill_entry(cache_entry_t* entry, const sensor_data_t* rows, uint16_t count, bool complete)
+{
+    uint16_t keep = (count < DB_CACHE_DEPTH) ? count : DB_CACHE_DEPTH;
+    uint16_t i;
+
+    /* 缓冲区按写入顺序存放：最旧的在前 */
+    for (i = 0; i < keep; i++) {
+        memcpy(&entry->rows[i], &rows[keep - 1 - i], sizeof(sensor_data_t));
+    }
+    entry->count = (uint8_t)keep;
+    entry->head = (uint8_t)(keep % DB_CACHE_DEPTH);
+    entry->complete = complete && count <= DB_CACHE_DEPTH;
+}
+
+/**
+ * @brief 从数据库读取最新的limit条数据
+ */
+static db_result_t query_database(sensor_type_t type, const char* student_id,
+                                  sensor_data_t* rows, uint16_t limit)
+{
+    db_result_t result;
+    db_stmt_t* stmt;
+    db_cursor_t cursor;
+    bool by_id = (student_id != NULL && student_id[0] != '\0');
+    uint16_t n = 0;
+    uint8_t index = 0;
+
+    if (type == SENSOR_TYPE_TEMP_HUMIDITY) {
+        stmt = database_prepare(by_id ? DB_STMT_SELECT_SENSOR1_BY_ID : DB_STMT_SELECT_SENSOR1_ALL);
+    } else {
+        stmt = database_prepare(by_id ? DB_STMT_SELECT_SENSOR2_BY_ID : DB_STMT_SELECT_SENSOR2_ALL);
+    }
+    if (stmt == NULL) {
+        return create_cache_result(false, DB_ERROR_QUERY, database_get_last_error(), 0);
+    }
+    if (by_id) {
+        db_stmt_bind_text(stmt, index++, student_id);
+    }
+    db_stmt_bind_uint(stmt, index, limit);
+
+    result = db_stmt_open_cursor(stmt, &cursor);
+    if (!result.success) {
+        return result;
+    }
+
+    while (n < limit && db_cursor_next(&cursor)) {
+        db_cursor_get_sensor_data(&cursor, type, &rows[n]);
+        n++;
+    }
+    db_cursor_close(&cursor);
+
+    return create_cache_result(true, DB_ERROR_NONE, NULL, n);
+}
+
+/**
+ * @brief 取数据中的学号
+ */
+static const char* get_student_id(const sensor_data_t* data)
+{
+    return (data->type == SENSOR_TYPE_TEMP_HUMIDITY) ?
+           data->data.sensor1.student_id : data->data.sensor2.student_id;
+}
+
+/**
+ * @brief 创建操作结果
+ */
+static db_result_t create_cache_result(bool success, int error_code, const char* message,
+                                       uint32_t rows)
+{
+    db_result_t result;
+
+    memset(&result, 0, sizeof(result));
+    result.success = success;
+    result.error_code = error_code;
+    result.affected_rows = rows;
+    if (message != NULL) {
+        SAFE_STRCPY(result.error_message, message, sizeof(result.error_message));
+    }
+    return result;
+}
+
+#else
+
+/* 未启用时本文件为空，避免空翻译单元告警 */
+typedef int db_cache_unused_t;
+
+#endif /* ENABLE_DB_CACHE */
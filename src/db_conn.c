@@ -0,0 +1,323 @@
+/**
+ * @file db_conn.c
+ * @brief 数据库连接管理模块实现 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ */
+
+#include "db_conn.h"
+
+#if ENABLE_DB_CONN
+#ifndef DEVICE_UID_BASE
+#include <time.h>
+#endif
+
+/* 静态变量 */
+static db_conn_config_t current_config;
+static db_config_t connection_config;
+static db_conn_statistics_t statistics;
+static bool suspect = false;                /* 收到错误报告，等待检查 */
+static uint32_t last_activity = 0;          /* 最近一次观察到语句执行的时间 */
+static uint32_t last_check = 0;             /* 最近一次心跳或连接的时间 */
+static uint32_t last_execute_count = 0;
+static uint32_t jitter_state = 0x2545F491UL;
+
+/* 默认连接管理配置 */
+const db_conn_config_t DEFAULT_DB_CONN_CONFIG = {
+    DB_CONN_DEFAULT_BACKOFF_MIN,            /* backoff_min */
+    DB_CONN_DEFAULT_BACKOFF_MAX,            /* backoff_max */
+    DB_CONN_DEFAULT_KEEPALIVE,              /* keepalive_interval */
+    DB_CONN_DEFAULT_PROBE,                  /* probe_interval */
+    DB_CONN_DEFAULT_THRESHOLD,              /* breaker_threshold */
+    DB_CONN_DEFAULT_COOLDOWN                /* breaker_cooldown */
+};
+
+/* 内部函数声明 */
+static void attempt_connect(uint32_t now);
+static void check_connection(uint32_t now);
+static void handle_failure(uint32_t now);
+static uint32_t get_backoff_delay(uint8_t failures);
+static uint32_t device_seed(void);
+static bool is_connection_error(int error_code);
+static uint32_t next_random(void);
+static bool is_due(uint32_t now, uint32_t deadline);
+static uint32_t get_execute_count(void);
+
+/**
+ * @brief 初始化连接管理
+ */
+system_status_t db_conn_init(const db_conn_config_t* config, const db_config_t* db_config)
+{
+
+    if (config == NULL) {
+        config = &DEFAULT_DB_CONN_CONFIG;
+    }
+    if (db_config == NULL || config->backoff_min == 0 ||
+        config->backoff_max < config->backoff_min) {
+        return SYSTEM_ERROR;
+    }
+
+    memcpy(&current_config, config, sizeof(db_conn_config_t));
+    memcpy(&connection_config, db_config, sizeof(db_config_t));
+    memset(&statistics, 0, sizeof(statistics));
+    suspect = false;
+
+    /* 抖动种子每台设备不同（同时上电的设备计时相同），同时掉线时错开重连 */
+    jitter_state = device_seed();
+    if (jitter_state == 0) {
+        jitter_state = 0x2545F491UL;
+    }
+
+    attempt_connect(get_tick_ms());
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 按计时执行心跳、重连和熔断探测
+ */
+void db_conn_poll(uint32_t now)
+{
+    uint32_t execute_count;
+
+    switch (statistics.state) {
+        case DB_CONN_UP:
+            /* 有语句执行即视为连接活跃，不需要心跳 */
+            execute_count = get_execute_count();
+            if (execute_count != last_execute_count) {
+                last_execute_count = execute_count;
+                last_activity = now;
+            }
+
+            if (suspect && is_due(now, last_check + current_config.probe_interval)) {
+                check_connection(now);
+            } else if (current_config.keepalive_interval != 0 &&
+                       is_due(now, last_activity + current_config.keepalive_interval) &&
+                       is_due(now, last_check + current_config.keepalive_interval)) {
+                check_connection(now);
+            }
+            break;
+
+        case DB_CONN_BACKOFF:
+            if (is_due(now, statistics.next_attempt)) {
+                attempt_connect(now);
+            }
+            break;
+
+        case DB_CONN_OPEN:
+            if (is_due(now, statistics.next_attempt)) {
+                /* 冷却结束：只放一次探测连接 */
+                statistics.state = DB_CONN_HALF_OPEN;
+                INFO_PRINT("Database breaker half-open, probing");
+                attempt_connect(now);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief 数据库当前是否可以访问
+ */
+bool db_conn_available(void)
+{
+    return statistics.state == DB_CONN_UP && database_get_status() == DB_STATUS_CONNECTED;
+}
+
+/**
+ * @brief 报告一次数据库错误
+ */
+void db_conn_report_error(int error_code)
+{
+    statistics.errors_reported++;
+
+    /* 数据被拒绝等语句错误不说明连接有问题；连接或探测过程中的错误由发起方处理 */
+    if (statistics.state == DB_CONN_UP && is_connection_error(error_code)) {
+        suspect = true;
+    }
+}
+
+/**
+ * @brief 获取当前连接状态
+ */
+db_conn_state_t db_conn_get_state(void)
+{
+    return statistics.state;
+}
+
+/**
+ * @brief 获取连接管理统计信息
+ */
+void db_conn_get_statistics(db_conn_statistics_t* stats)
+{
+    if (stats != NULL) {
+        memcpy(stats, &statistics, sizeof(db_conn_statistics_t));
+    }
+}
+
+/* 内部函数实现 */
+
+/**
+ * @brief 连接数据库并建表（重连时库文件可能已被替换）
+ */
+static void attempt_connect(uint32_t now)
+{
+    db_result_t result;
+
+    last_check = now;
+
+    /* 清理上一次失败留下的连接状态 */
+    if (database_get_status() != DB_STATUS_DISCONNECTED) {
+        database_disconnect();
+    }
+
+    result = database_connect(&connection_config);
+    if (result.success) {
+        result = database_create_tables();
+    }
+
+    if (!result.success) {
+        statistics.connect_failures++;
+        handle_failure(now);
+        return;
+    }
+
+    if (statistics.consecutive_failures > 0) {
+        INFO_PRINT("Database reconnected after %d failed attempts", statistics.consecutive_failures);
+    }
+    statistics.connect_count++;
+    statistics.consecutive_failures = 0;
+    statistics.state = DB_CONN_UP;
+    suspect = false;
+    last_activity = now;
+    last_execute_count = get_execute_count();
+}
+
+/**
+ * @brief 心跳检查，失败时断开并进入重连等待
+ */
+static void check_connection(uint32_t now)
+{
+    db_result_t result;
+
+    last_check = now;
+    suspect = false;
+    statistics.ping_count++;
+
+    result = database_ping();
+    if (result.success) {
+        return;
+    }
+
+    statistics.ping_failures++;
+    ERROR_PRINT("Database ping failed: %s", result.error_message);
+    database_disconnect();
+    handle_failure(now);
+}
+
+/**
+ * @brief 记录一次失败：未达阈值时退避重连，达到阈值时熔断
+ */
+static void handle_failure(uint32_t now)
+{
+    if (statistics.consecutive_failures < 0xFF) {
+        statistics.consecutive_failures++;
+    }
+
+    if (current_config.breaker_threshold != 0 &&
+        statistics.consecutive_failures >= current_config.breaker_threshold) {
+        if (statistics.state != DB_CONN_OPEN && statistics.state != DB_CONN_HALF_OPEN) {
+            statistics.breaker_trips++;
+            ERROR_PRINT("Database breaker open after %d failures", statistics.consecutive_failures);
+        }
+        statistics.state = DB_CONN_OPEN;
+        statistics.next_attempt = now + current_config.breaker_cooldown;
+        return;
+    }
+
+    statistics.state = DB_CONN_BACKOFF;
+    statistics.next_attempt = now + get_backoff_delay(statistics.consecutive_failures);
+}
+
+/**
+ * @brief 第failures次失败后的等待时间：d = min(backoff_min * 2^(failures-1), backoff_max)，
+ *        在[d/2, d]内随机
+ */
+static uint32_t get_backoff_delay(uint8_t failures)
+{
+    uint32_t delay = current_config.backoff_min;
+    uint8_t i;
+
+    for (i = 1; i < failures && delay < current_config.backoff_max; i++) {
+        delay <<= 1;
+    }
+    if (delay > current_config.backoff_max) {
+        delay = current_config.backoff_max;
+    }
+
+    return delay - (next_random() % (delay / 2 + 1));
+}
+
+/**
+ * @brief 抖动种子：目标板取96位唯一ID，宿主机构建取时间和栈地址
+ */
+static uint32_t device_seed(void)
+{
+#ifdef DEVICE_UID_BASE
+    const volatile uint32_t* uid = (const volatile uint32_t*)DEVICE_UID_BASE;
+
+    return (uid[0] * 2654435761UL) ^ (uid[1] * 2246822519UL) ^ (uid[2] * 3266489917UL);
+#else
+    uint32_t seed = (uint32_t)time(NULL);
+
+    return (seed * 2654435761UL) ^ (uint32_t)(size_t)&seed;
+#endif
+}
+
+/**
+ * @brief 是否为说明连接可能已断开的错误
+ */
+static bool is_connection_error(int error_code)
+{
+    return error_code == DB_ERROR_CONNECTION || error_code == DB_ERROR_TIMEOUT;
+}
+
+/**
+ * @brief xorshift32伪随机数
+ */
+static uint32_t next_random(void)
+{
+    jitter_state ^= jitter_state << 13;
+    jitter_state ^= jitter_state >> 17;
+    jitter_state ^= jitter_state << 5;
+    return jitter_state;
+}
+
+/**
+ * @brief 是否已到期（有符号差值，毫秒计时回绕时仍正确）
+ */
+static bool is_due(uint32_t now, uint32_t deadline)
+{
+    return (int32_t)(now - deadline) >= 0;
+}
+
+/**
+ * @brief 数据库模块累计执行的语句数
+ */
+static uint32_t get_execute_count(void)
+{
+    uint32_t prepare_count;
+    uint32_t execute_count;
+
+    database_get_stmt_statistics(&prepare_count, &execute_count);
+    return execute_count;
+}
+
+#else
+
+/* 未启用时本文件为空，避免空翻译单元告警 */
+typedef int db_conn_unused_t;
+
+#endif /* ENABLE_DB_CONN */
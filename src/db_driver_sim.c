@@ -0,0 +1,324 @@
+/**
+ * @file db_driver_sim.c
+ * @brief 模拟数据库驱动实现 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 不访问任何存储：每次操作用空循环模拟一次往返延迟，写语句按
+ * 插入语句影响1行计，查询不返回任何行（字典键查询除外：按名称
+ * 散列返回一个固定的非0键，v2表结构的写入才能解析字典键；当前时间
+ * 查询返回0，模拟没有时钟的服务器，汇总表的写入才能完成）。批量
+ * 装载读完暂存文件后丢弃（没有LOAD DATA的行数和警告可供核对）。用于
+ * 目标板联调和没有存储后端的构建。
+ */
+
+#include "db_driver.h"
+
+/* 静态变量 */
+static bool connected = false;
+static bool value_row_pending = false;  /* 字典键或当前时间查询还有一行未取出 */
+static uint16_t dict_row_key = 0;
+
+/* 内部函数声明 */
+static void simulate_database_delay(void);
+static uint16_t synthetic_dict_key(const db_stmt_t* stmt);
+static int sim_connect(const db_config_t* config);
+static void sim_disconnect(void);
+static int sim_exec(const char* sql, uint32_t* affected_rows);
+static int sim_prepare(db_stmt_t* stmt);
+static void sim_finalize(db_stmt_t* stmt);
+static int sim_execute(db_stmt_t* stmt, uint32_t* affected_rows);
+static int sim_query(db_stmt_t* stmt);
+static int sim_step(db_stmt_t* stmt, bool* has_row);
+static void sim_reset(db_stmt_t* stmt);
+static uint8_t sim_column_count(db_stmt_t* stmt);
+static int32_t sim_column_int(db_stmt_t* stmt, uint8_t column);
+static uint32_t sim_column_uint(db_stmt_t* stmt, uint8_t column);
+static double sim_column_real(db_stmt_t* stmt, uint8_t column);
+static const char* sim_column_text(db_stmt_t* stmt, uint8_t column);
+static int sim_begin(void);
+static int sim_commit(void);
+static int sim_rollback(void);
+static int sim_bulk_load(uint8_t table, const char* path, bool defer_indexes);
+static const char* sim_last_error(void);
+
+/* 模拟驱动函数表 */
+const db_driver_t DB_DRIVER_SIM = {
+    "sim",
+    NULL,                   /* create_tables：使用默认建表语句 */
+    NULL,                   /* statement_sql：使用默认语句模板 */
+    sim_connect,
+    sim_disconnect,
+    sim_exec,
+    sim_prepare,
+    sim_finalize,
+    sim_execute,
+    sim_query,
+    sim_step,
+    sim_reset,
+    sim_column_count,
+    sim_column_int,
+    sim_column_uint,
+    sim_column_real,
+    sim_column_text,
+    sim_begin,
+    sim_commit,
+    sim_rollback,
+    sim_bulk_load,
+    sim_last_error
+};
+
+/* 内部函数实现 */
+
+/**
+ * @brief 模拟数据库延迟
+ */
+static void simulate_database_delay(void)
+{
+    /* 在实际项目中，这里不需要延迟 */
+    /* 这里只是为了模拟数据库操作的时间消耗 */
+    volatile int i;
+    for (i = 0; i < 1000; i++) {
+        /* 空循环模拟延迟 */
+    }
+}
+
+/**
+ * @brief 字典键：按类别和名称做FNV-1a散列，同一名称总是得到同一个非0键
+ */
+static uint16_t synthetic_dict_key(const db_stmt_t* stmt)
+{
+    const db_param_t* name = &stmt->params[1];
+    uint32_t hash = 2166136261UL ^ stmt->params[0].value.u;
+    uint16_t i;
+
+    if (name->type == DB_PARAM_TEXT) {
+        for (i = 0; i < name->value.text.length; i++) {
+            hash = (hash ^ (uint8_t)name->value.text.ptr[i]) * 16777619UL;
+        }
+    }
+    return (uint16_t)(hash % 0xFFFFU + 1U);
+}
+
+/**
+ * @brief 模拟连接
+ */
+static int sim_connect(const db_config_t* config)
+{
+    (void)config;
+
+    /* 在实际项目中，这里应该是真实的MySQL连接代码 */
+    /* 由于IAR 5.3环境限制，这里使用模拟实现 */
+    simulate_database_delay();
+    connected = true;
+    return DB_ERROR_NONE;
+}
+
+/**
+ * @brief 模拟断开连接
+ */
+static void sim_disconnect(void)
+{
+    simulate_database_delay();
+    connected = false;
+}
+
+/**
+ * @brief 模拟执行无参数语句
+ */
+static int sim_exec(const char* sql, uint32_t* affected_rows)
+{
+    (void)sql;
+
+    if (!connected) {
+        return DB_ERROR_CONNECTION;
+    }
+
+    simulate_database_delay();
+    if (affected_rows != NULL) {
+        *affected_rows = 0;
+    }
+    return DB_ERROR_NONE;
+}
+
+/**
+ * @brief 模拟准备语句
+ */
+static int sim_prepare(db_stmt_t* stmt)
+{
+    if (!connected) {
+        return DB_ERROR_CONNECTION;
+    }
+
+    simulate_database_delay();
+    stmt->handle = NULL;
+    return DB_ERROR_NONE;
+}
+
+/**
+ * @brief 模拟释放语句
+ */
+static void sim_finalize(db_stmt_t* stmt)
+{
+    stmt->handle = NULL;
+}
+
+/**
+ * @brief 模拟执行写语句：插入语句影响1行
+ */
+static int sim_execute(db_stmt_t* stmt, uint32_t* affected_rows)
+{
+    if (!connected) {
+        return DB_ERROR_CONNECTION;
+    }
+
+    simulate_database_delay();
+    *affected_rows = (stmt->id == DB_STMT_INSERT_SENSOR1 ||
+                      stmt->id == DB_STMT_INSERT_SENSOR2 ||
+                      stmt->id == DB_STMT_DICT_INSERT) ? 1 : 0;
+    return DB_ERROR_NONE;
+}
+
+/**
+ * @brief 模拟开始查询
+ */
+static int sim_query(db_stmt_t* stmt)
+{
+    if (!connected) {
+        return DB_ERROR_CONNECTION;
+    }
+
+    simulate_database_delay();
+    value_row_pending = (stmt->id == DB_STMT_DICT_LOOKUP || stmt->id == DB_STMT_CURRENT_TIME);
+    dict_row_key = (stmt->id == DB_STMT_DICT_LOOKUP) ? synthetic_dict_key(stmt) : 0;
+    return DB_ERROR_NONE;
+}
+
+/**
+ * @brief 模拟取行：字典键和当前时间查询返回一行，其他查询没有数据
+ */
+static int sim_step(db_stmt_t* stmt, bool* has_row)
+{
+    *has_row = (stmt->id == DB_STMT_DICT_LOOKUP || stmt->id == DB_STMT_CURRENT_TIME) &&
+               value_row_pending;
+    value_row_pending = false;
+    return DB_ERROR_NONE;
+}
+
+/**
+ * @brief 模拟结束查询
+ */
+static void sim_reset(db_stmt_t* stmt)
+{
+    (void)stmt;
+    value_row_pending = false;
+}
+
+/**
+ * @brief 模拟列数
+ */
+static uint8_t sim_column_count(db_stmt_t* stmt)
+{
+    return (stmt->id == DB_STMT_DICT_LOOKUP || stmt->id == DB_STMT_CURRENT_TIME) ? 1 : 0;
+}
+
+/**
+ * @brief 模拟整数列
+ */
+static int32_t sim_column_int(db_stmt_t* stmt, uint8_t column)
+{
+    (void)stmt;
+    (void)column;
+    return 0;
+}
+
+/**
+ * @brief 模拟无符号整数列
+ */
+static uint32_t sim_column_uint(db_stmt_t* stmt, uint8_t column)
+{
+    return (stmt->id == DB_STMT_DICT_LOOKUP && column == 0) ? dict_row_key : 0;
+}
+
+/**
+ * @brief 模拟浮点数列
+ */
+static double sim_column_real(db_stmt_t* stmt, uint8_t column)
+{
+    (void)stmt;
+    (void)column;
+    return 0.0;
+}
+
+/**
+ * @brief 模拟文本列
+ */
+static const char* sim_column_text(db_stmt_t* stmt, uint8_t column)
+{
+    (void)stmt;
+    (void)column;
+    return "";
+}
+
+/**
+ * @brief 模拟开始事务
+ */
+static int sim_begin(void)
+{
+    return sim_exec("BEGIN", NULL);
+}
+
+/**
+ * @brief 模拟提交事务
+ */
+static int sim_commit(void)
+{
+    return sim_exec("COMMIT", NULL);
+}
+
+/**
+ * @brief 模拟回滚事务
+ */
+static int sim_rollback(void)
+{
+    return sim_exec("ROLLBACK", NULL);
+}
+
+/**
+ * @brief 模拟批量装载：读完暂存文件，不保存数据
+ */
+static int sim_bulk_load(uint8_t table, const char* path, bool defer_indexes)
+{
+    static char buffer[64];
+    FILE* fp;
+    bool ok;
+
+    (void)table;
+    (void)defer_indexes;
+
+    if (!connected) {
+        return DB_ERROR_CONNECTION;
+    }
+
+    fp = fopen(path, "rb");
+    if (fp == NULL) {
+        return DB_ERROR_INVALID_PARAM;
+    }
+    while (fread(buffer, 1, sizeof(buffer), fp) == sizeof(buffer)) {
+        /* 只读取，不保存 */
+    }
+    ok = !ferror(fp);
+    fclose(fp);
+
+    simulate_database_delay();
+    return ok ? DB_ERROR_NONE : DB_ERROR_INSERT;
+}
+
+/**
+ * @brief 模拟驱动没有额外错误信息
+ */
+static const char* sim_last_error(void)
+{
+    return connected ? "" : "Database not connected";
+}
@@ -0,0 +1,634 @@
+/**
+ * @file db_driver_sqlite.c
+ * @brief 嵌入式SQLite数据库驱动实现
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 仅在定义DB_WITH_SQLITE时编译（主机构建：make DB_WITH_SQLITE=1），
+ * 数据保存在本地文件db_config_t.database + DB_SQLITE_FILE_SUFFIX中，
+ * database为":memory:"时使用内存数据库。不需要服务器，可以离线运行
+ * 完整的采集-写库流程并测量真实的存储吞吐量。
+ */
+
+#include "db_driver.h"
+
+#ifdef DB_WITH_SQLITE
+
+#include <sqlite3.h>
+#include "strbuf.h"
+
+/* SQLite方言的建表语句 */
+static const char* const SQLITE_CREATE_TABLES[] = {
+#if DB_SCHEMA_VERSION >= 2
+    "CREATE TABLE IF NOT EXISTS sensor_dict ("
+    "dict_key INTEGER PRIMARY KEY AUTOINCREMENT, "
+    "kind TINYINT NOT NULL, "
+    "name VARCHAR(20) NOT NULL, "
+    "UNIQUE (kind, name)"
+    ")",
+    "CREATE TABLE IF NOT EXISTS sensor1_data ("
+    "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+    "student_key SMALLINT NOT NULL, "
+    "sensor_key SMALLINT NOT NULL, "
+    "temperature SMALLINT NOT NULL, "
+    "humidity SMALLINT NOT NULL, "
+    "status TINYINT NOT NULL, "
+    "timestamp INTEGER NOT NULL, "
+    "created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP"
+    ")",
+    "CREATE INDEX IF NOT EXISTS idx_sensor1_student_row ON sensor1_data (student_key, id)",
+    "CREATE INDEX IF NOT EXISTS idx_sensor1_timestamp ON sensor1_data (timestamp)",
+    "CREATE TABLE IF NOT EXISTS sensor2_data ("
+    "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+    "student_key SMALLINT NOT NULL, "
+    "sensor_key SMALLINT NOT NULL, "
+    "interrupt_type TINYINT NOT NULL, "
+    "interrupt_count INTEGER NOT NULL, "
+    "status TINYINT NOT NULL, "
+    "first_timestamp INTEGER NOT NULL DEFAULT 0, "
+    "timestamp INTEGER NOT NULL, "
+    "created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP"
+    ")",
+    "CREATE INDEX IF NOT EXISTS idx_sensor2_student_row ON sensor2_data (student_key, id)",
+    "CREATE INDEX IF NOT EXISTS idx_sensor2_sensor_ts ON sensor2_data (sensor_key, timestamp)",
+    "CREATE INDEX IF NOT EXISTS idx_sensor2_timestamp ON sensor2_data (timestamp)",
+#else
+    "CREATE TABLE IF NOT EXISTS sensor1_data ("
+    "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+    "student_id VARCHAR(20) NOT NULL, "
+    "sensor_name VARCHAR(16) NOT NULL, "
+    "temperature DECIMAL(5,2) NOT NULL, "
+    "humidity DECIMAL(5,2) NOT NULL, "
+    "status VARCHAR(10) NOT NULL, "
+    "timestamp INTEGER NOT NULL, "
+    "created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP"
+    ")",
+    "CREATE INDEX IF NOT EXISTS idx_sensor1_student_ts ON sensor1_data (student_id, timestamp)",
+    "CREATE INDEX IF NOT EXISTS idx_sensor1_timestamp ON sensor1_data (timestamp)",
+    "CREATE TABLE IF NOT EXISTS sensor2_data ("
+    "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+    "student_id VARCHAR(20) NOT NULL, "
+    "sensor_name VARCHAR(16) NOT NULL, "
+    "interrupt_type TINYINT NOT NULL, "
+    "interrupt_count INTEGER NOT NULL, "
+    "status VARCHAR(10) NOT NULL, "
+    "first_timestamp INTEGER NOT NULL DEFAULT 0, "
+    "timestamp INTEGER NOT NULL, "
+    "created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP"
+    ")",
+    "CREATE INDEX IF NOT EXISTS idx_sensor2_student_ts ON sensor2_data (student_id, timestamp)",
+    "CREATE INDEX IF NOT EXISTS idx_sensor2_sensor_name ON sensor2_data (sensor_name)",
+    "CREATE INDEX IF NOT EXISTS idx_sensor2_timestamp ON sensor2_data (timestamp)",
+#endif
+#if ENABLE_DB_ROLLUP
+    SQL_CREATE_ROLLUP_TABLE(SQL_ROLLUP_MINUTE),
+    SQL_CREATE_ROLLUP_TABLE(SQL_ROLLUP_HOUR),
+    SQL_CREATE_ROLLUP_TABLE(SQL_ROLLUP_DAY),
+#endif
+    NULL
+};
+
+/* SQLite的upsert语法（3.24及以上） */
+#define SQLITE_ROLLUP_UPSERT(table) \
+    SQL_ROLLUP_INSERT(table) " ON CONFLICT (bucket, sensor_type, student_id, sensor_name, status) " \
+    "DO UPDATE SET row_count = row_count + excluded.row_count, " \
+    "sum_a = sum_a + excluded.sum_a, " \
+    "sum_b = sum_b + excluded.sum_b, " \
+    "last_timestamp = MAX(last_timestamp, excluded.last_timestamp)"
+
+/* 与MySQL语法不同的语句，按db_stmt_id_t排列（NULL使用默认模板） */
+static const char* const SQLITE_STATEMENT_SQL[DB_STMT_COUNT] = {
+    NULL,                   /* DB_STMT_INSERT_SENSOR1 */
+    NULL,                   /* DB_STMT_INSERT_SENSOR2 */
+    NULL,                   /* DB_STMT_SELECT_SENSOR1_ALL */
+    NULL,                   /* DB_STMT_SELECT_SENSOR1_BY_ID */
+    NULL,                   /* DB_STMT_SELECT_SENSOR2_ALL */
+    NULL,                   /* DB_STMT_SELECT_SENSOR2_BY_ID */
+    NULL,                   /* DB_STMT_COUNT_SENSOR1 */
+    NULL,                   /* DB_STMT_COUNT_SENSOR2 */
+    "SELECT name FROM sqlite_master WHERE type = 'table' AND name = ?",
+    "DELETE FROM sensor1_data WHERE created_at < datetime('now', '-' || ? || ' days')",
+    "DELETE FROM sensor2_data WHERE created_at < datetime('now', '-' || ? || ' days')",
+    NULL,                   /* DB_STMT_SCAN_SENSOR1 */
+    NULL,                   /* DB_STMT_SCAN_SENSOR1_BY_ID */
+    NULL,                   /* DB_STMT_SCAN_SENSOR2 */
+    NULL,                   /* DB_STMT_SCAN_SENSOR2_BY_ID */
+    "SELECT name FROM sqlite_master WHERE 0 AND name = ?",  /* 不支持分区 */
+    "SELECT CAST(julianday('now', 'localtime') - 1721059.5 AS INTEGER)",
+    "SELECT CAST(strftime('%s', 'now') AS INTEGER)",
+    SQLITE_ROLLUP_UPSERT(SQL_ROLLUP_MINUTE),
+    SQLITE_ROLLUP_UPSERT(SQL_ROLLUP_HOUR),
+    SQLITE_ROLLUP_UPSERT(SQL_ROLLUP_DAY),
+    NULL,                   /* DB_STMT_ROLLUP_QUERY_MINUTE */
+    NULL,                   /* DB_STMT_ROLLUP_QUERY_HOUR */
+    NULL,                   /* DB_STMT_ROLLUP_QUERY_DAY */
+    NULL,                   /* DB_STMT_DICT_LOOKUP */
+    "INSERT OR IGNORE INTO sensor_dict (kind, name) VALUES (?, ?)",
+    NULL,                   /* DB_STMT_BACKUP_SENSOR1 */
+    NULL,                   /* DB_STMT_BACKUP_SENSOR2 */
+    "SELECT 0"              /* 没有警告：批量装载由sqlite_bulk_load逐行写入 */
+};
+
+/* 批量装载 */
+#define SQLITE_INDEX_PREFIX         "CREATE INDEX IF NOT EXISTS "
+#define SQLITE_BULK_LINE_SIZE       256
+#define SQLITE_BULK_MAX_FIELDS      7
+
+/* 静态变量 */
+static sqlite3* db = NULL;
+static char error_text[128] = "";
+
+/* 内部函数声明 */
+static int set_error(int error_code, const char* message);
+static int map_result(int rc, int fallback);
+static int set_table_indexes(uint8_t table, bool create);
+static uint8_t split_bulk_line(char* line, char** fields);
+static int bind_params(sqlite3_stmt* handle, const db_stmt_t* stmt);
+static int sqlite_connect(const db_config_t* config);
+static void sqlite_disconnect(void);
+static int sqlite_exec(const char* sql, uint32_t* affected_rows);
+static int sqlite_prepare(db_stmt_t* stmt);
+static void sqlite_finalize(db_stmt_t* stmt);
+static int sqlite_execute(db_stmt_t* stmt, uint32_t* affected_rows);
+static int sqlite_query(db_stmt_t* stmt);
+static int sqlite_step(db_stmt_t* stmt, bool* has_row);
+static void sqlite_reset(db_stmt_t* stmt);
+static uint8_t sqlite_column_count(db_stmt_t* stmt);
+static int32_t sqlite_column_int(db_stmt_t* stmt, uint8_t column);
+static uint32_t sqlite_column_uint(db_stmt_t* stmt, uint8_t column);
+static double sqlite_column_real(db_stmt_t* stmt, uint8_t column);
+static const char* sqlite_column_text(db_stmt_t* stmt, uint8_t column);
+static int sqlite_begin(void);
+static int sqlite_commit(void);
+static int sqlite_rollback(void);
+static int sqlite_bulk_load(uint8_t table, const char* path, bool defer_indexes);
+static const char* sqlite_last_error(void);
+
+/* SQLite驱动函数表 */
+const db_driver_t DB_DRIVER_SQLITE = {
+    "sqlite",
+    SQLITE_CREATE_TABLES,
+    SQLITE_STATEMENT_SQL,
+    sqlite_connect,
+    sqlite_disconnect,
+    sqlite_exec,
+    sqlite_prepare,
+    sqlite_finalize,
+    sqlite_execute,
+    sqlite_query,
+    sqlite_step,
+    sqlite_reset,
+    sqlite_column_count,
+    sqlite_column_int,
+    sqlite_column_uint,
+    sqlite_column_real,
+    sqlite_column_text,
+    sqlite_begin,
+    sqlite_commit,
+    sqlite_rollback,
+    sqlite_bulk_load,
+    sqlite_last_error
+};
+
+/* 内部函数实现 */
+
+/**
+ * @brief 记录错误信息并返回错误代码
+ */
+static int set_error(int error_code, const char* message)
+{
+    SAFE_STRCPY(error_text, (message != NULL) ? message : "SQLite error", sizeof(error_text));
+    return error_code;
+}
+
+/**
+ * @brief 将SQLite返回码映射为DB_ERROR_*
+ */
+static int map_result(int rc, int fallback)
+{
+    switch (rc) {
+        case SQLITE_OK:
+        case SQLITE_DONE:
+        case SQLITE_ROW:
+            return DB_ERROR_NONE;
+
+        case SQLITE_BUSY:
+        case SQLITE_LOCKED:
+            return set_error(DB_ERROR_TIMEOUT, sqlite3_errmsg(db));
+
+        case SQLITE_NOMEM:
+            return set_error(DB_ERROR_MEMORY, sqlite3_errmsg(db));
+
+        case SQLITE_CONSTRAINT:
+        case SQLITE_MISMATCH:
+        case SQLITE_RANGE:
+            return set_error(DB_ERROR_INVALID_PARAM, sqlite3_errmsg(db));
+
+        default:
+            return set_error(fallback, sqlite3_errmsg(db));
+    }
+}
+
+/**
+ * @brief 按类型绑定语句参数（文本不复制，执行期间由调用方保证有效）
+ */
+static int bind_params(sqlite3_stmt* handle, const db_stmt_t* stmt)
+{
+    const db_param_t* param;
+    uint8_t i;
+    int rc = SQLITE_OK;
+
+    sqlite3_reset(handle);
+
+    for (i = 0; i < stmt->param_count && rc == SQLITE_OK; i++) {
+        param = &stmt->params[i];
+        switch (param->type) {
+            case DB_PARAM_INT:
+                rc = sqlite3_bind_int(handle, i + 1, param->value.i);
+                break;
+            case DB_PARAM_UINT:
+                rc = sqlite3_bind_int64(handle, i + 1, (sqlite3_int64)param->value.u);
+                break;
+            case DB_PARAM_REAL:
+                rc = sqlite3_bind_double(handle, i + 1, param->value.f);
+                break;
+            case DB_PARAM_TEXT:
+                rc = sqlite3_bind_text(handle, i + 1, param->value.text.ptr,
+                                       (int)param->value.text.length, SQLITE_STATIC);
+                break;
+            default:
+                rc = sqlite3_bind_null(handle, i + 1);
+                break;
+        }
+    }
+
+    return map_result(rc, DB_ERROR_INVALID_PARAM);
+}
+
+/**
+ * @brief 删除或重建一张表的二级索引（建表语句中"ON <表名> "的CREATE INDEX）
+ */
+static int set_table_indexes(uint8_t table, bool create)
+{
+    const char* on_table = (table == DB_TABLE_SENSOR1) ? " ON sensor1_data " : " ON sensor2_data ";
+    const char* const* ddl;
+    const char* name;
+    char sql[96];
+    strbuf_t sb;
+    int error_code = DB_ERROR_NONE;
+
+    for (ddl = SQLITE_CREATE_TABLES; *ddl != NULL && error_code == DB_ERROR_NONE; ddl++) {
+        if (strncmp(*ddl, SQLITE_INDEX_PREFIX, sizeof(SQLITE_INDEX_PREFIX) - 1) != 0 ||
+            strstr(*ddl, on_table) == NULL) {
+            continue;
+        }
+        if (create) {
+            error_code = sqlite_exec(*ddl, NULL);
+            continue;
+        }
+        name = *ddl + sizeof(SQLITE_INDEX_PREFIX) - 1;
+        strbuf_init(&sb, sql, sizeof(sql));
+        strbuf_append_str(&sb, "DROP INDEX IF EXISTS ");
+        strbuf_append_mem(&sb, name, (size_t)(strchr(name, ' ') - name));
+        error_code = sqlite_exec(strbuf_cstr(&sb), NULL);
+    }
+    return error_code;
+}
+
+/**
+ * @brief 按制表符拆分一行并原地去掉转义，返回字段数（超过上限返回0）
+ */
+static uint8_t split_bulk_line(char* line, char** fields)
+{
+    char* in = line;
+    char* out = line;
+    uint8_t count = 1;
+
+    fields[0] = out;
+    for (; *in != '\0' && *in != SQL_BULK_LINE_END; in++) {
+        if (*in == SQL_BULK_FIELD_SEPARATOR) {
+            *out++ = '\0';
+            if (count >= SQLITE_BULK_MAX_FIELDS) {
+                return 0;
+            }
+            fields[count++] = out;
+        } else if (*in == '\\' && in[1] != '\0') {
+            in++;
+            *out++ = (*in == 't') ? '\t' : (*in == 'n') ? '\n' : *in;
+        } else {
+            *out++ = *in;
+        }
+    }
+    *out = '\0';
+    return count;
+}
+
+/**
+ * @brief 打开数据库文件
+ */
+static int sqlite_connect(const db_config_t* config)
+{
+    char path[DB_SQLITE_PATH_SIZE];
+    strbuf_t sb;
+    int rc;
+
+    strbuf_init(&sb, path, sizeof(path));
+    strbuf_append_str(&sb, config->database);
+    if (strcmp(config->database, DB_SQLITE_MEMORY) != 0) {
+        strbuf_append_str(&sb, DB_SQLITE_FILE_SUFFIX);
+    }
+    if (!strbuf_ok(&sb)) {
+        return set_error(DB_ERROR_INVALID_PARAM, "Database path too long");
+    }
+
+    rc = sqlite3_open_v2(path, &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL);
+    if (rc != SQLITE_OK) {
+        set_error(DB_ERROR_CONNECTION, (db != NULL) ? sqlite3_errmsg(db) : "Cannot open database");
+        sqlite3_close(db);
+        db = NULL;
+        return DB_ERROR_CONNECTION;
+    }
+
+    /* 连接超时用作锁等待时间 */
+    sqlite3_busy_timeout(db, (int)(config->timeout * 1000));
+
+    rc = sqlite3_exec(db, DB_SQLITE_PRAGMAS, NULL, NULL, NULL);
+    if (rc != SQLITE_OK) {
+        map_result(rc, DB_ERROR_CONNECTION);
+        sqlite3_close(db);
+        db = NULL;
+        return DB_ERROR_CONNECTION;
+    }
+
+    return DB_ERROR_NONE;
+}
+
+/**
+ * @brief 关闭数据库
+ */
+static void sqlite_disconnect(void)
+{
+    if (db != NULL) {
+        sqlite3_close(db);
+        db = NULL;
+    }
+}
+
+/**
+ * @brief 执行无参数语句
+ */
+static int sqlite_exec(const char* sql, uint32_t* affected_rows)
+{
+    int rc;
+
+    if (db == NULL) {
+        return set_error(DB_ERROR_CONNECTION, "Database not connected");
+    }
+
+    rc = sqlite3_exec(db, sql, NULL, NULL, NULL);
+    if (rc != SQLITE_OK) {
+        return map_result(rc, DB_ERROR_UPDATE);
+    }
+
+    if (affected_rows != NULL) {
+        *affected_rows = (uint32_t)sqlite3_changes(db);
+    }
+    return DB_ERROR_NONE;
+}
+
+/**
+ * @brief 准备语句
+ */
+static int sqlite_prepare(db_stmt_t* stmt)
+{
+    sqlite3_stmt* handle = NULL;
+    int rc;
+
+    if (db == NULL) {
+        return set_error(DB_ERROR_CONNECTION, "Database not connected");
+    }
+
+    rc = sqlite3_prepare_v2(db, stmt->sql, -1, &handle, NULL);
+    if (rc != SQLITE_OK) {
+        return map_result(rc, DB_ERROR_QUERY);
+    }
+
+    if (sqlite3_bind_parameter_count(handle) != (int)stmt->param_count) {
+        sqlite3_finalize(handle);
+        return set_error(DB_ERROR_INVALID_PARAM, "Statement parameter count mismatch");
+    }
+
+    stmt->handle = handle;
+    return DB_ERROR_NONE;
+}
+
+/**
+ * @brief 释放语句
+ */
+static void sqlite_finalize(db_stmt_t* stmt)
+{
+    sqlite3_finalize((sqlite3_stmt*)stmt->handle);
+    stmt->handle = NULL;
+}
+
+/**
+ * @brief 绑定参数并执行写语句
+ */
+static int sqlite_execute(db_stmt_t* stmt, uint32_t* affected_rows)
+{
+    sqlite3_stmt* handle = (sqlite3_stmt*)stmt->handle;
+    int error_code;
+    int rc;
+
+    error_code = bind_params(handle, stmt);
+    if (error_code != DB_ERROR_NONE) {
+        return error_code;
+    }
+
+    do {
+        rc = sqlite3_step(handle);
+    } while (rc == SQLITE_ROW);
+
+    error_code = map_result(rc, DB_ERROR_INSERT);
+    *affected_rows = (error_code == DB_ERROR_NONE) ? (uint32_t)sqlite3_changes(db) : 0;
+    sqlite3_reset(handle);
+
+    return error_code;
+}
+
+/**
+ * @brief 绑定参数并开始查询
+ */
+static int sqlite_query(db_stmt_t* stmt)
+{
+    return bind_params((sqlite3_stmt*)stmt->handle, stmt);
+}
+
+/**
+ * @brief 取下一行
+ */
+static int sqlite_step(db_stmt_t* stmt, bool* has_row)
+{
+    int rc = sqlite3_step((sqlite3_stmt*)stmt->handle);
+
+    *has_row = (rc == SQLITE_ROW);
+    return map_result(rc, DB_ERROR_QUERY);
+}
+
+/**
+ * @brief 结束查询
+ */
+static void sqlite_reset(db_stmt_t* stmt)
+{
+    sqlite3_reset((sqlite3_stmt*)stmt->handle);
+}
+
+/**
+ * @brief 结果列数
+ */
+static uint8_t sqlite_column_count(db_stmt_t* stmt)
+{
+    return (uint8_t)sqlite3_column_count((sqlite3_stmt*)stmt->handle);
+}
+
+/**
+ * @brief 整数列
+ */
+static int32_t sqlite_column_int(db_stmt_t* stmt, uint8_t column)
+{
+    return (int32_t)sqlite3_column_int((sqlite3_stmt*)stmt->handle, column);
+}
+
+/**
+ * @brief 无符号整数列
+ */
+static uint32_t sqlite_column_uint(db_stmt_t* stmt, uint8_t column)
+{
+    return (uint32_t)sqlite3_column_int64((sqlite3_stmt*)stmt->handle, column);
+}
+
+/**
+ * @brief 浮点数列
+ */
+static double sqlite_column_real(db_stmt_t* stmt, uint8_t column)
+{
+    return sqlite3_column_double((sqlite3_stmt*)stmt->handle, column);
+}
+
+/**
+ * @brief 文本列
+ */
+static const char* sqlite_column_text(db_stmt_t* stmt, uint8_t column)
+{
+    return (const char*)sqlite3_column_text((sqlite3_stmt*)stmt->handle, column);
+}
+
+/**
+ * @brief 开始事务
+ */
+static int sqlite_begin(void)
+{
+    return sqlite_exec("BEGIN", NULL);
+}
+
+/**
+ * @brief 提交事务
+ */
+static int sqlite_commit(void)
+{
+    return sqlite_exec("COMMIT", NULL);
+}
+
+/**
+ * @brief 回滚事务
+ */
+static int sqlite_rollback(void)
+{
+    return sqlite_exec("ROLLBACK", NULL);
+}
+
+/**
+ * @brief 批量装载：SQLite没有LOAD DATA，在调用方的事务中逐行读取暂存文件，
+ *        用同一条预编译INSERT写入（按文本绑定，由列类型亲和性转换）；
+ *        推迟索引维护时先删除该表的二级索引，装载后一次重建
+ */
+static int sqlite_bulk_load(uint8_t table, const char* path, bool defer_indexes)
+{
+    static char line[SQLITE_BULK_LINE_SIZE];
+    char* fields[SQLITE_BULK_MAX_FIELDS];
+    uint8_t field_count = (table == DB_TABLE_SENSOR1) ? 6 : 7;
+    const char* sql = (table == DB_TABLE_SENSOR1) ?
+        SQL_INSERT_SENSOR1 "(?, ?, ?, ?, ?, ?)" : SQL_INSERT_SENSOR2 "(?, ?, ?, ?, ?, ?, ?)";
+    sqlite3_stmt* handle = NULL;
+    FILE* fp;
+    uint8_t i;
+    int rc;
+    int error_code;
+
+    if (db == NULL) {
+        return set_error(DB_ERROR_CONNECTION, "Database not connected");
+    }
+
+    fp = fopen(path, "r");
+    if (fp == NULL) {
+        return set_error(DB_ERROR_INVALID_PARAM, "Cannot open bulk load file");
+    }
+
+    error_code = defer_indexes ? set_table_indexes(table, false) : DB_ERROR_NONE;
+    if (error_code == DB_ERROR_NONE) {
+        rc = sqlite3_prepare_v2(db, sql, -1, &handle, NULL);
+        error_code = map_result(rc, DB_ERROR_INSERT);
+    }
+
+    while (error_code == DB_ERROR_NONE && fgets(line, sizeof(line), fp) != NULL) {
+        if (strchr(line, SQL_BULK_LINE_END) == NULL && !feof(fp)) {
+            error_code = set_error(DB_ERROR_INVALID_PARAM, "Bulk load line too long");
+            break;
+        }
+        if (split_bulk_line(line, fields) != field_count) {
+            error_code = set_error(DB_ERROR_INVALID_PARAM, "Bulk load field count mismatch");
+            break;
+        }
+
+        rc = SQLITE_OK;
+        for (i = 0; i < field_count && rc == SQLITE_OK; i++) {
+            rc = sqlite3_bind_text(handle, i + 1, fields[i], -1, SQLITE_STATIC);
+        }
+        if (rc == SQLITE_OK) {
+            rc = sqlite3_step(handle);
+        }
+        error_code = map_result(rc, DB_ERROR_INSERT);
+        sqlite3_reset(handle);
+    }
+    if (error_code == DB_ERROR_NONE && ferror(fp)) {
+        error_code = set_error(DB_ERROR_INSERT, "Bulk load file read error");
+    }
+
+    sqlite3_finalize(handle);
+    fclose(fp);
+
+    /* 失败时也重建：调用方回滚事务会连同删除一起撤销，不在事务中时保证索引仍在 */
+    if (defer_indexes) {
+        rc = set_table_indexes(table, true);
+        if (error_code == DB_ERROR_NONE) {
+            error_code = rc;
+        }
+    }
+    return error_code;
+}
+
+/**
+ * @brief 最近一次错误信息
+ */
+static const char* sqlite_last_error(void)
+{
+    return error_text;
+}
+
+#else
+
+/* 未启用SQLite时本文件为空，避免空翻译单元告警 */
+typedef int db_driver_sqlite_unused_t;
+
+#endif /* DB_WITH_SQLITE */
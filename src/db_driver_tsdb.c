@@ -0,0 +1,2480 @@
+/**
+ * @file db_driver_tsdb.c
+ * @brief 嵌入式列式时序存储驱动实现
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ *
+ * 仅在定义DB_WITH_TSDB时编译（主机构建：make DB_WITH_TSDB=1），用于没有
+ * 数据库服务器的站点。数据不按行保存，而是按(表, 学号, 传感器)分成时间
+ * 序列，每个序列的若干行压缩成一个列式块：
+ *
+ * - id列：首个id加逐行增量（变长整数）
+ * - 时间戳列：首值、首个差值，之后是差值的差值（zigzag变长整数，
+ *   固定采样周期时每行1字节）
+ * - 数值列：温湿度本来就是0.01单位的定点数（v2表结构），按与前一行的
+ *   差值做zigzag变长整数；中断类型、次数同样处理；状态按游程编码
+ *
+ * 文件（前缀为db_config_t.database）：
+ *
+ * - <db>_head.tsd：头部日志，最近写入的行按固定长度记录追加（带CRC），
+ *   提交时fsync；达到DB_TSDB_HEAD_ROWS行后封存为列式块并清空
+ * - <db>_s1_<天>.seg / <db>_s2_<天>.seg：只追加的段文件，每天一个，
+ *   保存列式块；过期清理按整个文件删除
+ * - <db>_s1.idx / <db>_s2.idx：稀疏索引，每个块一项（所在天段、偏移、
+ *   学号和传感器键、时间戳和id范围），每次封存以提交标记结束，
+ *   没有标记的半次封存在打开时丢弃
+ * - <db>_dict.tsd：学号和传感器名称字典（v2表结构的字典键）
+ *
+ * 读取时段文件和索引以mmap映射（没有mmap的平台用fread），先按每天的
+ * 汇总、再按块的时间戳和id范围剪枝，只解码可能命中的块。查询语句按
+ * 语句编号解释绑定的参数，结果列与SQL_FROM_SENSOR*一致，上层的
+ * database_query_*、db_stream、db_rowset、备份和汇总查询不需要改动；
+ * 汇总查询直接从数据块计算，汇总表的累加语句为空操作。
+ *
+ * 多行INSERT（批量写入）按VALUES元组解析，v2表结构中元组只有整数；
+ * 批量装载的暂存文件逐行解析，每满一个头部直接封存。
+ */
+
+/* 宿主机构建使用fsync()/fileno()/mmap()，需在包含系统头文件前声明POSIX */
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "db_driver.h"
+
+#ifdef DB_WITH_TSDB
+
+#if DB_SCHEMA_VERSION < 2
+#error "DB_WITH_TSDB requires DB_SCHEMA_VERSION >= 2 (dictionary keys and fixed-point values)"
+#endif
+
+#include <stdlib.h>
+#include <time.h>
+#include "crc.h"
+#include "strbuf.h"
+#include "db_partition.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define TSDB_USE_MMAP               1
+#define TSDB_FSYNC(fp)              fsync(fileno(fp))
+#else
+/* 目标板文件系统（DLIB/半主机）没有mmap和fsync，按偏移读取，fflush后即视为已写入 */
+#define TSDB_USE_MMAP               0
+#define TSDB_FSYNC(fp)              0
+#endif
+
+#define TSDB_HEAD_RECORD_SIZE       32
+#define TSDB_INDEX_ENTRY_SIZE       36
+#define TSDB_DICT_RECORD_SIZE       24
+#define TSDB_DICT_NAME_SIZE         20      /* 与sensor_dict.name的VARCHAR(20)一致 */
+#define TSDB_CHUNK_HEADER_SIZE      8
+#define TSDB_CHUNK_MAGIC            0x4354u         /* "TC" */
+#define TSDB_MARKER_DAY             0xFFFFFFFFUL    /* 索引中的封存提交标记 */
+#define TSDB_MAX_ROW_BYTES          32      /* 一行在块中的最大字节数（6列各至多5字节 + 状态游程） */
+#define TSDB_CHUNK_BUFFER_SIZE      (TSDB_CHUNK_HEADER_SIZE + DB_TSDB_CHUNK_ROWS * TSDB_MAX_ROW_BYTES)
+#define TSDB_HEAD_CAPACITY          (DB_TSDB_HEAD_ROWS * 2)     /* 另一半容纳事务中未提交的行 */
+#define TSDB_SECONDS_PER_DAY        86400UL
+#define TSDB_STATUS_COUNT           (SENSOR_STATUS_OFFLINE + 1)
+#define TSDB_VALUE_FIELDS           7       /* VALUES元组的最大字段数（传感器2） */
+#define TSDB_BULK_LINE_SIZE         96      /* 批量装载行（v2只有整数字段） */
+
+/* 一行数据（温湿度为0.01单位的定点数） */
+typedef struct {
+    uint32_t id;
+    uint32_t timestamp;
+    int32_t value_a;                        /* 温度 / 中断类型 */
+    uint32_t value_b;                       /* 湿度（按int32解释） / 中断次数 */
+    uint32_t first_timestamp;               /* 传感器2首次触发时间 */
+    uint16_t student_key;
+    uint16_t sensor_key;
+    uint8_t status;
+    uint8_t table;
+} tsdb_row_t;
+
+/* 索引项：一个列式块 */
+typedef struct {
+    uint32_t day;                           /* 所在天段（TSDB_MARKER_DAY为提交标记） */
+    uint32_t offset;                        /* 块在段文件中的偏移 */
+    uint16_t student_key;
+    uint16_t sensor_key;
+    uint16_t row_count;
+    uint16_t length;                        /* 负载长度 */
+    uint32_t min_ts;
+    uint32_t max_ts;
+    uint32_t first_id;
+    uint32_t last_id;
+} tsdb_entry_t;
+
+/* 时间戳和id范围（块或天段），用于剪枝 */
+typedef struct {
+    uint32_t min_ts;
+    uint32_t max_ts;
+    uint32_t first_id;
+    uint32_t last_id;
+} tsdb_bounds_t;
+
+/* 一天的汇总：该天的索引项位于[first_record, record_end)中（其间可能夹有提交标记） */
+typedef struct {
+    uint32_t day;
+    uint32_t first_record;
+    uint32_t record_end;
+    uint32_t row_count;
+    tsdb_bounds_t bounds;
+} tsdb_day_t;
+
+/* 文件映射（没有mmap时保存打开的文件） */
+typedef struct {
+#if TSDB_USE_MMAP
+    const uint8_t* data;
+    uint32_t size;
+#else
+    FILE* fp;
+#endif
+} tsdb_map_t;
+
+/* 一张表的封存数据 */
+typedef struct {
+    tsdb_day_t days[DB_TSDB_MAX_DAYS];
+    tsdb_map_t segment_maps[DB_TSDB_MAX_DAYS];
+    tsdb_map_t index_map;
+    uint8_t day_count;
+    uint32_t file_records;                  /* 索引文件中已提交的记录数（含标记），新记录的位置 */
+    uint32_t sealed_rows;
+    uint32_t sealed_max_id;
+} tsdb_table_t;
+
+/* 查询结果类型 */
+typedef enum {
+    TSDB_QUERY_ROWS = 0,                    /* 数据行（按order归并） */
+    TSDB_QUERY_TOTALS = 1,                  /* 按状态合计（汇总查询） */
+    TSDB_QUERY_VALUE = 2,                   /* 单个整数 */
+    TSDB_QUERY_TEXT = 3,                    /* 单个名称 */
+    TSDB_QUERY_EMPTY = 4                    /* 没有行 */
+} tsdb_query_kind_t;
+
+/* 数据行的顺序 */
+typedef enum {
+    TSDB_ORDER_LATEST = 0,                  /* id DESC（timestamp每次启动从头计数，不表示先后） */
+    TSDB_ORDER_ID = 1                       /* id */
+} tsdb_order_t;
+
+/* 不带参数的临时语句（按SQL文本识别） */
+typedef enum {
+    TSDB_VALUE_ONE = 0,
+    TSDB_VALUE_ZERO = 1,
+    TSDB_VALUE_ROWS = 2,
+    TSDB_VALUE_MAX_ID = 3,
+    TSDB_VALUE_DAY = 4
+} tsdb_value_t;
+
+typedef struct {
+    const char* sql;
+    uint8_t value;                          /* tsdb_value_t */
+    uint8_t table;
+} tsdb_temp_query_t;
+
+/* 按状态的合计 */
+typedef struct {
+    uint32_t rows;
+    double sum_a;
+    double sum_b;
+    uint32_t last_timestamp;
+} tsdb_total_t;
+
+/* 查询游标 */
+typedef struct {
+    db_stmt_t* stmt;                        /* 占用的语句（NULL为空闲） */
+    uint8_t kind;                           /* tsdb_query_kind_t */
+    uint8_t table;
+    uint8_t order;                          /* tsdb_order_t */
+    bool exhausted;                         /* 已取完全部结果 */
+    uint16_t student_key;                   /* 0表示不按学号过滤 */
+    uint32_t ts_min;                        /* 时间戳下限（包含） */
+    uint32_t ts_end;                        /* 汇总查询的时间戳上限（不包含） */
+    uint32_t id_max;                        /* id上限（包含） */
+    uint32_t key_id;                        /* 键集位置：只取按顺序排在该id之后的行 */
+    uint32_t remaining;                     /* LIMIT剩余行数 */
+    uint8_t capacity;                       /* 本批最多取出的行数 */
+    uint8_t count;
+    uint8_t pos;                            /* 已输出的行数，当前行为pos - 1 */
+    tsdb_row_t rows[DB_TSDB_RESULT_ROWS];
+    tsdb_total_t totals[TSDB_STATUS_COUNT];
+    uint32_t value;
+    const char* text;
+} tsdb_cursor_t;
+
+/* 行访问回调（扫描数据块和头部时调用） */
+typedef void (*tsdb_visit_t)(tsdb_cursor_t* cursor, const tsdb_row_t* row);
+typedef bool (*tsdb_prune_t)(const tsdb_cursor_t* cursor, const tsdb_bounds_t* bounds);
+
+/* 没有建表语句：存储文件在连接时打开或创建 */
+static const char* const TSDB_CREATE_TABLES[] = {
+    NULL
+};
+
+/* 按文本识别的临时语句 */
+static const tsdb_temp_query_t TEMP_QUERIES[] = {
+    { SQL_PING, TSDB_VALUE_ONE, 0 },
+    { SQL_SCHEMA_CHECK_SENSOR1, TSDB_VALUE_ZERO, DB_TABLE_SENSOR1 },
+    { SQL_SCHEMA_CHECK_SENSOR2, TSDB_VALUE_ZERO, DB_TABLE_SENSOR2 },
+    { SQL_COUNT_SENSOR1, TSDB_VALUE_ROWS, DB_TABLE_SENSOR1 },
+    { SQL_COUNT_SENSOR2, TSDB_VALUE_ROWS, DB_TABLE_SENSOR2 },
+    { SQL_MAX_ID_SENSOR1, TSDB_VALUE_MAX_ID, DB_TABLE_SENSOR1 },
+    { SQL_MAX_ID_SENSOR2, TSDB_VALUE_MAX_ID, DB_TABLE_SENSOR2 }
+};
+#define TEMP_QUERY_COUNT            (sizeof(TEMP_QUERIES) / sizeof(TEMP_QUERIES[0]))
+
+static const char* const TABLE_NAMES[] = { "sensor1_data", "sensor2_data", "sensor_dict" };
+
+/* 静态变量 */
+static bool connected = false;
+static bool in_transaction = false;
+static char base_path[DB_TSDB_PATH_SIZE];
+static char path_buffer[DB_TSDB_PATH_SIZE];
+static char error_text[128] = "";
+static tsdb_table_t tables[DB_TABLE_COUNT];
+static tsdb_row_t head_rows[TSDB_HEAD_CAPACITY];
+static uint16_t head_count = 0;             /* 含事务中未提交的行 */
+static uint16_t head_committed = 0;
+static uint32_t head_table_rows[DB_TABLE_COUNT];
+static uint32_t head_max_id[DB_TABLE_COUNT];
+static uint32_t next_id[DB_TABLE_COUNT];
+static FILE* head_file = NULL;
+static uint8_t dict_kinds[DB_TSDB_DICT_SIZE];
+static char dict_names[DB_TSDB_DICT_SIZE][TSDB_DICT_NAME_SIZE + 1];
+static uint16_t dict_count = 0;
+static tsdb_cursor_t cursors[DB_TSDB_CURSORS];
+static tsdb_row_t chunk_rows[DB_TSDB_CHUNK_ROWS];
+static uint8_t chunk_buffer[TSDB_CHUNK_BUFFER_SIZE];
+static uint8_t record_buffer[TSDB_INDEX_ENTRY_SIZE];
+static uint16_t seal_order[TSDB_HEAD_CAPACITY];
+static tsdb_entry_t seal_entries[TSDB_HEAD_CAPACITY];
+
+/* 内部函数声明 */
+static int set_error(int error_code, const char* message);
+static void put_u16(uint8_t* p, uint16_t value);
+static void put_u32(uint8_t* p, uint32_t value);
+static uint16_t get_u16(const uint8_t* p);
+static uint32_t get_u32(const uint8_t* p);
+static uint16_t put_varint(uint8_t* p, uint32_t value);
+static bool get_varint(const uint8_t* data, uint16_t length, uint16_t* offset, uint32_t* value);
+static uint32_t zigzag_encode(int32_t value);
+static int32_t zigzag_decode(uint32_t value);
+static const char* file_path(const char* name);
+static const char* table_path(uint8_t table, const char* suffix);
+static const char* segment_path(uint8_t table, uint32_t day);
+static uint32_t current_time(void);
+static uint32_t current_day(void);
+static const uint8_t* map_range(tsdb_map_t* map, const char* path, uint32_t offset, uint16_t length,
+                                uint8_t* buffer);
+static void unmap_file(tsdb_map_t* map);
+static void unmap_table(tsdb_table_t* tb);
+static bool replace_file(const char* temp_path, const char* path);
+static void encode_entry(uint8_t* p, const tsdb_entry_t* entry);
+static bool decode_entry(const uint8_t* p, tsdb_entry_t* entry);
+static void encode_head_record(uint8_t* p, const tsdb_row_t* row);
+static bool decode_head_record(const uint8_t* p, tsdb_row_t* row);
+static bool load_dict(void);
+static bool write_dict_record(FILE* fp, uint16_t index);
+static uint16_t dict_find(uint8_t kind, const char* name, uint16_t length);
+static int dict_add(uint8_t kind, const char* name, uint16_t length, uint32_t* affected_rows);
+static bool load_index(uint8_t table);
+static bool rewrite_index(uint8_t table, uint32_t committed_records, uint32_t cutoff_day);
+static void add_to_summary(tsdb_table_t* tb, uint32_t record, const tsdb_entry_t* entry);
+static bool load_head(void);
+static bool rewrite_head(void);
+static int commit_head(int error_code);
+static void count_head_row(const tsdb_row_t* row);
+static void seal_head(void);
+static int compare_series(const void* a, const void* b);
+static bool seal_table(uint8_t table, const uint16_t* order, uint16_t count, uint32_t day);
+static uint16_t encode_chunk(const uint16_t* order, uint16_t count, uint8_t* out);
+static bool decode_chunk(const tsdb_entry_t* entry, const uint8_t* payload, uint8_t table);
+static int insert_values(uint8_t table, const uint32_t* values);
+static bool parse_number(const char** p, uint32_t* value);
+static int exec_insert(uint8_t table, const char* values);
+static uint32_t param_uint(const db_stmt_t* stmt, uint8_t index);
+static const char* param_text(const db_stmt_t* stmt, uint8_t index, uint16_t* length);
+static uint16_t param_student(const db_stmt_t* stmt, uint8_t index, bool* found);
+static tsdb_cursor_t* find_cursor(const db_stmt_t* stmt);
+static uint32_t value_of(uint8_t value, uint8_t table);
+static bool row_before(uint8_t order, const tsdb_row_t* a, const tsdb_row_t* b);
+static bool prune_rows(const tsdb_cursor_t* cursor, const tsdb_bounds_t* bounds);
+static bool prune_totals(const tsdb_cursor_t* cursor, const tsdb_bounds_t* bounds);
+static void visit_rows(tsdb_cursor_t* cursor, const tsdb_row_t* row);
+static void visit_totals(tsdb_cursor_t* cursor, const tsdb_row_t* row);
+static int scan_table(tsdb_cursor_t* cursor, tsdb_prune_t prune, tsdb_visit_t visit);
+static int fill_rows(tsdb_cursor_t* cursor);
+static int cleanup_table(uint8_t table, uint32_t days_old, uint32_t* affected_rows);
+static int tsdb_connect(const db_config_t* config);
+static void tsdb_disconnect(void);
+static int tsdb_exec(const char* sql, uint32_t* affected_rows);
+static int tsdb_prepare(db_stmt_t* stmt);
+static void tsdb_finalize(db_stmt_t* stmt);
+static int tsdb_execute(db_stmt_t* stmt, uint32_t* affected_rows);
+static int tsdb_query(db_stmt_t* stmt);
+static int tsdb_step(db_stmt_t* stmt, bool* has_row);
+static void tsdb_reset(db_stmt_t* stmt);
+static uint8_t tsdb_column_count(db_stmt_t* stmt);
+static int32_t tsdb_column_int(db_stmt_t* stmt, uint8_t column);
+static uint32_t tsdb_column_uint(db_stmt_t* stmt, uint8_t column);
+static double tsdb_column_real(db_stmt_t* stmt, uint8_t column);
+static const char* tsdb_column_text(db_stmt_t* stmt, uint8_t column);
+static int tsdb_begin(void);
+static int tsdb_commit(void);
+static int tsdb_rollback(void);
+static int tsdb_bulk_load(uint8_t table, const char* path, bool defer_indexes);
+static const char* tsdb_last_error(void);
+
+/* 时序存储驱动函数表 */
+const db_driver_t DB_DRIVER_TSDB = {
+    "tsdb",
+    TSDB_CREATE_TABLES,
+    NULL,                   /* statement_sql：按语句编号解释，模板只用于确定参数个数 */
+    tsdb_connect,
+    tsdb_disconnect,
+    tsdb_exec,
+    tsdb_prepare,
+    tsdb_finalize,
+    tsdb_execute,
+    tsdb_query,
+    tsdb_step,
+    tsdb_reset,
+    tsdb_column_count,
+    tsdb_column_int,
+    tsdb_column_uint,
+    tsdb_column_real,
+    tsdb_column_text,
+    tsdb_begin,
+    tsdb_commit,
+    tsdb_rollback,
+    tsdb_bulk_load,
+    tsdb_last_error
+};
+
+/* 内部函数实现 */
+
+/**
+ * @brief 记录错误信息并返回错误代码
+ */
+static int set_error(int error_code, const char* message)
+{
+    SAFE_STRCPY(error_text, (message != NULL) ? message : "TSDB error", sizeof(error_text));
+    return error_code;
+}
+
+/**
+ * @brief 小端整数读写
+ */
+static void put_u16(uint8_t* p, uint16_t value)
+{
+    p[0] = (uint8_t)(value & 0xFF);
+    p[1] = (uint8_t)(value >> 8);
+}
+
+static void put_u32(uint8_t* p, uint32_t value)
+{
+    p[0] = (uint8_t)(value & 0xFF);
+    p[1] = (uint8_t)((value >> 8) & 0xFF);
+    p[2] = (uint8_t)((value >> 16) & 0xFF);
+    p[3] = (uint8_t)(value >> 24);
+}
+
+static uint16_t get_u16(const uint8_t* p)
+{
+    return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief 变长整数（每字节7位，低位在前）
+ */
+static uint16_t put_varint(uint8_t* p, uint32_t value)
+{
+    uint16_t n = 0;
+
+    while (value >= 0x80) {
+        p[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    p[n++] = (uint8_t)value;
+    return n;
+}
+
+static bool get_varint(const uint8_t* data, uint16_t length, uint16_t* offset, uint32_t* value)
+{
+    uint32_t result = 0;
+    uint8_t shift = 0;
+    uint8_t byte;
+
+    do {
+        if (*offset >= length || shift > 28) {
+            return false;
+        }
+        byte = data[(*offset)++];
+        result |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    *value = result;
+    return true;
+}
+
+/**
+ * @brief zigzag编码：小的负数也编码为短的变长整数
+ */
+static uint32_t zigzag_encode(int32_t value)
+{
+    return (value >= 0) ? ((uint32_t)value << 1) : ((((uint32_t)(-(value + 1))) << 1) | 1U);
+}
+
+static int32_t zigzag_decode(uint32_t value)
+{
+    return (value & 1U) ? -(int32_t)(value >> 1) - 1 : (int32_t)(value >> 1);
+}
+
+/**
+ * @brief 构造文件路径：<db>_<name>、<db>_s<表><suffix>、<db>_s<表>_<天>.seg
+ */
+static const char* file_path(const char* name)
+{
+    strbuf_t sb;
+
+    strbuf_init(&sb, path_buffer, sizeof(path_buffer));
+    strbuf_append_str(&sb, base_path);
+    strbuf_append_char(&sb, '_');
+    strbuf_append_str(&sb, name);
+    return strbuf_cstr(&sb);
+}
+
+static const char* table_path(uint8_t table, const char* suffix)
+{
+    strbuf_t sb;
+
+    strbuf_init(&sb, path_buffer, sizeof(path_buffer));
+    strbuf_append_str(&sb, base_path);
+    strbuf_append_str(&sb, "_s");
+    strbuf_append_uint(&sb, (uint32_t)table + 1);
+    strbuf_append_str(&sb, suffix);
+    return strbuf_cstr(&sb);
+}
+
+static const char* segment_path(uint8_t table, uint32_t day)
+{
+    strbuf_t sb;
+
+    strbuf_init(&sb, path_buffer, sizeof(path_buffer));
+    strbuf_append_str(&sb, base_path);
+    strbuf_append_str(&sb, "_s");
+    strbuf_append_uint(&sb, (uint32_t)table + 1);
+    strbuf_append_char(&sb, '_');
+    strbuf_append_hex32(&sb, day);
+    strbuf_append_str(&sb, ".seg");
+    return strbuf_cstr(&sb);
+}
+
+/**
+ * @brief 当前时间（UNIX秒，没有时钟的平台为0）
+ */
+static uint32_t current_time(void)
+{
+    time_t now = time(NULL);
+
+    return (now == (time_t)-1) ? 0 : (uint32_t)now;
+}
+
+/**
+ * @brief 当前日期（1970-01-01起的天数，没有时钟的平台为0）
+ */
+static uint32_t current_day(void)
+{
+    return current_time() / TSDB_SECONDS_PER_DAY;
+}
+
+/**
+ * @brief 取得文件[offset, offset + length)的内容：mmap映射（文件增长后重新映射），
+ *        没有mmap时读入buffer
+ */
+static const uint8_t* map_range(tsdb_map_t* map, const char* path, uint32_t offset, uint16_t length,
+                                uint8_t* buffer)
+{
+#if TSDB_USE_MMAP
+    struct stat st;
+    void* data;
+    int fd;
+
+    (void)buffer;
+    if (map->data == NULL || offset + length > map->size) {
+        unmap_file(map);
+        fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            return NULL;
+        }
+        if (fstat(fd, &st) != 0 || (uint32_t)st.st_size < offset + length) {
+            close(fd);
+            return NULL;
+        }
+        data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) {
+            return NULL;
+        }
+        map->data = (const uint8_t*)data;
+        map->size = (uint32_t)st.st_size;
+    }
+    return map->data + offset;
+#else
+    if (map->fp == NULL) {
+        map->fp = fopen(path, "rb");
+        if (map->fp == NULL) {
+            return NULL;
+        }
+    }
+    if (fseek(map->fp, (long)offset, SEEK_SET) != 0 ||
+        fread(buffer, 1, length, map->fp) != length) {
+        return NULL;
+    }
+    return buffer;
+#endif
+}
+
+/**
+ * @brief 释放文件映射
+ */
+static void unmap_file(tsdb_map_t* map)
+{
+#if TSDB_USE_MMAP
+    if (map->data != NULL) {
+        munmap((void*)map->data, map->size);
+        map->data = NULL;
+        map->size = 0;
+    }
+#else
+    if (map->fp != NULL) {
+        fclose(map->fp);
+        map->fp = NULL;
+    }
+#endif
+}
+
+static void unmap_table(tsdb_table_t* tb)
+{
+    uint8_t i;
+
+    unmap_file(&tb->index_map);
+    for (i = 0; i < DB_TSDB_MAX_DAYS; i++) {
+        unmap_file(&tb->segment_maps[i]);
+    }
+}
+
+/**
+ * @brief 用临时文件替换目标文件（rename()不能覆盖已存在文件的平台上先删除）
+ */
+static bool replace_file(const char* temp_path, const char* path)
+{
+    if (rename(temp_path, path) == 0) {
+        return true;
+    }
+    remove(path);
+    return rename(temp_path, path) == 0;
+}
+
+/**
+ * @brief 索引项：天段、偏移、学号键、传感器键、行数、长度、时间戳范围、id范围、CRC32C
+ */
+static void encode_entry(uint8_t* p, const tsdb_entry_t* entry)
+{
+    put_u32(p, entry->day);
+    put_u32(p + 4, entry->offset);
+    put_u16(p + 8, entry->student_key);
+    put_u16(p + 10, entry->sensor_key);
+    put_u16(p + 12, entry->row_count);
+    put_u16(p + 14, entry->length);
+    put_u32(p + 16, entry->min_ts);
+    put_u32(p + 20, entry->max_ts);
+    put_u32(p + 24, entry->first_id);
+    put_u32(p + 28, entry->last_id);
+    put_u32(p + 32, crc32c(p, TSDB_INDEX_ENTRY_SIZE - 4));
+}
+
+static bool decode_entry(const uint8_t* p, tsdb_entry_t* entry)
+{
+    if (get_u32(p + 32) != crc32c(p, TSDB_INDEX_ENTRY_SIZE - 4)) {
+        return false;
+    }
+
+    entry->day = get_u32(p);
+    entry->offset = get_u32(p + 4);
+    entry->student_key = get_u16(p + 8);
+    entry->sensor_key = get_u16(p + 10);
+    entry->row_count = get_u16(p + 12);
+    entry->length = get_u16(p + 14);
+    entry->min_ts = get_u32(p + 16);
+    entry->max_ts = get_u32(p + 20);
+    entry->first_id = get_u32(p + 24);
+    entry->last_id = get_u32(p + 28);
+    return entry->day == TSDB_MARKER_DAY ||
+           (entry->row_count > 0 && entry->row_count <= DB_TSDB_CHUNK_ROWS &&
+            entry->length <= TSDB_CHUNK_BUFFER_SIZE - TSDB_CHUNK_HEADER_SIZE);
+}
+
+/**
+ * @brief 头部日志记录：表、状态、学号键、传感器键、保留、id、时间戳、数值a、数值b、首次时间、CRC32C
+ */
+static void encode_head_record(uint8_t* p, const tsdb_row_t* row)
+{
+    p[0] = row->table;
+    p[1] = row->status;
+    put_u16(p + 2, row->student_key);
+    put_u16(p + 4, row->sensor_key);
+    put_u16(p + 6, 0);
+    put_u32(p + 8, row->id);
+    put_u32(p + 12, row->timestamp);
+    put_u32(p + 16, (uint32_t)row->value_a);
+    put_u32(p + 20, row->value_b);
+    put_u32(p + 24, row->first_timestamp);
+    put_u32(p + 28, crc32c(p, TSDB_HEAD_RECORD_SIZE - 4));
+}
+
+static bool decode_head_record(const uint8_t* p, tsdb_row_t* row)
+{
+    if (get_u32(p + 28) != crc32c(p, TSDB_HEAD_RECORD_SIZE - 4) || p[0] >= DB_TABLE_COUNT) {
+        return false;
+    }
+
+    row->table = p[0];
+    row->status = p[1];
+    row->student_key = get_u16(p + 2);
+    row->sensor_key = get_u16(p + 4);
+    row->id = get_u32(p + 8);
+    row->timestamp = get_u32(p + 12);
+    row->value_a = (int32_t)get_u32(p + 16);
+    row->value_b = get_u32(p + 20);
+    row->first_timestamp = get_u32(p + 24);
+    return true;
+}
+
+/**
+ * @brief 读取字典文件；末尾的半条记录（写入时掉电）被截掉
+ */
+static bool load_dict(void)
+{
+    uint8_t record[TSDB_DICT_RECORD_SIZE];
+    FILE* fp;
+    bool truncated = false;
+    size_t n;
+    uint8_t length;
+
+    dict_count = 0;
+    fp = fopen(file_path("dict.tsd"), "rb");
+    if (fp == NULL) {
+        return true;
+    }
+
+    while ((n = fread(record, 1, sizeof(record), fp)) > 0) {
+        length = record[1];
+        if (n != sizeof(record) || dict_count >= DB_TSDB_DICT_SIZE || length == 0 ||
+            length > TSDB_DICT_NAME_SIZE ||
+            get_u16(record + 22) != crc16_ccitt(record, TSDB_DICT_RECORD_SIZE - 2)) {
+            truncated = true;
+            break;
+        }
+        dict_kinds[dict_count] = record[0];
+        memcpy(dict_names[dict_count], record + 2, length);
+        dict_names[dict_count][length] = '\0';
+        dict_count++;
+    }
+    fclose(fp);
+
+    if (truncated) {
+        uint16_t i;
+        bool ok;
+
+        fp = fopen(file_path("dict.tsd"), "wb");
+        ok = fp != NULL;
+        for (i = 0; ok && i < dict_count; i++) {
+            ok = write_dict_record(fp, i);
+        }
+        ok = ok && fflush(fp) == 0 && TSDB_FSYNC(fp) == 0;
+        if (fp != NULL) {
+            fclose(fp);
+        }
+        return ok;
+    }
+    return true;
+}
+
+/**
+ * @brief 字典记录：类别、长度、名称（20字节，不足补0）、CRC16
+ */
+static bool write_dict_record(FILE* fp, uint16_t index)
+{
+    uint8_t record[TSDB_DICT_RECORD_SIZE];
+    size_t length = strlen(dict_names[index]);
+
+    memset(record, 0, sizeof(record));
+    record[0] = dict_kinds[index];
+    record[1] = (uint8_t)length;
+    memcpy(record + 2, dict_names[index], length);
+    put_u16(record + 22, crc16_ccitt(record, TSDB_DICT_RECORD_SIZE - 2));
+
+    return fwrite(record, 1, sizeof(record), fp) == sizeof(record);
+}
+
+/**
+ * @brief 查找字典键（键 = 序号 + 1，0表示不存在）
+ */
+static uint16_t dict_find(uint8_t kind, const char* name, uint16_t length)
+{
+    uint16_t i;
+
+    for (i = 0; i < dict_count; i++) {
+        if (dict_kinds[i] == kind && strncmp(dict_names[i], name, length) == 0 &&
+            dict_names[i][length] == '\0') {
+            return (uint16_t)(i + 1);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 新增字典名称（已存在时忽略，与INSERT IGNORE一致）
+ */
+static int dict_add(uint8_t kind, const char* name, uint16_t length, uint32_t* affected_rows)
+{
+    FILE* fp;
+    bool ok;
+
+    *affected_rows = 0;
+    if (dict_find(kind, name, length) != 0) {
+        return DB_ERROR_NONE;
+    }
+    if (length == 0 || length > TSDB_DICT_NAME_SIZE) {
+        return set_error(DB_ERROR_INVALID_PARAM, "Dictionary name length");
+    }
+    if (dict_count >= DB_TSDB_DICT_SIZE) {
+        return set_error(DB_ERROR_MEMORY, "Dictionary full");
+    }
+
+    dict_kinds[dict_count] = kind;
+    memcpy(dict_names[dict_count], name, length);
+    dict_names[dict_count][length] = '\0';
+
+    /* 名称很少新增，每次立即落盘，数据行只引用已持久化的键 */
+    fp = fopen(file_path("dict.tsd"), "ab");
+    ok = fp != NULL && write_dict_record(fp, dict_count) &&
+         fflush(fp) == 0 && TSDB_FSYNC(fp) == 0;
+    if (fp != NULL) {
+        fclose(fp);
+    }
+    if (!ok) {
+        return set_error(DB_ERROR_INSERT, "Dictionary write failed");
+    }
+
+    dict_count++;
+    *affected_rows = 1;
+    return DB_ERROR_NONE;
+}
+
+/**
+ * @brief 读取一张表的索引：丢弃最后一个提交标记之后的记录，建立每天的汇总
+ *
+ * 校验失败的记录之后还有有效的提交标记时，是文件中间的损坏而不是半次
+ * 封存：只去掉损坏的记录（记录错误），之后已提交的块保留。
+ */
+static bool load_index(uint8_t table)
+{
+    tsdb_table_t* tb = &tables[table];
+    tsdb_entry_t entry;
+    FILE* fp;
+    uint32_t record = 0;
+    uint32_t committed = 0;
+    uint32_t corrupt = 0;
+    uint32_t uncommitted_corrupt = 0;
+    bool tail = false;
+    size_t n;
+
+    unmap_table(tb);
+    memset(tb, 0, sizeof(tsdb_table_t));
+
+    /* 第一遍：找到最后一个提交标记，统计它之前校验失败的记录 */
+    fp = fopen(table_path(table, ".idx"), "rb");
+    if (fp == NULL) {
+        return true;
+    }
+    while ((n = fread(record_buffer, 1, TSDB_INDEX_ENTRY_SIZE, fp)) > 0) {
+        if (n != TSDB_INDEX_ENTRY_SIZE) {
+            tail = true;
+            break;
+        }
+        record++;
+        if (!decode_entry(record_buffer, &entry)) {
+            uncommitted_corrupt++;
+        } else if (entry.day == TSDB_MARKER_DAY) {
+            committed = record;
+            corrupt += uncommitted_corrupt;
+            uncommitted_corrupt = 0;
+        }
+    }
+    fclose(fp);
+
+    if (corrupt > 0) {
+        ERROR_PRINT("TSDB: %lu corrupt index entries in %s dropped, their chunks are unreadable",
+                    (unsigned long)corrupt, table_path(table, ".idx"));
+    }
+
+    /* 半次封存：块仍在头部日志中，截掉索引中未提交的部分 */
+    if (tail || committed != record || corrupt > 0) {
+        if (!rewrite_index(table, committed, 0)) {
+            return false;
+        }
+        return load_index(table);
+    }
+
+    /* 第二遍：按天汇总 */
+    fp = fopen(table_path(table, ".idx"), "rb");
+    if (fp == NULL) {
+        return false;
+    }
+    for (record = 0; record < committed; record++) {
+        if (fread(record_buffer, 1, TSDB_INDEX_ENTRY_SIZE, fp) != TSDB_INDEX_ENTRY_SIZE ||
+            !decode_entry(record_buffer, &entry)) {
+            fclose(fp);
+            return false;
+        }
+        if (entry.day != TSDB_MARKER_DAY) {
+            add_to_summary(tb, record, &entry);
+        }
+    }
+    fclose(fp);
+
+    tb->file_records = committed;
+    return true;
+}
+
+/**
+ * @brief 重写索引：保留前committed条记录中天段不早于cutoff_day的项（校验失败的项
+ *        去掉），末尾写一个提交标记
+ */
+static bool rewrite_index(uint8_t table, uint32_t committed_records, uint32_t cutoff_day)
+{
+    char path[DB_TSDB_PATH_SIZE];
+    char temp_path[DB_TSDB_PATH_SIZE];
+    tsdb_entry_t entry;
+    FILE* in;
+    FILE* out;
+    uint32_t record;
+    bool ok = true;
+
+    SAFE_STRCPY(path, table_path(table, ".idx"), sizeof(path));
+    SAFE_STRCPY(temp_path, table_path(table, ".idx.tmp"), sizeof(temp_path));
+
+    out = fopen(temp_path, "wb");
+    if (out == NULL) {
+        return false;
+    }
+    in = fopen(path, "rb");
+    for (record = 0; ok && in != NULL && record < committed_records; record++) {
+        ok = fread(record_buffer, 1, TSDB_INDEX_ENTRY_SIZE, in) == TSDB_INDEX_ENTRY_SIZE;
+        if (ok && decode_entry(record_buffer, &entry) &&
+            entry.day != TSDB_MARKER_DAY && entry.day >= cutoff_day) {
+            ok = fwrite(record_buffer, 1, TSDB_INDEX_ENTRY_SIZE, out) == TSDB_INDEX_ENTRY_SIZE;
+        }
+    }
+    if (in != NULL) {
+        fclose(in);
+    }
+
+    memset(&entry, 0, sizeof(entry));
+    entry.day = TSDB_MARKER_DAY;
+    encode_entry(record_buffer, &entry);
+    ok = ok && fwrite(record_buffer, 1, TSDB_INDEX_ENTRY_SIZE, out) == TSDB_INDEX_ENTRY_SIZE &&
+         fflush(out) == 0 && TSDB_FSYNC(out) == 0;
+    fclose(out);
+
+    /* 重命名前释放旧文件的映射 */
+    unmap_table(&tables[table]);
+    if (!ok || !replace_file(temp_path, path)) {
+        remove(temp_path);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 把一个索引项计入所在天的汇总（天段按封存顺序递增）
+ */
+static void add_to_summary(tsdb_table_t* tb, uint32_t record, const tsdb_entry_t* entry)
+{
+    tsdb_day_t* day = (tb->day_count > 0) ? &tb->days[tb->day_count - 1] : NULL;
+
+    if (day == NULL || day->day != entry->day) {
+        if (tb->day_count >= DB_TSDB_MAX_DAYS) {
+            ERROR_PRINT("TSDB: too many day segments, entry %lu ignored", (unsigned long)record);
+            return;
+        }
+        day = &tb->days[tb->day_count++];
+        day->day = entry->day;
+        day->first_record = record;
+        day->row_count = 0;
+        day->bounds.min_ts = entry->min_ts;
+        day->bounds.max_ts = entry->max_ts;
+        day->bounds.first_id = entry->first_id;
+        day->bounds.last_id = entry->last_id;
+    }
+
+    day->record_end = record + 1;
+    day->row_count += entry->row_count;
+    if (entry->min_ts < day->bounds.min_ts) {
+        day->bounds.min_ts = entry->min_ts;
+    }
+    if (entry->max_ts > day->bounds.max_ts) {
+        day->bounds.max_ts = entry->max_ts;
+    }
+    if (entry->first_id < day->bounds.first_id) {
+        day->bounds.first_id = entry->first_id;
+    }
+    if (entry->last_id > day->bounds.last_id) {
+        day->bounds.last_id = entry->last_id;
+    }
+
+    tb->sealed_rows += entry->row_count;
+    if (entry->last_id > tb->sealed_max_id) {
+        tb->sealed_max_id = entry->last_id;
+    }
+}
+
+/**
+ * @brief 读取头部日志：跳过已封存的行（封存后清空头部前掉电），截掉末尾的半条记录
+ */
+static bool load_head(void)
+{
+    uint8_t record[TSDB_HEAD_RECORD_SIZE];
+    tsdb_row_t row;
+    FILE* fp;
+    bool dirty = false;
+    size_t n;
+
+    head_count = 0;
+    fp = fopen(file_path("head.tsd"), "rb");
+    if (fp != NULL) {
+        while ((n = fread(record, 1, sizeof(record), fp)) > 0) {
+            if (n != sizeof(record) || !decode_head_record(record, &row) ||
+                head_count >= TSDB_HEAD_CAPACITY) {
+                dirty = true;
+                break;
+            }
+            if (row.id <= tables[row.table].sealed_max_id) {
+                dirty = true;
+                continue;
+            }
+            memcpy(&head_rows[head_count++], &row, sizeof(tsdb_row_t));
+        }
+        fclose(fp);
+    }
+    head_committed = head_count;
+
+    if (dirty && !rewrite_head()) {
+        return false;
+    }
+
+    head_file = fopen(file_path("head.tsd"), "ab");
+    return head_file != NULL;
+}
+
+/**
+ * @brief 用已提交的头部行重写头部日志
+ */
+static bool rewrite_head(void)
+{
+    uint8_t record[TSDB_HEAD_RECORD_SIZE];
+    FILE* fp;
+    uint16_t i;
+    bool ok;
+
+    if (head_file != NULL) {
+        fclose(head_file);
+        head_file = NULL;
+    }
+
+    fp = fopen(file_path("head.tsd"), "wb");
+    ok = fp != NULL;
+    for (i = 0; ok && i < head_committed; i++) {
+        encode_head_record(record, &head_rows[i]);
+        ok = fwrite(record, 1, sizeof(record), fp) == sizeof(record);
+    }
+    ok = ok && fflush(fp) == 0 && TSDB_FSYNC(fp) == 0;
+    if (fp != NULL) {
+        fclose(fp);
+    }
+    return ok;
+}
+
+/**
+ * @brief 提交头部中未提交的行：追加到头部日志并fsync，满后封存
+ */
+static int commit_head(int error_code)
+{
+    uint8_t record[TSDB_HEAD_RECORD_SIZE];
+    uint16_t i;
+    bool ok = head_file != NULL;
+
+    for (i = head_committed; ok && i < head_count; i++) {
+        encode_head_record(record, &head_rows[i]);
+        ok = fwrite(record, 1, sizeof(record), head_file) == sizeof(record);
+    }
+    ok = ok && fflush(head_file) == 0 && TSDB_FSYNC(head_file) == 0;
+
+    if (!ok) {
+        /* 丢弃这些行，并去掉日志中可能已写入的部分 */
+        head_count = head_committed;
+        if (rewrite_head()) {
+            head_file = fopen(file_path("head.tsd"), "ab");
+        }
+        return set_error(error_code, "Head log write failed");
+    }
+
+    for (i = head_committed; i < head_count; i++) {
+        count_head_row(&head_rows[i]);
+    }
+    head_committed = head_count;
+
+    if (head_committed >= DB_TSDB_HEAD_ROWS) {
+        seal_head();
+    }
+    return DB_ERROR_NONE;
+}
+
+/**
+ * @brief 把已提交的头部行计入行数和最大id
+ */
+static void count_head_row(const tsdb_row_t* row)
+{
+    head_table_rows[row->table]++;
+    if (row->id > head_max_id[row->table]) {
+        head_max_id[row->table] = row->id;
+    }
+}
+
+/**
+ * @brief 把头部的行按序列封存为列式块；某张表失败时它的行留在头部，下次提交时重试
+ */
+static void seal_head(void)
+{
+    uint32_t day = current_day();
+    uint16_t i;
+    uint16_t start;
+    uint16_t kept;
+    uint8_t table;
+    bool sealed[DB_TABLE_COUNT];
+
+    for (i = 0; i < head_committed; i++) {
+        seal_order[i] = i;
+    }
+    qsort(seal_order, head_committed, sizeof(seal_order[0]), compare_series);
+
+    for (i = 0, table = 0; table < DB_TABLE_COUNT; table++) {
+        start = i;
+        while (i < head_committed && head_rows[seal_order[i]].table == table) {
+            i++;
+        }
+        sealed[table] = (i == start) || seal_table(table, &seal_order[start], (uint16_t)(i - start), day);
+        if (!sealed[table]) {
+            ERROR_PRINT("TSDB: sealing %s failed", TABLE_NAMES[table]);
+        }
+    }
+
+    /* 保留未能封存的行 */
+    for (i = 0, kept = 0; i < head_committed; i++) {
+        if (!sealed[head_rows[i].table]) {
+            memcpy(&head_rows[kept++], &head_rows[i], sizeof(tsdb_row_t));
+        }
+    }
+    head_count = head_committed = kept;
+    for (table = 0; table < DB_TABLE_COUNT; table++) {
+        if (sealed[table]) {
+            head_table_rows[table] = 0;
+            head_max_id[table] = 0;
+        }
+    }
+
+    /* 清空失败不影响正确性：重新打开时跳过id不大于已封存最大id的行 */
+    if (rewrite_head()) {
+        head_file = fopen(file_path("head.tsd"), "ab");
+    }
+}
+
+/**
+ * @brief 封存排序：表、学号键、传感器键、id
+ */
+static int compare_series(const void* a, const void* b)
+{
+    const tsdb_row_t* x = &head_rows[*(const uint16_t*)a];
+    const tsdb_row_t* y = &head_rows[*(const uint16_t*)b];
+
+    if (x->table != y->table) {
+        return (x->table < y->table) ? -1 : 1;
+    }
+    if (x->student_key != y->student_key) {
+        return (x->student_key < y->student_key) ? -1 : 1;
+    }
+    if (x->sensor_key != y->sensor_key) {
+        return (x->sensor_key < y->sensor_key) ? -1 : 1;
+    }
+    return (x->id < y->id) ? -1 : (x->id > y->id) ? 1 : 0;
+}
+
+/**
+ * @brief 把一张表的行写成列式块：先写段文件并fsync，再追加索引项和提交标记
+ */
+static bool seal_table(uint8_t table, const uint16_t* order, uint16_t count, uint32_t day)
+{
+    tsdb_table_t* tb = &tables[table];
+    tsdb_entry_t* entry;
+    const tsdb_row_t* row;
+    FILE* fp;
+    long offset;
+    uint16_t entry_count = 0;
+    uint16_t start = 0;
+    uint16_t n;
+    uint16_t length;
+    uint16_t i;
+    bool ok;
+
+    /* 天段只增不减（时钟回拨时写入最后一天），天段数满时也写入最后一天 */
+    if (tb->day_count > 0 &&
+        (day < tb->days[tb->day_count - 1].day || tb->day_count >= DB_TSDB_MAX_DAYS)) {
+        day = tb->days[tb->day_count - 1].day;
+    }
+
+    fp = fopen(segment_path(table, day), "ab");
+    if (fp == NULL || fseek(fp, 0, SEEK_END) != 0 || (offset = ftell(fp)) < 0) {
+        if (fp != NULL) {
+            fclose(fp);
+        }
+        return false;
+    }
+
+    ok = true;
+    while (ok && start < count) {
+        /* 同一序列的连续行，每块至多DB_TSDB_CHUNK_ROWS行 */
+        row = &head_rows[order[start]];
+        n = 1;
+        while (start + n < count && n < DB_TSDB_CHUNK_ROWS &&
+               head_rows[order[start + n]].student_key == row->student_key &&
+               head_rows[order[start + n]].sensor_key == row->sensor_key) {
+            n++;
+        }
+
+        length = encode_chunk(&order[start], n, chunk_buffer + TSDB_CHUNK_HEADER_SIZE);
+        put_u16(chunk_buffer, TSDB_CHUNK_MAGIC);
+        put_u16(chunk_buffer + 2, length);
+        put_u32(chunk_buffer + 4, crc32c(chunk_buffer + TSDB_CHUNK_HEADER_SIZE, length));
+        ok = fwrite(chunk_buffer, 1, TSDB_CHUNK_HEADER_SIZE + length, fp) ==
+             (size_t)(TSDB_CHUNK_HEADER_SIZE + length);
+
+        entry = &seal_entries[entry_count++];
+        entry->day = day;
+        entry->offset = (uint32_t)offset;
+        entry->student_key = row->student_key;
+        entry->sensor_key = row->sensor_key;
+        entry->row_count = n;
+        entry->length = length;
+        entry->first_id = row->id;
+        entry->last_id = head_rows[order[start + n - 1]].id;
+        entry->min_ts = row->timestamp;
+        entry->max_ts = row->timestamp;
+        for (i = 1; i < n; i++) {
+            row = &head_rows[order[start + i]];
+            if (row->timestamp < entry->min_ts) {
+                entry->min_ts = row->timestamp;
+            }
+            if (row->timestamp > entry->max_ts) {
+                entry->max_ts = row->timestamp;
+            }
+        }
+
+        offset += TSDB_CHUNK_HEADER_SIZE + length;
+        start = (uint16_t)(start + n);
+    }
+    ok = ok && fflush(fp) == 0 && TSDB_FSYNC(fp) == 0;
+    fclose(fp);
+    if (!ok) {
+        return false;
+    }
+
+    /* 块已落盘，追加索引项；提交标记写入并fsync后这次封存才生效 */
+    fp = fopen(table_path(table, ".idx"), "ab");
+    if (fp == NULL) {
+        return false;
+    }
+    for (i = 0; ok && i < entry_count; i++) {
+        encode_entry(record_buffer, &seal_entries[i]);
+        ok = fwrite(record_buffer, 1, TSDB_INDEX_ENTRY_SIZE, fp) == TSDB_INDEX_ENTRY_SIZE;
+    }
+    if (ok) {
+        tsdb_entry_t marker;
+
+        memset(&marker, 0, sizeof(marker));
+        marker.day = TSDB_MARKER_DAY;
+        encode_entry(record_buffer, &marker);
+        ok = fwrite(record_buffer, 1, TSDB_INDEX_ENTRY_SIZE, fp) == TSDB_INDEX_ENTRY_SIZE &&
+             fflush(fp) == 0 && TSDB_FSYNC(fp) == 0;
+    }
+    fclose(fp);
+
+    if (!ok) {
+        /* 截掉未提交的索引项，保证之后追加的封存前面没有残留 */
+        rewrite_index(table, tb->file_records, 0);
+        load_index(table);
+        return false;
+    }
+
+    for (i = 0; i < entry_count; i++) {
+        add_to_summary(tb, tb->file_records + i, &seal_entries[i]);
+    }
+    tb->file_records += (uint32_t)entry_count + 1;
+    return true;
+}
+
+/**
+ * @brief 编码一个列式块（同一序列、按id递增的行）
+ *
+ * 列依次为：id（首值 + 增量）、时间戳（首值、首差值、差值的差值）、状态（游程）、
+ * 数值a和数值b（首值 + 差值），传感器2另有首次触发时间（与时间戳的差）。
+ */
+static uint16_t encode_chunk(const uint16_t* order, uint16_t count, uint8_t* out)
+{
+    const tsdb_row_t* row;
+    const tsdb_row_t* prev;
+    uint16_t n = 0;
+    uint16_t i;
+    uint16_t run;
+    int32_t delta = 0;
+    int32_t prev_delta = 0;
+
+    /* id */
+    n += put_varint(out + n, head_rows[order[0]].id);
+    for (i = 1; i < count; i++) {
+        n += put_varint(out + n, head_rows[order[i]].id - head_rows[order[i - 1]].id);
+    }
+
+    /* 时间戳：固定采样周期时差值的差值为0 */
+    n += put_varint(out + n, head_rows[order[0]].timestamp);
+    for (i = 1; i < count; i++) {
+        delta = (int32_t)(head_rows[order[i]].timestamp - head_rows[order[i - 1]].timestamp);
+        n += put_varint(out + n, zigzag_encode((i == 1) ? delta : (int32_t)((uint32_t)delta - (uint32_t)prev_delta)));
+        prev_delta = delta;
+    }
+
+    /* 状态：(状态, 游程长度) */
+    for (i = 0; i < count; i += run) {
+        row = &head_rows[order[i]];
+        run = 1;
+        while (i + run < count && head_rows[order[i + run]].status == row->status) {
+            run++;
+        }
+        out[n++] = row->status;
+        n += put_varint(out + n, run);
+    }
+
+    /* 数值列：与前一行的差值 */
+    n += put_varint(out + n, zigzag_encode(head_rows[order[0]].value_a));
+    for (i = 1; i < count; i++) {
+        row = &head_rows[order[i]];
+        prev = &head_rows[order[i - 1]];
+        n += put_varint(out + n, zigzag_encode((int32_t)((uint32_t)row->value_a - (uint32_t)prev->value_a)));
+    }
+    n += put_varint(out + n, zigzag_encode((int32_t)head_rows[order[0]].value_b));
+    for (i = 1; i < count; i++) {
+        row = &head_rows[order[i]];
+        prev = &head_rows[order[i - 1]];
+        n += put_varint(out + n, zigzag_encode((int32_t)(row->value_b - prev->value_b)));
+    }
+
+    if (head_rows[order[0]].table == DB_TABLE_SENSOR2) {
+        for (i = 0; i < count; i++) {
+            row = &head_rows[order[i]];
+            n += put_varint(out + n, zigzag_encode((int32_t)(row->timestamp - row->first_timestamp)));
+        }
+    }
+
+    return n;
+}
+
+/**
+ * @brief 解码一个列式块到chunk_rows
+ */
+static bool decode_chunk(const tsdb_entry_t* entry, const uint8_t* payload, uint8_t table)
+{
+    tsdb_row_t* row;
+    uint16_t count = entry->row_count;
+    uint16_t length = entry->length;
+    uint16_t offset = 0;
+    uint16_t i;
+    uint32_t value;
+    uint32_t run;
+    int32_t delta = 0;
+    uint8_t status;
+
+    for (i = 0; i < count; i++) {
+        row = &chunk_rows[i];
+        row->table = table;
+        row->student_key = entry->student_key;
+        row->sensor_key = entry->sensor_key;
+        row->first_timestamp = 0;
+        if (!get_varint(payload, length, &offset, &value)) {
+            return false;
+        }
+        row->id = (i == 0) ? value : chunk_rows[i - 1].id + value;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (!get_varint(payload, length, &offset, &value)) {
+            return false;
+        }
+        if (i == 0) {
+            chunk_rows[i].timestamp = value;
+            continue;
+        }
+        delta = (i == 1) ? zigzag_decode(value) : (int32_t)((uint32_t)delta + (uint32_t)zigzag_decode(value));
+        chunk_rows[i].timestamp = chunk_rows[i - 1].timestamp + (uint32_t)delta;
+    }
+
+    for (i = 0; i < count; ) {
+        if (offset >= length) {
+            return false;
+        }
+        status = payload[offset++];
+        if (!get_varint(payload, length, &offset, &run) || run == 0 || run > (uint32_t)(count - i)) {
+            return false;
+        }
+        while (run-- > 0) {
+            chunk_rows[i++].status = status;
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        if (!get_varint(payload, length, &offset, &value)) {
+            return false;
+        }
+        chunk_rows[i].value_a = (i == 0) ? zigzag_decode(value) :
+            (int32_t)((uint32_t)chunk_rows[i - 1].value_a + (uint32_t)zigzag_decode(value));
+    }
+    for (i = 0; i < count; i++) {
+        if (!get_varint(payload, length, &offset, &value)) {
+            return false;
+        }
+        chunk_rows[i].value_b = (i == 0) ? (uint32_t)zigzag_decode(value) :
+            chunk_rows[i - 1].value_b + (uint32_t)zigzag_decode(value);
+    }
+
+    if (table == DB_TABLE_SENSOR2) {
+        for (i = 0; i < count; i++) {
+            if (!get_varint(payload, length, &offset, &value)) {
+                return false;
+            }
+            chunk_rows[i].first_timestamp = chunk_rows[i].timestamp - (uint32_t)zigzag_decode(value);
+        }
+    }
+
+    return offset == length;
+}
+
+/**
+ * @brief 按VALUES元组的字段顺序把一行放入头部（未提交）
+ *
+ * 传感器1：学号键、传感器键、温度、湿度、状态、时间戳；
+ * 传感器2：学号键、传感器键、中断类型、中断次数、状态、首次时间、时间戳。
+ */
+static int insert_values(uint8_t table, const uint32_t* values)
+{
+    tsdb_row_t* row;
+
+    if (head_count >= TSDB_HEAD_CAPACITY) {
+        return set_error(DB_ERROR_MEMORY, "Transaction too large for head log");
+    }
+    if (values[0] == 0 || values[0] > dict_count || values[1] == 0 || values[1] > dict_count ||
+        values[4] > SENSOR_STATUS_OFFLINE) {
+        return set_error(DB_ERROR_INVALID_PARAM, "Unknown dictionary key or status");
+    }
+
+    row = &head_rows[head_count++];
+    row->table = table;
+    row->id = next_id[table]++;
+    row->student_key = (uint16_t)values[0];
+    row->sensor_key = (uint16_t)values[1];
+    row->value_a = (int32_t)values[2];
+    row->value_b = values[3];
+    row->status = (uint8_t)values[4];
+    if (table == DB_TABLE_SENSOR1) {
+        row->first_timestamp = 0;
+        row->timestamp = values[5];
+    } else {
+        row->first_timestamp = values[5];
+        row->timestamp = values[6];
+    }
+    return DB_ERROR_NONE;
+}
+
+/**
+ * @brief 解析一个十进制整数（可带负号，按32位补码保存）
+ */
+static bool parse_number(const char** p, uint32_t* value)
+{
+    const char* s = *p;
+    uint32_t result = 0;
+    bool negative = false;
+
+    while (*s == ' ') {
+        s++;
+    }
+    if (*s == '-') {
+        negative = true;
+        s++;
+    }
+    if (*s < '0' || *s > '9') {
+        return false;
+    }
+    while (*s >= '0' && *s <= '9') {
+        result = result * 10 + (uint32_t)(*s++ - '0');
+    }
+
+    *value = negative ? (uint32_t)(0 - result) : result;
+    *p = s;
+    return true;
+}
+
+/**
+ * @brief 执行多行INSERT：逐个解析VALUES元组，整条语句一起提交或一起丢弃
+ */
+static int exec_insert(uint8_t table, const char* values)
+{
+    uint32_t fields[TSDB_VALUE_FIELDS];
+    uint8_t field_count = (table == DB_TABLE_SENSOR1) ? 6 : 7;
+    uint16_t start = head_count;
+    const char* p = values;
+    uint8_t i;
+    int error_code = DB_ERROR_NONE;
+
+    for (;;) {
+        while (*p == ' ') {
+            p++;
+        }
+        if (*p++ != '(') {
+            error_code = set_error(DB_ERROR_INVALID_PARAM, "Malformed VALUES tuple");
+            break;
+        }
+        for (i = 0; i < field_count; i++) {
+            if (!parse_number(&p, &fields[i])) {
+                break;
+            }
+            while (*p == ' ') {
+                p++;
+            }
+            if (*p++ != ((i + 1 < field_count) ? ',' : ')')) {
+                break;
+            }
+        }
+        if (i < field_count) {
+            error_code = set_error(DB_ERROR_INVALID_PARAM, "Malformed VALUES tuple");
+            break;
+        }
+
+        error_code = insert_values(table, fields);
+        if (error_code != DB_ERROR_NONE) {
+            break;
+        }
+
+        while (*p == ' ') {
+            p++;
+        }
+        if (*p == '\0') {
+            break;
+        }
+        if (*p++ != ',') {
+            error_code = set_error(DB_ERROR_INVALID_PARAM, "Malformed VALUES list");
+            break;
+        }
+    }
+
+    if (error_code != DB_ERROR_NONE) {
+        head_count = start;
+        return error_code;
+    }
+    return in_transaction ? DB_ERROR_NONE : commit_head(DB_ERROR_INSERT);
+}
+
+/**
+ * @brief 读取整数参数
+ */
+static uint32_t param_uint(const db_stmt_t* stmt, uint8_t index)
+{
+    const db_param_t* param = &stmt->params[index];
+
+    switch (param->type) {
+        case DB_PARAM_INT:
+            return (uint32_t)param->value.i;
+        case DB_PARAM_UINT:
+            return param->value.u;
+        case DB_PARAM_REAL:
+            return (uint32_t)(int32_t)param->value.f;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief 读取文本参数（非文本参数视为空串）
+ */
+static const char* param_text(const db_stmt_t* stmt, uint8_t index, uint16_t* length)
+{
+    const db_param_t* param = &stmt->params[index];
+
+    if (param->type != DB_PARAM_TEXT || param->value.text.ptr == NULL) {
+        *length = 0;
+        return "";
+    }
+    *length = param->value.text.length;
+    return param->value.text.ptr;
+}
+
+/**
+ * @brief 按学号参数取得字典键（空串不过滤，返回0；学号不在字典中时found为false）
+ */
+static uint16_t param_student(const db_stmt_t* stmt, uint8_t index, bool* found)
+{
+    uint16_t length;
+    const char* name = param_text(stmt, index, &length);
+    uint16_t key;
+
+    *found = true;
+    if (length == 0) {
+        return 0;
+    }
+    key = dict_find(DB_DICT_STUDENT, name, length);
+    *found = key != 0;
+    return key;
+}
+
+/**
+ * @brief 查找语句占用的游标
+ */
+static tsdb_cursor_t* find_cursor(const db_stmt_t* stmt)
+{
+    uint8_t i;
+
+    for (i = 0; i < DB_TSDB_CURSORS; i++) {
+        if (cursors[i].stmt == stmt) {
+            return &cursors[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 单值查询的结果
+ */
+static uint32_t value_of(uint8_t value, uint8_t table)
+{
+    switch (value) {
+        case TSDB_VALUE_ONE:
+            return 1;
+        case TSDB_VALUE_ROWS:
+            return tables[table].sealed_rows + head_table_rows[table];
+        case TSDB_VALUE_MAX_ID:
+            return (head_max_id[table] > tables[table].sealed_max_id) ?
+                   head_max_id[table] : tables[table].sealed_max_id;
+        case TSDB_VALUE_DAY:
+            return current_day() + DB_PARTITION_TO_DAYS_EPOCH;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief 行a是否按顺序排在行b之前
+ */
+static bool row_before(uint8_t order, const tsdb_row_t* a, const tsdb_row_t* b)
+{
+    switch (order) {
+        case TSDB_ORDER_LATEST:
+            return a->id > b->id;
+        default:
+            return a->id < b->id;
+    }
+}
+
+/**
+ * @brief 数据行查询的剪枝：范围内不可能有排在键集位置之后、且能进入本批的行时跳过
+ */
+static bool prune_rows(const tsdb_cursor_t* cursor, const tsdb_bounds_t* bounds)
+{
+    const tsdb_row_t* worst = (cursor->count >= cursor->capacity) ? &cursor->rows[cursor->count - 1] : NULL;
+
+    switch (cursor->order) {
+        case TSDB_ORDER_LATEST:
+            return bounds->first_id >= cursor->key_id ||
+                   (worst != NULL && bounds->last_id < worst->id);
+        default:
+            return bounds->last_id <= cursor->key_id || bounds->first_id > cursor->id_max ||
+                   (worst != NULL && bounds->first_id > worst->id);
+    }
+}
+
+/**
+ * @brief 汇总查询的剪枝：与[ts_min, ts_end)不相交时跳过
+ */
+static bool prune_totals(const tsdb_cursor_t* cursor, const tsdb_bounds_t* bounds)
+{
+    return bounds->max_ts < cursor->ts_min || bounds->min_ts >= cursor->ts_end;
+}
+
+/**
+ * @brief 数据行查询：排在键集位置之后的行按顺序插入本批，超出容量的丢弃
+ */
+static void visit_rows(tsdb_cursor_t* cursor, const tsdb_row_t* row)
+{
+    uint8_t i;
+
+    if (cursor->student_key != 0 && row->student_key != cursor->student_key) {
+        return;
+    }
+    if (cursor->order == TSDB_ORDER_ID) {
+        if (row->id <= cursor->key_id || row->id > cursor->id_max) {
+            return;
+        }
+    } else if (row->id >= cursor->key_id) {
+        return;
+    }
+
+    i = cursor->count;
+    if (i >= cursor->capacity) {
+        if (!row_before(cursor->order, row, &cursor->rows[i - 1])) {
+            return;
+        }
+        i--;
+    } else {
+        cursor->count++;
+    }
+    while (i > 0 && row_before(cursor->order, row, &cursor->rows[i - 1])) {
+        cursor->rows[i] = cursor->rows[i - 1];
+        i--;
+    }
+    cursor->rows[i] = *row;
+}
+
+/**
+ * @brief 汇总查询：[ts_min, ts_end)内的行按状态累加
+ */
+static void visit_totals(tsdb_cursor_t* cursor, const tsdb_row_t* row)
+{
+    tsdb_total_t* total;
+
+    if (row->timestamp < cursor->ts_min || row->timestamp >= cursor->ts_end ||
+        (cursor->student_key != 0 && row->student_key != cursor->student_key) ||
+        row->status >= TSDB_STATUS_COUNT) {
+        return;
+    }
+
+    total = &cursor->totals[row->status];
+    total->rows++;
+    if (row->table == DB_TABLE_SENSOR1) {
+        total->sum_a += (double)row->value_a / SQL_FIXED_SCALE;
+        total->sum_b += (double)(int32_t)row->value_b / SQL_FIXED_SCALE;
+    } else {
+        total->sum_a += (double)row->value_b;
+    }
+    if (row->timestamp > total->last_timestamp) {
+        total->last_timestamp = row->timestamp;
+    }
+}
+
+/**
+ * @brief 扫描一张表的封存块和头部行：按天汇总、再按索引项剪枝，只解码可能命中的块
+ */
+static int scan_table(tsdb_cursor_t* cursor, tsdb_prune_t prune, tsdb_visit_t visit)
+{
+    tsdb_table_t* tb = &tables[cursor->table];
+    const tsdb_day_t* day;
+    tsdb_bounds_t bounds;
+    tsdb_entry_t entry;
+    const uint8_t* data;
+    bool reverse = cursor->order == TSDB_ORDER_LATEST;
+    uint32_t record;
+    uint32_t step;
+    uint8_t d;
+    uint8_t slot;
+    uint16_t i;
+
+    /* 最新优先时从最后一天、最后一块开始，本批很快填满，较早的块随之剪掉 */
+    for (d = 0; d < tb->day_count; d++) {
+        slot = reverse ? (uint8_t)(tb->day_count - 1 - d) : d;
+        day = &tb->days[slot];
+        if (prune(cursor, &day->bounds)) {
+            continue;
+        }
+
+        for (step = 0; step < day->record_end - day->first_record; step++) {
+            record = reverse ? day->record_end - 1 - step : day->first_record + step;
+            data = map_range(&tb->index_map, table_path(cursor->table, ".idx"),
+                             record * TSDB_INDEX_ENTRY_SIZE, TSDB_INDEX_ENTRY_SIZE, record_buffer);
+            if (data == NULL || !decode_entry(data, &entry)) {
+                return set_error(DB_ERROR_QUERY, "Index read failed");
+            }
+            if (entry.day == TSDB_MARKER_DAY ||
+                (cursor->student_key != 0 && entry.student_key != cursor->student_key)) {
+                continue;
+            }
+            bounds.min_ts = entry.min_ts;
+            bounds.max_ts = entry.max_ts;
+            bounds.first_id = entry.first_id;
+            bounds.last_id = entry.last_id;
+            if (prune(cursor, &bounds)) {
+                continue;
+            }
+
+            data = map_range(&tb->segment_maps[slot], segment_path(cursor->table, entry.day),
+                             entry.offset, (uint16_t)(TSDB_CHUNK_HEADER_SIZE + entry.length), chunk_buffer);
+            if (data == NULL || get_u16(data) != TSDB_CHUNK_MAGIC || get_u16(data + 2) != entry.length ||
+                get_u32(data + 4) != crc32c(data + TSDB_CHUNK_HEADER_SIZE, entry.length) ||
+                !decode_chunk(&entry, data + TSDB_CHUNK_HEADER_SIZE, cursor->table)) {
+                return set_error(DB_ERROR_QUERY, "Corrupt chunk");
+            }
+            for (i = 0; i < entry.row_count; i++) {
+                visit(cursor, &chunk_rows[i]);
+            }
+        }
+    }
+
+    for (i = 0; i < head_committed; i++) {
+        if (head_rows[i].table == cursor->table) {
+            visit(cursor, &head_rows[i]);
+        }
+    }
+    return DB_ERROR_NONE;
+}
+
+/**
+ * @brief 从上一批最后一行之后取下一批行
+ */
+static int fill_rows(tsdb_cursor_t* cursor)
+{
+    const tsdb_row_t* last;
+    int error_code;
+
+    if (cursor->count > 0) {
+        last = &cursor->rows[cursor->count - 1];
+        cursor->key_id = last->id;
+    }
+
+    cursor->capacity = (cursor->remaining < DB_TSDB_RESULT_ROWS) ?
+                       (uint8_t)cursor->remaining : DB_TSDB_RESULT_ROWS;
+    cursor->count = 0;
+    cursor->pos = 0;
+
+    error_code = scan_table(cursor, prune_rows, visit_rows);
+    if (error_code != DB_ERROR_NONE) {
+        cursor->count = 0;
+        cursor->exhausted = true;
+        return error_code;
+    }
+
+    /* 本批没有取满说明后面没有更多的行 */
+    cursor->exhausted = cursor->count < cursor->capacity;
+    return DB_ERROR_NONE;
+}
+
+/**
+ * @brief 删除早于days_old天前的天段：先重写索引，再删除段文件
+ */
+static int cleanup_table(uint8_t table, uint32_t days_old, uint32_t* affected_rows)
+{
+    tsdb_table_t* tb = &tables[table];
+    uint32_t today = current_day();
+    uint32_t cutoff;
+    uint32_t rows = 0;
+    uint32_t removed[DB_TSDB_MAX_DAYS];
+    uint8_t count = 0;
+    uint8_t i;
+
+    *affected_rows = 0;
+    if (days_old >= today) {
+        return DB_ERROR_NONE;
+    }
+    cutoff = today - days_old;
+
+    for (i = 0; i < tb->day_count && tb->days[i].day < cutoff; i++) {
+        rows += tb->days[i].row_count;
+        removed[count++] = tb->days[i].day;
+    }
+    if (count == 0) {
+        return DB_ERROR_NONE;
+    }
+
+    if (!rewrite_index(table, tb->file_records, cutoff)) {
+        return set_error(DB_ERROR_DELETE, "Index rewrite failed");
+    }
+    /* 重新打开前掉电时，未删除的段文件不再被索引引用，只占空间 */
+    for (i = 0; i < count; i++) {
+        remove(segment_path(table, removed[i]));
+    }
+    if (!load_index(table)) {
+        return set_error(DB_ERROR_DELETE, "Index reload failed");
+    }
+
+    *affected_rows = rows;
+    return DB_ERROR_NONE;
+}
+
+/**
+ * @brief 打开存储：读取字典、索引和头部日志
+ */
+static int tsdb_connect(const db_config_t* config)
+{
+    uint16_t i;
+    uint8_t t;
+
+    if (strlen(config->database) + sizeof("_s1_00000000.seg") > sizeof(base_path)) {
+        return set_error(DB_ERROR_INVALID_PARAM, "Database path too long");
+    }
+    SAFE_STRCPY(base_path, config->database, sizeof(base_path));
+
+    memset(cursors, 0, sizeof(cursors));
+    memset(head_table_rows, 0, sizeof(head_table_rows));
+    memset(head_max_id, 0, sizeof(head_max_id));
+    in_transaction = false;
+
+    if (!load_dict()) {
+        return set_error(DB_ERROR_CONNECTION, "Cannot open dictionary");
+    }
+    for (t = 0; t < DB_TABLE_COUNT; t++) {
+        if (!load_index(t)) {
+            return set_error(DB_ERROR_CONNECTION, "Cannot open index");
+        }
+    }
+    if (!load_head()) {
+        return set_error(DB_ERROR_CONNECTION, "Cannot open head log");
+    }
+
+    for (i = 0; i < head_committed; i++) {
+        count_head_row(&head_rows[i]);
+    }
+    for (t = 0; t < DB_TABLE_COUNT; t++) {
+        next_id[t] = value_of(TSDB_VALUE_MAX_ID, t) + 1;
+    }
+
+    connected = true;
+    return DB_ERROR_NONE;
+}
+
+/**
+ * @brief 关闭存储（未提交的行被丢弃）
+ */
+static void tsdb_disconnect(void)
+{
+    uint8_t t;
+
+    for (t = 0; t < DB_TABLE_COUNT; t++) {
+        unmap_table(&tables[t]);
+    }
+    if (head_file != NULL) {
+        fclose(head_file);
+        head_file = NULL;
+    }
+    head_count = head_committed;
+    in_transaction = false;
+    connected = false;
+}
+
+/**
+ * @brief 执行无参数语句：只支持ping和多行INSERT
+ */
+static int tsdb_exec(const char* sql, uint32_t* affected_rows)
+{
+    uint16_t start = head_count;
+    int error_code;
+
+    if (!connected) {
+        return set_error(DB_ERROR_CONNECTION, "Database not connected");
+    }
+    if (affected_rows != NULL) {
+        *affected_rows = 0;
+    }
+
+    if (strcmp(sql, SQL_PING) == 0) {
+        return DB_ERROR_NONE;
+    }
+    if (strncmp(sql, SQL_INSERT_SENSOR1, sizeof(SQL_INSERT_SENSOR1) - 1) == 0) {
+        error_code = exec_insert(DB_TABLE_SENSOR1, sql + sizeof(SQL_INSERT_SENSOR1) - 1);
+    } else if (strncmp(sql, SQL_INSERT_SENSOR2, sizeof(SQL_INSERT_SENSOR2) - 1) == 0) {
+        error_code = exec_insert(DB_TABLE_SENSOR2, sql + sizeof(SQL_INSERT_SENSOR2) - 1);
+    } else {
+        return set_error(DB_ERROR_QUERY, "Statement not supported by tsdb driver");
+    }
+
+    if (error_code == DB_ERROR_NONE && affected_rows != NULL) {
+        *affected_rows = (uint32_t)(uint16_t)(head_count - start);
+    }
+    return error_code;
+}
+
+/**
+ * @brief 准备语句：预编译语句按编号解释；临时语句按文本识别，保存在handle中
+ */
+static int tsdb_prepare(db_stmt_t* stmt)
+{
+    uint8_t i;
+
+    if (!connected) {
+        return set_error(DB_ERROR_CONNECTION, "Database not connected");
+    }
+
+    stmt->handle = NULL;
+    if (stmt->id < DB_STMT_COUNT) {
+        return DB_ERROR_NONE;
+    }
+
+    for (i = 0; i < TEMP_QUERY_COUNT; i++) {
+        if (strcmp(stmt->sql, TEMP_QUERIES[i].sql) == 0) {
+            stmt->handle = (void*)&TEMP_QUERIES[i];
+            return DB_ERROR_NONE;
+        }
+    }
+    return set_error(DB_ERROR_QUERY, "Statement not supported by tsdb driver");
+}
+
+/**
+ * @brief 释放语句
+ */
+static void tsdb_finalize(db_stmt_t* stmt)
+{
+    tsdb_reset(stmt);
+    stmt->handle = NULL;
+}
+
+/**
+ * @brief 执行写语句
+ */
+static int tsdb_execute(db_stmt_t* stmt, uint32_t* affected_rows)
+{
+    uint32_t values[TSDB_VALUE_FIELDS];
+    uint16_t length;
+    const char* text;
+    uint8_t table;
+    uint8_t i;
+    int error_code;
+
+    *affected_rows = 0;
+    if (!connected) {
+        return set_error(DB_ERROR_CONNECTION, "Database not connected");
+    }
+
+    switch (stmt->id) {
+        case DB_STMT_INSERT_SENSOR1:
+        case DB_STMT_INSERT_SENSOR2:
+            table = (stmt->id == DB_STMT_INSERT_SENSOR1) ? DB_TABLE_SENSOR1 : DB_TABLE_SENSOR2;
+            for (i = 0; i < stmt->param_count && i < TSDB_VALUE_FIELDS; i++) {
+                values[i] = param_uint(stmt, i);
+            }
+            error_code = insert_values(table, values);
+            if (error_code == DB_ERROR_NONE && !in_transaction) {
+                error_code = commit_head(DB_ERROR_INSERT);
+            }
+            if (error_code == DB_ERROR_NONE) {
+                *affected_rows = 1;
+            }
+            return error_code;
+
+        case DB_STMT_DICT_INSERT:
+            text = param_text(stmt, 1, &length);
+            return dict_add((uint8_t)param_uint(stmt, 0), text, length, affected_rows);
+
+        case DB_STMT_CLEANUP_SENSOR1:
+        case DB_STMT_CLEANUP_SENSOR2:
+            return cleanup_table((stmt->id == DB_STMT_CLEANUP_SENSOR1) ? DB_TABLE_SENSOR1 : DB_TABLE_SENSOR2,
+                                 param_uint(stmt, 0), affected_rows);
+
+        case DB_STMT_ROLLUP_UPSERT_MINUTE:
+        case DB_STMT_ROLLUP_UPSERT_HOUR:
+        case DB_STMT_ROLLUP_UPSERT_DAY:
+            /* 汇总查询直接从数据块计算，不需要汇总表 */
+            *affected_rows = 1;
+            return DB_ERROR_NONE;
+
+        default:
+            return set_error(DB_ERROR_QUERY, "Statement not supported by tsdb driver");
+    }
+}
+
+/**
+ * @brief 开始查询：解释绑定的参数，数据行在step时按批取出
+ */
+static int tsdb_query(db_stmt_t* stmt)
+{
+    tsdb_cursor_t* cursor;
+    const tsdb_temp_query_t* temp;
+    uint16_t length;
+    const char* text;
+    bool found = true;
+    uint8_t p = 0;
+    uint8_t i;
+
+    if (!connected) {
+        return set_error(DB_ERROR_CONNECTION, "Database not connected");
+    }
+
+    cursor = find_cursor(stmt);
+    if (cursor == NULL) {
+        cursor = find_cursor(NULL);
+    }
+    if (cursor == NULL) {
+        return set_error(DB_ERROR_MEMORY, "Too many open queries");
+    }
+
+    memset(cursor, 0, sizeof(tsdb_cursor_t));
+    cursor->stmt = stmt;
+    cursor->kind = TSDB_QUERY_ROWS;
+    cursor->remaining = SQL_STMT_NO_LIMIT;
+    cursor->id_max = 0xFFFFFFFFUL;
+
+    switch (stmt->id) {
+        case DB_STMT_SELECT_SENSOR1_BY_ID:
+        case DB_STMT_SELECT_SENSOR2_BY_ID:
+            cursor->student_key = param_student(stmt, p++, &found);
+            /* fall through */
+        case DB_STMT_SELECT_SENSOR1_ALL:
+        case DB_STMT_SELECT_SENSOR2_ALL:
+            cursor->table = (stmt->id <= DB_STMT_SELECT_SENSOR1_BY_ID) ? DB_TABLE_SENSOR1 : DB_TABLE_SENSOR2;
+            cursor->order = TSDB_ORDER_LATEST;
+            cursor->key_id = 0xFFFFFFFFUL;
+            cursor->remaining = param_uint(stmt, p);
+            break;
+
+        case DB_STMT_SCAN_SENSOR1_BY_ID:
+        case DB_STMT_SCAN_SENSOR2_BY_ID:
+            cursor->student_key = param_student(stmt, p++, &found);
+            /* fall through */
+        case DB_STMT_SCAN_SENSOR1:
+        case DB_STMT_SCAN_SENSOR2:
+            cursor->table = (stmt->id <= DB_STMT_SCAN_SENSOR1_BY_ID) ? DB_TABLE_SENSOR1 : DB_TABLE_SENSOR2;
+            cursor->order = TSDB_ORDER_ID;
+            cursor->key_id = param_uint(stmt, p);
+            cursor->remaining = param_uint(stmt, (uint8_t)(p + 1));
+            break;
+
+        case DB_STMT_BACKUP_SENSOR1:
+        case DB_STMT_BACKUP_SENSOR2:
+            cursor->table = (stmt->id == DB_STMT_BACKUP_SENSOR1) ? DB_TABLE_SENSOR1 : DB_TABLE_SENSOR2;
+            cursor->order = TSDB_ORDER_ID;
+            cursor->key_id = param_uint(stmt, 0);
+            cursor->id_max = param_uint(stmt, 1);
+            cursor->remaining = param_uint(stmt, 2);
+            break;
+
+        case DB_STMT_ROLLUP_QUERY_MINUTE:
+        case DB_STMT_ROLLUP_QUERY_HOUR:
+        case DB_STMT_ROLLUP_QUERY_DAY:
+            cursor->kind = TSDB_QUERY_TOTALS;
+            cursor->ts_min = param_uint(stmt, 0);
+            cursor->ts_end = param_uint(stmt, 1);
+            i = (uint8_t)(param_uint(stmt, 2) - SENSOR_TYPE_TEMP_HUMIDITY);
+            if (i >= DB_TABLE_COUNT) {
+                cursor->kind = TSDB_QUERY_EMPTY;
+                break;
+            }
+            cursor->table = i;
+            cursor->student_key = param_student(stmt, 3, &found);
+            if (found && scan_table(cursor, prune_totals, visit_totals) != DB_ERROR_NONE) {
+                cursor->stmt = NULL;
+                return DB_ERROR_QUERY;
+            }
+            break;
+
+        case DB_STMT_COUNT_SENSOR1:
+        case DB_STMT_COUNT_SENSOR2:
+            cursor->kind = TSDB_QUERY_VALUE;
+            cursor->value = value_of(TSDB_VALUE_ROWS,
+                                     (stmt->id == DB_STMT_COUNT_SENSOR1) ? DB_TABLE_SENSOR1 : DB_TABLE_SENSOR2);
+            break;
+
+        case DB_STMT_CURRENT_DAY:
+            cursor->kind = TSDB_QUERY_VALUE;
+            cursor->value = value_of(TSDB_VALUE_DAY, 0);
+            break;
+
+        case DB_STMT_CURRENT_TIME:
+            cursor->kind = TSDB_QUERY_VALUE;
+            cursor->value = current_time();
+            break;
+
+        case DB_STMT_WARNING_COUNT:
+            /* 写入要么完整成功要么报错，没有警告 */
+            cursor->kind = TSDB_QUERY_VALUE;
+            cursor->value = 0;
+            break;
+
+        case DB_STMT_DICT_LOOKUP:
+            text = param_text(stmt, 1, &length);
+            cursor->value = dict_find((uint8_t)param_uint(stmt, 0), text, length);
+            cursor->kind = (cursor->value != 0) ? TSDB_QUERY_VALUE : TSDB_QUERY_EMPTY;
+            break;
+
+        case DB_STMT_TABLE_EXISTS:
+            text = param_text(stmt, 0, &length);
+            cursor->kind = TSDB_QUERY_EMPTY;
+            for (i = 0; i < sizeof(TABLE_NAMES) / sizeof(TABLE_NAMES[0]); i++) {
+                if (strlen(TABLE_NAMES[i]) == length && strncmp(TABLE_NAMES[i], text, length) == 0) {
+                    cursor->kind = TSDB_QUERY_TEXT;
+                    cursor->text = TABLE_NAMES[i];
+                }
+            }
+            break;
+
+        case DB_STMT_LIST_PARTITIONS:
+            /* 按天段删除过期数据，对上层表现为未分区的表 */
+            cursor->kind = TSDB_QUERY_EMPTY;
+            break;
+
+        default:
+            temp = (const tsdb_temp_query_t*)stmt->handle;
+            if (temp == NULL) {
+                cursor->stmt = NULL;
+                return set_error(DB_ERROR_QUERY, "Statement not supported by tsdb driver");
+            }
+            cursor->kind = TSDB_QUERY_VALUE;
+            cursor->value = value_of(temp->value, temp->table);
+            break;
+    }
+
+    /* 学号不在字典中：没有数据 */
+    if (!found || (cursor->kind == TSDB_QUERY_ROWS && cursor->remaining == 0)) {
+        cursor->kind = TSDB_QUERY_EMPTY;
+    }
+    return DB_ERROR_NONE;
+}
+
+/**
+ * @brief 取下一行
+ */
+static int tsdb_step(db_stmt_t* stmt, bool* has_row)
+{
+    tsdb_cursor_t* cursor = find_cursor(stmt);
+    int error_code;
+
+    *has_row = false;
+    if (cursor == NULL) {
+        return set_error(DB_ERROR_QUERY, "Query not started");
+    }
+
+    switch (cursor->kind) {
+        case TSDB_QUERY_ROWS:
+            if (cursor->pos >= cursor->count) {
+                if ((cursor->pos > 0 && cursor->exhausted) || cursor->remaining == 0) {
+                    return DB_ERROR_NONE;
+                }
+                error_code = fill_rows(cursor);
+                if (error_code != DB_ERROR_NONE || cursor->count == 0) {
+                    return error_code;
+                }
+            }
+            cursor->pos++;
+            cursor->remaining--;
+            *has_row = true;
+            return DB_ERROR_NONE;
+
+        case TSDB_QUERY_TOTALS:
+            /* pos为下一个要检查的状态 */
+            while (cursor->pos < TSDB_STATUS_COUNT && cursor->totals[cursor->pos].rows == 0) {
+                cursor->pos++;
+            }
+            if (cursor->pos < TSDB_STATUS_COUNT) {
+                cursor->value = cursor->pos++;
+                *has_row = true;
+            }
+            return DB_ERROR_NONE;
+
+        case TSDB_QUERY_VALUE:
+        case TSDB_QUERY_TEXT:
+            *has_row = cursor->pos++ == 0;
+            return DB_ERROR_NONE;
+
+        default:
+            return DB_ERROR_NONE;
+    }
+}
+
+/**
+ * @brief 结束查询，释放游标
+ */
+static void tsdb_reset(db_stmt_t* stmt)
+{
+    tsdb_cursor_t* cursor = find_cursor(stmt);
+
+    if (cursor != NULL) {
+        cursor->stmt = NULL;
+    }
+}
+
+/**
+ * @brief 结果列数
+ */
+static uint8_t tsdb_column_count(db_stmt_t* stmt)
+{
+    tsdb_cursor_t* cursor = find_cursor(stmt);
+
+    if (cursor == NULL) {
+        return 0;
+    }
+    switch (cursor->kind) {
+        case TSDB_QUERY_ROWS:
+            return (cursor->table == DB_TABLE_SENSOR1) ? 7 : 8;
+        case TSDB_QUERY_TOTALS:
+            return 5;
+        case TSDB_QUERY_VALUE:
+        case TSDB_QUERY_TEXT:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief 整数列
+ */
+static int32_t tsdb_column_int(db_stmt_t* stmt, uint8_t column)
+{
+    return (int32_t)tsdb_column_uint(stmt, column);
+}
+
+/**
+ * @brief 无符号整数列
+ */
+static uint32_t tsdb_column_uint(db_stmt_t* stmt, uint8_t column)
+{
+    tsdb_cursor_t* cursor = find_cursor(stmt);
+    const tsdb_row_t* row;
+    const tsdb_total_t* total;
+
+    if (cursor == NULL) {
+        return 0;
+    }
+
+    if (cursor->kind == TSDB_QUERY_TOTALS) {
+        total = &cursor->totals[cursor->value];
+        switch (column) {
+            case 0:
+                return cursor->value;
+            case 1:
+                return total->rows;
+            case 4:
+                return total->last_timestamp;
+            default:
+                return (uint32_t)tsdb_column_real(stmt, column);
+        }
+    }
+    if (cursor->kind != TSDB_QUERY_ROWS) {
+        return cursor->value;
+    }
+    if (cursor->pos == 0) {
+        return 0;
+    }
+
+    row = &cursor->rows[cursor->pos - 1];
+    switch (column) {
+        case DB_SENSOR1_COL_ID:
+            return row->id;
+        case 3:
+            return (uint32_t)row->value_a;      /* 温度（定点） / 中断类型 */
+        case 4:
+            return row->value_b;                /* 湿度（定点） / 中断次数 */
+        case 5:
+            return row->status;
+        case 6:
+            return (row->table == DB_TABLE_SENSOR1) ? row->timestamp : row->first_timestamp;
+        case 7:
+            return row->timestamp;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief 浮点数列（温湿度换算回小数）
+ */
+static double tsdb_column_real(db_stmt_t* stmt, uint8_t column)
+{
+    tsdb_cursor_t* cursor = find_cursor(stmt);
+    const tsdb_row_t* row;
+
+    if (cursor == NULL) {
+        return 0.0;
+    }
+
+    if (cursor->kind == TSDB_QUERY_TOTALS) {
+        if (column == 2) {
+            return cursor->totals[cursor->value].sum_a;
+        }
+        if (column == 3) {
+            return cursor->totals[cursor->value].sum_b;
+        }
+        return (double)tsdb_column_uint(stmt, column);
+    }
+    if (cursor->kind == TSDB_QUERY_ROWS && cursor->pos > 0) {
+        row = &cursor->rows[cursor->pos - 1];
+        if (row->table == DB_TABLE_SENSOR1 &&
+            (column == DB_SENSOR1_COL_TEMPERATURE || column == DB_SENSOR1_COL_HUMIDITY)) {
+            return (float)((column == DB_SENSOR1_COL_TEMPERATURE) ? row->value_a : (int32_t)row->value_b) /
+                   SQL_FIXED_SCALE;
+        }
+    }
+    return (double)tsdb_column_uint(stmt, column);
+}
+
+/**
+ * @brief 文本列（学号和传感器名称由字典还原）
+ */
+static const char* tsdb_column_text(db_stmt_t* stmt, uint8_t column)
+{
+    tsdb_cursor_t* cursor = find_cursor(stmt);
+    uint16_t key;
+
+    if (cursor == NULL) {
+        return "";
+    }
+    if (cursor->kind == TSDB_QUERY_TEXT) {
+        return cursor->text;
+    }
+    if (cursor->kind != TSDB_QUERY_ROWS || cursor->pos == 0 ||
+        (column != DB_SENSOR1_COL_STUDENT_ID && column != DB_SENSOR1_COL_SENSOR_NAME)) {
+        return "";
+    }
+
+    key = (column == DB_SENSOR1_COL_STUDENT_ID) ? cursor->rows[cursor->pos - 1].student_key :
+                                                  cursor->rows[cursor->pos - 1].sensor_key;
+    return (key > 0 && key <= dict_count) ? dict_names[key - 1] : "";
+}
+
+/**
+ * @brief 开始事务：之后写入的行暂存在头部，提交时一起写入头部日志
+ */
+static int tsdb_begin(void)
+{
+    if (!connected) {
+        return set_error(DB_ERROR_CONNECTION, "Database not connected");
+    }
+    if (in_transaction) {
+        return set_error(DB_ERROR_TRANSACTION, "Transaction already started");
+    }
+    in_transaction = true;
+    return DB_ERROR_NONE;
+}
+
+/**
+ * @brief 提交事务
+ */
+static int tsdb_commit(void)
+{
+    if (!in_transaction) {
+        return set_error(DB_ERROR_TRANSACTION, "No transaction");
+    }
+    in_transaction = false;
+    return commit_head(DB_ERROR_TRANSACTION);
+}
+
+/**
+ * @brief 回滚事务：丢弃未提交的行（已分配的id不再使用）
+ */
+static int tsdb_rollback(void)
+{
+    head_count = head_committed;
+    in_transaction = false;
+    return DB_ERROR_NONE;
+}
+
+/**
+ * @brief 批量装载：解析暂存文件的整数字段，每满DB_TSDB_HEAD_ROWS行直接封存为列式块
+ *        （块和索引提交标记落盘即持久，不经头部日志），剩余的行写入头部日志
+ *
+ * 装入的行立即生效，不随之后的rollback撤销；开始时事务中不能有未提交的行。
+ * 时序存储没有逐行维护的索引，defer_indexes不起作用。
+ */
+static int tsdb_bulk_load(uint8_t table, const char* path, bool defer_indexes)
+{
+    static char line[TSDB_BULK_LINE_SIZE];
+    uint32_t fields[TSDB_VALUE_FIELDS];
+    uint8_t field_count = (table == DB_TABLE_SENSOR1) ? 6 : 7;
+    const char* p;
+    FILE* fp;
+    uint16_t i;
+    uint8_t n;
+    int error_code = DB_ERROR_NONE;
+
+    (void)defer_indexes;
+    if (!connected) {
+        return set_error(DB_ERROR_CONNECTION, "Database not connected");
+    }
+    if (head_count != head_committed) {
+        return set_error(DB_ERROR_TRANSACTION, "Bulk load with uncommitted rows");
+    }
+
+    fp = fopen(path, "r");
+    if (fp == NULL) {
+        return set_error(DB_ERROR_INVALID_PARAM, "Cannot open bulk load file");
+    }
+
+    while (error_code == DB_ERROR_NONE && fgets(line, sizeof(line), fp) != NULL) {
+        p = line;
+        for (n = 0; n < field_count; n++) {
+            if (!parse_number(&p, &fields[n]) ||
+                *p++ != ((n + 1 < field_count) ? SQL_BULK_FIELD_SEPARATOR : SQL_BULK_LINE_END)) {
+                break;
+            }
+        }
+        if (n < field_count) {
+            error_code = set_error(DB_ERROR_INVALID_PARAM, "Malformed bulk load line");
+            break;
+        }
+
+        error_code = insert_values(table, fields);
+        if (error_code == DB_ERROR_NONE && head_count >= DB_TSDB_HEAD_ROWS) {
+            for (i = head_committed; i < head_count; i++) {
+                count_head_row(&head_rows[i]);
+            }
+            head_committed = head_count;
+            seal_head();
+        }
+    }
+    fclose(fp);
+
+    if (error_code != DB_ERROR_NONE) {
+        /* 已封存的部分保留，未封存的丢弃 */
+        head_count = head_committed;
+        return error_code;
+    }
+    return commit_head(DB_ERROR_INSERT);
+}
+
+/**
+ * @brief 最近一次错误信息
+ */
+static const char* tsdb_last_error(void)
+{
+    return error_text;
+}
+
+#else
+
+/* 未启用时序存储时本文件为空，避免空翻译单元告警 */
+typedef int db_driver_tsdb_unused_t;
+
+#endif /* DB_WITH_TSDB */
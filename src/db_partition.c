@@ -0,0 +1,476 @@
+/**
+ * @file db_partition.c
+ * @brief 数据表分区管理模块实现 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ */
+
+#include "db_partition.h"
+
+#if ENABLE_DB_PARTITION
+#include "strbuf.h"
+
+/* 一张表的日期分区 */
+typedef struct {
+    int32_t starts[DB_PARTITION_MAX];       /* 各分区起始日（1970-01-01起的天数），升序 */
+    uint8_t count;                          /* 日期分区数 */
+    bool has_max;                           /* 是否有pmax */
+    bool partitioned;                       /* 表是否已分区 */
+} partition_list_t;
+
+/* 静态变量 */
+static db_partition_config_t current_config;
+static db_partition_statistics_t statistics;
+static partition_list_t partitions;
+static char sql_buffer[MAX_SQL_LENGTH];
+
+static const char* const TABLE_NAMES[DB_TABLE_COUNT] = {
+    "sensor1_data",
+    "sensor2_data"
+};
+
+/* 默认分区配置 */
+const db_partition_config_t DEFAULT_DB_PARTITION_CONFIG = {
+    DB_PARTITION_DEFAULT_PERIOD,            /* period_days */
+    DB_PARTITION_DEFAULT_PRECREATE,         /* precreate */
+    DB_PARTITION_DEFAULT_RETENTION          /* retention_days */
+};
+
+/* 内部函数声明 */
+static db_result_t get_current_day(uint32_t* day);
+static db_result_t load_partitions(uint8_t table, partition_list_t* list);
+static db_result_t create_partitions(uint8_t table, const partition_list_t* list, int32_t today);
+static db_result_t drop_expired_partitions(uint8_t table, const partition_list_t* list, int32_t today);
+static bool append_partition_name(strbuf_t* sb, int32_t day);
+static bool append_date(strbuf_t* sb, int32_t day, bool separators);
+static int32_t get_period_start(int32_t day);
+static bool parse_partition_name(const char* name, int32_t* day);
+static int32_t days_from_civil(int32_t year, uint32_t month, uint32_t day);
+static void civil_from_days(int32_t days, int32_t* year, uint32_t* month, uint32_t* day);
+static db_result_t create_partition_result(bool success, int error_code, const char* message,
+                                           uint32_t rows);
+
+/**
+ * @brief 初始化分区管理
+ */
+system_status_t db_partition_init(const db_partition_config_t* config)
+{
+    if (config == NULL) {
+        config = &DEFAULT_DB_PARTITION_CONFIG;
+    }
+    if (config->period_days == 0) {
+        return SYSTEM_ERROR;
+    }
+
+    memcpy(&current_config, config, sizeof(db_partition_config_t));
+    memset(&statistics, 0, sizeof(statistics));
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 预建分区并删除过期分区
+ */
+db_result_t db_partition_maintain(void)
+{
+    db_result_t result;
+    uint32_t today;
+    uint32_t removed = 0;
+    uint8_t partitioned = 0;
+    uint8_t table;
+
+    if (database_get_status() != DB_STATUS_CONNECTED) {
+        return create_partition_result(false, DB_ERROR_CONNECTION, "Database not connected", 0);
+    }
+
+    /* 以服务器日期为准，与created_at的取值一致 */
+    result = get_current_day(&today);
+    if (!result.success) {
+        return result;
+    }
+
+    statistics.maintain_count++;
+
+    for (table = 0; table < DB_TABLE_COUNT; table++) {
+        result = load_partitions(table, &partitions);
+        if (!result.success) {
+            return result;
+        }
+
+        if (!partitions.partitioned) {
+            /* 未分区的表只能逐行删除 */
+            if (current_config.retention_days != 0) {
+                result = database_cleanup_table(table, current_config.retention_days);
+                if (!result.success) {
+                    return result;
+                }
+                statistics.rows_deleted += result.affected_rows;
+                removed += result.affected_rows;
+            }
+            continue;
+        }
+        partitioned++;
+
+        result = create_partitions(table, &partitions, (int32_t)today);
+        if (!result.success) {
+            return result;
+        }
+
+        if (current_config.retention_days != 0) {
+            result = drop_expired_partitions(table, &partitions, (int32_t)today);
+            if (!result.success) {
+                return result;
+            }
+            removed += result.affected_rows;
+        }
+    }
+
+    statistics.partitioned_tables = partitioned;
+    return create_partition_result(true, DB_ERROR_NONE, NULL, removed);
+}
+
+/**
+ * @brief 获取分区统计信息
+ */
+void db_partition_get_statistics(db_partition_statistics_t* stats)
+{
+    if (stats != NULL) {
+        memcpy(stats, &statistics, sizeof(db_partition_statistics_t));
+    }
+}
+
+/* 内部函数实现 */
+
+/**
+ * @brief 读取服务器当前日期（1970-01-01起的天数）
+ */
+static db_result_t get_current_day(uint32_t* day)
+{
+    db_result_t result;
+    db_stmt_t* stmt;
+    db_cursor_t cursor;
+
+    stmt = database_prepare(DB_STMT_CURRENT_DAY);
+    if (stmt == NULL) {
+        return create_partition_result(false, DB_ERROR_QUERY, database_get_last_error(), 0);
+    }
+
+    result = db_stmt_open_cursor(stmt, &cursor);
+    if (!result.success) {
+        return result;
+    }
+    if (!db_cursor_next(&cursor)) {
+        db_cursor_close(&cursor);
+        return create_partition_result(false, DB_ERROR_QUERY, "No current date", 0);
+    }
+    *day = db_cursor_get_uint(&cursor, 0) - DB_PARTITION_TO_DAYS_EPOCH;
+    db_cursor_close(&cursor);
+
+    return create_partition_result(true, DB_ERROR_NONE, NULL, 0);
+}
+
+/**
+ * @brief 读取表的分区列表
+ */
+static db_result_t load_partitions(uint8_t table, partition_list_t* list)
+{
+    db_result_t result;
+    db_stmt_t* stmt;
+    db_cursor_t cursor;
+    const char* name;
+    int32_t day;
+
+    memset(list, 0, sizeof(partition_list_t));
+
+    stmt = database_prepare(DB_STMT_LIST_PARTITIONS);
+    if (stmt == NULL) {
+        return create_partition_result(false, DB_ERROR_QUERY, database_get_last_error(), 0);
+    }
+    db_stmt_bind_text(stmt, 0, TABLE_NAMES[table]);
+
+    result = db_stmt_open_cursor(stmt, &cursor);
+    if (!result.success) {
+        return result;
+    }
+
+    while (db_cursor_next(&cursor)) {
+        name = db_cursor_get_text(&cursor, 0);
+        list->partitioned = true;
+
+        if (strcmp(name, DB_PARTITION_MAX_NAME) == 0) {
+            list->has_max = true;
+        } else if (parse_partition_name(name, &day) && list->count < DB_PARTITION_MAX &&
+                   (list->count == 0 || day > list->starts[list->count - 1])) {
+            list->starts[list->count++] = day;
+        }
+        /* 其他名称的分区不是本模块建立的，不做处理 */
+    }
+    db_cursor_close(&cursor);
+
+    return create_partition_result(true, DB_ERROR_NONE, NULL, list->count);
+}
+
+/**
+ * @brief 建立当前分区及之后precreate个分区中还不存在的分区
+ */
+static db_result_t create_partitions(uint8_t table, const partition_list_t* list, int32_t today)
+{
+    strbuf_t sb;
+    db_result_t result;
+    int32_t period = current_config.period_days;
+    int32_t current = get_period_start(today);
+    int32_t last = current + (int32_t)current_config.precreate * period;
+    int32_t next;
+    uint8_t created = 0;
+
+    /* 接着最后一个分区建；长时间未维护时从当前分区开始，
+     * 中间缺少的日期落入第一个新分区 */
+    next = (list->count > 0) ? list->starts[list->count - 1] + period : current;
+    if (next < current) {
+        next = current;
+    }
+    if (next > last) {
+        return create_partition_result(true, DB_ERROR_NONE, NULL, 0);
+    }
+
+    strbuf_init(&sb, sql_buffer, sizeof(sql_buffer));
+    strbuf_append_str(&sb, "ALTER TABLE ");
+    strbuf_append_str(&sb, TABLE_NAMES[table]);
+    if (list->has_max) {
+        /* 新分区都在pmax的范围内，从pmax拆分 */
+        strbuf_append_str(&sb, " REORGANIZE PARTITION " DB_PARTITION_MAX_NAME " INTO (");
+    } else {
+        strbuf_append_str(&sb, " ADD PARTITION (");
+    }
+
+    for (; next <= last; next += period) {
+        if (created > 0) {
+            strbuf_append_str(&sb, ", ");
+        }
+        strbuf_append_str(&sb, "PARTITION ");
+        append_partition_name(&sb, next);
+        strbuf_append_str(&sb, " VALUES LESS THAN (UNIX_TIMESTAMP('");
+        append_date(&sb, next + period, true);
+        strbuf_append_str(&sb, "'))");
+        created++;
+    }
+    if (list->has_max) {
+        strbuf_append_str(&sb, ", " SQL_PARTITION_MAX);
+    }
+    if (!strbuf_append_char(&sb, ')')) {
+        return create_partition_result(false, DB_ERROR_MEMORY, "Partition statement too long", 0);
+    }
+
+    result = database_execute_update(strbuf_cstr(&sb));
+    if (!result.success) {
+        ERROR_PRINT("Partition create failed on %s: %s", TABLE_NAMES[table], result.error_message);
+        return result;
+    }
+
+    statistics.partitions_created += created;
+    INFO_PRINT("Created %d partitions on %s", created, TABLE_NAMES[table]);
+    return create_partition_result(true, DB_ERROR_NONE, NULL, created);
+}
+
+/**
+ * @brief 删除结束日期早于保留期限的分区
+ */
+static db_result_t drop_expired_partitions(uint8_t table, const partition_list_t* list, int32_t today)
+{
+    strbuf_t sb;
+    db_result_t result;
+    int32_t cutoff = today - (int32_t)current_config.retention_days;
+    int32_t end;
+    uint32_t rows = 0;
+    uint32_t count;
+    uint8_t dropped = 0;
+    uint8_t i;
+
+    for (i = 0; i < list->count; i++) {
+        end = (i + 1 < list->count) ? list->starts[i + 1] : list->starts[i] + current_config.period_days;
+        if (end > cutoff) {
+            break;
+        }
+
+        /* 删除前统计分区行数（只扫描该分区），用于维护表行数 */
+        strbuf_init(&sb, sql_buffer, sizeof(sql_buffer));
+        strbuf_append_str(&sb, "SELECT COUNT(*) FROM ");
+        strbuf_append_str(&sb, TABLE_NAMES[table]);
+        strbuf_append_str(&sb, " PARTITION (");
+        append_partition_name(&sb, list->starts[i]);
+        strbuf_append_char(&sb, ')');
+        result = database_query_uint(strbuf_cstr(&sb), &count);
+        if (!result.success) {
+            return result;
+        }
+        rows += count;
+        dropped++;
+    }
+    if (dropped == 0) {
+        return create_partition_result(true, DB_ERROR_NONE, NULL, 0);
+    }
+
+    strbuf_init(&sb, sql_buffer, sizeof(sql_buffer));
+    strbuf_append_str(&sb, "ALTER TABLE ");
+    strbuf_append_str(&sb, TABLE_NAMES[table]);
+    strbuf_append_str(&sb, " DROP PARTITION ");
+    for (i = 0; i < dropped; i++) {
+        if (i > 0) {
+            strbuf_append_str(&sb, ", ");
+        }
+        append_partition_name(&sb, list->starts[i]);
+    }
+    if (sb.overflow) {
+        return create_partition_result(false, DB_ERROR_MEMORY, "Partition statement too long", 0);
+    }
+
+    result = database_execute_update(strbuf_cstr(&sb));
+    if (!result.success) {
+        ERROR_PRINT("Partition drop failed on %s: %s", TABLE_NAMES[table], result.error_message);
+        return result;
+    }
+
+    database_adjust_row_count(table, -(int32_t)rows);
+    statistics.partitions_dropped += dropped;
+    statistics.rows_dropped += rows;
+    INFO_PRINT("Dropped %d expired partitions (%lu rows) on %s", dropped, rows, TABLE_NAMES[table]);
+    return create_partition_result(true, DB_ERROR_NONE, NULL, rows);
+}
+
+/**
+ * @brief 追加分区名p<YYYYMMDD>
+ */
+static bool append_partition_name(strbuf_t* sb, int32_t day)
+{
+    strbuf_append_char(sb, 'p');
+    return append_date(sb, day, false);
+}
+
+/**
+ * @brief 追加日期YYYY-MM-DD（separators为false时为YYYYMMDD）
+ */
+static bool append_date(strbuf_t* sb, int32_t day, bool separators)
+{
+    int32_t year;
+    uint32_t month;
+    uint32_t mday;
+
+    civil_from_days(day, &year, &month, &mday);
+
+    strbuf_append_uint(sb, (uint32_t)year);
+    if (separators) {
+        strbuf_append_char(sb, '-');
+    }
+    if (month < 10) {
+        strbuf_append_char(sb, '0');
+    }
+    strbuf_append_uint(sb, month);
+    if (separators) {
+        strbuf_append_char(sb, '-');
+    }
+    if (mday < 10) {
+        strbuf_append_char(sb, '0');
+    }
+    return strbuf_append_uint(sb, mday);
+}
+
+/**
+ * @brief 某天所在分区的起始日（按周分区时对齐到周一）
+ */
+static int32_t get_period_start(int32_t day)
+{
+    int32_t period = current_config.period_days;
+    int32_t offset = (day - DB_PARTITION_MONDAY) % period;
+
+    if (offset < 0) {
+        offset += period;
+    }
+    return day - offset;
+}
+
+/**
+ * @brief 解析分区名p<YYYYMMDD>
+ */
+static bool parse_partition_name(const char* name, int32_t* day)
+{
+    uint32_t value = 0;
+    uint8_t i;
+
+    if (name[0] != 'p' || strlen(name) != 9) {
+        return false;
+    }
+    for (i = 1; i < 9; i++) {
+        if (name[i] < '0' || name[i] > '9') {
+            return false;
+        }
+        value = value * 10 + (uint32_t)(name[i] - '0');
+    }
+
+    *day = days_from_civil((int32_t)(value / 10000), (value / 100) % 100, value % 100);
+    return true;
+}
+
+/**
+ * @brief 公历日期转换为1970-01-01起的天数
+ */
+static int32_t days_from_civil(int32_t year, uint32_t month, uint32_t day)
+{
+    int32_t era;
+    uint32_t yoe;
+    uint32_t doy;
+    uint32_t doe;
+
+    year -= (month <= 2) ? 1 : 0;
+    era = (year >= 0 ? year : year - 399) / 400;
+    yoe = (uint32_t)(year - era * 400);
+    doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int32_t)doe - 719468;
+}
+
+/**
+ * @brief 1970-01-01起的天数转换为公历日期
+ */
+static void civil_from_days(int32_t days, int32_t* year, uint32_t* month, uint32_t* day)
+{
+    int32_t era;
+    uint32_t doe;
+    uint32_t yoe;
+    uint32_t doy;
+    uint32_t mp;
+
+    days += 719468;
+    era = (days >= 0 ? days : days - 146096) / 146097;
+    doe = (uint32_t)(days - era * 146097);
+    yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    mp = (5 * doy + 2) / 153;
+    *day = doy - (153 * mp + 2) / 5 + 1;
+    *month = (mp < 10) ? mp + 3 : mp - 9;
+    *year = (int32_t)yoe + era * 400 + ((*month <= 2) ? 1 : 0);
+}
+
+/**
+ * @brief 创建操作结果
+ */
+static db_result_t create_partition_result(bool success, int error_code, const char* message,
+                                           uint32_t rows)
+{
+    db_result_t result;
+
+    memset(&result, 0, sizeof(result));
+    result.success = success;
+    result.error_code = error_code;
+    result.affected_rows = rows;
+    if (message != NULL) {
+        SAFE_STRCPY(result.error_message, message, sizeof(result.error_message));
+    }
+    return result;
+}
+
+#else
+
+/* 未启用时本文件为空，避免空翻译单元告警 */
+typedef int db_partition_unused_t;
+
+#endif /* ENABLE_DB_PARTITION */
@@ -0,0 +1,419 @@
+/**
+ * @file db_rollup.c
+ * @brief 传感器数据汇总表模块实现 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ */
+
+#include "db_rollup.h"
+
+#if ENABLE_DB_ROLLUP
+
+/* 待写入的一个(级别, 键)合计 */
+typedef struct {
+    uint8_t level;                          /* 汇总级别（db_rollup_level_t） */
+    sensor_type_t type;                     /* 数据类型 */
+    sensor_status_t status;                 /* 传感器状态 */
+    char student_id[MAX_STUDENT_ID_LEN];    /* 学号 */
+    char sensor_name[MAX_SENSOR_NAME_LEN];  /* 传感器名称 */
+    uint32_t row_count;                     /* 行数 */
+    double sum_a;                           /* 温度或中断次数之和（单精度累加大量行会丢失精度） */
+    double sum_b;                           /* 湿度之和 */
+    uint32_t last_timestamp;                /* 最大时间戳 */
+} rollup_key_t;
+
+/* 范围查询的累计值 */
+typedef struct {
+    sensor_type_t type;
+    const char* student_id;                 /* 空串表示全部学号 */
+    db_rollup_summary_t* summary;
+    double sum_a;
+    double sum_b;
+    uint32_t rows_read;                     /* 读取的汇总行数 */
+} rollup_query_t;
+
+/* 静态变量 */
+static rollup_key_t keys[DB_ROLLUP_MAX_KEYS];
+static uint8_t key_count = 0;
+static db_rollup_statistics_t statistics;
+
+static const uint32_t BUCKET_SECONDS[DB_ROLLUP_LEVEL_COUNT] = {
+    DB_ROLLUP_MINUTE_SECONDS,
+    DB_ROLLUP_HOUR_SECONDS,
+    DB_ROLLUP_DAY_SECONDS
+};
+
+/* 内部函数声明 */
+static rollup_key_t* find_key(uint8_t level, sensor_type_t type, sensor_status_t status,
+                              const char* student_id, const char* sensor_name);
+static db_result_t get_current_time(uint32_t* now);
+static db_result_t upsert_key(const rollup_key_t* key, uint32_t now);
+static db_result_t query_range(rollup_query_t* query, uint8_t level, uint32_t start, uint32_t end);
+static db_result_t query_segment(rollup_query_t* query, uint8_t level, uint32_t start, uint32_t end);
+static db_result_t create_rollup_result(bool success, int error_code, const char* message,
+                                        uint32_t rows);
+
+/**
+ * @brief 初始化汇总模块
+ */
+system_status_t db_rollup_init(void)
+{
+    memset(keys, 0, sizeof(keys));
+    memset(&statistics, 0, sizeof(statistics));
+    key_count = 0;
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 计入一条与原始数据同一事务写入的行
+ */
+db_result_t db_rollup_add(const sensor_data_t* data)
+{
+    db_result_t result;
+    rollup_key_t* key;
+    const char* student_id;
+    const char* sensor_name;
+    sensor_status_t status;
+    uint32_t timestamp;
+    double value_a;
+    double value_b;
+    uint8_t level;
+
+    if (data == NULL) {
+        return create_rollup_result(false, DB_ERROR_INVALID_PARAM, "Invalid rollup row", 0);
+    }
+
+    if (data->type == SENSOR_TYPE_TEMP_HUMIDITY) {
+        student_id = data->data.sensor1.student_id;
+        sensor_name = data->data.sensor1.sensor_name;
+        status = data->data.sensor1.status;
+        timestamp = data->data.sensor1.timestamp;
+        value_a = data->data.sensor1.temperature;
+        value_b = data->data.sensor1.humidity;
+    } else if (data->type == SENSOR_TYPE_INTERRUPT) {
+        student_id = data->data.sensor2.student_id;
+        sensor_name = data->data.sensor2.sensor_name;
+        status = data->data.sensor2.status;
+        timestamp = data->data.sensor2.timestamp;
+        value_a = (double)data->data.sensor2.interrupt_count;
+        value_b = 0.0;
+    } else {
+        return create_rollup_result(false, DB_ERROR_INVALID_PARAM, "Invalid rollup row", 0);
+    }
+
+    /* 最坏情况下每级都需要一个新键 */
+    if (key_count + DB_ROLLUP_LEVEL_COUNT > DB_ROLLUP_MAX_KEYS) {
+        result = db_rollup_flush();
+        if (!result.success) {
+            return result;
+        }
+    }
+
+    for (level = 0; level < DB_ROLLUP_LEVEL_COUNT; level++) {
+        key = find_key(level, data->type, status, student_id, sensor_name);
+        if (key == NULL) {
+            key = &keys[key_count++];
+            memset(key, 0, sizeof(rollup_key_t));
+            key->level = level;
+            key->type = data->type;
+            key->status = status;
+            SAFE_STRCPY(key->student_id, student_id, sizeof(key->student_id));
+            SAFE_STRCPY(key->sensor_name, sensor_name, sizeof(key->sensor_name));
+        }
+
+        key->row_count++;
+        key->sum_a += value_a;
+        key->sum_b += value_b;
+        if (timestamp > key->last_timestamp) {
+            key->last_timestamp = timestamp;
+        }
+    }
+
+    statistics.rows_added++;
+    statistics.pending_keys = key_count;
+    return create_rollup_result(true, DB_ERROR_NONE, NULL, 0);
+}
+
+/**
+ * @brief 把待写入的键累加到各级汇总表
+ */
+db_result_t db_rollup_flush(void)
+{
+    db_result_t result;
+    uint32_t now = 0;
+    uint8_t i;
+
+    if (key_count == 0) {
+        return create_rollup_result(true, DB_ERROR_NONE, NULL, 0);
+    }
+
+    /* 一次写出的键都计入提交时服务器时间所在的时间桶 */
+    result = get_current_time(&now);
+    if (!result.success) {
+        statistics.flush_failures++;
+        return result;
+    }
+
+    for (i = 0; i < key_count; i++) {
+        result = upsert_key(&keys[i], now);
+        if (!result.success) {
+            /* 键保留到调用方回滚事务并调用db_rollup_discard() */
+            statistics.flush_failures++;
+            return result;
+        }
+        statistics.upserts++;
+    }
+
+    result = create_rollup_result(true, DB_ERROR_NONE, NULL, key_count);
+    key_count = 0;
+    statistics.pending_keys = 0;
+    return result;
+}
+
+/**
+ * @brief 丢弃待写入的键
+ */
+void db_rollup_discard(void)
+{
+    statistics.discarded += key_count;
+    key_count = 0;
+    statistics.pending_keys = 0;
+}
+
+/**
+ * @brief 汇总一个时间范围内的数据
+ */
+db_result_t db_rollup_query(sensor_type_t type, const char* student_id,
+                            uint32_t from, uint32_t to, db_rollup_summary_t* summary)
+{
+    rollup_query_t query;
+    db_result_t result;
+    uint32_t start;
+    uint32_t end;
+
+    if (summary == NULL || from >= to || to > 0xFFFFFFFFUL - DB_ROLLUP_MINUTE_SECONDS ||
+        (type != SENSOR_TYPE_TEMP_HUMIDITY && type != SENSOR_TYPE_INTERRUPT) ||
+        (student_id != NULL && strlen(student_id) >= MAX_STUDENT_ID_LEN)) {
+        return create_rollup_result(false, DB_ERROR_INVALID_PARAM, "Invalid rollup query parameters", 0);
+    }
+
+    memset(summary, 0, sizeof(db_rollup_summary_t));
+    memset(&query, 0, sizeof(query));
+    query.type = type;
+    query.student_id = (student_id != NULL) ? student_id : "";
+    query.summary = summary;
+
+    /* 分钟是最细的粒度，范围向外对齐到整分钟 */
+    start = from - from % DB_ROLLUP_MINUTE_SECONDS;
+    end = to + (DB_ROLLUP_MINUTE_SECONDS - to % DB_ROLLUP_MINUTE_SECONDS) % DB_ROLLUP_MINUTE_SECONDS;
+
+    statistics.queries++;
+    result = query_range(&query, DB_ROLLUP_DAY, start, end);
+    if (!result.success) {
+        return result;
+    }
+
+    if (summary->row_count > 0) {
+        if (type == SENSOR_TYPE_TEMP_HUMIDITY) {
+            summary->temperature_avg = (float)(query.sum_a / (double)summary->row_count);
+            summary->humidity_avg = (float)(query.sum_b / (double)summary->row_count);
+        } else {
+            summary->interrupt_total = (uint32_t)(query.sum_a + 0.5);
+        }
+    }
+
+    return create_rollup_result(true, DB_ERROR_NONE, NULL, query.rows_read);
+}
+
+/**
+ * @brief 获取汇总统计信息
+ */
+void db_rollup_get_statistics(db_rollup_statistics_t* stats)
+{
+    if (stats != NULL) {
+        memcpy(stats, &statistics, sizeof(db_rollup_statistics_t));
+    }
+}
+
+/* 内部函数实现 */
+
+/**
+ * @brief 查找待写入的键
+ */
+static rollup_key_t* find_key(uint8_t level, sensor_type_t type, sensor_status_t status,
+                              const char* student_id, const char* sensor_name)
+{
+    uint8_t i;
+
+    for (i = 0; i < key_count; i++) {
+        if (keys[i].level == level &&
+            keys[i].type == type && keys[i].status == status &&
+            strcmp(keys[i].student_id, student_id) == 0 &&
+            strcmp(keys[i].sensor_name, sensor_name) == 0) {
+            return &keys[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief 读取服务器当前时间（UNIX秒）
+ */
+static db_result_t get_current_time(uint32_t* now)
+{
+    db_result_t result;
+    db_stmt_t* stmt;
+    db_cursor_t cursor;
+
+    stmt = database_prepare(DB_STMT_CURRENT_TIME);
+    if (stmt == NULL) {
+        return create_rollup_result(false, DB_ERROR_QUERY, database_get_last_error(), 0);
+    }
+
+    result = db_stmt_open_cursor(stmt, &cursor);
+    if (!result.success) {
+        return result;
+    }
+    if (!db_cursor_next(&cursor)) {
+        db_cursor_close(&cursor);
+        return create_rollup_result(false, DB_ERROR_QUERY, "No current time", 0);
+    }
+    *now = db_cursor_get_uint(&cursor, 0);
+    db_cursor_close(&cursor);
+
+    return create_rollup_result(true, DB_ERROR_NONE, NULL, 0);
+}
+
+/**
+ * @brief 把一个键的合计累加到对应级别汇总表中now所在的时间桶
+ */
+static db_result_t upsert_key(const rollup_key_t* key, uint32_t now)
+{
+    db_stmt_t* stmt;
+
+    stmt = database_prepare((db_stmt_id_t)(DB_STMT_ROLLUP_UPSERT_MINUTE + key->level));
+    if (stmt == NULL) {
+        return create_rollup_result(false, DB_ERROR_INSERT, database_get_last_error(), 0);
+    }
+
+    db_stmt_bind_uint(stmt, 0, now - now % BUCKET_SECONDS[key->level]);
+    db_stmt_bind_uint(stmt, 1, (uint32_t)key->type);
+    db_stmt_bind_text(stmt, 2, key->student_id);
+    db_stmt_bind_text(stmt, 3, key->sensor_name);
+    db_stmt_bind_uint(stmt, 4, (uint32_t)key->status);
+    db_stmt_bind_uint(stmt, 5, key->row_count);
+    db_stmt_bind_real(stmt, 6, key->sum_a);
+    db_stmt_bind_real(stmt, 7, key->sum_b);
+    db_stmt_bind_uint(stmt, 8, key->last_timestamp);
+
+    return db_stmt_execute(stmt);
+}
+
+/**
+ * @brief 用level及更细的汇总表覆盖[start, end)：中间的整桶读level级，两端递归到下一级
+ */
+static db_result_t query_range(rollup_query_t* query, uint8_t level, uint32_t start, uint32_t end)
+{
+    db_result_t result;
+    uint32_t size = BUCKET_SECONDS[level];
+    uint32_t first;
+    uint32_t last;
+
+    if (start >= end) {
+        return create_rollup_result(true, DB_ERROR_NONE, NULL, 0);
+    }
+    if (level == DB_ROLLUP_MINUTE) {
+        return query_segment(query, level, start, end);
+    }
+
+    first = (start % size == 0) ? start : start - start % size + size;
+    last = end - end % size;
+    if (first >= last || first < start) {
+        return query_range(query, (uint8_t)(level - 1), start, end);
+    }
+
+    result = query_range(query, (uint8_t)(level - 1), start, first);
+    if (result.success) {
+        result = query_segment(query, level, first, last);
+    }
+    if (result.success) {
+        result = query_range(query, (uint8_t)(level - 1), last, end);
+    }
+    return result;
+}
+
+/**
+ * @brief 读取一级汇总表中[start, end)的时间桶并累加
+ */
+static db_result_t query_segment(rollup_query_t* query, uint8_t level, uint32_t start, uint32_t end)
+{
+    db_result_t result;
+    db_stmt_t* stmt;
+    db_cursor_t cursor;
+    db_rollup_summary_t* summary = query->summary;
+    uint32_t rows;
+    uint32_t status;
+    uint32_t last_timestamp;
+
+    stmt = database_prepare((db_stmt_id_t)(DB_STMT_ROLLUP_QUERY_MINUTE + level));
+    if (stmt == NULL) {
+        return create_rollup_result(false, DB_ERROR_QUERY, database_get_last_error(), 0);
+    }
+
+    db_stmt_bind_uint(stmt, 0, start);
+    db_stmt_bind_uint(stmt, 1, end);
+    db_stmt_bind_uint(stmt, 2, (uint32_t)query->type);
+    db_stmt_bind_text(stmt, 3, query->student_id);
+    db_stmt_bind_text(stmt, 4, query->student_id);
+
+    result = db_stmt_open_cursor(stmt, &cursor);
+    if (!result.success) {
+        return result;
+    }
+
+    statistics.segments[level]++;
+    while (db_cursor_next(&cursor)) {
+        status = db_cursor_get_uint(&cursor, 0);
+        rows = db_cursor_get_uint(&cursor, 1);
+        summary->row_count += rows;
+        if (status < DB_ROLLUP_STATUS_COUNT) {
+            summary->status_counts[status] += rows;
+        }
+        query->sum_a += db_cursor_get_real(&cursor, 2);
+        query->sum_b += db_cursor_get_real(&cursor, 3);
+        last_timestamp = db_cursor_get_uint(&cursor, 4);
+        if (last_timestamp > summary->last_timestamp) {
+            summary->last_timestamp = last_timestamp;
+        }
+        query->rows_read++;
+    }
+    db_cursor_close(&cursor);
+
+    return create_rollup_result(true, DB_ERROR_NONE, NULL, 0);
+}
+
+/**
+ * @brief 创建操作结果
+ */
+static db_result_t create_rollup_result(bool success, int error_code, const char* message,
+                                        uint32_t rows)
+{
+    db_result_t result;
+
+    memset(&result, 0, sizeof(result));
+    result.success = success;
+    result.error_code = error_code;
+    result.affected_rows = rows;
+    if (message != NULL) {
+        SAFE_STRCPY(result.error_message, message, sizeof(result.error_message));
+    }
+    return result;
+}
+
+#else
+
+/* 未启用时本文件为空，避免空翻译单元告警 */
+typedef int db_rollup_unused_t;
+
+#endif /* ENABLE_DB_ROLLUP */
@@ -0,0 +1,335 @@
+/**
+ * @file db_rowset.c
+ * @brief 列式查询结果模块实现 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ */
+
+#include "db_rowset.h"
+
+#define ARENA_ALIGN(size)           (((size) + 3UL) & ~3UL)
+
+/* 内部函数声明 */
+static uint32_t get_row_size(sensor_type_t type);
+static bool allocate_columns(db_rowset_t* rowset, uint32_t rows);
+static bool intern_string(db_rowset_t* rowset, const char* str, uint16_t* index);
+static bool read_row(db_rowset_t* rowset, const db_cursor_t* cursor);
+static int16_t to_fixed_signed(float value);
+static uint16_t to_fixed_unsigned(float value);
+static db_result_t create_rowset_error(int error_code, const char* message);
+
+/**
+ * @brief 初始化内存区
+ */
+void db_arena_init(db_arena_t* arena, void* buffer, uint32_t size)
+{
+    if (arena == NULL) {
+        return;
+    }
+
+    arena->base = (uint8_t*)buffer;
+    arena->capacity = (buffer != NULL) ? size : 0;
+    arena->used = 0;
+}
+
+/**
+ * @brief 从内存区分配
+ */
+void* db_arena_alloc(db_arena_t* arena, uint32_t size)
+{
+    uint32_t start;
+    void* ptr;
+
+    if (arena == NULL || arena->base == NULL) {
+        return NULL;
+    }
+
+    /* 起点按缓冲区实际地址对齐 */
+    start = (uint32_t)(ARENA_ALIGN((size_t)(arena->base + arena->used)) - (size_t)arena->base);
+    if (start > arena->capacity || size > arena->capacity - start) {
+        return NULL;
+    }
+
+    ptr = arena->base + start;
+    arena->used = start + size;
+    return ptr;
+}
+
+/**
+ * @brief 释放内存区中的全部分配
+ */
+void db_arena_reset(db_arena_t* arena)
+{
+    if (arena != NULL) {
+        arena->used = 0;
+    }
+}
+
+/**
+ * @brief 查询传感器数据到列式结果集
+ */
+db_result_t db_rowset_query(db_rowset_t* rowset, db_arena_t* arena, sensor_type_t type,
+                            const char* student_id, uint32_t max_rows)
+{
+    db_result_t result;
+    db_stmt_t* stmt;
+    db_cursor_t cursor;
+    uint32_t available;
+    uint8_t index = 0;
+
+    if (rowset == NULL || arena == NULL ||
+        (type != SENSOR_TYPE_TEMP_HUMIDITY && type != SENSOR_TYPE_INTERRUPT)) {
+        return create_rowset_error(DB_ERROR_INVALID_PARAM, "Invalid rowset parameters");
+    }
+
+    memset(rowset, 0, sizeof(db_rowset_t));
+    rowset->type = type;
+    rowset->arena = arena;
+    rowset->arena_mark = arena->used;
+
+    /* 字符串表固定大小，先于列数组分配 */
+    rowset->strings = (const char**)db_arena_alloc(arena, DB_ROWSET_MAX_STRINGS * sizeof(const char*));
+    rowset->string_slots = (uint16_t*)db_arena_alloc(arena, DB_ROWSET_HASH_SLOTS * sizeof(uint16_t));
+    if (rowset->strings == NULL || rowset->string_slots == NULL) {
+        db_rowset_free(rowset);
+        return create_rowset_error(DB_ERROR_MEMORY, "Rowset arena too small");
+    }
+    memset(rowset->string_slots, 0, DB_ROWSET_HASH_SLOTS * sizeof(uint16_t));
+
+    if (max_rows == 0) {
+        /* 按剩余空间估算行数，留一部分给字符串 */
+        available = arena->capacity - arena->used;
+        available -= available >> DB_ROWSET_STRING_RESERVE_SHIFT;
+        max_rows = available / get_row_size(type);
+    }
+    if (max_rows == 0 || !allocate_columns(rowset, max_rows)) {
+        db_rowset_free(rowset);
+        return create_rowset_error(DB_ERROR_MEMORY, "Rowset arena too small");
+    }
+
+    if (type == SENSOR_TYPE_TEMP_HUMIDITY) {
+        stmt = database_prepare((student_id != NULL && student_id[0] != '\0') ?
+                                DB_STMT_SELECT_SENSOR1_BY_ID : DB_STMT_SELECT_SENSOR1_ALL);
+    } else {
+        stmt = database_prepare((student_id != NULL && student_id[0] != '\0') ?
+                                DB_STMT_SELECT_SENSOR2_BY_ID : DB_STMT_SELECT_SENSOR2_ALL);
+    }
+    if (stmt == NULL) {
+        db_rowset_free(rowset);
+        return create_rowset_error(DB_ERROR_QUERY, database_get_last_error());
+    }
+    if (student_id != NULL && student_id[0] != '\0') {
+        db_stmt_bind_text(stmt, index++, student_id);
+    }
+    /* 多取一行用于判断是否截断 */
+    db_stmt_bind_uint(stmt, index, (max_rows < SQL_STMT_NO_LIMIT) ? max_rows + 1 : max_rows);
+
+    result = db_stmt_open_cursor(stmt, &cursor);
+    if (!result.success) {
+        db_rowset_free(rowset);
+        return result;
+    }
+
+    while (db_cursor_next(&cursor)) {
+        if (rowset->row_count >= rowset->row_capacity || !read_row(rowset, &cursor)) {
+            rowset->truncated = true;
+            break;
+        }
+        rowset->row_count++;
+    }
+    db_cursor_close(&cursor);
+
+    memset(&result, 0, sizeof(result));
+    result.success = true;
+    result.affected_rows = rowset->row_count;
+    return result;
+}
+
+/**
+ * @brief 释放结果集
+ */
+void db_rowset_free(db_rowset_t* rowset)
+{
+    if (rowset == NULL || rowset->arena == NULL) {
+        return;
+    }
+
+    rowset->arena->used = rowset->arena_mark;
+    memset(rowset, 0, sizeof(db_rowset_t));
+}
+
+/* 内部函数实现 */
+
+/**
+ * @brief 每行的列数组字节数
+ */
+static uint32_t get_row_size(sensor_type_t type)
+{
+    /* id + student_id + sensor_name + timestamp */
+    uint32_t size = sizeof(int32_t) + 2 * sizeof(uint16_t) + sizeof(uint32_t);
+
+    if (type == SENSOR_TYPE_TEMP_HUMIDITY) {
+        size += sizeof(int16_t) + sizeof(uint16_t);
+    } else {
+        size += sizeof(uint8_t) + 2 * sizeof(uint32_t);
+    }
+    return size;
+}
+
+/**
+ * @brief 分配各列数组
+ */
+static bool allocate_columns(db_rowset_t* rowset, uint32_t rows)
+{
+    db_arena_t* arena = rowset->arena;
+
+    rowset->id = (int32_t*)db_arena_alloc(arena, rows * sizeof(int32_t));
+    rowset->student_id = (uint16_t*)db_arena_alloc(arena, rows * sizeof(uint16_t));
+    rowset->sensor_name = (uint16_t*)db_arena_alloc(arena, rows * sizeof(uint16_t));
+    rowset->timestamp = (uint32_t*)db_arena_alloc(arena, rows * sizeof(uint32_t));
+    if (rowset->id == NULL || rowset->student_id == NULL ||
+        rowset->sensor_name == NULL || rowset->timestamp == NULL) {
+        return false;
+    }
+
+    if (rowset->type == SENSOR_TYPE_TEMP_HUMIDITY) {
+        rowset->temperature = (int16_t*)db_arena_alloc(arena, rows * sizeof(int16_t));
+        rowset->humidity = (uint16_t*)db_arena_alloc(arena, rows * sizeof(uint16_t));
+        if (rowset->temperature == NULL || rowset->humidity == NULL) {
+            return false;
+        }
+    } else {
+        rowset->interrupt_type = (uint8_t*)db_arena_alloc(arena, rows * sizeof(uint8_t));
+        rowset->interrupt_count = (uint32_t*)db_arena_alloc(arena, rows * sizeof(uint32_t));
+        rowset->first_timestamp = (uint32_t*)db_arena_alloc(arena, rows * sizeof(uint32_t));
+        if (rowset->interrupt_type == NULL || rowset->interrupt_count == NULL ||
+            rowset->first_timestamp == NULL) {
+            return false;
+        }
+    }
+
+    rowset->row_capacity = rows;
+    return true;
+}
+
+/**
+ * @brief 字符串去重：已存在时返回原序号，否则复制到arena
+ */
+static bool intern_string(db_rowset_t* rowset, const char* str, uint16_t* index)
+{
+    uint32_t hash = 2166136261UL;           /* FNV-1a */
+    uint32_t slot;
+    uint32_t length;
+    const char* p;
+    char* copy;
+
+    if (str == NULL) {
+        str = "";
+    }
+    for (p = str; *p != '\0'; p++) {
+        hash = (hash ^ (uint8_t)*p) * 16777619UL;
+    }
+    length = (uint32_t)(p - str);
+
+    slot = hash % DB_ROWSET_HASH_SLOTS;
+    while (rowset->string_slots[slot] != 0) {
+        if (strcmp(rowset->strings[rowset->string_slots[slot] - 1], str) == 0) {
+            *index = (uint16_t)(rowset->string_slots[slot] - 1);
+            return true;
+        }
+        slot = (slot + 1) % DB_ROWSET_HASH_SLOTS;
+    }
+
+    if (rowset->string_count >= DB_ROWSET_MAX_STRINGS) {
+        return false;
+    }
+    copy = (char*)db_arena_alloc(rowset->arena, length + 1);
+    if (copy == NULL) {
+        return false;
+    }
+    memcpy(copy, str, length + 1);
+
+    *index = rowset->string_count;
+    rowset->strings[rowset->string_count++] = copy;
+    rowset->string_slots[slot] = rowset->string_count;
+    return true;
+}
+
+/**
+ * @brief 把游标当前行写入各列
+ */
+static bool read_row(db_rowset_t* rowset, const db_cursor_t* cursor)
+{
+    uint32_t row = rowset->row_count;
+
+    if (rowset->type == SENSOR_TYPE_TEMP_HUMIDITY) {
+        if (!intern_string(rowset, db_cursor_get_text(cursor, DB_SENSOR1_COL_STUDENT_ID), &rowset->student_id[row]) ||
+            !intern_string(rowset, db_cursor_get_text(cursor, DB_SENSOR1_COL_SENSOR_NAME), &rowset->sensor_name[row])) {
+            return false;
+        }
+        rowset->id[row] = db_cursor_get_int(cursor, DB_SENSOR1_COL_ID);
+        rowset->temperature[row] = to_fixed_signed(db_cursor_get_real(cursor, DB_SENSOR1_COL_TEMPERATURE));
+        rowset->humidity[row] = to_fixed_unsigned(db_cursor_get_real(cursor, DB_SENSOR1_COL_HUMIDITY));
+        rowset->timestamp[row] = db_cursor_get_uint(cursor, DB_SENSOR1_COL_TIMESTAMP);
+    } else {
+        if (!intern_string(rowset, db_cursor_get_text(cursor, DB_SENSOR2_COL_STUDENT_ID), &rowset->student_id[row]) ||
+            !intern_string(rowset, db_cursor_get_text(cursor, DB_SENSOR2_COL_SENSOR_NAME), &rowset->sensor_name[row])) {
+            return false;
+        }
+        rowset->id[row] = db_cursor_get_int(cursor, DB_SENSOR2_COL_ID);
+        rowset->interrupt_type[row] = (uint8_t)db_cursor_get_uint(cursor, DB_SENSOR2_COL_INTERRUPT_TYPE);
+        rowset->interrupt_count[row] = db_cursor_get_uint(cursor, DB_SENSOR2_COL_INTERRUPT_COUNT);
+        rowset->first_timestamp[row] = db_cursor_get_uint(cursor, DB_SENSOR2_COL_FIRST_TIMESTAMP);
+        rowset->timestamp[row] = db_cursor_get_uint(cursor, DB_SENSOR2_COL_TIMESTAMP);
+    }
+
+    return true;
+}
+
+/**
+ * @brief 转换为0.01单位的有符号定点数（四舍五入，超出范围时饱和）
+ */
+static int16_t to_fixed_signed(float value)
+{
+    float scaled = value * DB_ROWSET_FIXED_SCALE;
+
+    if (scaled >= 32767.0f) {
+        return 32767;
+    }
+    if (scaled <= -32768.0f) {
+        return -32768;
+    }
+    return (int16_t)(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f);
+}
+
+/**
+ * @brief 转换为0.01单位的无符号定点数（四舍五入，超出范围时饱和）
+ */
+static uint16_t to_fixed_unsigned(float value)
+{
+    float scaled = value * DB_ROWSET_FIXED_SCALE;
+
+    if (scaled <= 0.0f) {
+        return 0;
+    }
+    if (scaled >= 65535.0f) {
+        return 65535;
+    }
+    return (uint16_t)(scaled + 0.5f);
+}
+
+/**
+ * @brief 创建查询失败结果
+ */
+static db_result_t create_rowset_error(int error_code, const char* message)
+{
+    db_result_t result;
+
+    memset(&result, 0, sizeof(result));
+    result.success = false;
+    result.error_code = error_code;
+    SAFE_STRCPY(result.error_message, message != NULL ? message : "Rowset query failed",
+                sizeof(result.error_message));
+    return result;
+}
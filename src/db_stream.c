@@ -0,0 +1,131 @@
+/**
+ * @file db_stream.c
+ * @brief 传感器数据流式读取模块实现 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ */
+
+#include "db_stream.h"
+
+/* 内部函数声明 */
+static db_result_t create_stream_result(bool success, int error_code, const char* message,
+                                        uint32_t rows);
+
+/**
+ * @brief 打开流式读取
+ */
+db_result_t db_stream_open(db_stream_t* stream, sensor_type_t type, const char* student_id,
+                           uint32_t after_id, uint16_t batch_size)
+{
+    if (stream == NULL ||
+        (type != SENSOR_TYPE_TEMP_HUMIDITY && type != SENSOR_TYPE_INTERRUPT) ||
+        batch_size == 0 || batch_size > DB_STREAM_MAX_BATCH ||
+        (student_id != NULL && strlen(student_id) >= MAX_STUDENT_ID_LEN)) {
+        return create_stream_result(false, DB_ERROR_INVALID_PARAM, "Invalid stream parameters", 0);
+    }
+
+    memset(stream, 0, sizeof(db_stream_t));
+    stream->type = type;
+    if (student_id != NULL) {
+        SAFE_STRCPY(stream->student_id, student_id, sizeof(stream->student_id));
+    }
+
+    stream->last_id = after_id;
+    stream->batch_size = batch_size;
+    stream->open = true;
+
+    return create_stream_result(true, DB_ERROR_NONE, NULL, 0);
+}
+
+/**
+ * @brief 读取下一批
+ */
+db_result_t db_stream_next_batch(db_stream_t* stream, db_stream_row_t* rows, uint16_t* count)
+{
+    db_result_t result;
+    db_stmt_t* stmt;
+    db_cursor_t cursor;
+    bool by_id;
+    uint16_t n = 0;
+    uint8_t index = 0;
+
+    if (count != NULL) {
+        *count = 0;
+    }
+    if (stream == NULL || rows == NULL || count == NULL || !stream->open) {
+        return create_stream_result(false, DB_ERROR_INVALID_PARAM, "Stream not open", 0);
+    }
+    if (stream->done) {
+        return create_stream_result(true, DB_ERROR_NONE, NULL, 0);
+    }
+
+    by_id = (stream->student_id[0] != '\0');
+    if (stream->type == SENSOR_TYPE_TEMP_HUMIDITY) {
+        stmt = database_prepare(by_id ? DB_STMT_SCAN_SENSOR1_BY_ID : DB_STMT_SCAN_SENSOR1);
+    } else {
+        stmt = database_prepare(by_id ? DB_STMT_SCAN_SENSOR2_BY_ID : DB_STMT_SCAN_SENSOR2);
+    }
+    if (stmt == NULL) {
+        return create_stream_result(false, DB_ERROR_QUERY, database_get_last_error(), 0);
+    }
+
+    if (by_id) {
+        db_stmt_bind_text(stmt, index++, stream->student_id);
+    }
+    db_stmt_bind_uint(stmt, index++, stream->last_id);
+    db_stmt_bind_uint(stmt, index, stream->batch_size);
+
+    result = db_stmt_open_cursor(stmt, &cursor);
+    if (!result.success) {
+        return result;
+    }
+
+    while (n < stream->batch_size && db_cursor_next(&cursor)) {
+        rows[n].id = db_cursor_get_sensor_data(&cursor, stream->type, &rows[n].data);
+        n++;
+    }
+    db_cursor_close(&cursor);
+
+    if (n > 0) {
+        stream->last_id = rows[n - 1].id;
+        stream->rows_read += n;
+    }
+    /* 不足一批说明已到末尾，省去一次空查询 */
+    if (n < stream->batch_size) {
+        stream->done = true;
+    }
+
+    *count = n;
+    return create_stream_result(true, DB_ERROR_NONE, NULL, n);
+}
+
+/**
+ * @brief 关闭流式读取
+ */
+void db_stream_close(db_stream_t* stream)
+{
+    if (stream != NULL) {
+        stream->open = false;
+    }
+}
+
+/* 内部函数实现 */
+
+/**
+ * @brief 创建操作结果
+ */
+static db_result_t create_stream_result(bool success, int error_code, const char* message,
+                                        uint32_t rows)
+{
+    db_result_t result;
+
+    memset(&result, 0, sizeof(result));
+    result.success = success;
+    result.error_code = error_code;
+    result.affected_rows = rows;
+    if (message != NULL) {
+        SAFE_STRCPY(result.error_message, message, sizeof(result.error_message));
+    }
+    return result;
+}
@@ -0,0 +1,809 @@
+/**
+ * @file db_wal.c
+ * @brief 数据库断线预写日志模块实现 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ */
+
+/* 宿主机构建使用fsync()/fileno()，需在包含系统头文件前声明POSIX */
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "db_wal.h"
+
+#if ENABLE_DB_WAL
+#include "crc.h"
+#include "strbuf.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#define WAL_FSYNC(fp)               fsync(fileno(fp))
+#else
+/* 目标板文件系统（DLIB/半主机）没有fsync，fflush后即视为已写入 */
+#define WAL_FSYNC(fp)               0
+#endif
+
+#define WAL_RECORD_MAGIC            0x5741u         /* "WA" */
+#define WAL_CHECKPOINT_MAGIC        0x574C434BUL    /* "WLCK" */
+#define WAL_CHECKPOINT_SIZE         16
+#define WAL_PAYLOAD_SIZE            ((uint16_t)sizeof(sensor_data_t))
+#define WAL_RECORD_SIZE             (DB_WAL_RECORD_HEADER_SIZE + WAL_PAYLOAD_SIZE)
+
+/* 记录读取结果 */
+typedef enum {
+    WAL_READ_OK = 0,
+    WAL_READ_END = 1,                       /* 段文件正常结束 */
+    WAL_READ_CORRUPT = 2                    /* 半条记录或校验失败 */
+} wal_read_t;
+
+/* 顺序读取位置：跨段读取已追加的记录 */
+typedef struct {
+    FILE* fp;
+    uint32_t segment;                       /* 当前段号 */
+    long offset;                            /* 下一条记录在段内的偏移 */
+    uint32_t record_segment;                /* 最近读出记录的起始位置 */
+    long record_offset;
+    uint32_t corrupt;                       /* 跳过的损坏记录数 */
+} wal_reader_t;
+
+/* 静态变量 */
+static db_wal_config_t current_config;
+static db_wal_statistics_t statistics;
+static bool wal_open = false;
+static FILE* active_file = NULL;
+static uint32_t active_size = 0;
+static uint32_t next_lsn = 1;
+static uint16_t unsynced_rows = 0;
+static uint32_t first_unsynced_time = 0;
+static uint32_t ack_segment = 1;            /* 第一条未确认记录的位置 */
+static long ack_offset = 0;
+static bool peek_valid = false;             /* 最近一次peek的结束位置 */
+static uint32_t peek_lsn = 0;
+static uint32_t peek_segment = 0;
+static long peek_offset = 0;
+static uint8_t record_buffer[WAL_RECORD_SIZE];
+static char path_buffer[DB_WAL_PATH_SIZE];
+
+/* 默认日志配置 */
+const db_wal_config_t DEFAULT_DB_WAL_CONFIG = {
+    DB_WAL_DIRECTORY,                       /* directory */
+    DB_WAL_PREFIX,                          /* prefix */
+    DB_WAL_DEFAULT_SEGMENT_SIZE,            /* segment_size */
+    DB_WAL_DEFAULT_SYNC_ROWS,               /* sync_rows */
+    DB_WAL_DEFAULT_SYNC_INTERVAL            /* sync_interval */
+};
+
+/* 内部函数声明 */
+static const char* build_path(uint32_t segment, const char* suffix);
+static void put_u16(uint8_t* p, uint16_t value);
+static void put_u32(uint8_t* p, uint32_t value);
+static uint16_t get_u16(const uint8_t* p);
+static uint32_t get_u32(const uint8_t* p);
+static wal_read_t read_record(FILE* fp, uint32_t* lsn, sensor_data_t* data);
+static void reader_open(wal_reader_t* reader, uint32_t segment, long offset);
+static bool reader_next(wal_reader_t* reader, uint32_t* lsn, sensor_data_t* data);
+static void reader_close(wal_reader_t* reader);
+static bool read_checkpoint(const char* path, uint32_t* acked_lsn, uint32_t* first_segment);
+static bool load_checkpoint(void);
+static uint32_t find_first_segment(void);
+static bool save_checkpoint(void);
+static bool open_active_segment(void);
+static bool rotate_segment(void);
+static bool sync_active(void);
+static void remove_segments(uint32_t from, uint32_t to);
+static db_result_t create_append_error(const char* message);
+
+/**
+ * @brief 打开日志
+ */
+system_status_t db_wal_init(const db_wal_config_t* config)
+{
+    wal_reader_t reader;
+    sensor_data_t data;
+    uint32_t lsn;
+    uint32_t first_lsn = 0;
+    uint32_t segment;
+    bool have_checkpoint;
+
+    if (config == NULL) {
+        config = &DEFAULT_DB_WAL_CONFIG;
+    }
+    if (config->directory == NULL || config->prefix == NULL ||
+        config->segment_size < WAL_RECORD_SIZE || config->sync_rows == 0) {
+        return SYSTEM_ERROR;
+    }
+
+    if (wal_open) {
+        db_wal_close();
+    }
+
+    memcpy(&current_config, config, sizeof(db_wal_config_t));
+    memset(&statistics, 0, sizeof(statistics));
+    unsynced_rows = 0;
+    peek_valid = false;
+
+    have_checkpoint = load_checkpoint();
+    if (!have_checkpoint) {
+        /* 没有有效检查点：从最小的已有段开始，其中的记录都按未确认处理 */
+        statistics.acked_lsn = 0;
+        statistics.first_segment = find_first_segment();
+    }
+
+    /* 删除检查点已越过但因掉电未删掉的旧段（紧邻首段之前的连续段） */
+    for (segment = statistics.first_segment - 1; segment > 0; segment--) {
+        if (remove(build_path(segment, ".log")) != 0) {
+            break;
+        }
+    }
+
+    /* 扫描已有的段：定位第一条未确认记录并找到最大序号 */
+    next_lsn = statistics.acked_lsn + 1;
+    ack_segment = 0;
+    ack_offset = 0;
+    statistics.active_segment = 0xFFFFFFFFUL;   /* 扫描时不限制段号 */
+    reader_open(&reader, statistics.first_segment, 0);
+    while (reader_next(&reader, &lsn, &data)) {
+        if (first_lsn == 0) {
+            first_lsn = lsn;
+        }
+        if (lsn > statistics.acked_lsn && ack_segment == 0) {
+            ack_segment = reader.record_segment;
+            ack_offset = reader.record_offset;
+        }
+        if (lsn >= next_lsn) {
+            next_lsn = lsn + 1;
+        }
+    }
+    statistics.corrupt_count = reader.corrupt;
+    reader_close(&reader);
+
+    /* 扫描停在第一个不存在的段：追加总是从这个新段开始，
+     * 旧段末尾的半条记录不影响新记录 */
+    statistics.active_segment = reader.segment;
+    if (!have_checkpoint && first_lsn != 0) {
+        /* 已确认的位置未知：从最小段的第一条记录开始回放（可能重放少量已落库的行） */
+        statistics.acked_lsn = first_lsn - 1;
+    }
+    statistics.pending_count = next_lsn - 1 - statistics.acked_lsn;
+
+    if (statistics.pending_count == 0) {
+        /* 日志已排空：删除剩余的段并从段1重新编号，没有检查点时只需从段1找起 */
+        remove_segments(statistics.first_segment, statistics.active_segment);
+        statistics.first_segment = 1;
+        statistics.active_segment = 1;
+        if (!save_checkpoint()) {
+            ERROR_PRINT("WAL: checkpoint write failed");
+        }
+    }
+    if (ack_segment == 0 || statistics.pending_count == 0) {
+        ack_segment = statistics.active_segment;
+        ack_offset = 0;
+    }
+
+    if (!open_active_segment()) {
+        ERROR_PRINT("WAL: cannot open segment %s", build_path(statistics.active_segment, ".log"));
+        return SYSTEM_ERROR;
+    }
+    wal_open = true;
+
+    DEBUG_PRINT("WAL initialized: segments %lu..%lu, acked=%lu, pending=%lu, corrupt=%lu",
+                statistics.first_segment, statistics.active_segment, statistics.acked_lsn,
+                statistics.pending_count, statistics.corrupt_count);
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 追加一条记录
+ */
+db_result_t db_wal_append(const sensor_data_t* data, uint32_t* lsn)
+{
+    db_result_t result;
+    uint32_t crc;
+
+    if (data == NULL) {
+        result = create_append_error("Invalid WAL record");
+        result.error_code = DB_ERROR_INVALID_PARAM;
+        return result;
+    }
+    if (!wal_open) {
+        return create_append_error("WAL not open");
+    }
+
+    put_u32(&record_buffer[0], next_lsn);
+    put_u16(&record_buffer[4], WAL_PAYLOAD_SIZE);
+    put_u16(&record_buffer[6], WAL_RECORD_MAGIC);
+    memcpy(&record_buffer[DB_WAL_RECORD_HEADER_SIZE], data, WAL_PAYLOAD_SIZE);
+    crc = crc32c(record_buffer, 8);
+    crc = crc32c_update(crc, &record_buffer[DB_WAL_RECORD_HEADER_SIZE], WAL_PAYLOAD_SIZE);
+    put_u32(&record_buffer[8], crc);
+
+    if (fwrite(record_buffer, 1, WAL_RECORD_SIZE, active_file) != WAL_RECORD_SIZE) {
+        /* 当前段末尾可能留下半条记录，换新段继续追加 */
+        rotate_segment();
+        return create_append_error("WAL write failed");
+    }
+
+    if (lsn != NULL) {
+        *lsn = next_lsn;
+    }
+    next_lsn++;
+    active_size += WAL_RECORD_SIZE;
+    statistics.appended_count++;
+    statistics.pending_count++;
+
+    if (unsynced_rows++ == 0) {
+        first_unsynced_time = get_tick_ms();
+    }
+    if (unsynced_rows >= current_config.sync_rows) {
+        sync_active();
+    }
+    if (active_size >= current_config.segment_size) {
+        rotate_segment();
+    }
+
+    memset(&result, 0, sizeof(result));
+    result.success = true;
+    result.affected_rows = 1;
+    return result;
+}
+
+/**
+ * @brief 读出最早的未确认记录
+ */
+uint16_t db_wal_peek(sensor_data_t* rows, uint16_t max_rows, uint32_t* last_lsn)
+{
+    wal_reader_t reader;
+    uint32_t lsn = 0;
+    uint16_t count = 0;
+
+    if (!wal_open || rows == NULL || max_rows == 0 || statistics.pending_count == 0) {
+        return 0;
+    }
+
+    /* 让当前段中尚在stdio缓冲区的记录对读取可见 */
+    fflush(active_file);
+
+    reader_open(&reader, ack_segment, ack_offset);
+    while (count < max_rows && reader_next(&reader, &lsn, &rows[count])) {
+        if (lsn > statistics.acked_lsn) {
+            count++;
+        }
+    }
+
+    if (count > 0) {
+        peek_valid = true;
+        peek_lsn = lsn;
+        peek_segment = reader.segment;
+        peek_offset = reader.offset;
+        statistics.replayed_count += count;
+        if (last_lsn != NULL) {
+            *last_lsn = lsn;
+        }
+    } else {
+        /* 读到末尾仍没有记录：剩余序号对应的记录已损坏，不再等待回放 */
+        statistics.corrupt_count += reader.corrupt;
+        statistics.acked_lsn = next_lsn - 1;
+        statistics.pending_count = 0;
+        ack_segment = reader.segment;
+        ack_offset = reader.offset;
+        peek_valid = false;
+    }
+    reader_close(&reader);
+
+    return count;
+}
+
+/**
+ * @brief 从上一次peek的结束位置继续读出
+ */
+uint16_t db_wal_peek_next(sensor_data_t* rows, uint16_t max_rows, uint32_t* last_lsn)
+{
+    wal_reader_t reader;
+    uint32_t lsn = 0;
+    uint16_t count = 0;
+
+    if (!peek_valid) {
+        return db_wal_peek(rows, max_rows, last_lsn);
+    }
+    if (!wal_open || rows == NULL || max_rows == 0) {
+        return 0;
+    }
+
+    fflush(active_file);
+
+    reader_open(&reader, peek_segment, peek_offset);
+    while (count < max_rows && reader_next(&reader, &lsn, &rows[count])) {
+        if (lsn > peek_lsn) {
+            count++;
+        }
+    }
+
+    /* 读到末尾时保留上一次的结束位置，确认仍可走快速路径 */
+    if (count > 0) {
+        peek_lsn = lsn;
+        peek_segment = reader.segment;
+        peek_offset = reader.offset;
+        statistics.replayed_count += count;
+        if (last_lsn != NULL) {
+            *last_lsn = lsn;
+        }
+    }
+    reader_close(&reader);
+
+    return count;
+}
+
+/**
+ * @brief 确认记录已落库
+ */
+system_status_t db_wal_ack(uint32_t lsn)
+{
+    wal_reader_t reader;
+    sensor_data_t data;
+    uint32_t record_lsn;
+    uint32_t old_first;
+
+    if (!wal_open || lsn >= next_lsn) {
+        return SYSTEM_ERROR;
+    }
+    if (lsn <= statistics.acked_lsn) {
+        return SYSTEM_OK;
+    }
+
+    if (peek_valid && lsn == peek_lsn) {
+        ack_segment = peek_segment;
+        ack_offset = peek_offset;
+    } else {
+        /* 部分确认：找到第一条序号大于lsn的记录 */
+        fflush(active_file);
+        reader_open(&reader, ack_segment, ack_offset);
+        ack_segment = 0;
+        while (reader_next(&reader, &record_lsn, &data)) {
+            if (record_lsn > lsn) {
+                ack_segment = reader.record_segment;
+                ack_offset = reader.record_offset;
+                break;
+            }
+        }
+        if (ack_segment == 0) {
+            ack_segment = reader.segment;
+            ack_offset = reader.offset;
+        }
+        reader_close(&reader);
+    }
+    peek_valid = false;
+
+    statistics.acked_count += lsn - statistics.acked_lsn;
+    statistics.pending_count = next_lsn - 1 - lsn;
+    statistics.acked_lsn = lsn;
+
+    /* 先写检查点再删除段：掉电时最多留下已确认的旧段，下次初始化删除 */
+    old_first = statistics.first_segment;
+    statistics.first_segment = ack_segment;
+    if (!save_checkpoint()) {
+        ERROR_PRINT("WAL: checkpoint write failed");
+        return SYSTEM_ERROR;
+    }
+    if (ack_segment > old_first) {
+        remove_segments(old_first, ack_segment);
+    }
+
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 获取未确认的记录数
+ */
+uint32_t db_wal_pending(void)
+{
+    return statistics.pending_count;
+}
+
+/**
+ * @brief 按时间同步
+ */
+void db_wal_poll(uint32_t now)
+{
+    if (!wal_open || unsynced_rows == 0 || current_config.sync_interval == 0) {
+        return;
+    }
+
+    if ((int32_t)(now - first_unsynced_time) >= (int32_t)current_config.sync_interval) {
+        sync_active();
+    }
+}
+
+/**
+ * @brief 立即同步
+ */
+system_status_t db_wal_sync(void)
+{
+    if (!wal_open) {
+        return SYSTEM_ERROR;
+    }
+
+    return sync_active() ? SYSTEM_OK : SYSTEM_ERROR;
+}
+
+/**
+ * @brief 同步并关闭日志
+ */
+void db_wal_close(void)
+{
+    if (!wal_open) {
+        return;
+    }
+
+    sync_active();
+    fclose(active_file);
+    active_file = NULL;
+    wal_open = false;
+
+    /* 本次运行没有追加记录的空段直接删除 */
+    if (active_size == 0) {
+        remove(build_path(statistics.active_segment, ".log"));
+    }
+}
+
+/**
+ * @brief 获取日志统计信息
+ */
+void db_wal_get_statistics(db_wal_statistics_t* stats)
+{
+    if (stats != NULL) {
+        memcpy(stats, &statistics, sizeof(db_wal_statistics_t));
+    }
+}
+
+/* 内部函数实现 */
+
+/**
+ * @brief 生成段文件名（segment为0时生成检查点文件名）
+ */
+static const char* build_path(uint32_t segment, const char* suffix)
+{
+    strbuf_t sb;
+
+    strbuf_init(&sb, path_buffer, sizeof(path_buffer));
+    strbuf_append_str(&sb, current_config.directory);
+    strbuf_append_char(&sb, '/');
+    strbuf_append_str(&sb, current_config.prefix);
+    if (segment != 0) {
+        strbuf_append_char(&sb, '_');
+        strbuf_append_hex32(&sb, segment);
+    }
+    strbuf_append_str(&sb, suffix);
+
+    return strbuf_cstr(&sb);
+}
+
+/**
+ * @brief 小端写入
+ */
+static void put_u16(uint8_t* p, uint16_t value)
+{
+    p[0] = (uint8_t)(value & 0xFF);
+    p[1] = (uint8_t)(value >> 8);
+}
+
+static void put_u32(uint8_t* p, uint32_t value)
+{
+    put_u16(p, (uint16_t)(value & 0xFFFF));
+    put_u16(p + 2, (uint16_t)(value >> 16));
+}
+
+/**
+ * @brief 小端读取
+ */
+static uint16_t get_u16(const uint8_t* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t* p)
+{
+    return (uint32_t)get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+/**
+ * @brief 读取并校验一条记录
+ */
+static wal_read_t read_record(FILE* fp, uint32_t* lsn, sensor_data_t* data)
+{
+    size_t length;
+    uint32_t crc;
+
+    length = fread(record_buffer, 1, DB_WAL_RECORD_HEADER_SIZE, fp);
+    if (length == 0) {
+        return WAL_READ_END;
+    }
+    if (length != DB_WAL_RECORD_HEADER_SIZE ||
+        get_u16(&record_buffer[6]) != WAL_RECORD_MAGIC ||
+        get_u16(&record_buffer[4]) != WAL_PAYLOAD_SIZE) {
+        return WAL_READ_CORRUPT;
+    }
+
+    if (fread(&record_buffer[DB_WAL_RECORD_HEADER_SIZE], 1, WAL_PAYLOAD_SIZE, fp) != WAL_PAYLOAD_SIZE) {
+        return WAL_READ_CORRUPT;
+    }
+
+    crc = crc32c(record_buffer, 8);
+    crc = crc32c_update(crc, &record_buffer[DB_WAL_RECORD_HEADER_SIZE], WAL_PAYLOAD_SIZE);
+    if (crc != get_u32(&record_buffer[8])) {
+        return WAL_READ_CORRUPT;
+    }
+
+    *lsn = get_u32(&record_buffer[0]);
+    memcpy(data, &record_buffer[DB_WAL_RECORD_HEADER_SIZE], WAL_PAYLOAD_SIZE);
+    return WAL_READ_OK;
+}
+
+/**
+ * @brief 从指定位置开始读取
+ */
+static void reader_open(wal_reader_t* reader, uint32_t segment, long offset)
+{
+    reader->fp = NULL;
+    reader->segment = segment;
+    reader->offset = offset;
+    reader->record_segment = segment;
+    reader->record_offset = offset;
+    reader->corrupt = 0;
+}
+
+/**
+ * @brief 读取下一条记录：段结束或损坏时转到下一段，直到当前追加段末尾
+ */
+static bool reader_next(wal_reader_t* reader, uint32_t* lsn, sensor_data_t* data)
+{
+    wal_read_t status;
+
+    while (reader->segment <= statistics.active_segment) {
+        if (reader->fp == NULL) {
+            reader->fp = fopen(build_path(reader->segment, ".log"), "rb");
+            if (reader->fp == NULL) {
+                /* 段不存在：扫描到此结束（追加段尚未创建时同样如此） */
+                return false;
+            }
+            if (reader->offset != 0 && fseek(reader->fp, reader->offset, SEEK_SET) != 0) {
+                reader->offset = 0;
+            }
+        }
+
+        status = read_record(reader->fp, lsn, data);
+        if (status == WAL_READ_OK) {
+            reader->record_segment = reader->segment;
+            reader->record_offset = reader->offset;
+            reader->offset += WAL_RECORD_SIZE;
+            return true;
+        }
+
+        if (reader->segment == statistics.active_segment) {
+            /* 追加段：停在已写入的末尾 */
+            if (status == WAL_READ_CORRUPT) {
+                reader->corrupt++;
+            }
+            return false;
+        }
+
+        /* 旧段结束，或掉电留下的半条记录：其余部分作废，转到下一段 */
+        if (status == WAL_READ_CORRUPT) {
+            reader->corrupt++;
+        }
+        fclose(reader->fp);
+        reader->fp = NULL;
+        reader->segment++;
+        reader->offset = 0;
+    }
+
+    return false;
+}
+
+/**
+ * @brief 关闭读取
+ */
+static void reader_close(wal_reader_t* reader)
+{
+    if (reader->fp != NULL) {
+        fclose(reader->fp);
+        reader->fp = NULL;
+    }
+}
+
+/**
+ * @brief 读取并校验一个检查点文件
+ */
+static bool read_checkpoint(const char* path, uint32_t* acked_lsn, uint32_t* first_segment)
+{
+    uint8_t buffer[WAL_CHECKPOINT_SIZE];
+    FILE* fp;
+    size_t length;
+
+    fp = fopen(path, "rb");
+    if (fp == NULL) {
+        return false;
+    }
+    length = fread(buffer, 1, sizeof(buffer), fp);
+    fclose(fp);
+
+    if (length != sizeof(buffer) || get_u32(&buffer[0]) != WAL_CHECKPOINT_MAGIC ||
+        get_u32(&buffer[12]) != crc32c(buffer, 12) || get_u32(&buffer[8]) == 0) {
+        return false;
+    }
+
+    *acked_lsn = get_u32(&buffer[4]);
+    *first_segment = get_u32(&buffer[8]);
+    return true;
+}
+
+/**
+ * @brief 读取检查点：改名前掉电（或先删除旧检查点的平台上在删除和改名之间
+ *        掉电）时临时文件是较新的检查点，取两者中确认位置较大的一个
+ */
+static bool load_checkpoint(void)
+{
+    uint32_t acked_lsn;
+    uint32_t first_segment;
+    uint32_t temp_acked_lsn;
+    uint32_t temp_first_segment;
+    bool found;
+
+    found = read_checkpoint(build_path(0, ".ckpt"), &acked_lsn, &first_segment);
+    if (read_checkpoint(build_path(0, ".ckpt.tmp"), &temp_acked_lsn, &temp_first_segment) &&
+        (!found || temp_acked_lsn >= acked_lsn)) {
+        acked_lsn = temp_acked_lsn;
+        first_segment = temp_first_segment;
+        found = true;
+    }
+
+    if (!found) {
+        ERROR_PRINT("WAL: no valid checkpoint, replaying from lowest segment");
+        return false;
+    }
+
+    statistics.acked_lsn = acked_lsn;
+    statistics.first_segment = first_segment;
+    return true;
+}
+
+/**
+ * @brief 找最小的已有段（没有目录列举接口，从段1起逐个探测）
+ * @return uint32_t 段号，没有任何段时为1
+ */
+static uint32_t find_first_segment(void)
+{
+    uint32_t segment;
+    FILE* fp;
+
+    for (segment = 1; segment <= DB_WAL_RECOVERY_PROBE; segment++) {
+        fp = fopen(build_path(segment, ".log"), "rb");
+        if (fp != NULL) {
+            fclose(fp);
+            return segment;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief 写检查点（临时文件同步后改名）
+ */
+static bool save_checkpoint(void)
+{
+    uint8_t buffer[WAL_CHECKPOINT_SIZE];
+    char temp_path[DB_WAL_PATH_SIZE];
+    FILE* fp;
+    bool ok;
+
+    put_u32(&buffer[0], WAL_CHECKPOINT_MAGIC);
+    put_u32(&buffer[4], statistics.acked_lsn);
+    put_u32(&buffer[8], statistics.first_segment);
+    put_u32(&buffer[12], crc32c(buffer, 12));
+
+    SAFE_STRCPY(temp_path, build_path(0, ".ckpt.tmp"), sizeof(temp_path));
+    fp = fopen(temp_path, "wb");
+    if (fp == NULL) {
+        return false;
+    }
+    ok = fwrite(buffer, 1, sizeof(buffer), fp) == sizeof(buffer) &&
+         fflush(fp) == 0 && WAL_FSYNC(fp) == 0;
+    fclose(fp);
+
+    /* rename()不能覆盖已存在文件的平台上先删除旧检查点 */
+    if (ok && rename(temp_path, build_path(0, ".ckpt")) != 0) {
+        remove(build_path(0, ".ckpt"));
+        ok = rename(temp_path, build_path(0, ".ckpt")) == 0;
+    }
+
+    return ok;
+}
+
+/**
+ * @brief 创建追加段（已存在的段号跳过，不截断其中的记录）
+ */
+static bool open_active_segment(void)
+{
+    FILE* fp;
+
+    while ((fp = fopen(build_path(statistics.active_segment, ".log"), "rb")) != NULL) {
+        fclose(fp);
+        ERROR_PRINT("WAL: segment %s already exists, skipped",
+                    build_path(statistics.active_segment, ".log"));
+        statistics.active_segment++;
+    }
+
+    active_file = fopen(build_path(statistics.active_segment, ".log"), "wb");
+    active_size = 0;
+    return active_file != NULL;
+}
+
+/**
+ * @brief 同步并关闭当前段，开始下一段
+ */
+static bool rotate_segment(void)
+{
+    sync_active();
+    fclose(active_file);
+    statistics.active_segment++;
+
+    if (!open_active_segment()) {
+        ERROR_PRINT("WAL: cannot open segment %s", build_path(statistics.active_segment, ".log"));
+        wal_open = false;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 组同步：一次fflush+fsync覆盖所有未同步记录
+ */
+static bool sync_active(void)
+{
+    bool ok;
+
+    if (unsynced_rows == 0) {
+        return true;
+    }
+
+    ok = fflush(active_file) == 0 && WAL_FSYNC(active_file) == 0;
+    if (ok) {
+        unsynced_rows = 0;
+        statistics.sync_count++;
+    }
+    return ok;
+}
+
+/**
+ * @brief 删除[from, to)范围内的段
+ */
+static void remove_segments(uint32_t from, uint32_t to)
+{
+    uint32_t segment;
+
+    for (segment = from; segment < to; segment++) {
+        remove(build_path(segment, ".log"));
+    }
+}
+
+/**
+ * @brief 创建追加失败结果
+ */
+static db_result_t create_append_error(const char* message)
+{
+    db_result_t result;
+
+    memset(&result, 0, sizeof(result));
+    result.success = false;
+    result.error_code = DB_ERROR_INSERT;
+    SAFE_STRCPY(result.error_message, message, sizeof(result.error_message));
+    return result;
+}
+
+#else
+
+/* 未启用时本文件为空，避免空翻译单元告警 */
+typedef int db_wal_unused_t;
+
+#endif /* ENABLE_DB_WAL */
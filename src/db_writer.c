@@ -0,0 +1,283 @@
+/**
+ * @file db_writer.c
+ * @brief 数据库异步写入队列模块实现 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ */
+
+#include "db_writer.h"
+
+#if ENABLE_DB_WRITER
+
+/* 队列条目 */
+typedef struct {
+    sensor_data_t data;                     /* 传感器数据 */
+    uint32_t enqueue_time;                  /* 入队时间（毫秒） */
+} writer_entry_t;
+
+/* 静态变量 */
+static writer_entry_t entries[DB_WRITER_MAX_DEPTH];
+static uint16_t queue_head = 0;
+static volatile uint16_t queue_length = 0;
+static db_writer_config_t current_config;
+static db_writer_statistics_t statistics;
+static db_writer_sink_t writer_sink = database_insert_sensor_data;
+static bool draining = false;
+
+/* 默认写入队列配置 */
+const db_writer_config_t DEFAULT_DB_WRITER_CONFIG = {
+    DB_WRITER_MAX_DEPTH,                    /* queue_depth */
+    DB_WRITER_DEFAULT_BATCH,                /* batch_size */
+    DB_WRITER_DROP_OLDEST,                  /* full_policy */
+    DB_WRITER_DEFAULT_TIMEOUT,              /* block_timeout */
+    DB_WRITER_MAIN_LOOP                     /* delivery */
+};
+
+/* 内部函数声明 */
+static bool is_valid_config(const db_writer_config_t* config);
+static bool pop_entry(writer_entry_t* entry);
+static void write_entry(const writer_entry_t* entry);
+static uint16_t drain_rows(uint16_t max_rows);
+
+/**
+ * @brief 初始化写入队列
+ */
+system_status_t db_writer_init(const db_writer_config_t* config)
+{
+    if (config == NULL) {
+        config = &DEFAULT_DB_WRITER_CONFIG;
+    }
+    if (!is_valid_config(config)) {
+        return SYSTEM_ERROR;
+    }
+
+    ENTER_CRITICAL();
+    memcpy(&current_config, config, sizeof(db_writer_config_t));
+    memset(&statistics, 0, sizeof(statistics));
+    queue_head = 0;
+    queue_length = 0;
+    draining = false;
+    EXIT_CRITICAL();
+
+    DEBUG_PRINT("DB writer initialized: depth=%d, batch=%d, policy=%d, delivery=%d",
+                current_config.queue_depth, current_config.batch_size,
+                current_config.full_policy, current_config.delivery);
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 设置写入函数
+ */
+void db_writer_set_sink(db_writer_sink_t sink)
+{
+    writer_sink = (sink != NULL) ? sink : database_insert_sensor_data;
+}
+
+/**
+ * @brief 数据入队
+ */
+system_status_t db_writer_enqueue(const sensor_data_t* data)
+{
+    writer_entry_t* entry;
+    uint32_t start_time;
+    bool waited = false;
+
+    if (data == NULL) {
+        return SYSTEM_ERROR;
+    }
+
+    start_time = get_tick_ms();
+
+    ENTER_CRITICAL();
+    while (queue_length >= current_config.queue_depth) {
+        if (current_config.full_policy == DB_WRITER_DROP_OLDEST) {
+            /* 覆盖最旧的未写入数据 */
+            queue_head = (uint16_t)((queue_head + 1) % current_config.queue_depth);
+            queue_length--;
+            statistics.dropped_count++;
+            break;
+        }
+
+        if (current_config.full_policy == DB_WRITER_DROP_NEWEST) {
+            statistics.dropped_count++;
+            EXIT_CRITICAL();
+            return SYSTEM_BUSY;
+        }
+
+        /* DB_WRITER_BLOCK */
+        if (!waited) {
+            waited = true;
+            statistics.blocked_count++;
+        }
+        if (get_tick_ms() - start_time >= current_config.block_timeout) {
+            statistics.dropped_count++;
+            EXIT_CRITICAL();
+            return SYSTEM_TIMEOUT;
+        }
+        EXIT_CRITICAL();
+        if (current_config.delivery == DB_WRITER_MAIN_LOOP && !draining) {
+            /* 没有写入线程：由入队方写出一条腾出空间 */
+            drain_rows(1);
+        } else {
+            DB_WRITER_YIELD();
+        }
+        ENTER_CRITICAL();
+    }
+
+    entry = &entries[(queue_head + queue_length) % current_config.queue_depth];
+    memcpy(&entry->data, data, sizeof(sensor_data_t));
+    entry->enqueue_time = start_time;
+    queue_length++;
+    statistics.enqueued_count++;
+    if (queue_length > statistics.max_queue_length) {
+        statistics.max_queue_length = queue_length;
+    }
+    EXIT_CRITICAL();
+
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 主循环写入
+ */
+uint16_t db_writer_poll(void)
+{
+    if (current_config.delivery != DB_WRITER_MAIN_LOOP) {
+        return 0;
+    }
+
+    return drain_rows(current_config.batch_size);
+}
+
+/**
+ * @brief 写入线程调用
+ */
+uint16_t db_writer_drain(uint16_t max_rows)
+{
+    return drain_rows(max_rows);
+}
+
+/**
+ * @brief 写完队列中所有数据
+ */
+uint16_t db_writer_flush(void)
+{
+    return drain_rows(0xFFFFu);
+}
+
+/**
+ * @brief 获取写入队列统计信息
+ */
+void db_writer_get_statistics(db_writer_statistics_t* stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+
+    ENTER_CRITICAL();
+    memcpy(stats, &statistics, sizeof(db_writer_statistics_t));
+    stats->queue_length = queue_length;
+    EXIT_CRITICAL();
+}
+
+/* 内部函数实现 */
+
+/**
+ * @brief 检查配置范围
+ */
+static bool is_valid_config(const db_writer_config_t* config)
+{
+    return config->queue_depth >= 1 && config->queue_depth <= DB_WRITER_MAX_DEPTH &&
+           config->batch_size >= 1 &&
+           config->full_policy <= DB_WRITER_BLOCK &&
+           config->delivery <= DB_WRITER_WORKER;
+}
+
+/**
+ * @brief 取出队首条目
+ */
+static bool pop_entry(writer_entry_t* entry)
+{
+    bool found = false;
+
+    ENTER_CRITICAL();
+    if (queue_length > 0) {
+        memcpy(entry, &entries[queue_head], sizeof(writer_entry_t));
+        queue_head = (uint16_t)((queue_head + 1) % current_config.queue_depth);
+        queue_length--;
+        found = true;
+    }
+    EXIT_CRITICAL();
+
+    return found;
+}
+
+/**
+ * @brief 在临界区外写入一条数据并记录延迟
+ */
+static void write_entry(const writer_entry_t* entry)
+{
+    db_result_t result;
+    uint32_t latency;
+
+    result = writer_sink(&entry->data);
+    latency = get_tick_ms() - entry->enqueue_time;
+
+    ENTER_CRITICAL();
+    if (result.success) {
+        statistics.written_count++;
+    } else {
+        statistics.failed_count++;
+    }
+    statistics.latency_last = latency;
+    if (latency > statistics.latency_max) {
+        statistics.latency_max = latency;
+    }
+    /* avg += (sample - avg) / 8，避免累加和溢出 */
+    if (latency >= statistics.latency_avg) {
+        statistics.latency_avg += (latency - statistics.latency_avg) >> 3;
+    } else {
+        statistics.latency_avg -= (statistics.latency_avg - latency) >> 3;
+    }
+    EXIT_CRITICAL();
+
+    if (!result.success) {
+        DEBUG_PRINT("DB writer: row not stored: %s", result.error_message);
+    }
+}
+
+/**
+ * @brief 写入至多max_rows条（同一时刻只允许一个写入者）
+ */
+static uint16_t drain_rows(uint16_t max_rows)
+{
+    writer_entry_t entry;
+    uint16_t written = 0;
+
+    ENTER_CRITICAL();
+    if (draining) {
+        EXIT_CRITICAL();
+        return 0;
+    }
+    draining = true;
+    EXIT_CRITICAL();
+
+    while (written < max_rows && pop_entry(&entry)) {
+        write_entry(&entry);
+        written++;
+    }
+
+    ENTER_CRITICAL();
+    draining = false;
+    EXIT_CRITICAL();
+
+    return written;
+}
+
+#else
+
+/* 未启用时本文件为空，避免空翻译单元告警 */
+typedef int db_writer_unused_t;
+
+#endif /* ENABLE_DB_WRITER */
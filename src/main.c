@@ -16,11 +16,29 @@
 #include "sensor_data.h"
 #include "database.h"
 #include "communication.h"
+#include "sensor_filter.h"
+#include "sensor_coalesce.h"
+#include "sensor_anomaly.h"
+#include "sensor_dispatch.h"
+#include "crc.h"
+#include "db_batch.h"
+#include "db_writer.h"
+#include "db_wal.h"
+#include "db_conn.h"
+#include "db_cache.h"
+#include "db_partition.h"
+#include "db_rollup.h"
+#include "db_backup.h"
+#include "db_bulk.h"
+#include "strbuf.h"
 
 /* 全局变量 */
 static bool system_running = true;
 static uint32_t main_loop_count = 0;
 static uint32_t last_heartbeat_time = 0;
+#if ENABLE_DB_CACHE && ENABLE_DB_CONN
+static uint32_t cache_connect_count = 0;    /* 缓存对应的连接次数，重连后缓存失效 */
+#endif
 
 /* 函数声明 */
 static system_status_t system_init(void);
@@ -33,6 +51,30 @@ static void data_received_callback(const uint8_t* data, uint16_t length);
 static void communication_error_callback(comm_error_t error);
 static void database_error_callback(const char* error_msg);
 static void sensor_data_callback(const sensor_data_t* data);
+#if ENABLE_SENSOR_COALESCE
+static void coalesced_data_callback(const sensor2_data_t* data);
+#endif
+#if ENABLE_SENSOR_ANOMALY
+static void anomaly_alert_callback(const sensor_anomaly_alert_t* alert);
+#endif
+static bool database_available(void);
+static bool bulk_load_running(void);
+static db_result_t store_sensor_data(const sensor_data_t* data);
+static bool submit_sensor_data(const sensor_data_t* data);
+#if ENABLE_DB_BATCH
+static void batch_outcome_callback(const db_row_outcome_t* outcomes, uint16_t count, void* context);
+#endif
+#if ENABLE_DB_WAL
+static void replay_wal_backlog(void);
+#if ENABLE_DB_BULK
+static void replay_wal_bulk(void);
+static void bulk_replay_failed(db_result_t result);
+static bool bulk_replay_due(void);
+#endif
+#endif
+#if ENABLE_DB_BACKUP
+static void start_scheduled_backup(void);
+#endif
 static void print_system_info(void);
 static void print_statistics(void);
 static uint32_t get_uptime_seconds(void);
@@ -93,6 +135,13 @@ static system_status_t system_init(void)
     db_config_t db_config;
     comm_config_t comm_config;
     
+    /* 初始化CRC模块（生成查表并检测硬件CRC指令） */
+    status = crc_init();
+    if (status != SYSTEM_OK) {
+        ERROR_PRINT("CRC module initialization failed");
+        return status;
+    }
+    
     /* 初始化传感器数据模块 */
     status = sensor_data_init();
     if (status != SYSTEM_OK) {
@@ -100,6 +149,24 @@ static system_status_t system_init(void)
         return status;
     }
     
+#if ENABLE_SENSOR_FILTER
+    /* 初始化死区过滤 */
+    status = sensor_filter_init();
+    if (status != SYSTEM_OK) {
+        ERROR_PRINT("Sensor filter initialization failed");
+        return status;
+    }
+#endif
+    
+#if ENABLE_SENSOR_COALESCE
+    /* 初始化中断事件合并 */
+    status = sensor_coalesce_init(SENSOR_COALESCE_DEFAULT_WINDOW);
+    if (status != SYSTEM_OK) {
+        ERROR_PRINT("Interrupt coalescing initialization failed");
+        return status;
+    }
+#endif
+    
     /* 初始化通信模块 */
     memcpy(&comm_config, &DEFAULT_COMM_CONFIG, sizeof(comm_config_t));
     status = communication_init(&comm_config);
@@ -117,6 +184,17 @@ static system_status_t system_init(void)
     
     /* 连接数据库 */
     memcpy(&db_config, &DEFAULT_DB_CONFIG, sizeof(db_config_t));
+#if ENABLE_DB_CONN
+    /* 由连接管理连接并建表；首次连接失败不阻止启动，主循环中按退避重连 */
+    status = db_conn_init(&DEFAULT_DB_CONN_CONFIG, &db_config);
+    if (status != SYSTEM_OK) {
+        ERROR_PRINT("Database connection manager initialization failed");
+        return status;
+    }
+    if (!db_conn_available()) {
+        ERROR_PRINT("Database unavailable at startup, retrying in background");
+    }
+#else
     {
         db_result_t db_result = database_connect(&db_config);
         if (!db_result.success) {
@@ -133,12 +211,77 @@ static system_status_t system_init(void)
             return SYSTEM_ERROR;
         }
     }
+#endif
+    
+#if ENABLE_DB_CACHE
+    /* 最新数据缓存（只缓存写入成功的行，启动时为空） */
+    db_cache_init();
+#endif
+    
+#if ENABLE_DB_ROLLUP
+    /* 汇总表随写入路径累加 */
+    db_rollup_init();
+#endif
+    
+#if ENABLE_DB_BACKUP
+    /* 备份在主循环中分块推进 */
+    db_backup_init();
+#endif
+    
+#if ENABLE_DB_BULK
+    /* 积压数据的批量装载 */
+    db_bulk_init();
+#endif
+    
+#if ENABLE_DB_PARTITION
+    /* 分区维护在主循环中进行（连接可能尚未建立） */
+    status = db_partition_init(&DEFAULT_DB_PARTITION_CONFIG);
+    if (status != SYSTEM_OK) {
+        ERROR_PRINT("DB partition manager initialization failed");
+        return status;
+    }
+#endif
+    
+#if ENABLE_DB_WAL
+    /* 打开断线日志，上次运行未回放的数据在连接可用后回放 */
+    status = db_wal_init(&DEFAULT_DB_WAL_CONFIG);
+    if (status != SYSTEM_OK) {
+        ERROR_PRINT("DB write-ahead log initialization failed");
+        return status;
+    }
+#endif
+    
+#if ENABLE_DB_BATCH
+    /* 初始化批量写入 */
+    status = db_batch_init(&DEFAULT_DB_BATCH_CONFIG);
+    if (status != SYSTEM_OK) {
+        ERROR_PRINT("DB batch writer initialization failed");
+        return status;
+    }
+    db_batch_set_outcome_callback(batch_outcome_callback, NULL);
+#endif
+    
+#if ENABLE_DB_WRITER
+    /* 初始化异步写入队列，接收路径只入队 */
+    status = db_writer_init(&DEFAULT_DB_WRITER_CONFIG);
+    if (status != SYSTEM_OK) {
+        ERROR_PRINT("DB writer initialization failed");
+        return status;
+    }
+    db_writer_set_sink(store_sensor_data);
+#endif
     
     /* 设置回调函数 */
     communication_set_rx_callback(data_received_callback);
     communication_set_error_callback(communication_error_callback);
     database_set_error_callback(database_error_callback);
     set_sensor_data_callback(sensor_data_callback);
+#if ENABLE_SENSOR_COALESCE
+    sensor_coalesce_set_output_callback(coalesced_data_callback);
+#endif
+#if ENABLE_SENSOR_ANOMALY
+    sensor_anomaly_set_alert_callback(anomaly_alert_callback);
+#endif
     
     /* 初始化系统状态 */
     main_loop_count = 0;
@@ -162,14 +305,92 @@ static void system_main_loop(void)
     /* 处理通信模块的接收数据 */
     communication_process_rx_data();
     
+#if ENABLE_DB_WRITER
+    /* 写入队列中的数据（每次至多一小批，数据库阻塞不影响接收） */
+    db_writer_poll();
+#endif
+    
+#if ENABLE_DB_WAL
+    /* 连接可用时回放断线期间写入日志的数据（每次一个事务，或批量装载的一批） */
+    replay_wal_backlog();
+#endif
+    
+#if ENABLE_SENSOR_DISPATCH
+    /* 向主循环订阅者批量投递数据 */
+    sensor_dispatch_poll();
+#endif
+    
     /* 更新系统状态 */
     update_system_status();
     
+#if ENABLE_SENSOR_COALESCE
+    /* 输出已到期的中断合并窗口 */
+    if (main_loop_count % 100 == 0) {
+        sensor_coalesce_flush(get_tick_ms());
+    }
+#endif
+    
+#if ENABLE_DB_BATCH
+    /* 写出等待时间已到的批次（按毫秒计时，与循环次数无关） */
+    if (!bulk_load_running()) {
+        db_batch_poll(get_tick_ms());
+    }
+#endif
+    
+#if ENABLE_DB_CONN
+    /* 心跳、退避重连和熔断探测 */
+    if (main_loop_count % 100 == 0) {
+        db_conn_poll(get_tick_ms());
+#if ENABLE_DB_CACHE
+        /* 重连后连接的可能是另一个库文件，缓存重新从数据库填充 */
+        {
+            db_conn_statistics_t conn_stats;
+            db_conn_get_statistics(&conn_stats);
+            if (conn_stats.connect_count != cache_connect_count) {
+                cache_connect_count = conn_stats.connect_count;
+                db_cache_invalidate();
+            }
+        }
+#endif
+    }
+#endif
+    
+#if ENABLE_DB_WAL
+    /* 按时间同步日志中未同步的记录（每轮只比较一次计时，未同步时间不受循环次数影响） */
+    db_wal_poll(get_tick_ms());
+#endif
+    
     /* 定期打印统计信息 */
     if (main_loop_count % 10000 == 0) {
         print_statistics();
     }
     
+    /* 统计中的表行数随写入维护，低频全表计数校正偏差 */
+    if (main_loop_count % 1000000 == 0 && database_available() && !bulk_load_running()) {
+        database_reconcile_statistics();
+    }
+    
+#if ENABLE_DB_PARTITION
+    /* 第一次循环及此后低频：预建分区，按整个分区删除过期数据 */
+    if (main_loop_count % 1000000 == 1 && database_available() && !bulk_load_running()) {
+        db_partition_maintain();
+    }
+#endif
+    
+#if ENABLE_DB_BACKUP
+    /* 低频开始一次备份（第一次为全量，之后从保存的终点增量），
+     * 每次推进只读写一块，写入路径在两次推进之间照常运行；
+     * 批量装载期间不读表，避免与装载争用数据库 */
+    if (main_loop_count % 1000000 == 2 && database_available() && !bulk_load_running() &&
+        !db_backup_running()) {
+        start_scheduled_backup();
+    }
+    if (main_loop_count % 100 == 50 && db_backup_running() && database_available() &&
+        !bulk_load_running()) {
+        db_backup_poll();
+    }
+#endif
+    
     /* 心跳检测 */
     {
         uint32_t current_time = get_uptime_seconds();
@@ -185,6 +406,36 @@ static void system_main_loop(void)
  */
 static void system_shutdown(void)
 {
+#if ENABLE_SENSOR_COALESCE
+    /* 写出未关闭的中断合并窗口 */
+    sensor_coalesce_flush_all();
+#endif
+    
+#if ENABLE_DB_WRITER
+    /* 写完队列中剩余的数据 */
+    db_writer_flush();
+#endif
+    
+#if ENABLE_DB_BULK
+    /* 未提交的装载回滚（在写出批次之前结束装载的事务），数据仍在日志中 */
+    db_bulk_abort();
+#endif
+    
+#if ENABLE_DB_BATCH
+    /* 断开连接前写出所有批次 */
+    db_batch_flush_all();
+#endif
+    
+#if ENABLE_DB_WAL
+    /* 同步并关闭日志，未回放的数据下次启动后回放 */
+    db_wal_close();
+#endif
+    
+#if ENABLE_DB_BACKUP
+    /* 未完成的备份文件不可用于恢复，直接删除 */
+    db_backup_abort();
+#endif
+    
     /* 断开数据库连接 */
     {
         db_result_t result = database_disconnect();
@@ -223,17 +474,35 @@ static void process_received_data(void)
         
         DEBUG_PRINT("Received data: %s", line_buffer);
         
+        /* 帧完整性校验（CRC32C），通过后去除CRC后缀 */
+        if (communication_verify_frame(line_buffer) != SYSTEM_OK) {
+            ERROR_PRINT("Frame integrity check failed: %s", line_buffer);
+            return;
+        }
+        
         /* 解析传感器数据 */
         parse_result = parse_sensor_data(line_buffer, &sensor_data);
         
         if (parse_result.is_valid) {
-            /* 存储到数据库 */
-            db_result_t db_result = database_insert_sensor_data(&sensor_data);
+#if ENABLE_SENSOR_FILTER
+            /* 死区过滤：数值无明显变化且未到心跳间隔时不存储 */
+            if (!sensor_filter_should_store(&sensor_data)) {
+                DEBUG_PRINT("Data suppressed by deadband filter");
+                return;
+            }
+#endif
             
-            if (db_result.success) {
-                INFO_PRINT("Data stored successfully");
-            } else {
-                ERROR_PRINT("Database insert failed: %s", db_result.error_message);
+#if ENABLE_SENSOR_COALESCE
+            /* 中断事件进入合并窗口，窗口关闭时再存储 */
+            if (sensor_data.type == SENSOR_TYPE_INTERRUPT &&
+                sensor_coalesce_add(&sensor_data.data.sensor2)) {
+                return;
+            }
+#endif
+            
+            /* 存储到数据库 */
+            if (submit_sensor_data(&sensor_data)) {
+                DEBUG_PRINT("Data queued for storage");
             }
         } else {
             ERROR_PRINT("Data parse failed: %s", parse_result.error_msg);
@@ -333,16 +602,29 @@ static void database_error_callback(const char* error_msg)
 {
     ERROR_PRINT("Database error callback: %s", error_msg ? error_msg : "Unknown error");
     
-    /* 尝试重新连接数据库 */
+#if ENABLE_DB_CONN
+    /* 只做标记，由db_conn_poll()按退避检查和重连，回调中不访问数据库 */
+    db_conn_report_error(database_get_last_error_code());
+#else
+    /* 尝试重新连接数据库（重连本身的错误也会回调，不能嵌套重连） */
     {
-        db_result_t result = database_disconnect();
+        static bool reconnecting = false;
+        db_result_t result;
+        
+        if (reconnecting) {
+            return;
+        }
+        reconnecting = true;
+        result = database_disconnect();
         if (result.success) {
             result = database_connect(&DEFAULT_DB_CONFIG);
             if (result.success) {
                 INFO_PRINT("Database reconnected successfully");
             }
         }
+        reconnecting = false;
     }
+#endif
 }
 
 /**
@@ -376,6 +658,360 @@ static void sensor_data_callback(const sensor_data_t* data)
     }
 }
 
+#if ENABLE_SENSOR_COALESCE
+/**
+ * @brief 中断合并窗口输出回调函数
+ */
+static void coalesced_data_callback(const sensor2_data_t* data)
+{
+    sensor_data_t row;
+    
+    if (data == NULL) {
+        return;
+    }
+    
+    row.type = SENSOR_TYPE_INTERRUPT;
+    memcpy(&row.data.sensor2, data, sizeof(sensor2_data_t));
+    
+    if (submit_sensor_data(&row)) {
+        DEBUG_PRINT("Coalesced window stored: ID=%s, Sensor=%s, Count=%lu", 
+                    data->student_id, data->sensor_name, data->interrupt_count);
+    }
+}
+#endif
+
+/**
+ * @brief 数据库当前是否可以访问（启用连接管理时熔断期间视为不可访问）
+ */
+static bool database_available(void)
+{
+#if ENABLE_DB_CONN
+    return db_conn_available();
+#else
+    return database_get_status() == DB_STATUS_CONNECTED;
+#endif
+}
+
+/**
+ * @brief 是否有跨多次循环进行中的批量装载（期间装载的事务保持打开，
+ *        不做其他数据库写入、统计校正和DDL）
+ */
+static bool bulk_load_running(void)
+{
+#if ENABLE_DB_BULK
+    return db_bulk_active();
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 存储一条传感器数据（启用批量写入时进入批次，数据库不可用时写入日志）
+ */
+static db_result_t store_sensor_data(const sensor_data_t* data)
+{
+    db_result_t result;
+    
+#if ENABLE_DB_WAL
+    /* 数据库不可用或日志中仍有未回放的数据时写入日志，保持写入顺序 */
+    if (!database_available() || db_wal_pending() > 0) {
+        result = database_check_sensor_row(data);
+        return result.success ? db_wal_append(data, NULL) : result;
+    }
+#endif
+    
+#if ENABLE_DB_BATCH
+    /* 语句执行失败的行由batch_outcome_callback写入日志 */
+    result = db_batch_add(data, NULL);
+#else
+    /* 启用汇总表时数据行和汇总表在同一事务中写入 */
+    result = database_insert_sensor_data(data);
+#if ENABLE_DB_CACHE
+    if (result.success) {
+        db_cache_put(data);
+    }
+#endif
+#if ENABLE_DB_WAL
+    if (!result.success && result.error_code != DB_ERROR_INVALID_PARAM) {
+        result = db_wal_append(data, NULL);
+    }
+#endif
+#endif
+    return result;
+}
+
+/**
+ * @brief 提交一条待存储的数据（启用写入队列时只入队，不等待数据库）
+ */
+static bool submit_sensor_data(const sensor_data_t* data)
+{
+#if ENABLE_DB_WRITER
+    system_status_t status = db_writer_enqueue(data);
+    
+    if (status != SYSTEM_OK) {
+        ERROR_PRINT("Write queue full, data dropped: %d", status);
+        return false;
+    }
+    return true;
+#else
+    db_result_t db_result = store_sensor_data(data);
+    
+    if (!db_result.success) {
+        ERROR_PRINT("Database insert failed: %s", db_result.error_message);
+        return false;
+    }
+    return true;
+#endif
+}
+
+#if ENABLE_DB_BATCH
+/**
+ * @brief 批量写入逐行结果回调函数
+ */
+static void batch_outcome_callback(const db_row_outcome_t* outcomes, uint16_t count, void* context)
+{
+    uint16_t failed = 0;
+    uint16_t spilled = 0;
+    uint16_t i;
+    
+    (void)context;
+    
+    for (i = 0; i < count; i++) {
+        if (outcomes[i].status != DB_ROW_INSERTED) {
+            failed++;
+            DEBUG_PRINT("Row %lu not stored: status=%d, error=%d", 
+                        outcomes[i].row_id, outcomes[i].status, outcomes[i].error_code);
+        }
+#if ENABLE_DB_CACHE
+        if (outcomes[i].status == DB_ROW_INSERTED) {
+            db_cache_put(outcomes[i].data);
+        }
+#endif
+#if ENABLE_DB_WAL
+        /* 语句失败（数据本身有效）的行写入日志，连接恢复后回放 */
+        if (outcomes[i].status == DB_ROW_FAILED &&
+            db_wal_append(outcomes[i].data, NULL).success) {
+            spilled++;
+        }
+#endif
+    }
+    
+    if (failed == 0) {
+        INFO_PRINT("Batch stored successfully: %d rows", count);
+    } else {
+        ERROR_PRINT("Batch store failed: %d of %d rows, %d saved to log", failed, count, spilled);
+    }
+}
+#endif
+
+#if ENABLE_DB_WAL
+/**
+ * @brief 回放日志中的一批数据：一个事务写入，提交成功后确认
+ */
+static sensor_data_t replay_rows[DB_WAL_REPLAY_BATCH];
+#if ENABLE_DB_BULK
+static uint32_t bulk_last_lsn = 0;          /* 进行中的装载已暂存的最后一条记录 */
+static uint32_t bulk_retry_time = 0;        /* 装载失败后可以再次开始的运行秒数，0表示不退避 */
+#endif
+
+static void replay_wal_backlog(void)
+{
+    sensor_data_t* rows = replay_rows;
+    db_result_t result;
+    uint32_t last_lsn;
+    uint16_t count;
+    uint16_t i;
+    
+    if (db_wal_pending() == 0) {
+        return;
+    }
+    if (!database_available()) {
+#if ENABLE_DB_BULK
+        /* 装载中途连接不可用：回滚，数据仍在日志中，恢复后重新开始 */
+        if (db_bulk_active()) {
+            db_bulk_abort();
+        }
+#endif
+        return;
+    }
+    
+#if ENABLE_DB_BULK
+    /* 积压较多时（长时间断线后）改为批量装载，暂存分散到多次循环 */
+    if (bulk_replay_due()) {
+        replay_wal_bulk();
+        return;
+    }
+#endif
+    
+    count = db_wal_peek(rows, DB_WAL_REPLAY_BATCH, &last_lsn);
+    if (count == 0) {
+        return;
+    }
+    
+    result = database_begin_transaction();
+    if (!result.success) {
+        return;
+    }
+    
+    for (i = 0; i < count; i++) {
+        result = database_insert_sensor_data(&rows[i]);
+        /* 数据无效的行无法写入，跳过以免阻塞后续回放 */
+        if (!result.success && result.error_code != DB_ERROR_INVALID_PARAM) {
+            break;
+        }
+    }
+    
+    if (i == count) {
+        /* 汇总表与回放的行在同一事务中提交 */
+        result = database_commit_transaction();
+        if (result.success) {
+#if ENABLE_DB_CACHE
+            /* 提交后才进入缓存；无效的行没有写入 */
+            for (i = 0; i < count; i++) {
+                if (database_check_sensor_row(&rows[i]).success) {
+                    db_cache_put(&rows[i]);
+                }
+            }
+#endif
+            db_wal_ack(last_lsn);
+            DEBUG_PRINT("WAL replayed %d rows, %lu pending", count, db_wal_pending());
+            return;
+        }
+    }
+    
+    database_rollback_transaction();
+    ERROR_PRINT("WAL replay failed: %s", result.error_message);
+}
+
+#if ENABLE_DB_BULK
+/**
+ * @brief 批量装载日志积压：每次循环只暂存一批，积压读完或达到单次装载上限时
+ *        装载提交，之后确认；装载失败后退避DB_BULK_RETRY_SECONDS秒
+ */
+static void replay_wal_bulk(void)
+{
+    db_result_t result;
+    uint32_t batch_lsn;
+    uint16_t count;
+    uint16_t i;
+    
+    if (db_bulk_active()) {
+        count = db_wal_peek_next(replay_rows, DB_WAL_REPLAY_BATCH, &batch_lsn);
+    } else {
+        count = db_wal_peek(replay_rows, DB_WAL_REPLAY_BATCH, &batch_lsn);
+        if (count == 0) {
+            return;
+        }
+        result = db_bulk_begin();
+        if (!result.success) {
+            bulk_replay_failed(result);
+            return;
+        }
+    }
+    
+    for (i = 0; i < count; i++) {
+        result = db_bulk_add(&replay_rows[i]);
+        /* 数据无效的行无法写入，跳过以免阻塞后续回放 */
+        if (!result.success && result.error_code != DB_ERROR_INVALID_PARAM) {
+            db_bulk_abort();
+            bulk_replay_failed(result);
+            return;
+        }
+    }
+    if (count > 0) {
+        bulk_last_lsn = batch_lsn;
+        if (db_bulk_staged_rows() + DB_WAL_REPLAY_BATCH <= DB_BULK_MAX_ROWS) {
+            return;
+        }
+    }
+    
+    result = db_bulk_commit();
+    if (!result.success) {
+        bulk_replay_failed(result);
+        return;
+    }
+    bulk_retry_time = 0;
+    
+#if ENABLE_DB_CACHE
+    /* 装载的行不经过缓存，缓存重新从数据库填充 */
+    db_cache_invalidate();
+#endif
+    db_wal_ack(bulk_last_lsn);
+    DEBUG_PRINT("WAL bulk replayed %lu rows, %lu pending", result.affected_rows, db_wal_pending());
+}
+
+/**
+ * @brief 批量装载失败：记录错误，退避期间按小事务逐批回放
+ */
+static void bulk_replay_failed(db_result_t result)
+{
+    bulk_retry_time = get_uptime_seconds() + DB_BULK_RETRY_SECONDS;
+    ERROR_PRINT("WAL bulk replay failed: %s", result.error_message);
+}
+
+/**
+ * @brief 是否可以开始或继续批量装载（装载进行中，或积压较多且不在退避期间）
+ */
+static bool bulk_replay_due(void)
+{
+    if (db_bulk_active()) {
+        return true;
+    }
+    if (db_wal_pending() < DB_BULK_MIN_ROWS) {
+        return false;
+    }
+    return bulk_retry_time == 0 || (int32_t)(get_uptime_seconds() - bulk_retry_time) >= 0;
+}
+#endif
+#endif
+
+#if ENABLE_SENSOR_ANOMALY
+/**
+ * @brief 异常告警回调函数
+ */
+static void anomaly_alert_callback(const sensor_anomaly_alert_t* alert)
+{
+    if (alert == NULL) {
+        return;
+    }
+    
+    /* 入库时即告警，无需事后扫描数据库 */
+    ERROR_PRINT("Anomaly: ID=%s, Sensor=%s, Metric=%d, Reason=%d, Value=%.2f, Mean=%.2f", 
+                alert->student_id, alert->sensor_name, alert->metric, alert->reason,
+                alert->value, alert->mean);
+}
+#endif
+
+#if ENABLE_DB_BACKUP
+/**
+ * @brief 开始一次备份：从上次完成的备份终点增量导出，文件名带备份序号
+ */
+static void start_scheduled_backup(void)
+{
+    char path[DB_BACKUP_PATH_SIZE];
+    db_backup_point_t point;
+    db_result_t result;
+    bool incremental;
+    strbuf_t sb;
+
+    strbuf_init(&sb, path, sizeof(path));
+    strbuf_append_str(&sb, DB_BACKUP_DIRECTORY "/" DB_BACKUP_PREFIX "_");
+    strbuf_append_hex32(&sb, db_backup_next_sequence());
+    strbuf_append_str(&sb, DB_BACKUP_SUFFIX);
+
+    incremental = db_backup_get_point(&point);
+    result = db_backup_start(strbuf_cstr(&sb), incremental ? &point : NULL);
+    if (!result.success && incremental && result.error_code == DB_ERROR_INVALID_PARAM) {
+        /* 表被重建过（如从备份恢复后id重新分配），保存的终点无法接续 */
+        INFO_PRINT("Backup point no longer matches tables, starting a full backup");
+        result = db_backup_start(strbuf_cstr(&sb), NULL);
+    }
+    if (!result.success) {
+        ERROR_PRINT("Backup start failed: %s", result.error_message);
+    }
+}
+#endif
+
 /**
  * @brief 打印系统信息
  */
@@ -423,8 +1059,128 @@ static void print_statistics(void)
                sensor_total, sensor_valid, sensor_error);
     INFO_PRINT("Communication - RX: %lu bytes, TX: %lu bytes, Errors: %lu", 
                comm_stats.bytes_received, comm_stats.bytes_transmitted, comm_stats.error_count);
+    INFO_PRINT("Frames (%s) - CRC OK: %lu, CRC Error: %lu, Unchecked: %lu", COMM_PORT_NAME,
+               comm_stats.frame_crc_ok_count, comm_stats.frame_crc_error_count,
+               comm_stats.frame_unchecked_count);
     INFO_PRINT("Database - Sensor1: %lu records, Sensor2: %lu records", 
                sensor1_count, sensor2_count);
+#if ENABLE_SENSOR_FILTER
+    {
+        sensor_filter_statistics_t filter_stats;
+        sensor_filter_get_statistics(&filter_stats);
+        INFO_PRINT("Filter - Passed: %lu, Suppressed: %lu, Heartbeat: %lu", 
+                   filter_stats.passed_count, filter_stats.suppressed_count,
+                   filter_stats.heartbeat_count);
+    }
+#endif
+#if ENABLE_SENSOR_COALESCE
+    {
+        sensor_coalesce_statistics_t coalesce_stats;
+        sensor_coalesce_get_statistics(&coalesce_stats);
+        INFO_PRINT("Coalesce - Events: %lu, Rows: %lu, Pending: %lu", 
+                   coalesce_stats.events_in, coalesce_stats.rows_out,
+                   coalesce_stats.pending_windows);
+    }
+#endif
+#if ENABLE_DB_BATCH
+    {
+        db_batch_statistics_t batch_stats;
+        db_batch_get_statistics(&batch_stats);
+        INFO_PRINT("Batch - Rows: %lu, Inserted: %lu, Rejected: %lu, Failed: %lu, Statements: %lu", 
+                   batch_stats.rows_added, batch_stats.rows_inserted, batch_stats.rows_rejected,
+                   batch_stats.rows_failed, batch_stats.statements);
+    }
+#endif
+#if ENABLE_DB_WRITER
+    {
+        db_writer_statistics_t writer_stats;
+        db_writer_get_statistics(&writer_stats);
+        INFO_PRINT("Writer - Queued: %lu, Written: %lu, Failed: %lu, Dropped: %lu, Depth: %d/%d", 
+                   writer_stats.enqueued_count, writer_stats.written_count,
+                   writer_stats.failed_count, writer_stats.dropped_count,
+                   writer_stats.queue_length, writer_stats.max_queue_length);
+        INFO_PRINT("Writer latency - Last: %lu ms, Avg: %lu ms, Max: %lu ms", 
+                   writer_stats.latency_last, writer_stats.latency_avg, writer_stats.latency_max);
+    }
+#endif
+#if ENABLE_DB_CONN
+    {
+        db_conn_statistics_t conn_stats;
+        db_conn_get_statistics(&conn_stats);
+        INFO_PRINT("Connection - State: %d, Connects: %lu, Failures: %lu, Pings: %lu/%lu failed, Breaker trips: %lu", 
+                   conn_stats.state, conn_stats.connect_count, conn_stats.connect_failures,
+                   conn_stats.ping_count, conn_stats.ping_failures, conn_stats.breaker_trips);
+    }
+#endif
+#if ENABLE_DB_CACHE
+    {
+        db_cache_statistics_t cache_stats;
+        db_cache_get_statistics(&cache_stats);
+        INFO_PRINT("Cache - Hits: %lu, Misses: %lu, Fills: %lu, Rows: %lu, Keys: %d, Evictions: %lu", 
+                   cache_stats.hits, cache_stats.misses, cache_stats.fills,
+                   cache_stats.puts, cache_stats.keys_used, cache_stats.evictions);
+    }
+#endif
+#if ENABLE_DB_PARTITION
+    {
+        db_partition_statistics_t partition_stats;
+        db_partition_get_statistics(&partition_stats);
+        INFO_PRINT("Partition - Tables: %d, Created: %lu, Dropped: %lu (%lu rows), Deleted rows: %lu", 
+                   partition_stats.partitioned_tables, partition_stats.partitions_created,
+                   partition_stats.partitions_dropped, partition_stats.rows_dropped,
+                   partition_stats.rows_deleted);
+    }
+#endif
+#if ENABLE_DB_ROLLUP
+    {
+        db_rollup_statistics_t rollup_stats;
+        db_rollup_get_statistics(&rollup_stats);
+        INFO_PRINT("Rollup - Rows: %lu, Upserts: %lu, Failures: %lu, Queries: %lu (day/hour/minute segments: %lu/%lu/%lu)", 
+                   rollup_stats.rows_added, rollup_stats.upserts, rollup_stats.flush_failures,
+                   rollup_stats.queries, rollup_stats.segments[DB_ROLLUP_DAY],
+                   rollup_stats.segments[DB_ROLLUP_HOUR], rollup_stats.segments[DB_ROLLUP_MINUTE]);
+    }
+#endif
+#if ENABLE_DB_BACKUP
+    {
+        db_backup_statistics_t backup_stats;
+        db_backup_get_statistics(&backup_stats);
+        INFO_PRINT("Backup - Completed: %lu, Failed: %lu, Last: %lu rows / %lu bytes, Restored: %lu%s", 
+                   backup_stats.backups_completed, backup_stats.backups_failed,
+                   backup_stats.rows_written, backup_stats.bytes_written,
+                   backup_stats.rows_restored,
+                   (backup_stats.state == DB_BACKUP_RUNNING) ? " (running)" : "");
+    }
+#endif
+#if ENABLE_DB_BULK
+    {
+        db_bulk_statistics_t bulk_stats;
+        db_bulk_get_statistics(&bulk_stats);
+        INFO_PRINT("Bulk - Loads: %lu, Failed: %lu, Rows: %lu, Rejected: %lu, Last: %lu rows in %lu ms (%lu rows/s)", 
+                   bulk_stats.loads_completed, bulk_stats.loads_failed, bulk_stats.rows_loaded,
+                   bulk_stats.rows_rejected, bulk_stats.last_rows, bulk_stats.last_elapsed_ms,
+                   bulk_stats.last_rows_per_second);
+    }
+#endif
+#if ENABLE_DB_WAL
+    {
+        db_wal_statistics_t wal_stats;
+        db_wal_get_statistics(&wal_stats);
+        INFO_PRINT("WAL - Appended: %lu, Acked: %lu, Pending: %lu, Syncs: %lu, Corrupt: %lu, Segments: %lu..%lu", 
+                   wal_stats.appended_count, wal_stats.acked_count, wal_stats.pending_count,
+                   wal_stats.sync_count, wal_stats.corrupt_count,
+                   wal_stats.first_segment, wal_stats.active_segment);
+    }
+#endif
+#if ENABLE_SENSOR_ANOMALY
+    {
+        sensor_anomaly_statistics_t anomaly_stats;
+        sensor_anomaly_get_statistics(&anomaly_stats);
+        INFO_PRINT("Anomaly - Evaluated: %lu, Anomalies: %lu, Sensors: %lu", 
+                   anomaly_stats.evaluated_count, anomaly_stats.anomaly_count,
+                   anomaly_stats.tracked_sensors);
+    }
+#endif
     INFO_PRINT("========================");
 }
 
@@ -519,6 +1275,7 @@ static void test_database_operations(void)
     sensor2_data.interrupt_count = 1;
     sensor2_data.status = SENSOR_STATUS_NORMAL;
     sensor2_data.timestamp = get_timestamp();
+    sensor2_data.first_timestamp = sensor2_data.timestamp;
     
     /* 测试插入操作 */
     result = database_insert_sensor1_data(&sensor1_data);
@@ -0,0 +1,343 @@
+/**
+ * @file sensor_aggregate.c
+ * @brief 传感器滚动统计模块实现 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ */
+
+#include "sensor_aggregate.h"
+
+#if ENABLE_SENSOR_AGGREGATE
+#include "sensor_table.h"
+
+/* 统计子桶 */
+typedef struct {
+    uint32_t start;                         /* 桶起始时间（秒） */
+    uint32_t count;                         /* 样本数 */
+    float mean;                             /* 均值 */
+    float m2;                               /* 离差平方和 */
+    float min;                              /* 最小值 */
+    float max;                              /* 最大值 */
+} agg_bucket_t;
+
+/* 每传感器统计状态 */
+typedef struct {
+    agg_bucket_t buckets[SENSOR_AGG_METRIC_SLOTS][SENSOR_AGG_WINDOW_COUNT][SENSOR_AGG_BUCKETS];
+} agg_state_t;
+
+/* 静态变量 */
+static sensor_table_entry_t table_entries[SENSOR_AGG_MAX_SENSORS];
+static sensor_table_t sensor_table;
+static agg_state_t sensor_states[SENSOR_AGG_MAX_SENSORS];
+static uint32_t window_lengths[SENSOR_AGG_WINDOW_COUNT] = {
+    SENSOR_AGG_WINDOW_1MIN,
+    SENSOR_AGG_WINDOW_5MIN,
+    SENSOR_AGG_WINDOW_1HOUR
+};
+static uint8_t window_count = SENSOR_AGG_WINDOW_COUNT;
+static uint32_t clock_seconds = 0;
+static uint32_t clock_last_ms = 0;
+static uint32_t clock_remainder_ms = 0;
+
+/* 内部函数声明 */
+static uint32_t now_seconds(void);
+static void update_metric(agg_state_t* state, uint8_t slot, float value, uint32_t now);
+static void bucket_add(agg_bucket_t* bucket, float value);
+static void bucket_merge(agg_bucket_t* dst, const agg_bucket_t* src);
+static bool metric_to_slot(sensor_metric_t metric, uint8_t* slot, sensor_type_t* type);
+
+/**
+ * @brief 初始化滚动统计模块
+ */
+system_status_t sensor_aggregate_init(void)
+{
+    system_status_t status;
+
+    status = sensor_table_init(&sensor_table, table_entries, SENSOR_AGG_MAX_SENSORS);
+    if (status != SYSTEM_OK) {
+        return status;
+    }
+
+    memset(sensor_states, 0, sizeof(sensor_states));
+    clock_seconds = 0;
+    clock_last_ms = get_tick_ms();
+    clock_remainder_ms = 0;
+
+    DEBUG_PRINT("Sensor aggregate module initialized: %d sensors, %d windows",
+                SENSOR_AGG_MAX_SENSORS, window_count);
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 配置滑动窗口长度
+ */
+system_status_t sensor_aggregate_set_windows(const uint32_t* lengths, uint8_t count)
+{
+    uint8_t i;
+
+    if (lengths == NULL || count == 0 || count > SENSOR_AGG_WINDOW_COUNT) {
+        return SYSTEM_ERROR;
+    }
+
+    /* 窗口长度至少要能分成SENSOR_AGG_BUCKETS个子桶 */
+    for (i = 0; i < count; i++) {
+        if (lengths[i] < SENSOR_AGG_BUCKETS) {
+            return SYSTEM_ERROR;
+        }
+    }
+
+    for (i = 0; i < count; i++) {
+        window_lengths[i] = lengths[i];
+    }
+    window_count = count;
+
+    /* 子桶宽度变化后旧统计无法复用 */
+    return sensor_aggregate_init();
+}
+
+/**
+ * @brief 用一条有效传感器数据更新滚动统计
+ */
+void sensor_aggregate_update(const sensor_data_t* data)
+{
+    int32_t index;
+    uint32_t now;
+
+    if (data == NULL) {
+        return;
+    }
+
+    /* 按到达时间归桶：数据中的timestamp是get_timestamp()的调用计数，不是时间 */
+    now = now_seconds();
+
+    switch (data->type) {
+        case SENSOR_TYPE_TEMP_HUMIDITY:
+        {
+            const sensor1_data_t* s1 = &data->data.sensor1;
+
+            index = sensor_table_acquire(&sensor_table, s1->student_id, s1->sensor_name,
+                                         (uint8_t)data->type, now);
+            if (index < 0) {
+                DEBUG_PRINT("Aggregate table full, sample dropped: %s", s1->student_id);
+                return;
+            }
+            update_metric(&sensor_states[index], 0, s1->temperature, now);
+            update_metric(&sensor_states[index], 1, s1->humidity, now);
+            break;
+        }
+
+        case SENSOR_TYPE_INTERRUPT:
+        {
+            const sensor2_data_t* s2 = &data->data.sensor2;
+
+            index = sensor_table_acquire(&sensor_table, s2->student_id, s2->sensor_name,
+                                         (uint8_t)data->type, now);
+            if (index < 0) {
+                DEBUG_PRINT("Aggregate table full, sample dropped: %s", s2->student_id);
+                return;
+            }
+            update_metric(&sensor_states[index], 0, (float)s2->interrupt_count, now);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief 获取传感器滚动统计
+ */
+system_status_t get_sensor_aggregate(const char* student_id, const char* sensor_name,
+                                     sensor_metric_t metric, uint8_t window_index,
+                                     sensor_aggregate_t* aggregate)
+{
+    agg_bucket_t merged;
+    const agg_bucket_t* buckets;
+    sensor_type_t type;
+    uint8_t slot;
+    int32_t index;
+    uint32_t length;
+    uint32_t now;
+    uint8_t i;
+
+    if (student_id == NULL || sensor_name == NULL || aggregate == NULL ||
+        window_index >= window_count) {
+        return SYSTEM_ERROR;
+    }
+
+    if (!metric_to_slot(metric, &slot, &type)) {
+        return SYSTEM_ERROR;
+    }
+
+    index = sensor_table_find(&sensor_table, student_id, sensor_name, (uint8_t)type);
+    if (index < 0) {
+        return SYSTEM_ERROR;
+    }
+
+    /* 合并落在窗口内的子桶，时间基准为当前时间 */
+    now = now_seconds();
+    length = window_lengths[window_index];
+    buckets = sensor_states[index].buckets[slot][window_index];
+    memset(&merged, 0, sizeof(merged));
+
+    for (i = 0; i < SENSOR_AGG_BUCKETS; i++) {
+        if (buckets[i].count > 0 &&
+            buckets[i].start <= now &&
+            now - buckets[i].start < length) {
+            bucket_merge(&merged, &buckets[i]);
+        }
+    }
+
+    memset(aggregate, 0, sizeof(sensor_aggregate_t));
+    aggregate->window_length = length;
+    aggregate->count = merged.count;
+    if (merged.count > 0) {
+        aggregate->min = merged.min;
+        aggregate->max = merged.max;
+        aggregate->mean = merged.mean;
+        aggregate->variance = merged.m2 / (float)merged.count;
+    }
+
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 获取已跟踪的传感器数量
+ */
+uint32_t sensor_aggregate_get_sensor_count(void)
+{
+    return sensor_table.count;
+}
+
+/* 内部函数实现 */
+
+/**
+ * @brief 模块启动以来的秒数（由毫秒计时累加，毫秒计数回绕不影响）
+ */
+static uint32_t now_seconds(void)
+{
+    uint32_t ms = get_tick_ms();
+
+    clock_remainder_ms += ms - clock_last_ms;
+    clock_last_ms = ms;
+    clock_seconds += clock_remainder_ms / 1000U;
+    clock_remainder_ms %= 1000U;
+    return clock_seconds;
+}
+
+/**
+ * @brief 更新一个指标在所有窗口中的子桶
+ */
+static void update_metric(agg_state_t* state, uint8_t slot, float value, uint32_t now)
+{
+    uint8_t w;
+
+    for (w = 0; w < window_count; w++) {
+        uint32_t width = window_lengths[w] / SENSOR_AGG_BUCKETS;
+        uint32_t start = now - (now % width);
+        agg_bucket_t* bucket = &state->buckets[slot][w][(now / width) % SENSOR_AGG_BUCKETS];
+
+        /* 迟到的样本（子桶已轮转到更新的时间段）直接丢弃，不覆盖更新的统计 */
+        if (bucket->count > 0 && start < bucket->start) {
+            continue;
+        }
+
+        /* 子桶已轮转到新的时间段，丢弃旧统计 */
+        if (bucket->count == 0 || bucket->start != start) {
+            memset(bucket, 0, sizeof(agg_bucket_t));
+            bucket->start = start;
+        }
+
+        bucket_add(bucket, value);
+    }
+}
+
+/**
+ * @brief Welford增量更新
+ */
+static void bucket_add(agg_bucket_t* bucket, float value)
+{
+    float delta;
+
+    bucket->count++;
+    if (bucket->count == 1) {
+        bucket->mean = value;
+        bucket->m2 = 0.0f;
+        bucket->min = value;
+        bucket->max = value;
+        return;
+    }
+
+    delta = value - bucket->mean;
+    bucket->mean += delta / (float)bucket->count;
+    bucket->m2 += delta * (value - bucket->mean);
+
+    if (value < bucket->min) {
+        bucket->min = value;
+    }
+    if (value > bucket->max) {
+        bucket->max = value;
+    }
+}
+
+/**
+ * @brief 合并两个子桶的统计量（Chan并行算法）
+ */
+static void bucket_merge(agg_bucket_t* dst, const agg_bucket_t* src)
+{
+    uint32_t total;
+    float delta;
+
+    if (src->count == 0) {
+        return;
+    }
+
+    if (dst->count == 0) {
+        memcpy(dst, src, sizeof(agg_bucket_t));
+        return;
+    }
+
+    total = dst->count + src->count;
+    delta = src->mean - dst->mean;
+
+    dst->m2 += src->m2 + delta * delta * ((float)dst->count * (float)src->count / (float)total);
+    dst->mean += delta * (float)src->count / (float)total;
+    dst->count = total;
+    dst->min = MIN(dst->min, src->min);
+    dst->max = MAX(dst->max, src->max);
+}
+
+/**
+ * @brief 指标映射到指标槽和传感器类型
+ */
+static bool metric_to_slot(sensor_metric_t metric, uint8_t* slot, sensor_type_t* type)
+{
+    switch (metric) {
+        case SENSOR_METRIC_TEMPERATURE:
+            *slot = 0;
+            *type = SENSOR_TYPE_TEMP_HUMIDITY;
+            return true;
+
+        case SENSOR_METRIC_HUMIDITY:
+            *slot = 1;
+            *type = SENSOR_TYPE_TEMP_HUMIDITY;
+            return true;
+
+        case SENSOR_METRIC_INTERRUPT:
+            *slot = 0;
+            *type = SENSOR_TYPE_INTERRUPT;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+#else
+
+/* 未启用时本文件为空，避免空翻译单元告警 */
+typedef int sensor_aggregate_unused_t;
+
+#endif /* ENABLE_SENSOR_AGGREGATE */
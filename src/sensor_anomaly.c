@@ -0,0 +1,364 @@
+/**
+ * @file sensor_anomaly.c
+ * @brief 传感器流式异常检测模块实现 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ */
+
+#include "sensor_anomaly.h"
+
+#if ENABLE_SENSOR_ANOMALY
+#include "sensor_table.h"
+
+/* 单指标EWMA状态 */
+typedef struct {
+    float mean;                             /* EWMA均值 */
+    float variance;                         /* EWMA方差 */
+    float last_value;                       /* 上一个样本值 */
+    uint32_t last_time;                     /* 上一个样本的到达时间（毫秒） */
+    uint16_t samples;                       /* 已学习样本数 */
+} ewma_metric_t;
+
+/* 每传感器检测状态 */
+typedef struct {
+    ewma_metric_t metrics[2];               /* 传感器1：温度/湿度；传感器2：事件间隔 */
+} anomaly_state_t;
+
+/* 方差下限，避免读数长期不变时微小波动被判为异常 */
+static const float MIN_VARIANCE[] = {
+    0.25f,      /* 温度 */
+    1.0f,       /* 湿度 */
+    100.0f      /* 中断事件间隔（毫秒） */
+};
+
+/* 静态变量 */
+static sensor_table_entry_t table_entries[SENSOR_ANOMALY_MAX_SENSORS];
+static sensor_table_t sensor_table;
+static anomaly_state_t sensor_states[SENSOR_ANOMALY_MAX_SENSORS];
+static sensor_anomaly_config_t current_config;
+static sensor_anomaly_statistics_t statistics;
+static void (*alert_callback)(const sensor_anomaly_alert_t* alert) = NULL;
+
+/* 默认检测配置 */
+const sensor_anomaly_config_t DEFAULT_SENSOR_ANOMALY_CONFIG = {
+    SENSOR_ANOMALY_DEFAULT_ALPHA,           /* alpha */
+    SENSOR_ANOMALY_DEFAULT_Z,               /* z_threshold */
+    SENSOR_ANOMALY_DEFAULT_T_RATE,          /* max_temperature_rate */
+    SENSOR_ANOMALY_DEFAULT_H_RATE,          /* max_humidity_rate */
+    SENSOR_ANOMALY_DEFAULT_WARMUP           /* warmup_samples */
+};
+
+/* 内部函数声明 */
+static anomaly_reason_t evaluate_metric(ewma_metric_t* m, sensor_metric_t metric,
+                                        float value, uint32_t now, float max_rate);
+static bool is_out_of_range(sensor_metric_t metric, float value);
+static void ewma_update(ewma_metric_t* m, float value);
+static bool is_zscore_outlier(const ewma_metric_t* m, sensor_metric_t metric, float value);
+static void raise_alert(const char* student_id, const char* sensor_name, sensor_metric_t metric,
+                        anomaly_reason_t reason, float value, float mean, uint32_t timestamp);
+static float abs_float(float value);
+
+/**
+ * @brief 初始化异常检测模块
+ */
+system_status_t sensor_anomaly_init(void)
+{
+    system_status_t status;
+
+    status = sensor_table_init(&sensor_table, table_entries, SENSOR_ANOMALY_MAX_SENSORS);
+    if (status != SYSTEM_OK) {
+        return status;
+    }
+
+    memset(sensor_states, 0, sizeof(sensor_states));
+    memset(&statistics, 0, sizeof(statistics));
+    memcpy(&current_config, &DEFAULT_SENSOR_ANOMALY_CONFIG, sizeof(sensor_anomaly_config_t));
+
+    DEBUG_PRINT("Anomaly detector initialized: %d sensors, z=%.1f",
+                SENSOR_ANOMALY_MAX_SENSORS, current_config.z_threshold);
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 设置检测配置
+ */
+system_status_t sensor_anomaly_set_config(const sensor_anomaly_config_t* config)
+{
+    if (config == NULL || config->alpha <= 0.0f || config->alpha >= 1.0f ||
+        config->z_threshold <= 0.0f) {
+        return SYSTEM_ERROR;
+    }
+
+    memcpy(&current_config, config, sizeof(sensor_anomaly_config_t));
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 评估传感器1数据并更新检测器
+ */
+sensor_status_t sensor_anomaly_evaluate_sensor1(const sensor1_data_t* data)
+{
+    anomaly_state_t* state;
+    anomaly_reason_t reason;
+    sensor_status_t status = SENSOR_STATUS_NORMAL;
+    uint32_t now;
+    int32_t index;
+    float mean;
+
+    if (data == NULL) {
+        return SENSOR_STATUS_ERROR;
+    }
+
+    statistics.evaluated_count++;
+
+    /* 变化率按到达时间计算：data->timestamp是解析计数，不随真实时间增长 */
+    now = get_tick_ms();
+    index = sensor_table_acquire(&sensor_table, data->student_id, data->sensor_name,
+                                 (uint8_t)SENSOR_TYPE_TEMP_HUMIDITY, now);
+    if (index < 0) {
+        /* 索引表已满：没有基线，仍按预热阶段的固定阈值检查 */
+        statistics.untracked_count++;
+        if (is_out_of_range(SENSOR_METRIC_TEMPERATURE, data->temperature)) {
+            raise_alert(data->student_id, data->sensor_name, SENSOR_METRIC_TEMPERATURE,
+                        ANOMALY_REASON_RANGE, data->temperature, 0.0f, data->timestamp);
+            status = SENSOR_STATUS_WARNING;
+        }
+        if (is_out_of_range(SENSOR_METRIC_HUMIDITY, data->humidity)) {
+            raise_alert(data->student_id, data->sensor_name, SENSOR_METRIC_HUMIDITY,
+                        ANOMALY_REASON_RANGE, data->humidity, 0.0f, data->timestamp);
+            status = SENSOR_STATUS_WARNING;
+        }
+        if (status != SENSOR_STATUS_NORMAL) {
+            statistics.anomaly_count++;
+        }
+        return status;
+    }
+    statistics.tracked_sensors = sensor_table.count;
+    state = &sensor_states[index];
+
+    mean = state->metrics[0].mean;
+    reason = evaluate_metric(&state->metrics[0], SENSOR_METRIC_TEMPERATURE, data->temperature,
+                             now, current_config.max_temperature_rate);
+    if (reason != ANOMALY_REASON_NONE) {
+        raise_alert(data->student_id, data->sensor_name, SENSOR_METRIC_TEMPERATURE, reason,
+                    data->temperature, mean, data->timestamp);
+        status = SENSOR_STATUS_WARNING;
+    }
+
+    mean = state->metrics[1].mean;
+    reason = evaluate_metric(&state->metrics[1], SENSOR_METRIC_HUMIDITY, data->humidity,
+                             now, current_config.max_humidity_rate);
+    if (reason != ANOMALY_REASON_NONE) {
+        raise_alert(data->student_id, data->sensor_name, SENSOR_METRIC_HUMIDITY, reason,
+                    data->humidity, mean, data->timestamp);
+        status = SENSOR_STATUS_WARNING;
+    }
+
+    if (status != SENSOR_STATUS_NORMAL) {
+        statistics.anomaly_count++;
+    }
+
+    return status;
+}
+
+/**
+ * @brief 评估传感器2数据并更新检测器
+ */
+sensor_status_t sensor_anomaly_evaluate_sensor2(const sensor2_data_t* data)
+{
+    ewma_metric_t* m;
+    uint32_t now;
+    int32_t index;
+    float interval;
+
+    if (data == NULL) {
+        return SENSOR_STATUS_ERROR;
+    }
+
+    /* 没有中断发生 */
+    if (data->interrupt_type == INTERRUPT_TYPE_NONE) {
+        return SENSOR_STATUS_NORMAL;
+    }
+
+    statistics.evaluated_count++;
+
+    /* 事件间隔按到达时间计算（毫秒） */
+    now = get_tick_ms();
+    index = sensor_table_acquire(&sensor_table, data->student_id, data->sensor_name,
+                                 (uint8_t)SENSOR_TYPE_INTERRUPT, now);
+    if (index < 0) {
+        /* 事件间隔没有固定阈值可用，索引表满时只计数 */
+        statistics.untracked_count++;
+        return SENSOR_STATUS_NORMAL;
+    }
+    statistics.tracked_sensors = sensor_table.count;
+    m = &sensor_states[index].metrics[0];
+
+    /* 第一个事件只记录时间 */
+    if (m->last_time == 0 && m->samples == 0) {
+        m->last_time = now;
+        return SENSOR_STATUS_NORMAL;
+    }
+
+    /* 对事件间隔建模：间隔异常缩短表示抖动或事件风暴 */
+    interval = (float)(now - m->last_time);
+    m->last_time = now;
+
+    if (m->samples >= current_config.warmup_samples &&
+        interval < m->mean && is_zscore_outlier(m, SENSOR_METRIC_INTERRUPT, interval)) {
+        raise_alert(data->student_id, data->sensor_name, SENSOR_METRIC_INTERRUPT,
+                    ANOMALY_REASON_ZSCORE, interval, m->mean, data->timestamp);
+        ewma_update(m, interval);
+        statistics.anomaly_count++;
+        return SENSOR_STATUS_WARNING;
+    }
+
+    ewma_update(m, interval);
+    return SENSOR_STATUS_NORMAL;
+}
+
+/**
+ * @brief 设置异常告警回调函数
+ */
+void sensor_anomaly_set_alert_callback(void (*callback)(const sensor_anomaly_alert_t* alert))
+{
+    alert_callback = callback;
+}
+
+/**
+ * @brief 获取检测统计信息
+ */
+void sensor_anomaly_get_statistics(sensor_anomaly_statistics_t* stats)
+{
+    if (stats != NULL) {
+        memcpy(stats, &statistics, sizeof(sensor_anomaly_statistics_t));
+    }
+}
+
+/* 内部函数实现 */
+
+/**
+ * @brief 评估单个指标，返回异常原因并更新EWMA
+ */
+static anomaly_reason_t evaluate_metric(ewma_metric_t* m, sensor_metric_t metric,
+                                        float value, uint32_t now, float max_rate)
+{
+    anomaly_reason_t reason = ANOMALY_REASON_NONE;
+
+    if (m->samples < current_config.warmup_samples) {
+        /* 预热阶段：基线未建立，使用固定阈值 */
+        if (is_out_of_range(metric, value)) {
+            reason = ANOMALY_REASON_RANGE;
+        }
+    } else {
+        uint32_t dt = now - m->last_time;
+
+        /* 串口数据成批解析时到达间隔偏短，按下限计算，避免正常变化被判为突变 */
+        if (dt < SENSOR_ANOMALY_MIN_RATE_INTERVAL) {
+            dt = SENSOR_ANOMALY_MIN_RATE_INTERVAL;
+        }
+
+        if (max_rate > 0.0f &&
+            abs_float(value - m->last_value) > max_rate * ((float)dt / 1000.0f)) {
+            reason = ANOMALY_REASON_RATE;
+        } else if (is_zscore_outlier(m, metric, value)) {
+            reason = ANOMALY_REASON_ZSCORE;
+        }
+    }
+
+    ewma_update(m, value);
+    m->last_value = value;
+    m->last_time = now;
+
+    return reason;
+}
+
+/**
+ * @brief 是否超出预热阶段的固定阈值
+ */
+static bool is_out_of_range(sensor_metric_t metric, float value)
+{
+    if (metric == SENSOR_METRIC_TEMPERATURE) {
+        return value < ANOMALY_WARMUP_TEMP_LOW || value > ANOMALY_WARMUP_TEMP_HIGH;
+    }
+    if (metric == SENSOR_METRIC_HUMIDITY) {
+        return value < ANOMALY_WARMUP_HUMID_LOW || value > ANOMALY_WARMUP_HUMID_HIGH;
+    }
+    return false;
+}
+
+/**
+ * @brief EWMA均值和方差增量更新
+ */
+static void ewma_update(ewma_metric_t* m, float value)
+{
+    float diff;
+    float increment;
+
+    if (m->samples == 0) {
+        m->mean = value;
+        m->variance = 0.0f;
+        m->samples = 1;
+        return;
+    }
+
+    diff = value - m->mean;
+    increment = current_config.alpha * diff;
+    m->mean += increment;
+    m->variance = (1.0f - current_config.alpha) * (m->variance + diff * increment);
+
+    if (m->samples < 0xFFFF) {
+        m->samples++;
+    }
+}
+
+/**
+ * @brief z分数检查（比较平方，避免开方）
+ */
+static bool is_zscore_outlier(const ewma_metric_t* m, sensor_metric_t metric, float value)
+{
+    float diff = value - m->mean;
+    float variance = MAX(m->variance, MIN_VARIANCE[metric]);
+    float z = current_config.z_threshold;
+
+    return diff * diff > z * z * variance;
+}
+
+/**
+ * @brief 触发异常告警
+ */
+static void raise_alert(const char* student_id, const char* sensor_name, sensor_metric_t metric,
+                        anomaly_reason_t reason, float value, float mean, uint32_t timestamp)
+{
+    sensor_anomaly_alert_t alert;
+
+    if (alert_callback == NULL) {
+        return;
+    }
+
+    alert.student_id = student_id;
+    alert.sensor_name = sensor_name;
+    alert.metric = metric;
+    alert.reason = reason;
+    alert.value = value;
+    alert.mean = mean;
+    alert.timestamp = timestamp;
+
+    alert_callback(&alert);
+}
+
+/**
+ * @brief 浮点绝对值
+ */
+static float abs_float(float value)
+{
+    return (value < 0.0f) ? -value : value;
+}
+
+#else
+
+/* 未启用时本文件为空，避免空翻译单元告警 */
+typedef int sensor_anomaly_unused_t;
+
+#endif /* ENABLE_SENSOR_ANOMALY */
@@ -0,0 +1,181 @@
+/**
+ * @file sensor_coalesce.c
+ * @brief 中断事件合并模块实现 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ */
+
+#include "sensor_coalesce.h"
+
+#if ENABLE_SENSOR_COALESCE
+#include "sensor_table.h"
+
+/* 每键合并状态 */
+typedef struct {
+    bool active;                            /* 窗口是否打开 */
+    uint32_t opened;                        /* 窗口打开时间（毫秒） */
+    sensor2_data_t pending;                 /* 累计中的记录 */
+} coalesce_state_t;
+
+/* 静态变量 */
+static sensor_table_entry_t table_entries[SENSOR_COALESCE_MAX_KEYS];
+static sensor_table_t key_table;
+static coalesce_state_t key_states[SENSOR_COALESCE_MAX_KEYS];
+static uint32_t window_length = SENSOR_COALESCE_DEFAULT_WINDOW;
+static sensor_coalesce_statistics_t statistics;
+static void (*output_callback)(const sensor2_data_t* data) = NULL;
+
+/* 内部函数声明 */
+static void emit_window(coalesce_state_t* state);
+
+/**
+ * @brief 初始化中断事件合并模块
+ */
+system_status_t sensor_coalesce_init(uint32_t length)
+{
+    system_status_t status;
+
+    if (length == 0) {
+        return SYSTEM_ERROR;
+    }
+
+    status = sensor_table_init(&key_table, table_entries, SENSOR_COALESCE_MAX_KEYS);
+    if (status != SYSTEM_OK) {
+        return status;
+    }
+
+    memset(key_states, 0, sizeof(key_states));
+    memset(&statistics, 0, sizeof(statistics));
+    window_length = length;
+
+    DEBUG_PRINT("Interrupt coalescing initialized: window=%lu", window_length);
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 设置合并窗口输出回调函数
+ */
+void sensor_coalesce_set_output_callback(void (*callback)(const sensor2_data_t* data))
+{
+    output_callback = callback;
+}
+
+/**
+ * @brief 将一个中断事件加入合并窗口
+ */
+bool sensor_coalesce_add(const sensor2_data_t* data)
+{
+    coalesce_state_t* state;
+    uint32_t now;
+    int32_t index;
+
+    if (data == NULL) {
+        return false;
+    }
+
+    /* 窗口按到达时间计时：data->timestamp是解析计数，不随真实时间增长 */
+    now = get_tick_ms();
+    index = sensor_table_acquire(&key_table, data->student_id, data->sensor_name,
+                                 (uint8_t)data->interrupt_type, now);
+    if (index < 0) {
+        statistics.bypass_count++;
+        return false;
+    }
+
+    statistics.events_in++;
+    state = &key_states[index];
+
+    /* 事件落在当前窗口之外：先关闭旧窗口 */
+    if (state->active && now - state->opened >= window_length) {
+        emit_window(state);
+    }
+
+    if (!state->active) {
+        memcpy(&state->pending, data, sizeof(sensor2_data_t));
+        state->pending.first_timestamp = data->timestamp;
+        state->opened = now;
+        state->active = true;
+        statistics.pending_windows++;
+        return true;
+    }
+
+    state->pending.interrupt_count += data->interrupt_count;
+    state->pending.timestamp = data->timestamp;
+    if (data->status > state->pending.status) {
+        state->pending.status = data->status;
+    }
+
+    return true;
+}
+
+/**
+ * @brief 输出所有已到期的窗口
+ */
+uint32_t sensor_coalesce_flush(uint32_t now)
+{
+    uint32_t emitted = 0;
+    uint32_t i;
+
+    for (i = 0; i < SENSOR_COALESCE_MAX_KEYS; i++) {
+        coalesce_state_t* state = &key_states[i];
+
+        if (state->active && now - state->opened >= window_length) {
+            emit_window(state);
+            emitted++;
+        }
+    }
+
+    return emitted;
+}
+
+/**
+ * @brief 输出所有未关闭的窗口
+ */
+uint32_t sensor_coalesce_flush_all(void)
+{
+    uint32_t emitted = 0;
+    uint32_t i;
+
+    for (i = 0; i < SENSOR_COALESCE_MAX_KEYS; i++) {
+        if (key_states[i].active) {
+            emit_window(&key_states[i]);
+            emitted++;
+        }
+    }
+
+    return emitted;
+}
+
+/**
+ * @brief 获取合并统计信息
+ */
+void sensor_coalesce_get_statistics(sensor_coalesce_statistics_t* stats)
+{
+    if (stats != NULL) {
+        memcpy(stats, &statistics, sizeof(sensor_coalesce_statistics_t));
+    }
+}
+
+/* 内部函数实现 */
+
+/**
+ * @brief 关闭窗口并输出合并记录
+ */
+static void emit_window(coalesce_state_t* state)
+{
+    state->active = false;
+    statistics.pending_windows--;
+    statistics.rows_out++;
+
+    if (output_callback != NULL) {
+        output_callback(&state->pending);
+    }
+}
+
+#else
+
+/* 未启用时本文件为空，避免空翻译单元告警 */
+typedef int sensor_coalesce_unused_t;
+
+#endif /* ENABLE_SENSOR_COALESCE */
@@ -6,13 +6,25 @@
  * @version 1.0.0
  */
 
+/* 宿主机构建使用clock_gettime()计时，需在包含系统头文件前声明POSIX */
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+
 #include "sensor_data.h"
+#include "sensor_aggregate.h"
+#include "sensor_anomaly.h"
+#include "sensor_dispatch.h"
+#include "crc.h"
+#include "strbuf.h"
+#include "sensor_stats.h"
+#include <time.h>
 
 /* 静态变量 */
-static uint32_t total_data_count = 0;
-static uint32_t valid_data_count = 0;
-static uint32_t error_data_count = 0;
 static void (*data_callback)(const sensor_data_t* data) = NULL;
+#if ENABLE_SENSOR_DISPATCH
+static int8_t callback_subscriber_id = -1;
+#endif
 
 /* 常量字符串数组 */
 const char* const SENSOR_STATUS_STRINGS[] = {
@@ -34,8 +46,12 @@ static bool is_numeric_string(const char* str);
 static float parse_float_safe(const char* str);
 static int parse_int_safe(const char* str);
 static void trim_whitespace(char* str);
+static char* next_token(char** cursor, char delimiter);
 static sensor_status_t determine_sensor1_status(const sensor1_data_t* data);
 static sensor_status_t determine_sensor2_status(const sensor2_data_t* data);
+#if ENABLE_SENSOR_DISPATCH
+static void callback_subscriber_handler(const sensor_data_t* items, uint16_t count, void* context);
+#endif
 
 /**
  * @brief 初始化传感器数据处理模块
@@ -43,11 +59,31 @@ static sensor_status_t determine_sensor2_status(const sensor2_data_t* data);
 system_status_t sensor_data_init(void)
 {
     /* 重置统计信息 */
-    total_data_count = 0;
-    valid_data_count = 0;
-    error_data_count = 0;
+    sensor_stats_init();
     data_callback = NULL;
     
+#if ENABLE_SENSOR_AGGREGATE
+    /* 初始化滚动统计 */
+    if (sensor_aggregate_init() != SYSTEM_OK) {
+        return SYSTEM_ERROR;
+    }
+#endif
+    
+#if ENABLE_SENSOR_ANOMALY
+    /* 初始化异常检测 */
+    if (sensor_anomaly_init() != SYSTEM_OK) {
+        return SYSTEM_ERROR;
+    }
+#endif
+    
+#if ENABLE_SENSOR_DISPATCH
+    /* 初始化多订阅者分发 */
+    if (sensor_dispatch_init() != SYSTEM_OK) {
+        return SYSTEM_ERROR;
+    }
+    callback_subscriber_id = -1;
+#endif
+    
     DEBUG_PRINT("Sensor data module initialized");
     return SYSTEM_OK;
 }
@@ -60,6 +96,7 @@ parse_result_t parse_sensor1_data(const char* data_str, sensor1_data_t* sensor_d
     parse_result_t result;
     char temp_str[32], humid_str[32];
     char input_copy[128];
+    char* cursor;
     char* token;
     int field_count = 0;
     
@@ -86,7 +123,8 @@ parse_result_t parse_sensor1_data(const char* data_str, sensor1_data_t* sensor_d
     strcpy(sensor_data->sensor_name, "TEMP_HUMIDITY");
     
     /* 解析数据字段 */
-    token = strtok(input_copy, ",");
+    cursor = input_copy;
+    token = next_token(&cursor, ',');
     while (token != NULL && field_count < 3) {
         trim_whitespace(token);
         
@@ -117,7 +155,7 @@ parse_result_t parse_sensor1_data(const char* data_str, sensor1_data_t* sensor_d
         }
         
         field_count++;
-        token = strtok(NULL, ",");
+        token = next_token(&cursor, ',');
     }
     
     /* 检查字段数量 */
@@ -147,6 +185,7 @@ parse_result_t parse_sensor2_data(const char* data_str, sensor2_data_t* sensor_d
 {
     parse_result_t result;
     char input_copy[128];
+    char* cursor;
     char* token;
     int field_count = 0;
     
@@ -172,7 +211,8 @@ parse_result_t parse_sensor2_data(const char* data_str, sensor2_data_t* sensor_d
     memset(sensor_data, 0, sizeof(sensor2_data_t));
     
     /* 解析数据字段 */
-    token = strtok(input_copy, ",");
+    cursor = input_copy;
+    token = next_token(&cursor, ',');
     while (token != NULL && field_count < 3) {
         trim_whitespace(token);
         
@@ -211,7 +251,7 @@ parse_result_t parse_sensor2_data(const char* data_str, sensor2_data_t* sensor_d
         }
         
         field_count++;
-        token = strtok(NULL, ",");
+        token = next_token(&cursor, ',');
     }
     
     /* 检查字段数量 */
@@ -228,6 +268,7 @@ parse_result_t parse_sensor2_data(const char* data_str, sensor2_data_t* sensor_d
     
     /* 设置时间戳和状态 */
     sensor_data->timestamp = get_timestamp();
+    sensor_data->first_timestamp = sensor_data->timestamp;
     sensor_data->status = determine_sensor2_status(sensor_data);
     
     result.is_valid = true;
@@ -238,6 +279,15 @@ parse_result_t parse_sensor2_data(const char* data_str, sensor2_data_t* sensor_d
  * @brief 自动识别并解析传感器数据
  */
 parse_result_t parse_sensor_data(const char* data_str, sensor_data_t* sensor_data)
+{
+    return parse_sensor_data_on_shard(data_str, sensor_data, SENSOR_STATS_DEFAULT_SHARD);
+}
+
+/**
+ * @brief 自动识别并解析传感器数据（指定统计分片）
+ */
+parse_result_t parse_sensor_data_on_shard(const char* data_str, sensor_data_t* sensor_data,
+                                          uint8_t stats_shard)
 {
     parse_result_t result;
     char input_copy[128];
@@ -258,16 +308,15 @@ parse_result_t parse_sensor_data(const char* data_str, sensor_data_t* sensor_dat
         }
     }
     
-    /* 更新统计 */
-    total_data_count++;
-    
-    if (comma_count == 2) {
+    /* 超出input_copy的输入按格式错误处理，不复制 */
+    if (comma_count == 2 && (size_t)i < sizeof(input_copy)) {
         /* 检查第二个字段是否为数字（温度） */
         strcpy(input_copy, data_str);
         {
-            char* token = strtok(input_copy, ",");
+            char* cursor = input_copy;
+            char* token = next_token(&cursor, ',');
             if (token != NULL) {
-                token = strtok(NULL, ",");
+                token = next_token(&cursor, ',');
                 if (token != NULL && is_numeric_string(token)) {
                     /* 传感器1数据 */
                     sensor_data->type = SENSOR_TYPE_TEMP_HUMIDITY;
@@ -287,16 +336,24 @@ parse_result_t parse_sensor_data(const char* data_str, sensor_data_t* sensor_dat
         strcpy(result.error_msg, ERROR_MSG_INVALID_FORMAT);
     }
     
-    /* 更新统计 */
+    /* 更新统计（total与valid/error在同一次写入中更新） */
+    sensor_stats_record(stats_shard, result.is_valid);
+    
     if (result.is_valid) {
-        valid_data_count++;
+#if ENABLE_SENSOR_AGGREGATE
+        /* 更新滚动统计 */
+        sensor_aggregate_update(sensor_data);
+#endif
         
+#if ENABLE_SENSOR_DISPATCH
+        /* 只入队，由主循环或工作线程投递给订阅者 */
+        sensor_dispatch_publish(sensor_data);
+#else
         /* 调用回调函数 */
         if (data_callback != NULL) {
             data_callback(sensor_data);
         }
-    } else {
-        error_data_count++;
+#endif
     }
     
     return result;
@@ -391,18 +448,25 @@ system_status_t format_sensor1_data(const sensor1_data_t* sensor_data,
         return SYSTEM_ERROR;
     }
     
-    /* IAR 5.3兼容的sprintf使用 */
+    /* 顺序追加，不经过printf格式解析 */
     {
-        int ret = sprintf(buffer, 
-            "ID:%s,Sensor:%s,Temp:%.2f,Humid:%.2f,Status:%s,Time:%lu",
-            sensor_data->student_id,
-            sensor_data->sensor_name,
-            sensor_data->temperature,
-            sensor_data->humidity,
-            get_sensor_status_string(sensor_data->status),
-            sensor_data->timestamp);
+        strbuf_t sb;
         
-        if (ret < 0 || (size_t)ret >= buffer_size) {
+        strbuf_init(&sb, buffer, buffer_size);
+        strbuf_append_str(&sb, "ID:");
+        strbuf_append_str(&sb, sensor_data->student_id);
+        strbuf_append_str(&sb, ",Sensor:");
+        strbuf_append_str(&sb, sensor_data->sensor_name);
+        strbuf_append_str(&sb, ",Temp:");
+        strbuf_append_fixed(&sb, sensor_data->temperature, 2);
+        strbuf_append_str(&sb, ",Humid:");
+        strbuf_append_fixed(&sb, sensor_data->humidity, 2);
+        strbuf_append_str(&sb, ",Status:");
+        strbuf_append_str(&sb, get_sensor_status_string(sensor_data->status));
+        strbuf_append_str(&sb, ",Time:");
+        strbuf_append_uint(&sb, sensor_data->timestamp);
+        
+        if (!strbuf_ok(&sb)) {
             return SYSTEM_ERROR;
         }
     }
@@ -420,18 +484,25 @@ system_status_t format_sensor2_data(const sensor2_data_t* sensor_data,
         return SYSTEM_ERROR;
     }
     
-    /* IAR 5.3兼容的sprintf使用 */
+    /* 顺序追加，不经过printf格式解析 */
     {
-        int ret = sprintf(buffer,
-            "ID:%s,Sensor:%s,IntType:%s,Count:%lu,Status:%s,Time:%lu",
-            sensor_data->student_id,
-            sensor_data->sensor_name,
-            get_interrupt_type_string(sensor_data->interrupt_type),
-            sensor_data->interrupt_count,
-            get_sensor_status_string(sensor_data->status),
-            sensor_data->timestamp);
+        strbuf_t sb;
+        
+        strbuf_init(&sb, buffer, buffer_size);
+        strbuf_append_str(&sb, "ID:");
+        strbuf_append_str(&sb, sensor_data->student_id);
+        strbuf_append_str(&sb, ",Sensor:");
+        strbuf_append_str(&sb, sensor_data->sensor_name);
+        strbuf_append_str(&sb, ",IntType:");
+        strbuf_append_str(&sb, get_interrupt_type_string(sensor_data->interrupt_type));
+        strbuf_append_str(&sb, ",Count:");
+        strbuf_append_uint(&sb, sensor_data->interrupt_count);
+        strbuf_append_str(&sb, ",Status:");
+        strbuf_append_str(&sb, get_sensor_status_string(sensor_data->status));
+        strbuf_append_str(&sb, ",Time:");
+        strbuf_append_uint(&sb, sensor_data->timestamp);
         
-        if (ret < 0 || (size_t)ret >= buffer_size) {
+        if (!strbuf_ok(&sb)) {
             return SYSTEM_ERROR;
         }
     }
@@ -444,18 +515,12 @@ system_status_t format_sensor2_data(const sensor2_data_t* sensor_data,
  */
 uint16_t calculate_checksum(const uint8_t* data, size_t length)
 {
-    uint16_t checksum = 0;
-    size_t i;
-    
     if (data == NULL) {
         return 0;
     }
     
-    for (i = 0; i < length; i++) {
-        checksum += data[i];
-    }
-    
-    return checksum;
+    /* CRC16-CCITT：累加和无法发现字节交换，CRC可以 */
+    return crc16_ccitt(data, length);
 }
 
 /**
@@ -468,14 +533,36 @@ uint32_t get_timestamp(void)
     return ++tick_count;
 }
 
+/**
+ * @brief 获取毫秒计时
+ */
+uint32_t get_tick_ms(void)
+{
+#if defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0) {
+        return 0;
+    }
+    return (uint32_t)ts.tv_sec * 1000U + (uint32_t)(ts.tv_nsec / 1000000L);
+#elif !defined(TEST_BUILD) && !defined(IAR_LEGACY_SUPPORT)
+    return HAL_GetTick();
+#else
+    clock_t ticks = clock();
+
+    if (ticks == (clock_t)-1) {
+        return 0;
+    }
+    return (uint32_t)((float)ticks * 1000.0f / (float)CLOCKS_PER_SEC);
+#endif
+}
+
 /**
  * @brief 重置传感器数据统计
  */
 void reset_sensor_statistics(void)
 {
-    total_data_count = 0;
-    valid_data_count = 0;
-    error_data_count = 0;
+    sensor_stats_reset();
 }
 
 /**
@@ -483,14 +570,19 @@ void reset_sensor_statistics(void)
  */
 void get_sensor_statistics(uint32_t* total_count, uint32_t* valid_count, uint32_t* error_count)
 {
+    sensor_stats_snapshot_t snapshot;
+    
+    /* 汇总所有分片，三个计数来自同一次一致读取 */
+    sensor_stats_snapshot(&snapshot);
+    
     if (total_count != NULL) {
-        *total_count = total_data_count;
+        *total_count = snapshot.total_count;
     }
     if (valid_count != NULL) {
-        *valid_count = valid_data_count;
+        *valid_count = snapshot.valid_count;
     }
     if (error_count != NULL) {
-        *error_count = error_data_count;
+        *error_count = snapshot.error_count;
     }
 }
 
@@ -500,10 +592,51 @@ void get_sensor_statistics(uint32_t* total_count, uint32_t* valid_count, uint32_
 void set_sensor_data_callback(void (*callback)(const sensor_data_t* data))
 {
     data_callback = callback;
+    
+#if ENABLE_SENSOR_DISPATCH
+    /* 兼容接口：旧回调作为一个主循环订阅者注册 */
+    if (callback_subscriber_id >= 0) {
+        sensor_dispatch_unsubscribe(callback_subscriber_id);
+        callback_subscriber_id = -1;
+    }
+    
+    if (callback != NULL) {
+        dispatch_subscriber_config_t config;
+        
+        memset(&config, 0, sizeof(config));
+        config.name = "legacy_callback";
+        config.handler = callback_subscriber_handler;
+        config.queue_depth = SENSOR_DISPATCH_MAX_QUEUE_DEPTH;
+        config.batch_size = SENSOR_DISPATCH_DEFAULT_BATCH;
+        config.drop_policy = DISPATCH_DROP_OLDEST;
+        config.delivery = DISPATCH_DELIVER_MAIN_LOOP;
+        callback_subscriber_id = sensor_dispatch_subscribe(&config);
+    }
+#endif
 }
 
 /* 内部函数实现 */
 
+#if ENABLE_SENSOR_DISPATCH
+/**
+ * @brief 旧回调接口的批量适配
+ */
+static void callback_subscriber_handler(const sensor_data_t* items, uint16_t count, void* context)
+{
+    uint16_t i;
+    
+    (void)context;
+    
+    if (data_callback == NULL) {
+        return;
+    }
+    
+    for (i = 0; i < count; i++) {
+        data_callback(&items[i]);
+    }
+}
+#endif
+
 /**
  * @brief 检查字符串是否为数字
  */
@@ -598,6 +731,42 @@ static void trim_whitespace(char* str)
     str[len] = '\0';
 }
 
+/**
+ * @brief 可重入分词（跳过连续分隔符，行为与strtok一致）
+ */
+static char* next_token(char** cursor, char delimiter)
+{
+    char* start = *cursor;
+    char* end;
+    
+    if (start == NULL) {
+        return NULL;
+    }
+    
+    while (*start == delimiter) {
+        start++;
+    }
+    
+    if (*start == '\0') {
+        *cursor = NULL;
+        return NULL;
+    }
+    
+    end = start;
+    while (*end != '\0' && *end != delimiter) {
+        end++;
+    }
+    
+    if (*end != '\0') {
+        *end = '\0';
+        *cursor = end + 1;
+    } else {
+        *cursor = end;
+    }
+    
+    return start;
+}
+
 /**
  * @brief 确定传感器1状态
  */
@@ -607,6 +776,10 @@ static sensor_status_t determine_sensor1_status(const sensor1_data_t* data)
         return SENSOR_STATUS_ERROR;
     }
     
+#if ENABLE_SENSOR_ANOMALY
+    /* 流式异常检测：EWMA z分数 + 变化率 */
+    return sensor_anomaly_evaluate_sensor1(data);
+#else
     /* 检查温度警告范围 */
     if (data->temperature < -20.0f || data->temperature > 60.0f) {
         return SENSOR_STATUS_WARNING;
@@ -618,6 +791,7 @@ static sensor_status_t determine_sensor1_status(const sensor1_data_t* data)
     }
     
     return SENSOR_STATUS_NORMAL;
+#endif
 }
 
 /**
@@ -629,10 +803,15 @@ static sensor_status_t determine_sensor2_status(const sensor2_data_t* data)
         return SENSOR_STATUS_ERROR;
     }
     
+#if ENABLE_SENSOR_ANOMALY
+    /* 流式异常检测：仅事件频率异常时告警 */
+    return sensor_anomaly_evaluate_sensor2(data);
+#else
     /* 根据中断类型确定状态 */
     if (data->interrupt_type == INTERRUPT_TYPE_NONE) {
         return SENSOR_STATUS_NORMAL;
     } else {
         return SENSOR_STATUS_WARNING; /* 有中断发生 */
     }
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,306 @@
+/**
+ * @file sensor_dispatch.c
+ * @brief 传感器数据多订阅者分发模块实现 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ */
+
+#include "sensor_dispatch.h"
+
+#if ENABLE_SENSOR_DISPATCH
+
+/* 订阅者状态 */
+typedef struct {
+    bool in_use;                            /* 槽位是否占用 */
+    dispatch_subscriber_config_t config;    /* 订阅者配置 */
+    uint16_t head;                          /* 队首下标 */
+    uint16_t length;                        /* 队列长度 */
+    uint16_t inflight;                      /* 正在投递的条数（队首起） */
+    uint8_t generation;                     /* 每次退订加一，投递期间槽位被退订或重用时可以识别 */
+    dispatch_statistics_t statistics;       /* 统计信息 */
+} subscriber_t;
+
+/* 静态变量 */
+static subscriber_t subscribers[SENSOR_DISPATCH_MAX_SUBSCRIBERS];
+static sensor_data_t queue_pool[SENSOR_DISPATCH_MAX_SUBSCRIBERS][SENSOR_DISPATCH_MAX_QUEUE_DEPTH];
+
+/* 内部函数声明 */
+static bool filter_matches(const dispatch_filter_t* filter, const sensor_data_t* data);
+static const char* get_data_student_id(const sensor_data_t* data);
+static sensor_status_t get_data_status(const sensor_data_t* data);
+static uint16_t deliver_batch(int8_t subscriber_id);
+
+/**
+ * @brief 初始化分发模块
+ */
+system_status_t sensor_dispatch_init(void)
+{
+    ENTER_CRITICAL();
+    memset(subscribers, 0, sizeof(subscribers));
+    EXIT_CRITICAL();
+
+    DEBUG_PRINT("Sensor dispatch initialized: %d subscribers x %d entries",
+                SENSOR_DISPATCH_MAX_SUBSCRIBERS, SENSOR_DISPATCH_MAX_QUEUE_DEPTH);
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 添加订阅者
+ */
+int8_t sensor_dispatch_subscribe(const dispatch_subscriber_config_t* config)
+{
+    uint8_t generation;
+    int8_t i;
+
+    if (config == NULL || config->handler == NULL ||
+        config->queue_depth == 0 || config->queue_depth > SENSOR_DISPATCH_MAX_QUEUE_DEPTH ||
+        config->batch_size == 0) {
+        return -1;
+    }
+
+    ENTER_CRITICAL();
+    for (i = 0; i < SENSOR_DISPATCH_MAX_SUBSCRIBERS; i++) {
+        if (!subscribers[i].in_use) {
+            generation = subscribers[i].generation;
+            memset(&subscribers[i], 0, sizeof(subscriber_t));
+            memcpy(&subscribers[i].config, config, sizeof(dispatch_subscriber_config_t));
+            subscribers[i].generation = generation;
+            subscribers[i].in_use = true;
+            break;
+        }
+    }
+    EXIT_CRITICAL();
+
+    if (i == SENSOR_DISPATCH_MAX_SUBSCRIBERS) {
+        ERROR_PRINT("No free dispatch subscriber slot");
+        return -1;
+    }
+
+    DEBUG_PRINT("Dispatch subscriber %d added: %s, depth=%d, batch=%d", i,
+                config->name ? config->name : "unnamed", config->queue_depth, config->batch_size);
+    return i;
+}
+
+/**
+ * @brief 移除订阅者
+ */
+system_status_t sensor_dispatch_unsubscribe(int8_t subscriber_id)
+{
+    if (subscriber_id < 0 || subscriber_id >= SENSOR_DISPATCH_MAX_SUBSCRIBERS) {
+        return SYSTEM_ERROR;
+    }
+
+    /* 投递中的批次在处理函数返回后发现代次变化，不再改动队列 */
+    ENTER_CRITICAL();
+    subscribers[subscriber_id].in_use = false;
+    subscribers[subscriber_id].head = 0;
+    subscribers[subscriber_id].length = 0;
+    subscribers[subscriber_id].inflight = 0;
+    subscribers[subscriber_id].generation++;
+    EXIT_CRITICAL();
+
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 发布一条数据到所有匹配的订阅者队列
+ */
+uint8_t sensor_dispatch_publish(const sensor_data_t* data)
+{
+    uint8_t delivered = 0;
+    int8_t i;
+
+    if (data == NULL) {
+        return 0;
+    }
+
+    for (i = 0; i < SENSOR_DISPATCH_MAX_SUBSCRIBERS; i++) {
+        subscriber_t* sub = &subscribers[i];
+
+        if (!sub->in_use || !filter_matches(&sub->config.filter, data)) {
+            continue;
+        }
+
+        ENTER_CRITICAL();
+        if (sub->length >= sub->config.queue_depth) {
+            /* 正在投递的数据不能被覆盖，此时退化为丢弃新数据 */
+            if (sub->config.drop_policy == DISPATCH_DROP_OLDEST && sub->inflight == 0) {
+                sub->head = (uint16_t)((sub->head + 1) % sub->config.queue_depth);
+                sub->length--;
+                sub->statistics.dropped_count++;
+            } else {
+                sub->statistics.dropped_count++;
+                EXIT_CRITICAL();
+                continue;
+            }
+        }
+
+        memcpy(&queue_pool[i][(sub->head + sub->length) % sub->config.queue_depth],
+               data, sizeof(sensor_data_t));
+        sub->length++;
+        sub->statistics.enqueued_count++;
+        if (sub->length > sub->statistics.max_queue_length) {
+            sub->statistics.max_queue_length = sub->length;
+        }
+        EXIT_CRITICAL();
+
+        delivered++;
+    }
+
+    return delivered;
+}
+
+/**
+ * @brief 主循环投递
+ */
+uint32_t sensor_dispatch_poll(void)
+{
+    uint32_t total = 0;
+    int8_t i;
+
+    for (i = 0; i < SENSOR_DISPATCH_MAX_SUBSCRIBERS; i++) {
+        if (subscribers[i].in_use &&
+            subscribers[i].config.delivery == DISPATCH_DELIVER_MAIN_LOOP) {
+            total += deliver_batch(i);
+        }
+    }
+
+    return total;
+}
+
+/**
+ * @brief 工作线程投递
+ */
+uint32_t sensor_dispatch_drain(int8_t subscriber_id, uint16_t max_batches)
+{
+    uint32_t total = 0;
+    uint16_t batch;
+    uint16_t n;
+
+    if (subscriber_id < 0 || subscriber_id >= SENSOR_DISPATCH_MAX_SUBSCRIBERS) {
+        return 0;
+    }
+
+    for (batch = 0; batch < max_batches; batch++) {
+        n = deliver_batch(subscriber_id);
+        if (n == 0) {
+            break;
+        }
+        total += n;
+    }
+
+    return total;
+}
+
+/**
+ * @brief 获取订阅者统计信息
+ */
+system_status_t sensor_dispatch_get_statistics(int8_t subscriber_id, dispatch_statistics_t* stats)
+{
+    if (subscriber_id < 0 || subscriber_id >= SENSOR_DISPATCH_MAX_SUBSCRIBERS || stats == NULL) {
+        return SYSTEM_ERROR;
+    }
+
+    ENTER_CRITICAL();
+    memcpy(stats, &subscribers[subscriber_id].statistics, sizeof(dispatch_statistics_t));
+    stats->queue_length = subscribers[subscriber_id].length;
+    EXIT_CRITICAL();
+
+    return SYSTEM_OK;
+}
+
+/* 内部函数实现 */
+
+/**
+ * @brief 投递一批数据（在队列内原地投递，不复制）
+ */
+static uint16_t deliver_batch(int8_t subscriber_id)
+{
+    subscriber_t* sub = &subscribers[subscriber_id];
+    uint16_t count;
+    uint16_t head;
+    uint8_t generation;
+
+    ENTER_CRITICAL();
+    if (!sub->in_use || sub->length == 0 || sub->inflight != 0) {
+        EXIT_CRITICAL();
+        return 0;
+    }
+
+    /* 只投递到环形队列末尾的连续段，回绕部分留给下一批 */
+    head = sub->head;
+    count = MIN(sub->length, sub->config.batch_size);
+    count = MIN(count, (uint16_t)(sub->config.queue_depth - head));
+    sub->inflight = count;
+    generation = sub->generation;
+    EXIT_CRITICAL();
+
+    sub->config.handler(&queue_pool[subscriber_id][head], count, sub->config.context);
+
+    ENTER_CRITICAL();
+    /* 处理函数或其他线程已退订（槽位可能已被新订阅者使用）：队列已重置，不再出队 */
+    if (!sub->in_use || sub->generation != generation || sub->length < count) {
+        EXIT_CRITICAL();
+        return count;
+    }
+    sub->head = (uint16_t)((head + count) % sub->config.queue_depth);
+    sub->length -= count;
+    sub->inflight = 0;
+    sub->statistics.delivered_count += count;
+    sub->statistics.batch_count++;
+    EXIT_CRITICAL();
+
+    return count;
+}
+
+/**
+ * @brief 检查数据是否满足过滤条件
+ */
+static bool filter_matches(const dispatch_filter_t* filter, const sensor_data_t* data)
+{
+    if (filter->type_mask != 0 && (filter->type_mask & DISPATCH_TYPE_BIT(data->type)) == 0) {
+        return false;
+    }
+
+    if (filter->status_mask != 0 &&
+        (filter->status_mask & DISPATCH_STATUS_BIT(get_data_status(data))) == 0) {
+        return false;
+    }
+
+    if (filter->student_id[0] != '\0' &&
+        strcmp(filter->student_id, get_data_student_id(data)) != 0) {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief 获取数据中的学号
+ */
+static const char* get_data_student_id(const sensor_data_t* data)
+{
+    if (data->type == SENSOR_TYPE_INTERRUPT) {
+        return data->data.sensor2.student_id;
+    }
+    return data->data.sensor1.student_id;
+}
+
+/**
+ * @brief 获取数据中的状态
+ */
+static sensor_status_t get_data_status(const sensor_data_t* data)
+{
+    if (data->type == SENSOR_TYPE_INTERRUPT) {
+        return data->data.sensor2.status;
+    }
+    return data->data.sensor1.status;
+}
+
+#else
+
+/* 未启用时本文件为空，避免空翻译单元告警 */
+typedef int sensor_dispatch_unused_t;
+
+#endif /* ENABLE_SENSOR_DISPATCH */
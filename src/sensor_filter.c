@@ -0,0 +1,210 @@
+/**
+ * @file sensor_filter.c
+ * @brief 传感器死区过滤模块实现 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ */
+
+#include "sensor_filter.h"
+
+#if ENABLE_SENSOR_FILTER
+#include "sensor_table.h"
+
+/* 每传感器过滤状态 */
+typedef struct {
+    bool has_stored;                        /* 是否已有存储基准 */
+    bool has_override;                      /* 是否使用单独配置 */
+    sensor_status_t last_status;            /* 上次存储的状态 */
+    float last_temperature;                 /* 上次存储的温度 */
+    float last_humidity;                    /* 上次存储的湿度 */
+    uint32_t last_stored_time;              /* 上次存储的到达时间（毫秒） */
+    sensor_filter_config_t config;          /* 单独配置 */
+} filter_state_t;
+
+/* 静态变量 */
+static sensor_table_entry_t table_entries[SENSOR_FILTER_MAX_SENSORS];
+static sensor_table_t sensor_table;
+static filter_state_t sensor_states[SENSOR_FILTER_MAX_SENSORS];
+static sensor_filter_config_t default_config;
+static sensor_filter_statistics_t statistics;
+
+/* 默认过滤配置 */
+const sensor_filter_config_t DEFAULT_SENSOR_FILTER_CONFIG = {
+    SENSOR_FILTER_DEFAULT_TEMP_DEADBAND,    /* temperature_deadband */
+    SENSOR_FILTER_DEFAULT_HUMID_DEADBAND,   /* humidity_deadband */
+    SENSOR_FILTER_DEFAULT_MAX_SILENCE       /* max_silence */
+};
+
+/* 内部函数声明 */
+static bool is_valid_filter_config(const sensor_filter_config_t* config);
+static float abs_float(float value);
+
+/**
+ * @brief 初始化死区过滤模块
+ */
+system_status_t sensor_filter_init(void)
+{
+    system_status_t status;
+
+    status = sensor_table_init(&sensor_table, table_entries, SENSOR_FILTER_MAX_SENSORS);
+    if (status != SYSTEM_OK) {
+        return status;
+    }
+
+    memset(sensor_states, 0, sizeof(sensor_states));
+    memset(&statistics, 0, sizeof(statistics));
+    memcpy(&default_config, &DEFAULT_SENSOR_FILTER_CONFIG, sizeof(sensor_filter_config_t));
+
+    DEBUG_PRINT("Sensor filter initialized: deadband T=%.2f H=%.2f, silence=%lu",
+                default_config.temperature_deadband, default_config.humidity_deadband,
+                default_config.max_silence);
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 设置默认过滤配置
+ */
+system_status_t sensor_filter_set_default_config(const sensor_filter_config_t* config)
+{
+    if (!is_valid_filter_config(config)) {
+        return SYSTEM_ERROR;
+    }
+
+    memcpy(&default_config, config, sizeof(sensor_filter_config_t));
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 为单个传感器设置过滤配置
+ */
+system_status_t sensor_filter_set_sensor_config(const char* student_id, const char* sensor_name,
+                                                const sensor_filter_config_t* config)
+{
+    int32_t index;
+
+    if (!is_valid_filter_config(config)) {
+        return SYSTEM_ERROR;
+    }
+
+    index = sensor_table_acquire(&sensor_table, student_id, sensor_name,
+                                 (uint8_t)SENSOR_TYPE_TEMP_HUMIDITY, 0);
+    if (index < 0) {
+        return SYSTEM_ERROR;
+    }
+
+    memcpy(&sensor_states[index].config, config, sizeof(sensor_filter_config_t));
+    sensor_states[index].has_override = true;
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 判断样本是否需要存储
+ */
+bool sensor_filter_should_store(const sensor_data_t* data)
+{
+    const sensor1_data_t* s1;
+    const sensor_filter_config_t* config;
+    filter_state_t* state;
+    uint32_t now;
+    int32_t index;
+    bool store = false;
+
+    if (data == NULL) {
+        return false;
+    }
+
+    /* 中断事件本身就是信号，不做死区过滤 */
+    if (data->type != SENSOR_TYPE_TEMP_HUMIDITY) {
+        statistics.passed_count++;
+        return true;
+    }
+
+    s1 = &data->data.sensor1;
+    /* 静默间隔按到达时间计算：s1->timestamp是解析计数，不随真实时间增长 */
+    now = get_tick_ms();
+    index = sensor_table_acquire(&sensor_table, s1->student_id, s1->sensor_name,
+                                 (uint8_t)data->type, now);
+    if (index < 0) {
+        /* 无法跟踪时宁可多存，不丢信号 */
+        statistics.untracked_count++;
+        statistics.passed_count++;
+        return true;
+    }
+
+    state = &sensor_states[index];
+    config = state->has_override ? &state->config : &default_config;
+
+    if (!state->has_stored || s1->status != state->last_status) {
+        store = true;
+    } else if (abs_float(s1->temperature - state->last_temperature) > config->temperature_deadband ||
+               abs_float(s1->humidity - state->last_humidity) > config->humidity_deadband) {
+        store = true;
+    } else if (config->max_silence > 0 &&
+               now - state->last_stored_time >= config->max_silence) {
+        store = true;
+        statistics.heartbeat_count++;
+    }
+
+    if (!store) {
+        statistics.suppressed_count++;
+        return false;
+    }
+
+    /* 以存储值作为新基准，避免缓慢漂移被持续抑制 */
+    state->has_stored = true;
+    state->last_status = s1->status;
+    state->last_temperature = s1->temperature;
+    state->last_humidity = s1->humidity;
+    state->last_stored_time = now;
+    statistics.passed_count++;
+
+    return true;
+}
+
+/**
+ * @brief 获取过滤统计信息
+ */
+void sensor_filter_get_statistics(sensor_filter_statistics_t* stats)
+{
+    if (stats != NULL) {
+        memcpy(stats, &statistics, sizeof(sensor_filter_statistics_t));
+    }
+}
+
+/**
+ * @brief 重置过滤统计信息
+ */
+void sensor_filter_reset_statistics(void)
+{
+    memset(&statistics, 0, sizeof(sensor_filter_statistics_t));
+}
+
+/* 内部函数实现 */
+
+/**
+ * @brief 验证过滤配置
+ */
+static bool is_valid_filter_config(const sensor_filter_config_t* config)
+{
+    if (config == NULL) {
+        return false;
+    }
+
+    return config->temperature_deadband >= 0.0f && config->humidity_deadband >= 0.0f;
+}
+
+/**
+ * @brief 浮点绝对值
+ */
+static float abs_float(float value)
+{
+    return (value < 0.0f) ? -value : value;
+}
+
+#else
+
+/* 未启用时本文件为空，避免空翻译单元告警 */
+typedef int sensor_filter_unused_t;
+
+#endif /* ENABLE_SENSOR_FILTER */
@@ -0,0 +1,149 @@
+/**
+ * @file sensor_stats.c
+ * @brief 传感器解析统计分片计数模块实现 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ */
+
+#include "sensor_stats.h"
+
+/* 内存屏障：主机上为完整屏障；单核MCU上volatile访问顺序已足够 */
+#if defined(__GNUC__) || defined(__clang__)
+    #define STATS_BARRIER()         __sync_synchronize()
+    #define STATS_ALIGNED           __attribute__((aligned(SENSOR_STATS_CACHE_LINE)))
+#else
+    #define STATS_BARRIER()         do { } while (0)
+    #define STATS_ALIGNED
+#endif
+
+/* 分片计数 */
+typedef struct {
+    volatile uint32_t sequence;             /* 序号，奇数表示写入中 */
+    volatile uint32_t total_count;          /* 总数据包数 */
+    volatile uint32_t valid_count;          /* 有效数据包数 */
+    volatile uint32_t error_count;          /* 错误数据包数 */
+} stats_counters_t;
+
+/* 按缓存行填充，避免相邻分片伪共享 */
+typedef union {
+    stats_counters_t counters;
+    uint8_t padding[SENSOR_STATS_CACHE_LINE];
+} stats_shard_t;
+
+/* 静态变量 */
+static stats_shard_t shards[SENSOR_STATS_SHARD_COUNT] STATS_ALIGNED;
+static sensor_stats_snapshot_t baselines[SENSOR_STATS_SHARD_COUNT];
+
+/* 内部函数声明 */
+static void read_shard(const stats_shard_t* shard, sensor_stats_snapshot_t* snapshot);
+
+/**
+ * @brief 初始化统计模块
+ */
+system_status_t sensor_stats_init(void)
+{
+    memset((void*)shards, 0, sizeof(shards));
+    memset(baselines, 0, sizeof(baselines));
+
+    DEBUG_PRINT("Sensor stats initialized: %d shards", SENSOR_STATS_SHARD_COUNT);
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 记录一次解析结果
+ */
+void sensor_stats_record(uint8_t shard, bool valid)
+{
+    stats_counters_t* c = &shards[shard % SENSOR_STATS_SHARD_COUNT].counters;
+
+    /* 单写入者，不需要原子加；序号为奇数期间读者会重试 */
+    c->sequence++;
+    STATS_BARRIER();
+
+    c->total_count++;
+    if (valid) {
+        c->valid_count++;
+    } else {
+        c->error_count++;
+    }
+
+    STATS_BARRIER();
+    c->sequence++;
+}
+
+/**
+ * @brief 获取所有分片汇总后的一致快照
+ */
+void sensor_stats_snapshot(sensor_stats_snapshot_t* snapshot)
+{
+    sensor_stats_snapshot_t shard_snapshot;
+    uint8_t i;
+
+    if (snapshot == NULL) {
+        return;
+    }
+
+    memset(snapshot, 0, sizeof(sensor_stats_snapshot_t));
+
+    for (i = 0; i < SENSOR_STATS_SHARD_COUNT; i++) {
+        sensor_stats_shard_snapshot(i, &shard_snapshot);
+        snapshot->total_count += shard_snapshot.total_count;
+        snapshot->valid_count += shard_snapshot.valid_count;
+        snapshot->error_count += shard_snapshot.error_count;
+    }
+}
+
+/**
+ * @brief 获取单个分片的一致快照
+ */
+system_status_t sensor_stats_shard_snapshot(uint8_t shard, sensor_stats_snapshot_t* snapshot)
+{
+    if (shard >= SENSOR_STATS_SHARD_COUNT || snapshot == NULL) {
+        return SYSTEM_ERROR;
+    }
+
+    read_shard(&shards[shard], snapshot);
+    snapshot->total_count -= baselines[shard].total_count;
+    snapshot->valid_count -= baselines[shard].valid_count;
+    snapshot->error_count -= baselines[shard].error_count;
+
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 重置统计
+ */
+void sensor_stats_reset(void)
+{
+    uint8_t i;
+
+    /* 写入者独占计数，重置只移动读取侧基线，不与写入者竞争 */
+    for (i = 0; i < SENSOR_STATS_SHARD_COUNT; i++) {
+        read_shard(&shards[i], &baselines[i]);
+    }
+}
+
+/* 内部函数实现 */
+
+/**
+ * @brief 按序号锁读取分片的一致计数
+ */
+static void read_shard(const stats_shard_t* shard, sensor_stats_snapshot_t* snapshot)
+{
+    const stats_counters_t* c = &shard->counters;
+    uint32_t begin;
+    uint32_t end;
+
+    do {
+        begin = c->sequence;
+        STATS_BARRIER();
+
+        snapshot->total_count = c->total_count;
+        snapshot->valid_count = c->valid_count;
+        snapshot->error_count = c->error_count;
+
+        STATS_BARRIER();
+        end = c->sequence;
+    } while ((begin & 1u) != 0 || begin != end);
+}
@@ -0,0 +1,188 @@
+/**
+ * @file sensor_table.c
+ * @brief 传感器键值索引表实现 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ */
+
+#include "sensor_table.h"
+
+/* FNV-1a参数 */
+#define FNV_OFFSET_BASIS        2166136261UL
+#define FNV_PRIME               16777619UL
+
+/* 内部函数声明 */
+static bool entry_matches(const sensor_table_entry_t* entry, uint32_t hash,
+                          const char* student_id, const char* sensor_name, uint8_t tag);
+static int32_t probe(const sensor_table_t* table, uint32_t hash, const char* student_id,
+                     const char* sensor_name, uint8_t tag, int32_t* free_slot);
+
+/**
+ * @brief 初始化索引表
+ */
+system_status_t sensor_table_init(sensor_table_t* table, sensor_table_entry_t* entries,
+                                  uint32_t capacity)
+{
+    if (table == NULL || entries == NULL || capacity == 0) {
+        return SYSTEM_ERROR;
+    }
+
+    /* 容量必须为2的幂，以便用掩码代替取模 */
+    if ((capacity & (capacity - 1)) != 0) {
+        return SYSTEM_ERROR;
+    }
+
+    table->entries = entries;
+    table->capacity = capacity;
+    sensor_table_clear(table);
+
+    return SYSTEM_OK;
+}
+
+/**
+ * @brief 清空索引表
+ */
+void sensor_table_clear(sensor_table_t* table)
+{
+    if (table == NULL || table->entries == NULL) {
+        return;
+    }
+
+    memset(table->entries, 0, sizeof(sensor_table_entry_t) * table->capacity);
+    table->count = 0;
+}
+
+/**
+ * @brief 查找键对应的槽位
+ */
+int32_t sensor_table_find(const sensor_table_t* table, const char* student_id,
+                          const char* sensor_name, uint8_t tag)
+{
+    if (table == NULL || table->entries == NULL || student_id == NULL || sensor_name == NULL) {
+        return -1;
+    }
+
+    return probe(table, sensor_key_hash(student_id, sensor_name, tag),
+                 student_id, sensor_name, tag, NULL);
+}
+
+/**
+ * @brief 查找或新建键对应的槽位
+ */
+int32_t sensor_table_acquire(sensor_table_t* table, const char* student_id,
+                             const char* sensor_name, uint8_t tag, uint32_t now)
+{
+    uint32_t hash;
+    int32_t index;
+    int32_t free_slot = -1;
+    sensor_table_entry_t* entry;
+
+    if (table == NULL || table->entries == NULL || student_id == NULL || sensor_name == NULL) {
+        return -1;
+    }
+
+    if (strlen(student_id) >= MAX_STUDENT_ID_LEN || strlen(sensor_name) >= MAX_SENSOR_NAME_LEN) {
+        return -1;
+    }
+
+    hash = sensor_key_hash(student_id, sensor_name, tag);
+    index = probe(table, hash, student_id, sensor_name, tag, &free_slot);
+    if (index >= 0) {
+        table->entries[index].last_seen = now;
+        return index;
+    }
+
+    /* 新键：检查装载上限 */
+    if (free_slot < 0 || table->count >= SENSOR_TABLE_LOAD_LIMIT(table->capacity)) {
+        return -1;
+    }
+
+    entry = &table->entries[free_slot];
+    strcpy(entry->student_id, student_id);
+    strcpy(entry->sensor_name, sensor_name);
+    entry->tag = tag;
+    entry->hash = hash;
+    entry->last_seen = now;
+    entry->in_use = true;
+    table->count++;
+
+    return free_slot;
+}
+
+/**
+ * @brief 计算传感器键哈希（FNV-1a）
+ */
+uint32_t sensor_key_hash(const char* student_id, const char* sensor_name, uint8_t tag)
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    const char* p;
+
+    if (student_id != NULL) {
+        for (p = student_id; *p != '\0'; p++) {
+            hash ^= (uint8_t)*p;
+            hash *= FNV_PRIME;
+        }
+    }
+
+    /* 分隔符，避免("AB","C")与("A","BC")碰撞 */
+    hash ^= 0xFFu;
+    hash *= FNV_PRIME;
+
+    if (sensor_name != NULL) {
+        for (p = sensor_name; *p != '\0'; p++) {
+            hash ^= (uint8_t)*p;
+            hash *= FNV_PRIME;
+        }
+    }
+
+    hash ^= tag;
+    hash *= FNV_PRIME;
+
+    return hash;
+}
+
+/* 内部函数实现 */
+
+/**
+ * @brief 比较条目与键
+ */
+static bool entry_matches(const sensor_table_entry_t* entry, uint32_t hash,
+                          const char* student_id, const char* sensor_name, uint8_t tag)
+{
+    return entry->hash == hash &&
+           entry->tag == tag &&
+           strcmp(entry->student_id, student_id) == 0 &&
+           strcmp(entry->sensor_name, sensor_name) == 0;
+}
+
+/**
+ * @brief 线性探测查找
+ */
+static int32_t probe(const sensor_table_t* table, uint32_t hash, const char* student_id,
+                     const char* sensor_name, uint8_t tag, int32_t* free_slot)
+{
+    uint32_t mask = table->capacity - 1;
+    uint32_t index = hash & mask;
+    uint32_t i;
+
+    for (i = 0; i < table->capacity; i++) {
+        const sensor_table_entry_t* entry = &table->entries[index];
+
+        if (!entry->in_use) {
+            /* 没有删除操作，遇到空槽即可确定键不存在 */
+            if (free_slot != NULL) {
+                *free_slot = (int32_t)index;
+            }
+            return -1;
+        }
+
+        if (entry_matches(entry, hash, student_id, sensor_name, tag)) {
+            return (int32_t)index;
+        }
+
+        index = (index + 1) & mask;
+    }
+
+    return -1;
+}
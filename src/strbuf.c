@@ -0,0 +1,219 @@
+/**
+ * @file strbuf.c
+ * @brief 定长缓冲区字符串构建模块实现 - IAR 5.3兼容版本
+ * @author OpenHands
+ * @date 2026-10-18
+ * @version 1.0.0
+ */
+
+#include "strbuf.h"
+
+/* 10的幂（定点小数缩放） */
+static const uint32_t POW10[STRBUF_MAX_DECIMALS + 1] = {
+    1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL
+};
+
+static const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+/* 内部函数声明 */
+static bool append_digits(strbuf_t* sb, uint32_t value, uint8_t min_digits);
+
+/**
+ * @brief 初始化构建器
+ */
+void strbuf_init(strbuf_t* sb, char* buffer, size_t capacity)
+{
+    if (sb == NULL) {
+        return;
+    }
+
+    sb->data = buffer;
+    sb->capacity = (buffer != NULL) ? capacity : 0;
+    sb->length = 0;
+    sb->overflow = (sb->capacity == 0);
+
+    if (sb->capacity > 0) {
+        buffer[0] = '\0';
+    }
+}
+
+/**
+ * @brief 清空构建器内容
+ */
+void strbuf_reset(strbuf_t* sb)
+{
+    sb->length = 0;
+    sb->overflow = (sb->capacity == 0);
+    if (sb->capacity > 0) {
+        sb->data[0] = '\0';
+    }
+}
+
+/**
+ * @brief 回退到指定长度
+ */
+void strbuf_truncate(strbuf_t* sb, size_t length)
+{
+    if (length <= sb->length && sb->capacity > 0) {
+        sb->length = length;
+        sb->data[length] = '\0';
+        sb->overflow = false;
+    }
+}
+
+/**
+ * @brief 追加字符串
+ */
+bool strbuf_append_str(strbuf_t* sb, const char* str)
+{
+    if (str == NULL) {
+        return !sb->overflow;
+    }
+
+    return strbuf_append_mem(sb, str, strlen(str));
+}
+
+/**
+ * @brief 追加指定长度的字节
+ */
+bool strbuf_append_mem(strbuf_t* sb, const char* data, size_t length)
+{
+    if (sb->overflow) {
+        return false;
+    }
+
+    if (length >= sb->capacity - sb->length) {
+        sb->overflow = true;
+        return false;
+    }
+
+    memcpy(&sb->data[sb->length], data, length);
+    sb->length += length;
+    sb->data[sb->length] = '\0';
+    return true;
+}
+
+/**
+ * @brief 追加单个字符
+ */
+bool strbuf_append_char(strbuf_t* sb, char c)
+{
+    if (sb->overflow || sb->length + 1 >= sb->capacity) {
+        sb->overflow = true;
+        return false;
+    }
+
+    sb->data[sb->length++] = c;
+    sb->data[sb->length] = '\0';
+    return true;
+}
+
+/**
+ * @brief 追加无符号十进制整数
+ */
+bool strbuf_append_uint(strbuf_t* sb, uint32_t value)
+{
+    return append_digits(sb, value, 1);
+}
+
+/**
+ * @brief 追加有符号十进制整数
+ */
+bool strbuf_append_int(strbuf_t* sb, int32_t value)
+{
+    uint32_t magnitude;
+
+    if (value < 0) {
+        if (!strbuf_append_char(sb, '-')) {
+            return false;
+        }
+        /* 先转无符号再取负，INT32_MIN不会溢出 */
+        magnitude = 0u - (uint32_t)value;
+    } else {
+        magnitude = (uint32_t)value;
+    }
+
+    return append_digits(sb, magnitude, 1);
+}
+
+/**
+ * @brief 追加定点小数
+ */
+bool strbuf_append_fixed(strbuf_t* sb, float value, uint8_t decimals)
+{
+    float scaled;
+    uint32_t fixed;
+    uint32_t scale;
+
+    if (decimals > STRBUF_MAX_DECIMALS) {
+        decimals = STRBUF_MAX_DECIMALS;
+    }
+    scale = POW10[decimals];
+
+    /* 放大后整数部分必须能放进uint32_t（同时拒绝NaN） */
+    scaled = value * (float)scale;
+    if (!(scaled > -4294967040.0f && scaled < 4294967040.0f)) {
+        sb->overflow = true;
+        return false;
+    }
+
+    if (scaled < 0.0f) {
+        fixed = (uint32_t)(-scaled + 0.5f);
+        /* 舍入后为0时不输出"-0.00" */
+        if (fixed != 0 && !strbuf_append_char(sb, '-')) {
+            return false;
+        }
+    } else {
+        fixed = (uint32_t)(scaled + 0.5f);
+    }
+
+    if (!append_digits(sb, fixed / scale, 1)) {
+        return false;
+    }
+
+    if (decimals == 0) {
+        return true;
+    }
+
+    return strbuf_append_char(sb, '.') && append_digits(sb, fixed % scale, decimals);
+}
+
+/**
+ * @brief 追加8位大写十六进制数
+ */
+bool strbuf_append_hex32(strbuf_t* sb, uint32_t value)
+{
+    char digits[8];
+    int i;
+
+    for (i = 7; i >= 0; i--) {
+        digits[i] = HEX_DIGITS[value & 0x0F];
+        value >>= 4;
+    }
+
+    return strbuf_append_mem(sb, digits, sizeof(digits));
+}
+
+/* 内部函数实现 */
+
+/**
+ * @brief 追加十进制数字，不足min_digits位时补前导0
+ */
+static bool append_digits(strbuf_t* sb, uint32_t value, uint8_t min_digits)
+{
+    char digits[STRBUF_UINT_DIGITS];
+    uint8_t count = 0;
+
+    do {
+        digits[STRBUF_UINT_DIGITS - 1 - count] = (char)('0' + (value % 10));
+        value /= 10;
+        count++;
+    } while (value != 0);
+
+    while (count < min_digits && count < STRBUF_UINT_DIGITS) {
+        digits[STRBUF_UINT_DIGITS - 1 - count] = '0';
+        count++;
+    }
+
+    return strbuf_append_mem(sb, &digits[STRBUF_UINT_DIGITS - count], count);
+}
@@ -0,0 +1,146 @@
+/**
+ * @file bench_parser.c
+ * @brief 数据解析微基准（ns/行，行/秒）
+ * @author OpenHands
+ * @date 2026-10-18
+ *
+ * 用法：make bench && ./build/bench/bench_parser [行数]
+ * 分别测量有效、无效和混合（约90%有效）三种语料，每种语料先预热
+ * 一轮再计时。测量的是parse_sensor_data()的完整路径，包括滚动统计、
+ * 异常检测和分发入队（按config.h中的功能开关）。
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "config.h"
+#include "sensor_data.h"
+#include "crc.h"
+
+#include <time.h>
+
+#define BENCH_DEFAULT_LINES     200000UL
+#define BENCH_CORPUS_SIZE       1024        /* 语料条数（循环使用） */
+#define BENCH_LINE_SIZE         64
+
+/* 语料类型 */
+typedef enum {
+    CORPUS_VALID = 0,
+    CORPUS_INVALID = 1,
+    CORPUS_MIXED = 2
+} corpus_kind_t;
+
+static char corpus[BENCH_CORPUS_SIZE][BENCH_LINE_SIZE];
+
+/* 无效输入样例：字段数错误、非数字、超范围、超长学号 */
+static const char* const INVALID_LINES[] = {
+    "ZS2021001,abc,60.0",
+    "ZS2021001,25.5",
+    "ZS2021001,25.5,60.0,1",
+    "ZS2021001,125.0,60.0",
+    "ZS2021001,KEY1,9",
+    "ZS2021001ZS2021001ZS2021001,25.5,60.0",
+    ",,",
+    "ZS2021001,25.5.1,60.0"
+};
+
+/**
+ * @brief 生成一条有效数据（温湿度和中断交替）
+ */
+static void make_valid_line(char* line, uint32_t i)
+{
+    if ((i & 3u) == 3u) {
+        sprintf(line, "ZS%04lu,KEY%lu,%lu",
+                (unsigned long)(i % 16), (unsigned long)(i % 4), (unsigned long)(i % 4));
+    } else {
+        sprintf(line, "ZS%04lu,%lu.%lu,%lu.%lu",
+                (unsigned long)(i % 16), (unsigned long)(20 + i % 10), (unsigned long)(i % 10),
+                (unsigned long)(40 + i % 30), (unsigned long)(i % 10));
+    }
+}
+
+/**
+ * @brief 生成语料
+ */
+static void build_corpus(corpus_kind_t kind)
+{
+    uint32_t i;
+
+    for (i = 0; i < BENCH_CORPUS_SIZE; i++) {
+        bool invalid = (kind == CORPUS_INVALID) || (kind == CORPUS_MIXED && i % 10 == 9);
+
+        if (invalid) {
+            strcpy(corpus[i], INVALID_LINES[i % ARRAY_SIZE(INVALID_LINES)]);
+        } else {
+            make_valid_line(corpus[i], i);
+        }
+    }
+}
+
+/**
+ * @brief 单调时钟（纳秒）
+ */
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief 解析lines行并返回耗时（纳秒）
+ */
+static double run_lines(unsigned long lines, unsigned long* valid_count)
+{
+    sensor_data_t data;
+    parse_result_t result;
+    unsigned long i;
+    unsigned long valid = 0;
+    double start;
+
+    start = now_ns();
+    for (i = 0; i < lines; i++) {
+        result = parse_sensor_data(corpus[i % BENCH_CORPUS_SIZE], &data);
+        valid += result.is_valid ? 1 : 0;
+    }
+
+    *valid_count = valid;
+    return now_ns() - start;
+}
+
+/**
+ * @brief 测量一种语料
+ */
+static void bench_corpus(const char* name, corpus_kind_t kind, unsigned long lines)
+{
+    unsigned long valid;
+    double elapsed;
+
+    build_corpus(kind);
+    sensor_data_init();
+
+    run_lines(BENCH_CORPUS_SIZE, &valid);
+    elapsed = run_lines(lines, &valid);
+
+    printf("%-8s %10lu lines %8.1f ns/line %12.0f lines/s  (valid %lu)\n",
+           name, lines, elapsed / (double)lines, (double)lines * 1e9 / elapsed, valid);
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned long lines = BENCH_DEFAULT_LINES;
+
+    if (argc > 1) {
+        lines = strtoul(argv[1], NULL, 10);
+        if (lines == 0) {
+            lines = BENCH_DEFAULT_LINES;
+        }
+    }
+
+    crc_init();
+
+    bench_corpus("valid", CORPUS_VALID, lines);
+    bench_corpus("invalid", CORPUS_INVALID, lines);
+    bench_corpus("mixed", CORPUS_MIXED, lines);
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file fuzz_parser.c
+ * @brief 数据解析与帧校验模糊测试入口（libFuzzer / AFL）
+ * @author OpenHands
+ * @date 2026-10-18
+ *
+ * 构建：
+ *   make fuzz                     libFuzzer（clang -fsanitize=fuzzer）
+ *   make fuzz FUZZ_ENGINE=afl     AFL（afl-clang-fast，从stdin读取输入）
+ *   make fuzz FUZZ_ENGINE=replay  gcc + ASan/UBSan，回放语料文件
+ *
+ * 除了由sanitizer发现的内存错误外，还检查以下不变量：
+ * - 解析成功的数据必须能通过validate_sensor*_data()并能格式化
+ * - error_msg总是以'\0'结尾
+ * - 统计计数满足 total == valid + error
+ * - 合法负载加上CRC后缀后必须校验通过并恢复原负载
+ */
+
+#include "config.h"
+#include "sensor_data.h"
+#include "communication.h"
+#include "crc.h"
+#include "strbuf.h"
+
+#include <assert.h>
+
+/* 与主程序行缓冲区一致 */
+#define FUZZ_LINE_SIZE          128
+
+static bool initialized = false;
+
+/**
+ * @brief 检查解析结果的不变量
+ */
+static void check_parse_result(const parse_result_t* result, const sensor_data_t* data)
+{
+    char text[FUZZ_LINE_SIZE];
+
+    assert(memchr(result->error_msg, '\0', sizeof(result->error_msg)) != NULL);
+
+    if (!result->is_valid) {
+        return;
+    }
+
+    if (data->type == SENSOR_TYPE_TEMP_HUMIDITY) {
+        assert(validate_sensor1_data(&data->data.sensor1));
+        assert(format_sensor1_data(&data->data.sensor1, text, sizeof(text)) == SYSTEM_OK);
+    } else {
+        assert(validate_sensor2_data(&data->data.sensor2));
+        assert(format_sensor2_data(&data->data.sensor2, text, sizeof(text)) == SYSTEM_OK);
+    }
+}
+
+/**
+ * @brief 帧校验：原样校验一次，再对负载加合法CRC后缀校验一次
+ */
+static void fuzz_framing(const char* line)
+{
+    char frame[FUZZ_LINE_SIZE + 1 + COMM_FRAME_CRC_HEX_LEN];
+    char copy[FUZZ_LINE_SIZE];
+    size_t length = strlen(line);
+    strbuf_t sb;
+
+    memcpy(copy, line, length + 1);
+    communication_verify_frame(copy);
+
+    /* 负载中含分隔符时，strrchr取最后一个，仍应校验通过 */
+    strbuf_init(&sb, frame, sizeof(frame));
+    strbuf_append_mem(&sb, line, length);
+    strbuf_append_char(&sb, COMM_FRAME_CRC_DELIMITER);
+    strbuf_append_hex32(&sb, crc32c((const uint8_t*)line, length));
+    assert(strbuf_ok(&sb));
+
+    assert(communication_verify_frame(frame) == SYSTEM_OK);
+    assert(strcmp(frame, line) == 0);
+}
+
+/**
+ * @brief libFuzzer入口
+ */
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    char line[FUZZ_LINE_SIZE];
+    sensor_data_t sensor_data;
+    sensor1_data_t sensor1;
+    sensor2_data_t sensor2;
+    parse_result_t result;
+    uint32_t total, valid, error;
+
+    if (!initialized) {
+        crc_init();
+        sensor_data_init();
+        initialized = true;
+    }
+
+    /* 主程序按行读取，输入截断到行缓冲区大小并在第一个'\0'处结束 */
+    size = MIN(size, sizeof(line) - 1);
+    memcpy(line, data, size);
+    line[size] = '\0';
+
+    fuzz_framing(line);
+
+    result = parse_sensor_data(line, &sensor_data);
+    check_parse_result(&result, &sensor_data);
+
+    result = parse_sensor1_data(line, &sensor1);
+    assert(memchr(result.error_msg, '\0', sizeof(result.error_msg)) != NULL);
+    if (result.is_valid) {
+        assert(validate_sensor1_data(&sensor1));
+    }
+
+    result = parse_sensor2_data(line, &sensor2);
+    assert(memchr(result.error_msg, '\0', sizeof(result.error_msg)) != NULL);
+    if (result.is_valid) {
+        assert(validate_sensor2_data(&sensor2));
+    }
+
+    get_sensor_statistics(&total, &valid, &error);
+    assert(total == valid + error);
+
+    return 0;
+}
+
+#ifndef FUZZ_LIBFUZZER
+/**
+ * @brief 独立驱动：回放参数中的文件，无参数时从stdin读取一条输入（AFL）
+ */
+int main(int argc, char* argv[])
+{
+    static uint8_t buffer[4096];
+    size_t size;
+    int i;
+
+    if (argc < 2) {
+        size = fread(buffer, 1, sizeof(buffer), stdin);
+        return LLVMFuzzerTestOneInput(buffer, size);
+    }
+
+    for (i = 1; i < argc; i++) {
+        FILE* fp = fopen(argv[i], "rb");
+        if (fp == NULL) {
+            fprintf(stderr, "cannot open %s\n", argv[i]);
+            return 1;
+        }
+        size = fread(buffer, 1, sizeof(buffer), fp);
+        fclose(fp);
+        LLVMFuzzerTestOneInput(buffer, size);
+    }
+
+    printf("replayed %d inputs\n", argc - 1);
+    return 0;
+}
+#endif
@@ -0,0 +1,243 @@
+/**
+ * @file test_cache.c
+ * @brief 最新数据缓存回归测试
+ * @author OpenHands
+ * @date 2026-10-18
+ *
+ * 用法：make check（以-DDB_WITH_TSDB -DENABLE_DB_CACHE=1编译，文件写在build/check下）
+ * 按写入路径的约定：每行写入数据库成功后调用db_cache_put()，检查：
+ *
+ * - 写满并回绕后按最新优先返回，顺序与数据库查询一致
+ * - 回绕后缓存不再包含全部行，超出缓存行数的查询回到数据库
+ * - 数据库行数少于limit时填充为完整，之后更大的limit仍命中；
+ *   行数等于limit时不能视为完整
+ * - database_query_sensor1_data()按学号的最新N条查询经过缓存
+ */
+
+#include "config.h"
+#include "database.h"
+#include "db_driver.h"
+#include "db_cache.h"
+#include "crc.h"
+#include "strbuf.h"
+
+#include <time.h>
+
+#define TEST_DB                 "build/check/cache"
+#define TEST_WRAP_ROWS          (DB_CACHE_DEPTH + 5)
+
+/* 检查失败时打印位置并计数，不中止后续检查 */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static int failures = 0;
+static char path_buffer[64];
+static sensor_data_t rows[DB_CACHE_DEPTH * 2];
+static uint32_t next_timestamp = 1000;
+
+/**
+ * @brief 测试数据库的文件路径
+ */
+static const char* test_path(const char* suffix)
+{
+    strbuf_t sb;
+
+    strbuf_init(&sb, path_buffer, sizeof(path_buffer));
+    strbuf_append_str(&sb, TEST_DB);
+    strbuf_append_str(&sb, suffix);
+    return strbuf_cstr(&sb);
+}
+
+/**
+ * @brief 段文件路径（天段为当前日期，与驱动一致）
+ */
+static const char* segment_path(uint8_t table, uint32_t day)
+{
+    strbuf_t sb;
+
+    strbuf_init(&sb, path_buffer, sizeof(path_buffer));
+    strbuf_append_str(&sb, TEST_DB "_s");
+    strbuf_append_uint(&sb, (uint32_t)table + 1);
+    strbuf_append_char(&sb, '_');
+    strbuf_append_hex32(&sb, day);
+    strbuf_append_str(&sb, ".seg");
+    return strbuf_cstr(&sb);
+}
+
+/**
+ * @brief 删除上次运行留下的文件
+ */
+static void remove_files(void)
+{
+    uint32_t today = (uint32_t)time(NULL) / 86400UL;
+    uint8_t t;
+
+    remove(test_path("_head.tsd"));
+    remove(test_path("_dict.tsd"));
+    for (t = 0; t < DB_TABLE_COUNT; t++) {
+        remove(test_path((t == 0) ? "_s1.idx" : "_s2.idx"));
+        remove(segment_path(t, today));
+        remove(segment_path(t, today - 1));
+    }
+}
+
+/**
+ * @brief 写入一行并按写入路径的约定放入缓存，返回该行时间戳
+ */
+static uint32_t put_row(const char* student_id)
+{
+    sensor_data_t data;
+
+    memset(&data, 0, sizeof(sensor_data_t));
+    data.type = SENSOR_TYPE_TEMP_HUMIDITY;
+    SAFE_STRCPY(data.data.sensor1.student_id, student_id, sizeof(data.data.sensor1.student_id));
+    strcpy(data.data.sensor1.sensor_name, "TEMP_HUMID");
+    data.data.sensor1.temperature = 20.0f;
+    data.data.sensor1.humidity = 50.0f;
+    data.data.sensor1.status = SENSOR_STATUS_NORMAL;
+    data.data.sensor1.timestamp = next_timestamp++;
+
+    CHECK(database_insert_sensor_data(&data).success);
+    db_cache_put(&data);
+    return data.data.sensor1.timestamp;
+}
+
+/**
+ * @brief 查询最新limit条，检查条数和从newest起逐条递减的时间戳
+ */
+static void check_latest(const char* student_id, uint16_t limit, uint32_t expected_rows,
+                         uint32_t newest)
+{
+    db_result_t result;
+    uint32_t i;
+
+    result = db_cache_query_latest(SENSOR_TYPE_TEMP_HUMIDITY, student_id, rows, limit);
+    CHECK(result.success);
+    CHECK(result.affected_rows == expected_rows);
+    for (i = 0; i < result.affected_rows && i < expected_rows; i++) {
+        CHECK(strcmp(rows[i].data.sensor1.student_id, student_id) == 0);
+        CHECK(rows[i].data.sensor1.timestamp == newest - i);
+    }
+}
+
+/**
+ * @brief 写满并回绕：命中时按最新优先，超出缓存的行数回到数据库
+ */
+static void test_ring_order(void)
+{
+    db_cache_statistics_t before;
+    db_cache_statistics_t after;
+    uint32_t newest = 0;
+    uint32_t i;
+
+    for (i = 0; i < TEST_WRAP_ROWS; i++) {
+        newest = put_row("ZS0001");
+    }
+
+    db_cache_get_statistics(&before);
+    check_latest("ZS0001", 3, 3, newest);
+    check_latest("ZS0001", DB_CACHE_DEPTH, DB_CACHE_DEPTH, newest);
+    db_cache_get_statistics(&after);
+    CHECK(after.hits == before.hits + 2);
+    CHECK(after.misses == before.misses);
+
+    /* 回绕覆盖了最旧的行，更多的行只能从数据库读 */
+    check_latest("ZS0001", DB_CACHE_DEPTH + 2, DB_CACHE_DEPTH + 2, newest);
+    db_cache_get_statistics(&after);
+    CHECK(after.misses == before.misses + 1);
+}
+
+/**
+ * @brief 填充后的完整标记：行数少于limit时完整，等于limit时不完整
+ */
+static void test_complete(void)
+{
+    db_cache_statistics_t before;
+    db_cache_statistics_t after;
+    uint32_t newest = 0;
+    uint32_t i;
+
+    for (i = 0; i < 3; i++) {
+        newest = put_row("ZS0002");
+    }
+    db_cache_invalidate();
+
+    /* 恰好取到limit行：数据库中可能还有更早的行 */
+    db_cache_get_statistics(&before);
+    check_latest("ZS0002", 2, 2, newest);
+    check_latest("ZS0002", 3, 3, newest);
+    db_cache_get_statistics(&after);
+    CHECK(after.misses == before.misses + 2);
+    CHECK(after.fills == before.fills + 2);
+
+    /* 取到的行少于limit：缓冲区就是全部行，更大的limit直接命中 */
+    check_latest("ZS0002", 8, 3, newest);
+    db_cache_get_statistics(&before);
+    check_latest("ZS0002", DB_CACHE_DEPTH, 3, newest);
+    db_cache_get_statistics(&after);
+    CHECK(after.hits == before.hits + 1);
+    CHECK(after.misses == before.misses);
+
+    /* 完整时继续写入仍完整，直到回绕 */
+    newest = put_row("ZS0002");
+    check_latest("ZS0002", DB_CACHE_DEPTH, 4, newest);
+    db_cache_get_statistics(&after);
+    CHECK(after.hits == before.hits + 2);
+}
+
+/**
+ * @brief 按学号的最新N条查询经过缓存，全部学号和不限行数的查询不经过
+ */
+static void test_query_path(void)
+{
+    db_cache_statistics_t before;
+    db_cache_statistics_t after;
+    db_query_result_t result;
+
+    /* test_complete之后缓存已失效：第一次从数据库填充，第二次命中 */
+    db_cache_get_statistics(&before);
+    result = database_query_sensor1_data("ZS0001", 4);
+    CHECK(result.row_count == 4);
+    result = database_query_sensor1_data("ZS0001", 4);
+    CHECK(result.row_count == 4);
+    db_cache_get_statistics(&after);
+    CHECK(after.misses == before.misses + 1);
+    CHECK(after.hits == before.hits + 1);
+
+    before = after;
+    result = database_query_sensor1_data("ZS0001", 0);
+    CHECK(result.row_count == TEST_WRAP_ROWS);
+    result = database_query_sensor1_data(NULL, 4);
+    CHECK(result.row_count == 4);
+    db_cache_get_statistics(&after);
+    CHECK(after.hits == before.hits);
+    CHECK(after.misses == before.misses);
+}
+
+int main(void)
+{
+    db_config_t config = DEFAULT_DB_CONFIG;
+
+    crc_init();
+    remove_files();
+    CHECK(database_init() == SYSTEM_OK);
+    CHECK(database_get_driver() == &DB_DRIVER_TSDB);
+    SAFE_STRCPY(config.database, TEST_DB, sizeof(config.database));
+    CHECK(database_connect(&config).success);
+    CHECK(database_create_tables().success);
+    CHECK(db_cache_init() == SYSTEM_OK);
+
+    test_ring_order();
+    test_complete();
+    test_query_path();
+
+    database_disconnect();
+    remove_files();
+    printf("test_cache: %s\n", (failures == 0) ? "OK" : "FAILED");
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+/**
+ * @file test_database.c
+ * @brief 默认构建（模拟驱动）的数据库写入回归测试
+ * @author OpenHands
+ * @date 2026-10-18
+ *
+ * 用法：make check
+ * 不定义DB_WITH_*时使用目标板默认的模拟驱动和config.h中的表结构
+ * 版本，检查逐行INSERT、批量写入和批量装载（ENABLE_DB_BULK）三条写入
+ * 路径都能成功。模拟驱动不保存数据，这里只检查返回结果和逐行回调，不检查
+ * 表内容。
+ */
+
+#include "config.h"
+#include "database.h"
+#include "db_driver.h"
+#include "db_batch.h"
+#include "crc.h"
+#if ENABLE_DB_BULK
+#include "db_bulk.h"
+#endif
+#if ENABLE_DB_ROLLUP
+#include "db_rollup.h"
+#endif
+
+#define TEST_ROWS               20
+
+/* 检查失败时打印位置并计数，不中止后续检查 */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static int failures = 0;
+static uint16_t inserted_rows = 0;
+static uint16_t failed_rows = 0;
+
+/**
+ * @brief 生成一行数据（温湿度和中断交替）
+ */
+static void make_row(sensor_data_t* data, uint32_t i)
+{
+    memset(data, 0, sizeof(sensor_data_t));
+    if (i % 2 == 0) {
+        data->type = SENSOR_TYPE_TEMP_HUMIDITY;
+        sprintf(data->data.sensor1.student_id, "ZS%04lu", (unsigned long)(i % 4));
+        strcpy(data->data.sensor1.sensor_name, "TEMP_HUMID");
+        data->data.sensor1.temperature = 20.0f + (float)(i % 10);
+        data->data.sensor1.humidity = 50.0f;
+        data->data.sensor1.status = SENSOR_STATUS_NORMAL;
+        data->data.sensor1.timestamp = 1000 + i;
+    } else {
+        data->type = SENSOR_TYPE_INTERRUPT;
+        sprintf(data->data.sensor2.student_id, "ZS%04lu", (unsigned long)(i % 4));
+        strcpy(data->data.sensor2.sensor_name, "KEY1");
+        data->data.sensor2.interrupt_type = INTERRUPT_TYPE_RISING;
+        data->data.sensor2.interrupt_count = 1;
+        data->data.sensor2.status = SENSOR_STATUS_NORMAL;
+        data->data.sensor2.first_timestamp = 1000 + i;
+        data->data.sensor2.timestamp = 1000 + i;
+    }
+}
+
+/**
+ * @brief 批量写入结果回调
+ */
+static void outcome_callback(const db_row_outcome_t* outcomes, uint16_t count, void* context)
+{
+    uint16_t i;
+
+    (void)context;
+    for (i = 0; i < count; i++) {
+        if (outcomes[i].status == DB_ROW_INSERTED) {
+            inserted_rows++;
+        } else {
+            failed_rows++;
+        }
+    }
+}
+
+/**
+ * @brief 逐行INSERT
+ */
+static void test_insert(void)
+{
+    sensor_data_t data;
+    db_result_t result;
+    uint32_t i;
+
+    for (i = 0; i < TEST_ROWS; i++) {
+        make_row(&data, i);
+        result = database_insert_sensor_data(&data);
+        CHECK(result.success);
+        if (!result.success) {
+            printf("  row %lu: %s\n", (unsigned long)i, result.error_message);
+        }
+    }
+}
+
+/**
+ * @brief 批量写入：每行都应报告为已写入
+ */
+static void test_batch(void)
+{
+    sensor_data_t data;
+    uint32_t i;
+
+    CHECK(db_batch_init(NULL) == SYSTEM_OK);
+    db_batch_set_outcome_callback(outcome_callback, NULL);
+
+    for (i = 0; i < TEST_ROWS; i++) {
+        make_row(&data, i);
+        CHECK(db_batch_add(&data, NULL).success);
+    }
+    db_batch_flush_all();
+
+    CHECK(inserted_rows == TEST_ROWS);
+    CHECK(failed_rows == 0);
+}
+
+#if ENABLE_DB_BULK
+/**
+ * @brief 批量装载：暂存的行全部装入
+ */
+static void test_bulk(void)
+{
+    sensor_data_t data;
+    db_result_t result;
+    uint32_t i;
+
+    CHECK(db_bulk_init() == SYSTEM_OK);
+    CHECK(db_bulk_begin().success);
+    for (i = 0; i < TEST_ROWS; i++) {
+        make_row(&data, i);
+        CHECK(db_bulk_add(&data).success);
+    }
+    CHECK(db_bulk_staged_rows() == TEST_ROWS);
+
+    result = db_bulk_commit();
+    CHECK(result.success);
+    CHECK(result.affected_rows == TEST_ROWS);
+    CHECK(!db_bulk_active());
+}
+#endif
+
+int main(void)
+{
+    crc_init();
+    CHECK(database_init() == SYSTEM_OK);
+    CHECK(database_get_driver() == &DB_DRIVER_SIM);
+    CHECK(database_connect(&DEFAULT_DB_CONFIG).success);
+    CHECK(database_create_tables().success);
+#if ENABLE_DB_ROLLUP
+    db_rollup_init();
+#endif
+
+    test_insert();
+    test_batch();
+#if ENABLE_DB_BULK
+    test_bulk();
+#endif
+
+    database_disconnect();
+    printf("test_database: %s\n", (failures == 0) ? "OK" : "FAILED");
+    return (failures == 0) ? 0 : 1;
+}
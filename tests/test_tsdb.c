@@ -0,0 +1,320 @@
+/**
+ * @file test_tsdb.c
+ * @brief 列式时序存储驱动的恢复回归测试
+ * @author OpenHands
+ * @date 2026-10-18
+ *
+ * 用法：make check（以-DDB_WITH_TSDB编译，文件写在build/check下）
+ * 写入几次封存的数据后检查：
+ *
+ * - 重新打开后行数、逐行内容和最新行不变
+ * - 头部日志和索引末尾的半条记录（写入时掉电）被截掉，已提交的数据不丢
+ * - 索引中间一项损坏时只丢该项对应的块，之后提交的块仍可读，
+ *   并且之后仍可写入
+ */
+
+#include "config.h"
+#include "database.h"
+#include "db_driver.h"
+#include "crc.h"
+#include "strbuf.h"
+
+#include <time.h>
+
+#define TEST_DB                 "build/check/tsdb"
+#define TEST_ROWS               999
+#define TEST_TXN_ROWS           50
+#define TEST_INDEX_ENTRY_SIZE   36          /* 与db_driver_tsdb.c的TSDB_INDEX_ENTRY_SIZE一致 */
+
+/* 检查失败时打印位置并计数，不中止后续检查 */
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+static int failures = 0;
+static char path_buffer[64];
+
+/**
+ * @brief 测试数据库的文件路径
+ */
+static const char* test_path(const char* suffix)
+{
+    strbuf_t sb;
+
+    strbuf_init(&sb, path_buffer, sizeof(path_buffer));
+    strbuf_append_str(&sb, TEST_DB);
+    strbuf_append_str(&sb, suffix);
+    return strbuf_cstr(&sb);
+}
+
+/**
+ * @brief 段文件路径（天段为当前日期，与驱动一致）
+ */
+static const char* segment_path(uint8_t table, uint32_t day)
+{
+    strbuf_t sb;
+
+    strbuf_init(&sb, path_buffer, sizeof(path_buffer));
+    strbuf_append_str(&sb, TEST_DB "_s");
+    strbuf_append_uint(&sb, (uint32_t)table + 1);
+    strbuf_append_char(&sb, '_');
+    strbuf_append_hex32(&sb, day);
+    strbuf_append_str(&sb, ".seg");
+    return strbuf_cstr(&sb);
+}
+
+/**
+ * @brief 删除上次运行留下的文件
+ */
+static void remove_files(void)
+{
+    uint32_t today = (uint32_t)time(NULL) / 86400UL;
+    uint8_t t;
+
+    remove(test_path("_head.tsd"));
+    remove(test_path("_dict.tsd"));
+    for (t = 0; t < DB_TABLE_COUNT; t++) {
+        remove(test_path((t == 0) ? "_s1.idx" : "_s2.idx"));
+        remove(segment_path(t, today));
+        remove(segment_path(t, today - 1));
+    }
+}
+
+/**
+ * @brief 文件长度（不存在时为-1）
+ */
+static long file_size(const char* path)
+{
+    FILE* fp = fopen(path, "rb");
+    long size;
+
+    if (fp == NULL) {
+        return -1;
+    }
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fclose(fp);
+    return size;
+}
+
+/**
+ * @brief 在文件末尾追加length字节
+ */
+static void append_bytes(const char* path, const uint8_t* bytes, size_t length)
+{
+    FILE* fp = fopen(path, "ab");
+
+    CHECK(fp != NULL);
+    if (fp != NULL) {
+        CHECK(fwrite(bytes, 1, length, fp) == length);
+        fclose(fp);
+    }
+}
+
+/**
+ * @brief 翻转文件中offset处一个字节的一位
+ */
+static void flip_byte(const char* path, long offset)
+{
+    FILE* fp = fopen(path, "r+b");
+    int c;
+
+    CHECK(fp != NULL);
+    if (fp == NULL) {
+        return;
+    }
+    fseek(fp, offset, SEEK_SET);
+    c = fgetc(fp);
+    fseek(fp, offset, SEEK_SET);
+    fputc(c ^ 0x10, fp);
+    fclose(fp);
+}
+
+/**
+ * @brief 第i行（温湿度，学号和温度由i决定）
+ */
+static void make_row(sensor_data_t* data, uint32_t i)
+{
+    memset(data, 0, sizeof(sensor_data_t));
+    data->type = SENSOR_TYPE_TEMP_HUMIDITY;
+    sprintf(data->data.sensor1.student_id, "ZS%04lu", (unsigned long)(i % 3));
+    strcpy(data->data.sensor1.sensor_name, "TEMP_HUMID");
+    data->data.sensor1.temperature = (float)(i % 100) * 0.5f;
+    data->data.sensor1.humidity = 40.0f + (float)(i % 20);
+    data->data.sensor1.status = SENSOR_STATUS_NORMAL;
+    data->data.sensor1.timestamp = 1000 + i;
+}
+
+/**
+ * @brief 写入[first, first + count)行，每TEST_TXN_ROWS行一个事务
+ */
+static void insert_rows(uint32_t first, uint32_t count)
+{
+    sensor_data_t data;
+    uint32_t i;
+
+    for (i = 0; i < count; i++) {
+        if (i % TEST_TXN_ROWS == 0) {
+            CHECK(database_begin_transaction().success);
+        }
+        make_row(&data, first + i);
+        CHECK(database_insert_sensor_data(&data).success);
+        if (i % TEST_TXN_ROWS == TEST_TXN_ROWS - 1 || i == count - 1) {
+            CHECK(database_commit_transaction().success);
+        }
+    }
+}
+
+/**
+ * @brief 打开（或重新打开）测试数据库
+ */
+static bool reopen(void)
+{
+    db_config_t config = DEFAULT_DB_CONFIG;
+
+    database_disconnect();
+    SAFE_STRCPY(config.database, TEST_DB, sizeof(config.database));
+    return database_connect(&config).success && database_create_tables().success;
+}
+
+/**
+ * @brief 温湿度表的行数
+ */
+static uint32_t sensor1_rows(void)
+{
+    uint32_t sensor1 = 0;
+    uint32_t sensor2 = 0;
+
+    CHECK(database_get_statistics(&sensor1, &sensor2).success);
+    return sensor1;
+}
+
+/**
+ * @brief 按最新优先读出全部行：行数与计数一致、每行都是写入时的内容，返回最新一行的序号
+ */
+static uint32_t check_rows(uint32_t expected_rows)
+{
+    db_stmt_t* stmt = database_prepare(DB_STMT_SELECT_SENSOR1_ALL);
+    db_cursor_t cursor;
+    sensor_data_t data;
+    sensor_data_t expected;
+    uint32_t rows = 0;
+    uint32_t latest = 0;
+    uint32_t i;
+
+    CHECK(stmt != NULL);
+    if (stmt == NULL) {
+        return 0;
+    }
+    db_stmt_bind_uint(stmt, 0, SQL_STMT_NO_LIMIT);
+    CHECK(db_stmt_open_cursor(stmt, &cursor).success);
+
+    while (db_cursor_next(&cursor)) {
+        db_cursor_get_sensor_data(&cursor, SENSOR_TYPE_TEMP_HUMIDITY, &data);
+        i = data.data.sensor1.timestamp - 1000;
+        if (rows == 0) {
+            latest = i;
+        }
+        make_row(&expected, i);
+        CHECK(strcmp(data.data.sensor1.student_id, expected.data.sensor1.student_id) == 0);
+        CHECK(data.data.sensor1.temperature == expected.data.sensor1.temperature);
+        CHECK(data.data.sensor1.humidity == expected.data.sensor1.humidity);
+        rows++;
+    }
+    db_cursor_close(&cursor);
+
+    CHECK(rows == expected_rows);
+    return latest;
+}
+
+/**
+ * @brief 重新打开后数据不变
+ */
+static void test_reopen(void)
+{
+    CHECK(reopen());
+    insert_rows(0, TEST_ROWS);
+    CHECK(sensor1_rows() == TEST_ROWS);
+    CHECK(check_rows(TEST_ROWS) == TEST_ROWS - 1);
+
+    CHECK(reopen());
+    CHECK(sensor1_rows() == TEST_ROWS);
+    CHECK(check_rows(TEST_ROWS) == TEST_ROWS - 1);
+}
+
+/**
+ * @brief 头部日志和索引末尾的半条记录被截掉
+ */
+static void test_torn_tail(void)
+{
+    static const uint8_t garbage[TEST_INDEX_ENTRY_SIZE + 14] = { 1, 2, 3 };
+    long index_size;
+
+    database_disconnect();
+    index_size = file_size(test_path("_s1.idx"));
+    append_bytes(test_path("_head.tsd"), garbage, 7);
+    append_bytes(test_path("_s1.idx"), garbage, sizeof(garbage));
+
+    CHECK(reopen());
+    CHECK(sensor1_rows() == TEST_ROWS);
+    CHECK(check_rows(TEST_ROWS) == TEST_ROWS - 1);
+    /* 截掉的是追加的半条记录；重写时中间的提交标记合并为一个，文件只会变短 */
+    CHECK(file_size(test_path("_s1.idx")) <= index_size);
+    CHECK(file_size(test_path("_s1.idx")) % TEST_INDEX_ENTRY_SIZE == 0);
+}
+
+/**
+ * @brief 索引中间一项损坏：只丢该块，之后提交的块仍可读，之后仍可写入
+ */
+static void test_mid_file_corruption(void)
+{
+    uint32_t before;
+    uint32_t after;
+    long records;
+
+    database_disconnect();
+    records = file_size(test_path("_s1.idx")) / TEST_INDEX_ENTRY_SIZE;
+    CHECK(records >= 4);
+
+    /* 第一项是第一次封存的块（不是提交标记），之后还有多次封存 */
+    flip_byte(test_path("_s1.idx"), 20);
+
+    CHECK(reopen());
+    before = TEST_ROWS;
+    after = sensor1_rows();
+    CHECK(after < before);
+    CHECK(after + DB_TSDB_CHUNK_ROWS >= before);
+    CHECK(check_rows(after) == TEST_ROWS - 1);
+
+    /* 去掉损坏项后的索引再次打开不再变化 */
+    records = file_size(test_path("_s1.idx"));
+    CHECK(reopen());
+    CHECK(sensor1_rows() == after);
+    CHECK(file_size(test_path("_s1.idx")) == records);
+
+    insert_rows(TEST_ROWS, TEST_TXN_ROWS);
+    CHECK(reopen());
+    CHECK(sensor1_rows() == after + TEST_TXN_ROWS);
+    CHECK(check_rows(after + TEST_TXN_ROWS) == TEST_ROWS + TEST_TXN_ROWS - 1);
+}
+
+int main(void)
+{
+    crc_init();
+    CHECK(database_init() == SYSTEM_OK);
+    CHECK(database_get_driver() == &DB_DRIVER_TSDB);
+    remove_files();
+
+    test_reopen();
+    test_torn_tail();
+    test_mid_file_corruption();
+
+    database_disconnect();
+    remove_files();
+    printf("test_tsdb: %s\n", (failures == 0) ? "OK" : "FAILED");
+    return (failures == 0) ? 0 : 1;
+}